@@ -0,0 +1,434 @@
+/**
+ * Minecraft Unifier - Streaming JSON Reader Implementation
+ * 流式JSON读取器实现
+ */
+
+#include "json_reader.h"
+#include <cstring>
+
+namespace mcu {
+namespace common {
+
+namespace {
+const int kMaxDepth = 512;
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 码点编码为UTF-8
+void AppendUTF8(std::string& out, unsigned codepoint) {
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+}
+
+JsonSaxReader::JsonSaxReader(size_t bufferSize)
+    : file_(nullptr), buffer_(bufferSize < 16 ? 16 : bufferSize), base_(nullptr), cursor_(nullptr), end_(nullptr),
+      consumed_(0), eof_(true), depth_(0) {
+}
+
+JsonSaxReader::~JsonSaxReader() {
+}
+
+bool JsonSaxReader::ParseFile(const std::string& path, JsonSaxHandler& handler) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error_ = "无法打开文件: " + path;
+        return false;
+    }
+    bool result = Parse(file, handler);
+    std::fclose(file);
+    return result;
+}
+
+bool JsonSaxReader::Parse(std::FILE* file, JsonSaxHandler& handler) {
+    file_ = file;
+    eof_ = false;
+    cursor_ = end_ = base_ = buffer_.data();
+    consumed_ = 0;
+    depth_ = 0;
+    error_.clear();
+
+    // 跳过UTF-8 BOM（Windows编辑器保存的语言文件常带BOM）
+    char c;
+    if (Peek(c) && c == '\xEF') {
+        if (end_ - cursor_ < 3) {
+            Refill();
+        }
+        if (end_ - cursor_ >= 3 && std::memcmp(cursor_, "\xEF\xBB\xBF", 3) == 0) {
+            cursor_ += 3;
+        }
+    }
+
+    SkipWhitespace();
+    if (!ParseValue(handler)) {
+        return false;
+    }
+    SkipWhitespace();
+    if (Peek(c)) {
+        return Fail("文档结尾存在多余内容");
+    }
+    return true;
+}
+
+bool JsonSaxReader::Parse(const char* data, size_t size, JsonSaxHandler& handler) {
+    file_ = nullptr;
+    eof_ = true;
+    cursor_ = base_ = data;
+    end_ = data + size;
+    consumed_ = 0;
+    depth_ = 0;
+    error_.clear();
+
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        cursor_ += 3;
+    }
+
+    SkipWhitespace();
+    if (!ParseValue(handler)) {
+        return false;
+    }
+    SkipWhitespace();
+    char c;
+    if (Peek(c)) {
+        return Fail("文档结尾存在多余内容");
+    }
+    return true;
+}
+
+bool JsonSaxReader::Refill() {
+    if (eof_ || !file_) {
+        return false;
+    }
+    // 保留未消费的尾部字节（仅BOM检测时会出现）
+    size_t remaining = end_ - cursor_;
+    consumed_ += cursor_ - buffer_.data();
+    std::memmove(buffer_.data(), cursor_, remaining);
+    size_t read = std::fread(buffer_.data() + remaining, 1, buffer_.size() - remaining, file_);
+    if (read == 0) {
+        eof_ = true;
+    }
+    cursor_ = buffer_.data();
+    end_ = buffer_.data() + remaining + read;
+    return read > 0;
+}
+
+bool JsonSaxReader::Peek(char& c) {
+    if (cursor_ == end_ && !Refill()) {
+        return false;
+    }
+    c = *cursor_;
+    return true;
+}
+
+void JsonSaxReader::SkipWhitespace() {
+    while (true) {
+        while (cursor_ < end_ && IsWhitespace(*cursor_)) {
+            cursor_++;
+        }
+        if (cursor_ < end_ || !Refill()) {
+            return;
+        }
+    }
+}
+
+bool JsonSaxReader::Fail(const char* message) {
+    if (error_.empty()) {
+        size_t offset = consumed_ + (cursor_ - base_);
+        error_ = std::string(message) + " (offset " + std::to_string(offset) + ")";
+    }
+    return false;
+}
+
+bool JsonSaxReader::ParseValue(JsonSaxHandler& handler) {
+    char c;
+    if (!Peek(c)) {
+        return Fail("意外的文件结尾");
+    }
+    switch (c) {
+        case '{':
+            return ParseObject(handler);
+        case '[':
+            return ParseArray(handler);
+        case '"':
+            if (!ParseString(scratch_)) {
+                return false;
+            }
+            return handler.String(scratch_) || Fail("解析被中止");
+        case 't':
+            return (ParseLiteral("true") && handler.Bool(true)) || Fail("无效的字面量");
+        case 'f':
+            return (ParseLiteral("false") && handler.Bool(false)) || Fail("无效的字面量");
+        case 'n':
+            return (ParseLiteral("null") && handler.Null()) || Fail("无效的字面量");
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                if (!ParseNumber(scratch_)) {
+                    return false;
+                }
+                return handler.Number(scratch_) || Fail("解析被中止");
+            }
+            return Fail("无效的值");
+    }
+}
+
+bool JsonSaxReader::ParseObject(JsonSaxHandler& handler) {
+    if (++depth_ > kMaxDepth) {
+        return Fail("嵌套层级过深");
+    }
+    cursor_++; // '{'
+    if (!handler.StartObject()) {
+        return Fail("解析被中止");
+    }
+
+    SkipWhitespace();
+    char c;
+    if (Peek(c) && c == '}') {
+        cursor_++;
+        depth_--;
+        return handler.EndObject() || Fail("解析被中止");
+    }
+
+    while (true) {
+        SkipWhitespace();
+        if (!Peek(c) || c != '"') {
+            return Fail("对象键必须是字符串");
+        }
+        if (!ParseString(scratch_)) {
+            return false;
+        }
+        if (!handler.Key(scratch_)) {
+            return Fail("解析被中止");
+        }
+        SkipWhitespace();
+        if (!Peek(c) || c != ':') {
+            return Fail("缺少':'");
+        }
+        cursor_++;
+        SkipWhitespace();
+        if (!ParseValue(handler)) {
+            return false;
+        }
+        SkipWhitespace();
+        if (!Peek(c)) {
+            return Fail("意外的文件结尾");
+        }
+        cursor_++;
+        if (c == '}') {
+            break;
+        }
+        if (c != ',') {
+            return Fail("缺少','或'}'");
+        }
+    }
+
+    depth_--;
+    return handler.EndObject() || Fail("解析被中止");
+}
+
+bool JsonSaxReader::ParseArray(JsonSaxHandler& handler) {
+    if (++depth_ > kMaxDepth) {
+        return Fail("嵌套层级过深");
+    }
+    cursor_++; // '['
+    if (!handler.StartArray()) {
+        return Fail("解析被中止");
+    }
+
+    SkipWhitespace();
+    char c;
+    if (Peek(c) && c == ']') {
+        cursor_++;
+        depth_--;
+        return handler.EndArray() || Fail("解析被中止");
+    }
+
+    while (true) {
+        SkipWhitespace();
+        if (!ParseValue(handler)) {
+            return false;
+        }
+        SkipWhitespace();
+        if (!Peek(c)) {
+            return Fail("意外的文件结尾");
+        }
+        cursor_++;
+        if (c == ']') {
+            break;
+        }
+        if (c != ',') {
+            return Fail("缺少','或']'");
+        }
+    }
+
+    depth_--;
+    return handler.EndArray() || Fail("解析被中止");
+}
+
+bool JsonSaxReader::ParseString(std::string& out) {
+    out.clear();
+    cursor_++; // '"'
+
+    while (true) {
+        // 快速路径：整段复制不含引号/转义/控制字符的片段
+        const char* start = cursor_;
+        while (cursor_ < end_) {
+            unsigned char c = static_cast<unsigned char>(*cursor_);
+            if (c == '"' || c == '\\' || c < 0x20) {
+                break;
+            }
+            cursor_++;
+        }
+        out.append(start, cursor_ - start);
+
+        if (cursor_ == end_) {
+            if (!Refill()) {
+                return Fail("字符串未结束");
+            }
+            continue;
+        }
+
+        char c = *cursor_++;
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            return Fail("字符串中包含未转义的控制字符");
+        }
+
+        char escape;
+        if (!Peek(escape)) {
+            return Fail("字符串未结束");
+        }
+        cursor_++;
+        switch (escape) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                unsigned codepoint;
+                if (!ParseHex4(codepoint)) {
+                    return false;
+                }
+                // UTF-16代理对
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    char next;
+                    if (Peek(next) && next == '\\') {
+                        cursor_++;
+                        if (!Peek(next) || next != 'u') {
+                            return Fail("无效的代理对");
+                        }
+                        cursor_++;
+                        unsigned low;
+                        if (!ParseHex4(low)) {
+                            return false;
+                        }
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            return Fail("无效的代理对");
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        codepoint = 0xFFFD;
+                    }
+                } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    codepoint = 0xFFFD;
+                }
+                AppendUTF8(out, codepoint);
+                break;
+            }
+            default:
+                return Fail("无效的转义序列");
+        }
+    }
+}
+
+bool JsonSaxReader::ParseHex4(unsigned& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c;
+        if (!Peek(c)) {
+            return Fail("字符串未结束");
+        }
+        cursor_++;
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            return Fail("无效的\\u转义");
+        }
+    }
+    return true;
+}
+
+bool JsonSaxReader::ParseNumber(std::string& out) {
+    out.clear();
+    char c;
+    while (Peek(c) && (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9'))) {
+        out.push_back(c);
+        cursor_++;
+    }
+    // 校验 -?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+    size_t i = 0;
+    if (i < out.size() && out[i] == '-') i++;
+    if (i >= out.size()) return Fail("无效的数字");
+    if (out[i] == '0') {
+        i++;
+    } else if (out[i] >= '1' && out[i] <= '9') {
+        while (i < out.size() && out[i] >= '0' && out[i] <= '9') i++;
+    } else {
+        return Fail("无效的数字");
+    }
+    if (i < out.size() && out[i] == '.') {
+        size_t digits = ++i;
+        while (i < out.size() && out[i] >= '0' && out[i] <= '9') i++;
+        if (i == digits) return Fail("无效的数字");
+    }
+    if (i < out.size() && (out[i] == 'e' || out[i] == 'E')) {
+        i++;
+        if (i < out.size() && (out[i] == '+' || out[i] == '-')) i++;
+        size_t digits = i;
+        while (i < out.size() && out[i] >= '0' && out[i] <= '9') i++;
+        if (i == digits) return Fail("无效的数字");
+    }
+    if (i != out.size()) {
+        return Fail("无效的数字");
+    }
+    return true;
+}
+
+bool JsonSaxReader::ParseLiteral(const char* literal) {
+    for (const char* p = literal; *p; p++) {
+        char c;
+        if (!Peek(c) || c != *p) {
+            return false;
+        }
+        cursor_++;
+    }
+    return true;
+}
+
+} // namespace common
+} // namespace mcu
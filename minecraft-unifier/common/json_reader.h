@@ -0,0 +1,72 @@
+/**
+ * Minecraft Unifier - Streaming JSON Reader
+ * 流式JSON读取器 - SAX风格回调，分块读取，不构建内存DOM
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace common {
+
+// SAX事件回调，返回false中止解析
+class JsonSaxHandler {
+public:
+    virtual ~JsonSaxHandler() = default;
+
+    virtual bool StartObject() { return true; }
+    virtual bool EndObject() { return true; }
+    virtual bool StartArray() { return true; }
+    virtual bool EndArray() { return true; }
+    virtual bool Key(const std::string& key) { (void)key; return true; }
+    virtual bool String(const std::string& value) { (void)value; return true; }
+    virtual bool Number(const std::string& raw) { (void)raw; return true; }  // 原始数字文本
+    virtual bool Bool(bool value) { (void)value; return true; }
+    virtual bool Null() { return true; }
+};
+
+// 流式JSON读取器（RFC 8259，字符串转义解码为UTF-8）
+class JsonSaxReader {
+public:
+    explicit JsonSaxReader(size_t bufferSize = 64 * 1024);
+    ~JsonSaxReader();
+
+    // 解析文件/内存，成功返回true
+    bool ParseFile(const std::string& path, JsonSaxHandler& handler);
+    bool Parse(std::FILE* file, JsonSaxHandler& handler);
+    bool Parse(const char* data, size_t size, JsonSaxHandler& handler);
+
+    // 获取错误信息（含字节偏移）
+    const std::string& GetError() const { return error_; }
+
+private:
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    const char* base_;          // 当前数据块起始
+    const char* cursor_;
+    const char* end_;
+    size_t consumed_;           // 已丢弃的字节数，用于计算错误偏移
+    bool eof_;
+    std::string error_;
+    std::string scratch_;       // 复用的字符串缓冲
+    int depth_;
+
+    bool Refill();
+    bool Peek(char& c);
+    void SkipWhitespace();
+    bool Fail(const char* message);
+
+    bool ParseValue(JsonSaxHandler& handler);
+    bool ParseObject(JsonSaxHandler& handler);
+    bool ParseArray(JsonSaxHandler& handler);
+    bool ParseString(std::string& out);
+    bool ParseNumber(std::string& out);
+    bool ParseLiteral(const char* literal);
+    bool ParseHex4(unsigned& value);
+};
+
+} // namespace common
+} // namespace mcu
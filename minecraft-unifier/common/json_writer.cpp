@@ -0,0 +1,170 @@
+/**
+ * Minecraft Unifier - Streaming JSON Writer Implementation
+ * 流式JSON写入器实现
+ */
+
+#include "json_writer.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace mcu {
+namespace common {
+
+namespace {
+const size_t kBufferSize = 64 * 1024;
+}
+
+JsonWriter::JsonWriter(std::FILE* file)
+    : file_(file), afterKey_(false), failed_(file == nullptr) {
+    buffer_.reserve(kBufferSize);
+}
+
+JsonWriter::~JsonWriter() {
+    Flush();
+}
+
+void JsonWriter::BeginObject() {
+    BeforeValue();
+    Put('{');
+    firstInScope_.push_back(true);
+}
+
+void JsonWriter::EndObject() {
+    firstInScope_.pop_back();
+    Put('}');
+}
+
+void JsonWriter::BeginArray() {
+    BeforeValue();
+    Put('[');
+    firstInScope_.push_back(true);
+}
+
+void JsonWriter::EndArray() {
+    firstInScope_.pop_back();
+    Put(']');
+}
+
+void JsonWriter::Key(const std::string& key) {
+    BeforeValue();
+    WriteEscaped(key);
+    Put(':');
+    afterKey_ = true;
+}
+
+void JsonWriter::String(const std::string& value) {
+    BeforeValue();
+    WriteEscaped(value);
+}
+
+void JsonWriter::Number(double value) {
+    BeforeValue();
+    // JSON不支持NaN/Inf
+    if (!std::isfinite(value)) {
+        Write("0", 1);
+        return;
+    }
+    // 最短可往返表示，避免printf的格式化开销
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    Write(text, result.ptr - text);
+}
+
+void JsonWriter::Number(float value) {
+    BeforeValue();
+    if (!std::isfinite(value)) {
+        Write("0", 1);
+        return;
+    }
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    Write(text, result.ptr - text);
+}
+
+void JsonWriter::Int(int64_t value) {
+    BeforeValue();
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    Write(text, result.ptr - text);
+}
+
+void JsonWriter::Bool(bool value) {
+    BeforeValue();
+    if (value) {
+        Write("true", 4);
+    } else {
+        Write("false", 5);
+    }
+}
+
+void JsonWriter::Null() {
+    BeforeValue();
+    Write("null", 4);
+}
+
+bool JsonWriter::Flush() {
+    if (!buffer_.empty() && !failed_) {
+        if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            failed_ = true;
+        }
+    }
+    buffer_.clear();
+    return !failed_;
+}
+
+void JsonWriter::BeforeValue() {
+    // 键之后的值不需要逗号
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (!firstInScope_.empty()) {
+        if (!firstInScope_.back()) {
+            Put(',');
+        }
+        firstInScope_.back() = false;
+    }
+}
+
+void JsonWriter::Write(const char* data, size_t size) {
+    if (buffer_.size() + size > kBufferSize) {
+        Flush();
+    }
+    buffer_.insert(buffer_.end(), data, data + size);
+}
+
+void JsonWriter::Put(char c) {
+    if (buffer_.size() >= kBufferSize) {
+        Flush();
+    }
+    buffer_.push_back(c);
+}
+
+void JsonWriter::WriteEscaped(const std::string& value) {
+    static const char kHex[] = "0123456789abcdef";
+    Put('"');
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':  Write("\\\"", 2); break;
+            case '\\': Write("\\\\", 2); break;
+            case '\b': Write("\\b", 2); break;
+            case '\f': Write("\\f", 2); break;
+            case '\n': Write("\\n", 2); break;
+            case '\r': Write("\\r", 2); break;
+            case '\t': Write("\\t", 2); break;
+            default:
+                if (c < 0x20) {
+                    char escaped[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+                    Write(escaped, sizeof(escaped));
+                } else {
+                    Put(static_cast<char>(c));
+                }
+                break;
+        }
+    }
+    Put('"');
+}
+
+} // namespace common
+} // namespace mcu
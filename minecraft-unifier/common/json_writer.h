@@ -0,0 +1,56 @@
+/**
+ * Minecraft Unifier - Streaming JSON Writer
+ * 流式JSON写入器 - 边生成边写出，不构建内存DOM
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace common {
+
+// 紧凑格式输出的流式JSON写入器，调用方负责保证结构配对
+class JsonWriter {
+public:
+    explicit JsonWriter(std::FILE* file);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    // 结构
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    void Key(const std::string& key);
+
+    // 值
+    void String(const std::string& value);
+    void Number(double value);
+    void Number(float value);   // 按单精度取最短表示
+    void Int(int64_t value);
+    void Bool(bool value);
+    void Null();
+
+    // 写出缓冲区，返回是否全部写入成功
+    bool Flush();
+
+private:
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    std::vector<bool> firstInScope_;  // 每层容器是否尚未写入元素
+    bool afterKey_;
+    bool failed_;
+
+    void BeforeValue();
+    void Write(const char* data, size_t size);
+    void Put(char c);
+    void WriteEscaped(const std::string& value);
+};
+
+} // namespace common
+} // namespace mcu
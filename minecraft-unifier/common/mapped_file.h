@@ -0,0 +1,43 @@
+/**
+ * Minecraft Unifier - Mapped File
+ * 只读内存映射文件 - 供缓存、归档等按需读取的大文件使用
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mcu {
+namespace common {
+
+// 只读内存映射文件
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整个文件，空文件或失败返回false
+    bool Open(const std::string& path);
+
+    // 解除映射
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+};
+
+} // namespace common
+} // namespace mcu
@@ -0,0 +1,112 @@
+/**
+ * Minecraft Unifier - Thread Pool Implementation
+ * 通用线程池实现
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace mcu {
+namespace common {
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : stopping_(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+ThreadPool& ThreadPool::GetDefault() {
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, const std::function<void(size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+
+    // 共享状态：工作线程可能在调用方返回后才被调度，需持有shared_ptr
+    struct State {
+        std::atomic<size_t> next;
+        std::atomic<size_t> done{0};
+        size_t end;
+        std::function<void(size_t)> fn;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+    state->next = begin;
+    state->end = end;
+    state->fn = fn;
+    size_t total = end - begin;
+
+    auto run = [state, total]() {
+        size_t processed = 0;
+        size_t i;
+        while ((i = state->next.fetch_add(1)) < state->end) {
+            state->fn(i);
+            processed++;
+        }
+        if (processed > 0 && state->done.fetch_add(processed) + processed == total) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->finished.notify_all();
+        }
+    };
+
+    size_t helpers = std::min(workers_.size(), total - 1);
+    for (size_t h = 0; h < helpers; h++) {
+        Enqueue(run);
+    }
+
+    // 调用线程参与执行，保证嵌套调用时也能推进
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done.load() == total; });
+}
+
+} // namespace common
+} // namespace mcu
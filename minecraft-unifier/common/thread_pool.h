@@ -0,0 +1,62 @@
+/**
+ * Minecraft Unifier - Thread Pool
+ * 通用线程池 - 供资源转换、着色器编译等批处理任务使用
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mcu {
+namespace common {
+
+// 固定大小线程池
+class ThreadPool {
+public:
+    // threadCount为0时使用硬件并发数
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，返回future
+    template <typename F>
+    auto Submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        Enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    // 并行执行fn(i)，i ∈ [begin, end)，阻塞直到全部完成
+    // 调用线程也参与执行，可在工作线程内嵌套调用
+    void ParallelFor(size_t begin, size_t end, const std::function<void(size_t)>& fn);
+
+    // 获取线程数
+    size_t GetThreadCount() const { return workers_.size(); }
+
+    // 进程级默认线程池
+    static ThreadPool& GetDefault();
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+
+    void Enqueue(std::function<void()> task);
+    void WorkerLoop();
+};
+
+} // namespace common
+} // namespace mcu
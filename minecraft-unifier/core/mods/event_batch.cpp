@@ -0,0 +1,133 @@
+/**
+ * Minecraft Unifier - Event Batch Queue Implementation
+ * 事件批处理队列实现
+ */
+
+#include "event_batch.h"
+#include <algorithm>
+#include <cstring>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+EventBatchQueue::EventBatchQueue(size_t slabSize, size_t slabCount)
+    : slabSize_(std::max(slabSize, sizeof(EventRecordHeader)))
+    , slabs_(std::max<size_t>(slabCount, 1))
+    , read_(0)
+    , sealed_(0) {
+    for (auto& slab : slabs_) {
+        slab.data.resize(slabSize_);
+    }
+}
+
+uint16_t EventBatchQueue::RegisterEventType(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = eventTypeIndex_.find(name);
+    if (it != eventTypeIndex_.end()) {
+        return it->second;
+    }
+
+    uint16_t type = static_cast<uint16_t>(eventTypes_.size());
+    eventTypes_.push_back(name);
+    eventTypeIndex_[name] = type;
+    return type;
+}
+
+int EventBatchQueue::FindEventType(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = eventTypeIndex_.find(name);
+    return it != eventTypeIndex_.end() ? it->second : -1;
+}
+
+std::vector<std::string> EventBatchQueue::GetEventTypes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return eventTypes_;
+}
+
+bool EventBatchQueue::Push(uint16_t type, const void* payload, uint32_t size) {
+    size_t recordSize = sizeof(EventRecordHeader) + size;
+    if (recordSize > slabSize_) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_ >= slabs_.size()) {
+        // 所有缓冲区都在等待分发
+        return false;
+    }
+
+    Slab* slab = &slabs_[(read_ + sealed_) % slabs_.size()];
+    if (slab->used + recordSize > slabSize_) {
+        // 当前缓冲区写满，必须保留一个可写的缓冲区
+        if (sealed_ + 1 >= slabs_.size()) {
+            return false;
+        }
+        sealed_++;
+        slab = &slabs_[(read_ + sealed_) % slabs_.size()];
+    }
+
+    EventRecordHeader header = {type, 0, size};
+    uint8_t* out = slab->data.data() + slab->used;
+    std::memcpy(out, &header, sizeof(header));
+    if (size > 0) {
+        std::memcpy(out + sizeof(header), payload, size);
+    }
+    slab->used += recordSize;
+    slab->count++;
+    return true;
+}
+
+size_t EventBatchQueue::Flush(const BatchSink& sink) {
+    // 分发进行中（例如Java侧处理事件时又产生事件）直接返回，避免重入
+    std::unique_lock<std::mutex> flushLock(flushMutex_, std::try_to_lock);
+    if (!flushLock.owns_lock()) {
+        return 0;
+    }
+
+    std::vector<Batch> batches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 封存当前缓冲区（此后直到分发完成，Push可能返回false）
+        if (sealed_ < slabs_.size() && slabs_[(read_ + sealed_) % slabs_.size()].count > 0) {
+            sealed_++;
+        }
+        for (size_t i = 0; i < sealed_; i++) {
+            size_t index = (read_ + i) % slabs_.size();
+            const Slab& slab = slabs_[index];
+            batches.push_back({index, slab.data.data(), slab.used, slab.count});
+        }
+    }
+
+    // 在锁外分发，生产者可继续写入未封存的缓冲区
+    size_t events = 0;
+    for (const auto& batch : batches) {
+        if (sink) {
+            sink(batch);
+        }
+        events += batch.count;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < batches.size(); i++) {
+        Slab& slab = slabs_[read_];
+        slab.used = 0;
+        slab.count = 0;
+        read_ = (read_ + 1) % slabs_.size();
+    }
+    sealed_ -= batches.size();
+    return events;
+}
+
+size_t EventBatchQueue::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& slab : slabs_) {
+        count += slab.count;
+    }
+    return count;
+}
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
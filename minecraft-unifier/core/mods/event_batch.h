@@ -0,0 +1,84 @@
+/**
+ * Minecraft Unifier - Event Batch Queue
+ * 事件批处理队列 - 每tick收集事件，整批交给Java侧分发，减少JNI跨越次数
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+// 批内事件记录头（本机字节序），负载紧跟其后
+struct EventRecordHeader {
+    uint16_t type;              // 事件类型ID（RegisterEventType返回值）
+    uint16_t flags;             // 保留
+    uint32_t size;              // 负载字节数
+};
+
+// 固定大小缓冲区组成的环，地址在构造后不变，可直接包装为DirectByteBuffer
+// 生产者可在任意线程追加事件；Flush时按顺序交出已封存的缓冲区
+class EventBatchQueue {
+public:
+    // 已封存的批次
+    struct Batch {
+        size_t slab;            // 缓冲区索引
+        const uint8_t* data;
+        size_t bytes;
+        uint32_t count;         // 事件数
+    };
+    using BatchSink = std::function<void(const Batch& batch)>;
+
+    explicit EventBatchQueue(size_t slabSize = 64 * 1024, size_t slabCount = 4);
+
+    // 登记事件类型，同名返回已有ID
+    uint16_t RegisterEventType(const std::string& name);
+
+    // 查找事件类型，不存在返回-1
+    int FindEventType(const std::string& name) const;
+
+    // 所有事件类型名称（下标为ID）
+    std::vector<std::string> GetEventTypes() const;
+
+    // 追加事件，所有缓冲区都已写满或事件大于单个缓冲区时返回false
+    bool Push(uint16_t type, const void* payload, uint32_t size);
+
+    // 封存当前缓冲区并依次交给sink，返回交出的事件数
+    // sink执行期间生产者继续写入其他缓冲区；已有Flush进行中时直接返回0
+    size_t Flush(const BatchSink& sink);
+
+    // 待处理事件数
+    size_t GetPendingCount() const;
+
+    uint8_t* GetSlabData(size_t slab) { return slabs_[slab].data.data(); }
+    size_t GetSlabSize() const { return slabSize_; }
+    size_t GetSlabCount() const { return slabs_.size(); }
+
+private:
+    struct Slab {
+        std::vector<uint8_t> data;
+        size_t used = 0;
+        uint32_t count = 0;
+    };
+
+    size_t slabSize_;
+    std::vector<Slab> slabs_;
+    size_t read_;               // 最早封存的缓冲区
+    size_t sealed_;             // 已封存数，read_+sealed_为当前写入的缓冲区
+    mutable std::mutex mutex_;
+    std::mutex flushMutex_;
+
+    std::vector<std::string> eventTypes_;
+    std::unordered_map<std::string, uint16_t> eventTypeIndex_;
+};
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,610 @@
+/**
+ * Minecraft Unifier - JAR Scanner Implementation
+ * JAR元数据扫描实现
+ */
+
+#include "jar_scanner.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+namespace {
+
+// ZIP记录签名与固定长度
+const uint32_t kEndOfCentralDirectorySignature = 0x06054B50;
+const uint32_t kCentralDirectorySignature = 0x02014B50;
+const uint32_t kLocalHeaderSignature = 0x04034B50;
+const size_t kEndOfCentralDirectorySize = 22;
+const size_t kCentralDirectoryEntrySize = 46;
+const size_t kLocalHeaderSize = 30;
+const size_t kMaxCommentSize = 0xFFFF;
+
+const uint16_t kMethodStored = 0;
+const uint16_t kMethodDeflated = 8;
+
+// 缓存文件：magic | 版本 | 条目数 | 条目（hash | 三个描述文件 | 入口类） | 条目数据的CRC
+const char kCacheMagic[8] = {'M', 'C', 'U', 'J', 'A', 'R', 'C', 'H'};
+const uint32_t kCacheFormatVersion = 2;
+
+const char* const kMcmodInfoPath = "mcmod.info";
+const char* const kModsTomlPath = "META-INF/mods.toml";
+const char* const kFabricModJsonPath = "fabric.mod.json";
+
+// Forge各版本@Mod注解的类型描述符
+const char* const kModAnnotationDescriptors[] = {
+    "Lnet/minecraftforge/fml/common/Mod;",
+    "Lnet/neoforged/fml/common/Mod;",
+    "Lcpw/mods/fml/common/Mod;"
+};
+
+// Fabric中需要在客户端初始化的入口点
+const char* const kFabricEntryPointKeys[] = {"\"main\"", "\"client\""};
+
+template <typename T>
+T ReadValue(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void WriteValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void WriteString(std::vector<uint8_t>& out, const std::string& value) {
+    WriteValue<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// 带边界检查的顺序读取
+struct CacheReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    template <typename T>
+    bool Read(T& value) {
+        if (size - pos < sizeof(T)) {
+            return false;
+        }
+        value = ReadValue<T>(data + pos);
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string& value) {
+        uint32_t length;
+        if (!Read(length) || size - pos < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+};
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    return static_cast<uint32_t>(crc32(crc, data, static_cast<uInt>(size)));
+}
+
+// 按8字节混合的哈希（中央目录可达数百KB，逐字节哈希会占据热启动的大部分时间）
+uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    uint64_t hash = seed ^ (size * 0x9E3779B97F4A7C15ULL);
+    auto mix = [&hash](uint64_t word) {
+        hash = (((hash << 5) | (hash >> 59)) ^ word) * 0x9E3779B97F4A7C15ULL;
+    };
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        mix(ReadValue<uint64_t>(data + i));
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    mix(tail);
+    
+    // splitmix64终结
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+uint16_t ReadBigEndian16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+// 遍历类文件常量池，查找与注解描述符相同的UTF8常量（注解类型只以描述符形式出现在常量池中）
+bool ClassHasModAnnotation(const std::string& classFile) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(classFile.data());
+    size_t size = classFile.size();
+    if (size < 10 || data[0] != 0xCA || data[1] != 0xFE || data[2] != 0xBA || data[3] != 0xBE) {
+        return false;
+    }
+
+    uint16_t constantCount = ReadBigEndian16(data + 8);
+    size_t pos = 10;
+    for (uint16_t i = 1; i < constantCount; i++) {
+        if (pos >= size) {
+            return false;
+        }
+        size_t length;
+        switch (data[pos]) {
+        case 1: {   // Utf8
+            if (size - pos < 3) {
+                return false;
+            }
+            uint16_t utf8Length = ReadBigEndian16(data + pos + 1);
+            if (size - pos - 3 < utf8Length) {
+                return false;
+            }
+            for (const char* descriptor : kModAnnotationDescriptors) {
+                if (std::strlen(descriptor) == utf8Length &&
+                    std::memcmp(data + pos + 3, descriptor, utf8Length) == 0) {
+                    return true;
+                }
+            }
+            length = 3 + utf8Length;
+            break;
+        }
+        case 3: case 4: case 9: case 10: case 11: case 12: case 17: case 18:
+            length = 5;
+            break;
+        case 5: case 6:     // Long/Double占两个槽位
+            length = 9;
+            i++;
+            break;
+        case 7: case 8: case 16: case 19: case 20:
+            length = 3;
+            break;
+        case 15:
+            length = 4;
+            break;
+        default:
+            return false;
+        }
+        pos += length;
+    }
+    return false;
+}
+
+// 解析fabric.mod.json的entrypoints，条目为"类名"、"类名::成员"或{"adapter": ..., "value": ...}
+void ParseFabricEntryPoints(const std::string& content, std::vector<std::string>& entryPoints) {
+    size_t section = content.find("\"entrypoints\"");
+    if (section == std::string::npos) {
+        return;
+    }
+    for (const char* key : kFabricEntryPointKeys) {
+        size_t pos = content.find(key, section);
+        size_t begin = pos != std::string::npos ? content.find('[', pos) : std::string::npos;
+        size_t end = begin != std::string::npos ? content.find(']', begin) : std::string::npos;
+        if (end == std::string::npos) {
+            continue;
+        }
+
+        bool skipNext = false;
+        for (size_t quote = content.find('"', begin); quote != std::string::npos && quote < end;) {
+            size_t close = content.find('"', quote + 1);
+            if (close == std::string::npos || close > end) {
+                break;
+            }
+            std::string token = content.substr(quote + 1, close - quote - 1);
+            size_t next = content.find_first_not_of(" \t\r\n", close + 1);
+            bool isKey = next != std::string::npos && content[next] == ':';
+            quote = content.find('"', close + 1);
+
+            if (isKey) {
+                skipNext = token != "value";
+                continue;
+            }
+            if (skipNext) {
+                skipNext = false;
+                continue;
+            }
+
+            std::string className = token.substr(0, token.find("::"));
+            std::replace(className.begin(), className.end(), '.', '/');
+            if (!className.empty() &&
+                std::find(entryPoints.begin(), entryPoints.end(), className) == entryPoints.end()) {
+                entryPoints.push_back(className);
+            }
+        }
+    }
+}
+
+// 解压原始deflate数据（无zlib头）
+bool InflateRaw(const uint8_t* data, size_t size, std::string& output) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int result = inflate(&stream, Z_FINISH);
+    bool ok = result == Z_STREAM_END && stream.total_out == output.size();
+    inflateEnd(&stream);
+    return ok;
+}
+
+} // namespace
+
+// ==================== JarArchive ====================
+
+JarArchive::JarArchive()
+    : file_(new common::MappedFile())
+    , centralDirectory_(nullptr)
+    , centralDirectorySize_(0)
+    , entryCount_(0)
+    , hash_(0) {
+}
+
+JarArchive::~JarArchive() {
+}
+
+bool JarArchive::Open(const std::string& path) {
+    Close();
+    if (!file_->Open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = file_->Data();
+    size_t size = file_->Size();
+    if (size < kEndOfCentralDirectorySize) {
+        Close();
+        return false;
+    }
+
+    // 从文件末尾向前查找中央目录结束记录（其后可能有注释）
+    size_t searchStart = size > kEndOfCentralDirectorySize + kMaxCommentSize
+        ? size - kEndOfCentralDirectorySize - kMaxCommentSize : 0;
+    size_t end = size - kEndOfCentralDirectorySize + 1;
+    const uint8_t* record = nullptr;
+    while (end-- > searchStart) {
+        if (ReadValue<uint32_t>(data + end) == kEndOfCentralDirectorySignature) {
+            record = data + end;
+            break;
+        }
+    }
+    if (!record) {
+        Close();
+        return false;
+    }
+
+    uint16_t entryCount = ReadValue<uint16_t>(record + 10);
+    uint32_t directorySize = ReadValue<uint32_t>(record + 12);
+    uint32_t directoryOffset = ReadValue<uint32_t>(record + 16);
+    if (static_cast<uint64_t>(directoryOffset) + directorySize > static_cast<uint64_t>(record - data)) {
+        // ZIP64或损坏的归档
+        Close();
+        return false;
+    }
+
+    centralDirectory_ = data + directoryOffset;
+    centralDirectorySize_ = directorySize;
+    entryCount_ = entryCount;
+
+    hash_ = HashBytes(centralDirectory_, centralDirectorySize_, size);
+    return true;
+}
+
+void JarArchive::Close() {
+    file_->Close();
+    centralDirectory_ = nullptr;
+    centralDirectorySize_ = 0;
+    entryCount_ = 0;
+    hash_ = 0;
+}
+
+bool JarArchive::NextEntry(size_t& pos, const char*& name, size_t& nameLength, Entry& entry) const {
+    if (centralDirectorySize_ - pos < kCentralDirectoryEntrySize) {
+        return false;
+    }
+    const uint8_t* header = centralDirectory_ + pos;
+    if (ReadValue<uint32_t>(header) != kCentralDirectorySignature) {
+        return false;
+    }
+    uint16_t extraLength = ReadValue<uint16_t>(header + 30);
+    uint16_t commentLength = ReadValue<uint16_t>(header + 32);
+    nameLength = ReadValue<uint16_t>(header + 28);
+    size_t recordSize = kCentralDirectoryEntrySize + nameLength + extraLength + commentLength;
+    if (centralDirectorySize_ - pos < recordSize) {
+        return false;
+    }
+
+    name = reinterpret_cast<const char*>(header + kCentralDirectoryEntrySize);
+    entry.method = ReadValue<uint16_t>(header + 10);
+    entry.crc = ReadValue<uint32_t>(header + 16);
+    entry.compressedSize = ReadValue<uint32_t>(header + 20);
+    entry.size = ReadValue<uint32_t>(header + 24);
+    entry.localHeaderOffset = ReadValue<uint32_t>(header + 42);
+    pos += recordSize;
+    return true;
+}
+
+bool JarArchive::FindEntry(const std::string& name, Entry& entry) const {
+    if (!centralDirectory_) {
+        return false;
+    }
+
+    // 顺序扫描中央目录，只比较名称，不分配内存
+    size_t pos = 0;
+    const char* entryName;
+    size_t nameLength;
+    for (size_t i = 0; i < entryCount_ && NextEntry(pos, entryName, nameLength, entry); i++) {
+        if (nameLength == name.size() && std::memcmp(entryName, name.data(), nameLength) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JarArchive::HasEntry(const std::string& name) const {
+    Entry entry;
+    return FindEntry(name, entry);
+}
+
+bool JarArchive::ReadEntry(const std::string& name, std::string& content) const {
+    Entry entry;
+    return FindEntry(name, entry) && ReadEntryData(entry, content);
+}
+
+size_t JarArchive::ReadEntries(const std::string& suffix, const EntryVisitor& visitor) const {
+    if (!centralDirectory_) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    size_t visited = 0;
+    const char* entryName;
+    size_t nameLength;
+    Entry entry;
+    std::string name;
+    std::string content;
+    for (size_t i = 0; i < entryCount_ && NextEntry(pos, entryName, nameLength, entry); i++) {
+        if (nameLength < suffix.size() ||
+            std::memcmp(entryName + nameLength - suffix.size(), suffix.data(), suffix.size()) != 0 ||
+            !ReadEntryData(entry, content)) {
+            continue;
+        }
+        name.assign(entryName, nameLength);
+        visited++;
+        if (!visitor(name, content)) {
+            break;
+        }
+    }
+    return visited;
+}
+
+bool JarArchive::ReadEntryData(const Entry& entry, std::string& content) const {
+    // 本地文件头的扩展字段长度可能与中央目录不同，需重新读取
+    const uint8_t* data = file_->Data();
+    size_t size = file_->Size();
+    if (static_cast<uint64_t>(entry.localHeaderOffset) + kLocalHeaderSize > size ||
+        ReadValue<uint32_t>(data + entry.localHeaderOffset) != kLocalHeaderSignature) {
+        return false;
+    }
+    const uint8_t* local = data + entry.localHeaderOffset;
+    uint64_t dataOffset = static_cast<uint64_t>(entry.localHeaderOffset) + kLocalHeaderSize +
+                          ReadValue<uint16_t>(local + 26) + ReadValue<uint16_t>(local + 28);
+    if (dataOffset + entry.compressedSize > size) {
+        return false;
+    }
+    const uint8_t* payload = data + dataOffset;
+
+    // deflate的压缩比不超过1032:1，超出说明中央目录损坏，避免按错误的大小分配内存
+    if (entry.method == kMethodDeflated &&
+        static_cast<uint64_t>(entry.size) > static_cast<uint64_t>(entry.compressedSize) * 1032 + 64) {
+        return false;
+    }
+
+    content.assign(entry.size, '\0');
+    if (entry.method == kMethodStored) {
+        if (entry.compressedSize != entry.size) {
+            return false;
+        }
+        if (entry.size > 0) {
+            std::memcpy(&content[0], payload, entry.size);
+        }
+    } else if (entry.method == kMethodDeflated) {
+        if (entry.size > 0 && !InflateRaw(payload, entry.compressedSize, content)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    return Crc32(reinterpret_cast<const uint8_t*>(content.data()), content.size()) == entry.crc;
+}
+
+// ==================== JarScanner ====================
+
+JarScanner::JarScanner()
+    : threadPool_(nullptr)
+    , hits_(0)
+    , misses_(0) {
+}
+
+JarScanner::~JarScanner() {
+}
+
+void JarScanner::SetThreadPool(common::ThreadPool* pool) {
+    threadPool_ = pool;
+}
+
+bool JarScanner::Scan(const std::string& jarPath, JarMetadata& metadata) {
+    metadata = JarMetadata();
+
+    JarArchive archive;
+    if (!archive.Open(jarPath)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(archive.GetHash());
+        if (it != cache_.end()) {
+            hits_++;
+            metadata = it->second;
+            return true;
+        }
+    }
+    misses_++;
+
+    // 只解压描述文件，读取失败的视为不存在
+    metadata.valid = true;
+    metadata.hash = archive.GetHash();
+    if (!archive.ReadEntry(kMcmodInfoPath, metadata.mcmodInfo)) {
+        metadata.mcmodInfo.clear();
+    }
+    if (!archive.ReadEntry(kModsTomlPath, metadata.modsToml)) {
+        metadata.modsToml.clear();
+    }
+    if (!archive.ReadEntry(kFabricModJsonPath, metadata.fabricModJson)) {
+        metadata.fabricModJson.clear();
+    }
+
+    // 解析入口类，结果随元数据缓存：Fabric直接声明，Forge需在类文件中查找@Mod注解
+    // 运行时只使用描述文件中的第一个模组，找到第一个@Mod类即可停止解压
+    ParseFabricEntryPoints(metadata.fabricModJson, metadata.entryPoints);
+    if (metadata.fabricModJson.empty() && (!metadata.modsToml.empty() || !metadata.mcmodInfo.empty())) {
+        archive.ReadEntries(".class", [&metadata](const std::string& name, const std::string& content) {
+            if (!ClassHasModAnnotation(content)) {
+                return true;
+            }
+            metadata.entryPoints.push_back(name.substr(0, name.size() - 6));
+            return false;
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_[metadata.hash] = metadata;
+    return true;
+}
+
+std::vector<JarMetadata> JarScanner::ScanAll(const std::vector<std::string>& jarPaths) {
+    std::vector<JarMetadata> results(jarPaths.size());
+    common::ThreadPool& pool = threadPool_ ? *threadPool_ : common::ThreadPool::GetDefault();
+    pool.ParallelFor(0, jarPaths.size(), [&](size_t i) {
+        Scan(jarPaths[i], results[i]);
+    });
+    return results;
+}
+
+bool JarScanner::SaveCache(const std::string& cachePath) const {
+    std::vector<uint8_t> data(kCacheMagic, kCacheMagic + sizeof(kCacheMagic));
+    WriteValue<uint32_t>(data, kCacheFormatVersion);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteValue<uint32_t>(data, static_cast<uint32_t>(cache_.size()));
+        for (const auto& [hash, metadata] : cache_) {
+            WriteValue<uint64_t>(data, hash);
+            WriteString(data, metadata.mcmodInfo);
+            WriteString(data, metadata.modsToml);
+            WriteString(data, metadata.fabricModJson);
+            WriteValue<uint32_t>(data, static_cast<uint32_t>(metadata.entryPoints.size()));
+            for (const auto& entryPoint : metadata.entryPoints) {
+                WriteString(data, entryPoint);
+            }
+        }
+    }
+    size_t headerSize = sizeof(kCacheMagic) + 2 * sizeof(uint32_t);
+    WriteValue<uint32_t>(data, Crc32(data.data() + headerSize, data.size() - headerSize));
+
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, cachePath, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool JarScanner::LoadCache(const std::string& cachePath) {
+    common::MappedFile file;
+    if (!file.Open(cachePath)) {
+        return false;
+    }
+
+    const uint8_t* data = file.Data();
+    size_t size = file.Size();
+    size_t headerSize = sizeof(kCacheMagic) + 2 * sizeof(uint32_t);
+    if (size < headerSize + sizeof(uint32_t) ||
+        std::memcmp(data, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        ReadValue<uint32_t>(data + sizeof(kCacheMagic)) != kCacheFormatVersion ||
+        ReadValue<uint32_t>(data + size - sizeof(uint32_t)) !=
+            Crc32(data + headerSize, size - headerSize - sizeof(uint32_t))) {
+        return false;
+    }
+
+    uint32_t count = ReadValue<uint32_t>(data + sizeof(kCacheMagic) + sizeof(uint32_t));
+    CacheReader reader = {data, size - sizeof(uint32_t), headerSize};
+    std::unordered_map<uint64_t, JarMetadata> loaded;
+    for (uint32_t i = 0; i < count; i++) {
+        JarMetadata metadata;
+        if (!reader.Read(metadata.hash) || !reader.ReadString(metadata.mcmodInfo) ||
+            !reader.ReadString(metadata.modsToml) || !reader.ReadString(metadata.fabricModJson)) {
+            return false;
+        }
+        uint32_t entryPointCount;
+        if (!reader.Read(entryPointCount)) {
+            return false;
+        }
+        for (uint32_t e = 0; e < entryPointCount; e++) {
+            std::string entryPoint;
+            if (!reader.ReadString(entryPoint)) {
+                return false;
+            }
+            metadata.entryPoints.push_back(std::move(entryPoint));
+        }
+        metadata.valid = true;
+        loaded[metadata.hash] = std::move(metadata);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [hash, metadata] : loaded) {
+        cache_[hash] = std::move(metadata);
+    }
+    return true;
+}
+
+size_t JarScanner::GetCacheSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+void JarScanner::ClearCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,123 @@
+/**
+ * Minecraft Unifier - JAR Scanner
+ * JAR元数据扫描 - 直接读取ZIP中央目录，在内存中解压模组描述文件
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace common {
+class MappedFile;
+class ThreadPool;
+}
+
+namespace core {
+namespace mods {
+
+// 只读JAR（ZIP）归档，不支持ZIP64与加密条目
+class JarArchive {
+public:
+    JarArchive();
+    ~JarArchive();
+
+    JarArchive(const JarArchive&) = delete;
+    JarArchive& operator=(const JarArchive&) = delete;
+
+    // 映射文件并定位中央目录
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return centralDirectory_ != nullptr; }
+    size_t GetEntryCount() const { return entryCount_; }
+
+    // 中央目录与文件大小的哈希（中央目录包含每个条目的CRC，内容变化时哈希随之变化）
+    uint64_t GetHash() const { return hash_; }
+
+    // 查找条目
+    bool HasEntry(const std::string& name) const;
+
+    // 读取条目（存储或deflate），CRC不符时返回false
+    bool ReadEntry(const std::string& name, std::string& content) const;
+
+    // 按中央目录顺序读取名称以suffix结尾的条目，读取失败的跳过；visitor返回false时停止
+    using EntryVisitor = std::function<bool(const std::string& name, const std::string& content)>;
+    size_t ReadEntries(const std::string& suffix, const EntryVisitor& visitor) const;
+
+private:
+    struct Entry {
+        uint16_t method;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t localHeaderOffset;
+    };
+
+    std::unique_ptr<common::MappedFile> file_;
+    const uint8_t* centralDirectory_;
+    size_t centralDirectorySize_;
+    size_t entryCount_;
+    uint64_t hash_;
+
+    bool FindEntry(const std::string& name, Entry& entry) const;
+
+    // 解析pos处的中央目录记录并前进到下一条，记录不完整时返回false
+    bool NextEntry(size_t& pos, const char*& name, size_t& nameLength, Entry& entry) const;
+    bool ReadEntryData(const Entry& entry, std::string& content) const;
+};
+
+// 从JAR中读取的模组描述文件（不存在的为空）
+struct JarMetadata {
+    bool valid = false;             // JAR可以解析
+    uint64_t hash = 0;              // JarArchive::GetHash
+    std::string mcmodInfo;          // mcmod.info（Forge旧版）
+    std::string modsToml;           // META-INF/mods.toml（Forge新版）
+    std::string fabricModJson;      // fabric.mod.json（Fabric）
+    std::vector<std::string> entryPoints; // 入口类的内部名称（Fabric入口点或带@Mod注解的类）
+};
+
+// JAR元数据扫描器，结果按JAR哈希缓存，命中时无需解压
+class JarScanner {
+public:
+    JarScanner();
+    ~JarScanner();
+
+    // 设置线程池（nullptr使用默认线程池）
+    void SetThreadPool(common::ThreadPool* pool);
+
+    // 扫描单个JAR
+    bool Scan(const std::string& jarPath, JarMetadata& metadata);
+
+    // 并行扫描多个JAR，结果与输入顺序一致
+    std::vector<JarMetadata> ScanAll(const std::vector<std::string>& jarPaths);
+
+    // 缓存持久化（先写临时文件再替换），文件损坏时LoadCache返回false
+    bool SaveCache(const std::string& cachePath) const;
+    bool LoadCache(const std::string& cachePath);
+
+    // 统计
+    size_t GetCacheSize() const;
+    uint64_t GetHitCount() const { return hits_.load(); }
+    uint64_t GetMissCount() const { return misses_.load(); }
+
+    void ClearCache();
+
+private:
+    common::ThreadPool* threadPool_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, JarMetadata> cache_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
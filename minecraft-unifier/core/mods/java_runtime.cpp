@@ -4,6 +4,10 @@
  */
 
 #include "java_runtime.h"
+#include "thread_pool.h"
+#include "mod_profiler.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -11,6 +15,185 @@
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Java侧事件分发器：
+//   static void registerEventType(int type, String name)
+//   static void dispatchBatch(ByteBuffer buffer, int bytes, int count)
+// buffer中为连续的EventRecordHeader与负载（本机字节序）
+const char* const kEventDispatcherClass = "com/mcu/bridge/EventDispatcher";
+
+// JVM代数，创建与销毁时递增（进程内只有一个JVM，线程局部缓存据此判断是否过期）
+std::atomic<uint64_t> g_jvmGeneration(0);
+
+// 线程局部的JNIEnv缓存
+struct ThreadEnv {
+    JavaVM* vm = nullptr;
+    JNIEnv* env = nullptr;
+    uint64_t generation = 0;
+    bool attached = false;      // 由运行时附加，线程退出时分离
+    
+    ~ThreadEnv() {
+        if (attached && generation == g_jvmGeneration.load()) {
+            vm->DetachCurrentThread();
+        }
+    }
+};
+
+thread_local ThreadEnv t_threadEnv;
+
+// 目录中的JAR文件（按路径排序）
+std::vector<std::string> ListJarFiles(const std::string& directory) {
+    std::error_code ec;
+    std::vector<std::string> jarPaths;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".jar") {
+            jarPaths.push_back(entry.path().string());
+        }
+    }
+    std::sort(jarPaths.begin(), jarPaths.end());
+    return jarPaths;
+}
+
+// FNV-1a
+uint64_t HashCombine(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// 委托多个依赖加载器的类加载器（类文件在运行时定义，findClass由本地方法实现）：
+//   public class DependencyClassLoader extends ClassLoader {
+//       private ClassLoader[] dependencies;
+//       public DependencyClassLoader(ClassLoader parent) { super(parent); }
+//       protected native Class<?> findClass(String name);
+//   }
+const char* const kDependencyClassLoaderClass = "com/mcu/bridge/DependencyClassLoader";
+
+const unsigned char kDependencyClassLoaderBytes[] = {
+    0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34,  // magic，版本52（Java 8）
+    0x00, 0x0E,                                      // 常量池：13项
+    0x01, 0x00, 0x24, 'c', 'o', 'm', '/', 'm', 'c', 'u', '/', 'b', 'r', 'i', 'd', 'g', 'e', '/',
+    'D', 'e', 'p', 'e', 'n', 'd', 'e', 'n', 'c', 'y', 'C', 'l', 'a', 's', 's', 'L', 'o', 'a', 'd', 'e', 'r',
+    0x07, 0x00, 0x01,                                // #2 Class #1
+    0x01, 0x00, 0x15, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/',
+    'C', 'l', 'a', 's', 's', 'L', 'o', 'a', 'd', 'e', 'r',
+    0x07, 0x00, 0x03,                                // #4 Class #3
+    0x01, 0x00, 0x06, '<', 'i', 'n', 'i', 't', '>',
+    0x01, 0x00, 0x1A, '(', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/',
+    'C', 'l', 'a', 's', 's', 'L', 'o', 'a', 'd', 'e', 'r', ';', ')', 'V',
+    0x0C, 0x00, 0x05, 0x00, 0x06,                    // #7 NameAndType <init>
+    0x0A, 0x00, 0x04, 0x00, 0x07,                    // #8 Methodref ClassLoader.<init>
+    0x01, 0x00, 0x04, 'C', 'o', 'd', 'e',
+    0x01, 0x00, 0x09, 'f', 'i', 'n', 'd', 'C', 'l', 'a', 's', 's',
+    0x01, 0x00, 0x25, '(', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'S', 't', 'r', 'i', 'n', 'g', ';', ')',
+    'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'C', 'l', 'a', 's', 's', ';',
+    0x01, 0x00, 0x0C, 'd', 'e', 'p', 'e', 'n', 'd', 'e', 'n', 'c', 'i', 'e', 's',
+    0x01, 0x00, 0x18, '[', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/',
+    'C', 'l', 'a', 's', 's', 'L', 'o', 'a', 'd', 'e', 'r', ';',
+    0x00, 0x21, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00,  // public super，this #2，super #4，无接口
+    0x00, 0x01,                                      // 字段：private ClassLoader[] dependencies
+    0x00, 0x02, 0x00, 0x0C, 0x00, 0x0D, 0x00, 0x00,
+    0x00, 0x02,                                      // 方法
+    0x00, 0x01, 0x00, 0x05, 0x00, 0x06, 0x00, 0x01,  // public <init>(ClassLoader)
+    0x00, 0x09, 0x00, 0x00, 0x00, 0x12, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x06,
+    0x2A, 0x2B, 0xB7, 0x00, 0x08, 0xB1,              // aload_0 aload_1 invokespecial #8 return
+    0x00, 0x00, 0x00, 0x00,
+    0x01, 0x04, 0x00, 0x0A, 0x00, 0x0B, 0x00, 0x00,  // protected native findClass(String)
+    0x00, 0x00,                                      // 无类属性
+};
+
+// 定义类时解析，之后只读
+struct DependencyLoaderIds {
+    jfieldID dependencies = nullptr;
+    jmethodID loadClass = nullptr;
+    jclass classNotFound = nullptr;  // 全局引用
+} g_dependencyLoader;
+
+// DependencyClassLoader.findClass：依次尝试各依赖的加载器，类由找到它的加载器定义
+jclass JNICALL DependencyLoaderFindClass(JNIEnv* env, jobject self, jstring name) {
+    jobjectArray loaders = static_cast<jobjectArray>(env->GetObjectField(self, g_dependencyLoader.dependencies));
+    jsize count = loaders ? env->GetArrayLength(loaders) : 0;
+    for (jsize i = 0; i < count; i++) {
+        jobject loader = env->GetObjectArrayElement(loaders, i);
+        jobject found = env->CallObjectMethod(loader, g_dependencyLoader.loadClass, name);
+        env->DeleteLocalRef(loader);
+        if (!env->ExceptionCheck()) {
+            if (found) {
+                env->DeleteLocalRef(loaders);
+                return static_cast<jclass>(found);
+            }
+            continue;
+        }
+        // 只有ClassNotFoundException才尝试下一个依赖，LinkageError等照常抛出
+        jthrowable error = env->ExceptionOccurred();
+        env->ExceptionClear();
+        bool notFound = env->IsInstanceOf(error, g_dependencyLoader.classNotFound);
+        if (!notFound) {
+            env->Throw(error);
+        }
+        env->DeleteLocalRef(error);
+        if (!notFound) {
+            env->DeleteLocalRef(loaders);
+            return nullptr;
+        }
+    }
+    if (loaders) {
+        env->DeleteLocalRef(loaders);
+    }
+    
+    const char* chars = env->GetStringUTFChars(name, nullptr);
+    env->ThrowNew(g_dependencyLoader.classNotFound, chars ? chars : "");
+    if (chars) {
+        env->ReleaseStringUTFChars(name, chars);
+    }
+    return nullptr;
+}
+
+// 在系统类加载器中定义DependencyClassLoader并注册findClass
+jclass DefineDependencyLoaderClass(JNIEnv* env) {
+    jclass classLoader = env->FindClass("java/lang/ClassLoader");
+    jclass classNotFound = env->FindClass("java/lang/ClassNotFoundException");
+    jmethodID getSystemLoader = classLoader
+        ? env->GetStaticMethodID(classLoader, "getSystemClassLoader", "()Ljava/lang/ClassLoader;") : nullptr;
+    jobject systemLoader = getSystemLoader ? env->CallStaticObjectMethod(classLoader, getSystemLoader) : nullptr;
+    jclass clazz = systemLoader && classNotFound && !env->ExceptionCheck()
+        ? env->DefineClass(kDependencyClassLoaderClass, systemLoader,
+                           reinterpret_cast<const jbyte*>(kDependencyClassLoaderBytes),
+                           sizeof(kDependencyClassLoaderBytes))
+        : nullptr;
+    
+    JNINativeMethod method;
+    method.name = const_cast<char*>("findClass");
+    method.signature = const_cast<char*>("(Ljava/lang/String;)Ljava/lang/Class;");
+    method.fnPtr = reinterpret_cast<void*>(DependencyLoaderFindClass);
+    if (clazz && env->RegisterNatives(clazz, &method, 1) == JNI_OK) {
+        g_dependencyLoader.dependencies = env->GetFieldID(clazz, "dependencies", "[Ljava/lang/ClassLoader;");
+        g_dependencyLoader.loadClass = env->GetMethodID(classLoader, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;");
+        if (!g_dependencyLoader.classNotFound) {
+            g_dependencyLoader.classNotFound = static_cast<jclass>(env->NewGlobalRef(classNotFound));
+        }
+    }
+    if (env->ExceptionCheck() || !g_dependencyLoader.dependencies || !g_dependencyLoader.loadClass) {
+        env->ExceptionClear();
+        if (clazz) {
+            env->DeleteLocalRef(clazz);
+        }
+        clazz = nullptr;
+    }
+    
+    for (jobject ref : {static_cast<jobject>(classLoader), static_cast<jobject>(classNotFound), systemLoader}) {
+        if (ref) {
+            env->DeleteLocalRef(ref);
+        }
+    }
+    return clazz;
+}
+
+} // namespace
+
 namespace mcu {
 namespace core {
 namespace mods {
@@ -23,6 +206,9 @@ JavaModRuntime::JavaModRuntime()
     , initialized_(false)
     , classPath_(".")
     , modsDirectory_("./mods")
+    , cdsMode_(CdsArchiveMode::DISABLED)
+    , methodCacheGeneration_(1)
+    , syncedEventTypes_(0)
 {
 }
 
@@ -40,6 +226,9 @@ bool JavaModRuntime::Initialize() {
         return false;
     }
     
+    // 模组处理函数的工作线程（按需附加到JVM）
+    workerPool_ = std::make_unique<common::ThreadPool>();
+    
     // 注册本地方法
     RegisterNativeMethods();
     
@@ -51,7 +240,15 @@ bool JavaModRuntime::Initialize() {
 }
 
 void JavaModRuntime::Shutdown() {
+    // 丢弃未分发的事件
+    eventQueue_.Flush(nullptr);
+    ReleaseEventBuffers();
+    ClearMethodCache();
+    ReleaseModLoaders();
+    // 工作线程退出时自动分离，必须在销毁JVM之前结束
+    workerPool_.reset();
     if (jvm_) {
+        g_jvmGeneration++;
         jvm_->DestroyJavaVM();
         jvm_ = nullptr;
         env_ = nullptr;
@@ -59,44 +256,71 @@ void JavaModRuntime::Shutdown() {
     initialized_ = false;
 }
 
+bool JavaModRuntime::LoadJvmProfile(const std::string& configPath) {
+    return mods::LoadJvmProfile(configPath, jvmProfile_);
+}
+
+uint64_t JavaModRuntime::ComputeModSetHash(const std::string& directory) {
+    std::vector<std::string> jarPaths = ListJarFiles(directory);
+    
+    // 同时预热JAR元数据缓存，随后的LoadAll直接命中
+    std::vector<JarMetadata> metadata = jarScanner_.ScanAll(jarPaths);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = HashCombine(hash, classPath_.data(), classPath_.size() + 1);
+    for (size_t i = 0; i < jarPaths.size(); i++) {
+        hash = HashCombine(hash, jarPaths[i].data(), jarPaths[i].size() + 1);
+        hash = HashCombine(hash, &metadata[i].hash, sizeof(metadata[i].hash));
+    }
+    return hash;
+}
+
 bool JavaModRuntime::CreateJVM() {
-    JavaVMInitArgs args;
-    JavaVMOption options[10];
-    int optionCount = 0;
-    
-    // 设置类路径
-    std::string classpath = "-Djava.class.path=" + classPath_;
-    options[optionCount].optionString = const_cast<char*>(classpath.c_str());
-    optionCount++;
-    
-    // 设置模组目录
-    std::string modsPath = "-Dminecraft.mods.dir=" + modsDirectory_;
-    options[optionCount].optionString = const_cast<char*>(modsPath.c_str());
-    optionCount++;
-    
-    // 设置JVM参数
-    options[optionCount].optionString = const_cast<char*>("-Xmx512M");
-    optionCount++;
-    
-    options[optionCount].optionString = const_cast<char*>("-Xms128M");
-    optionCount++;
-    
-    // 禁用严格模式
-    options[optionCount].optionString = const_cast<char*>("-Djava.compiler=NONE");
-    optionCount++;
-    
-    args.version = JNI_VERSION_1_8;
-    args.nOptions = optionCount;
-    args.options = options;
-    args.ignoreUnrecognized = JNI_FALSE;
+    // CDS归档按模组集合命名，模组变化后重新生成
+    uint64_t modSetHash = 0;
+    if (jvmProfile_.classDataSharing) {
+        ModProfileScope profile("java", "", "hash_mod_set");
+        modSetHash = ComputeModSetHash(modsDirectory_);
+    }
     
-    // 创建JVM
-    jint res = JNI_CreateJavaVM(&jvm_, reinterpret_cast<void**>(&env_), &args);
-    if (res != JNI_OK) {
-        return false;
+    JvmProfile profile = jvmProfile_;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        std::vector<std::string> optionStrings;
+        optionStrings.push_back("-Djava.class.path=" + classPath_);
+        optionStrings.push_back("-Dminecraft.mods.dir=" + modsDirectory_);
+        std::vector<std::string> profileOptions = BuildJvmOptions(profile, modSetHash, cdsMode_);
+        optionStrings.insert(optionStrings.end(), profileOptions.begin(), profileOptions.end());
+        
+        std::vector<JavaVMOption> options(optionStrings.size());
+        for (size_t i = 0; i < optionStrings.size(); i++) {
+            options[i].optionString = const_cast<char*>(optionStrings[i].c_str());
+            options[i].extraInfo = nullptr;
+        }
+        
+        JavaVMInitArgs args;
+        args.version = JNI_VERSION_1_8;
+        args.nOptions = static_cast<jint>(options.size());
+        args.options = options.data();
+        args.ignoreUnrecognized = JNI_FALSE;
+        
+        // 创建JVM
+        jint res = JNI_CreateJavaVM(&jvm_, reinterpret_cast<void**>(&env_), &args);
+        if (res == JNI_OK) {
+            jvmOptions_ = std::move(optionStrings);
+            g_jvmGeneration++;
+            return true;
+        }
+        
+        // 参数解析失败时JVM允许再次创建：JDK 13之前不识别动态归档参数，关闭CDS重试
+        if (cdsMode_ == CdsArchiveMode::DISABLED) {
+            break;
+        }
+        profile.classDataSharing = false;
     }
     
-    return true;
+    jvm_ = nullptr;
+    env_ = nullptr;
+    cdsMode_ = CdsArchiveMode::DISABLED;
+    return false;
 }
 
 bool JavaModRuntime::LoadMod(const std::string& jarPath) {
@@ -104,6 +328,8 @@ bool JavaModRuntime::LoadMod(const std::string& jarPath) {
         return false;
     }
     
+    // 模组ID在解析描述文件后才知道，先以文件名记录
+    ModProfileScope profile("java", fs::path(jarPath).stem().string(), "load");
     JavaModInfo info;
     if (!LoadModFromJar(jarPath, info)) {
         return false;
@@ -122,62 +348,95 @@ bool JavaModRuntime::LoadMod(const std::string& jarPath) {
         }
     }
     
-    // 添加到类路径
-    std::string cmd = "System.getProperty(\"java.class.path\") + \":\" + \"" + jarPath + "\"";
-    jstring newClasspath = env_->NewStringUTF(cmd.c_str());
+    if (!InitializeMod(info)) {
+        return false;
+    }
     
-    // 调用System.setProperty
-    jclass systemClass = env_->FindClass("java/lang/System");
-    jmethodID setPropertyMethod = env_->GetStaticMethodID(systemClass, "setProperty",
-                                                           "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;");
-    env_->CallStaticObjectMethod(systemClass, setPropertyMethod,
-                                 env_->NewStringUTF("java.class.path"),
-                                 newClasspath);
+    loadedMods_[info.modId] = info;
     
-    // 尝试加载模组主类
-    std::string mainClass = info.modId;
-    std::replace(mainClass.begin(), mainClass.end(), '.', '/');
+    // 触发模组加载事件
+    TriggerEvent("mod_loaded", &info);
     
-    // 尝试常见的模组主类命名模式
-    std::vector<std::string> possibleMainClasses = {
-        mainClass,
-        mainClass + "/ModMain",
-        mainClass + "/Main",
-        mainClass + "/Core",
-        "com/" + info.modId + "/ModMain",
-        "net/" + info.modId + "/ModMain",
-        "io/github/" + info.modId + "/ModMain"
+    return true;
+}
+
+bool JavaModRuntime::InitializeMod(const JavaModInfo& info) {
+    JNIEnv* env = GetEnv();
+    if (!env) {
+        return false;
+    }
+    
+    // 每个模组使用独立的类加载器（JVM启动后修改java.class.path无效），卸载时丢弃加载器即可回收其类
+    jobject loader;
+    {
+        ModProfileScope profile("java", info.modId, "class_loader");
+        loader = CreateModClassLoader(env, info);
+    }
+    if (!loader) {
+        return false;
+    }
+    
+    // 入口类在扫描JAR时已解析，不再逐个猜测类名
+    std::vector<jclass> entryClasses = ResolveEntryClasses(env, info, loader);
+    
+    ModClassLoader modLoader;
+    modLoader.loader = loader;
+    modLoader.entryClasses = std::move(entryClasses);
+    
+    // 初始化方法抛出异常视为加载失败，异常未清除前不能再调用其他JNI函数
+    auto threw = [env]() {
+        if (!env->ExceptionCheck()) {
+            return false;
+        }
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return true;
     };
     
     bool modLoaded = false;
-    for (const auto& className : possibleMainClasses) {
-        jclass modClass = env_->FindClass(className.c_str());
-        if (modClass) {
-            // 尝试调用初始化方法
-            jmethodID initMethod = env_->GetStaticMethodID(modClass, "init", "()V");
-            if (initMethod) {
-                env_->CallStaticVoidMethod(modClass, initMethod);
-                modLoaded = true;
+    bool initFailed = false;
+    for (jclass modClass : modLoader.entryClasses) {
+        // 尝试调用初始化方法
+        jmethodID initMethod = env->GetStaticMethodID(modClass, "init", "()V");
+        env->ExceptionClear();
+        if (initMethod) {
+            ModProfileScope profile("java", info.modId, "init");
+            env->CallStaticVoidMethod(modClass, initMethod);
+            initFailed = threw();
+            if (initFailed) {
                 break;
             }
-            
-            // 尝试调用onLoad方法
-            jmethodID loadMethod = env_->GetStaticMethodID(modClass, "onLoad", "()V");
-            if (loadMethod) {
-                env_->CallStaticVoidMethod(modClass, loadMethod);
-                modLoaded = true;
+            modLoaded = true;
+            continue;
+        }
+        
+        // 尝试调用onLoad方法
+        jmethodID loadMethod = env->GetStaticMethodID(modClass, "onLoad", "()V");
+        env->ExceptionClear();
+        if (loadMethod) {
+            ModProfileScope profile("java", info.modId, "onLoad");
+            env->CallStaticVoidMethod(modClass, loadMethod);
+            initFailed = threw();
+            if (initFailed) {
                 break;
             }
-            
-            // 尝试调用构造函数
-            jmethodID constructor = env_->GetMethodID(modClass, "<init>", "()V");
-            if (constructor) {
-                jobject modInstance = env_->NewObject(modClass, constructor);
-                if (modInstance) {
-                    modLoaded = true;
-                    env_->DeleteLocalRef(modInstance);
-                    break;
-                }
+            modLoaded = true;
+            continue;
+        }
+        
+        // 尝试调用构造函数
+        jmethodID constructor = env->GetMethodID(modClass, "<init>", "()V");
+        env->ExceptionClear();
+        if (constructor) {
+            ModProfileScope profile("java", info.modId, "constructor");
+            jobject modInstance = env->NewObject(modClass, constructor);
+            initFailed = threw();
+            if (initFailed) {
+                break;
+            }
+            if (modInstance) {
+                modLoaded = true;
+                env->DeleteLocalRef(modInstance);
             }
         }
     }
@@ -187,14 +446,284 @@ bool JavaModRuntime::LoadMod(const std::string& jarPath) {
         // 某些模组可能通过事件系统初始化
     }
     
-    loadedMods_[info.modId] = info;
-    
-    // 触发模组加载事件
-    TriggerEvent("mod_loaded", &info);
+    if (initFailed) {
+        CloseModClassLoader(env, modLoader);
+        return false;
+    }
     
+    // 保留加载器与入口类的全局引用，卸载时直接使用
+    ModClassLoader previous;
+    {
+        std::lock_guard<std::mutex> lock(modLoadersMutex_);
+        ModClassLoader& cached = modLoaders_[info.modId];
+        previous = std::move(cached);
+        cached = std::move(modLoader);
+    }
+    CloseModClassLoader(env, previous);
     return true;
 }
 
+jobject JavaModRuntime::CreateModClassLoader(JNIEnv* env, const JavaModInfo& info) {
+    JavaMethodHandle fileInit, toUri, toUrl, loaderInit, systemLoader;
+    if (!PrepareCall("java/io/File", "<init>", "(Ljava/lang/String;)V", false, fileInit) ||
+        !PrepareCall("java/io/File", "toURI", "()Ljava/net/URI;", false, toUri) ||
+        !PrepareCall("java/net/URI", "toURL", "()Ljava/net/URL;", false, toUrl) ||
+        !PrepareCall("java/net/URLClassLoader", "<init>", "([Ljava/net/URL;Ljava/lang/ClassLoader;)V", false, loaderInit) ||
+        !PrepareCall("java/lang/ClassLoader", "getSystemClassLoader", "()Ljava/lang/ClassLoader;", true, systemLoader)) {
+        return nullptr;
+    }
+    jclass urlClass;
+    {
+        std::lock_guard<std::mutex> lock(methodCacheMutex_);
+        urlClass = FindCachedClass(env, "java/net/URL");
+    }
+    if (!urlClass) {
+        return nullptr;
+    }
+    
+    // 父加载器：只有一个已加载依赖时为该依赖的加载器；多个时为依次委托各依赖加载器的DependencyClassLoader
+    // 本加载器只包含模组自己的JAR，依赖的类只由依赖自己的加载器定义一次
+    std::vector<jobject> dependencyLoaders;
+    {
+        std::lock_guard<std::mutex> lock(modLoadersMutex_);
+        for (const auto& dep : info.dependencies) {
+            auto it = modLoaders_.find(dep);
+            if (it != modLoaders_.end()) {
+                dependencyLoaders.push_back(env->NewLocalRef(it->second.loader));
+            }
+        }
+    }
+    jobject parent = nullptr;
+    if (dependencyLoaders.size() == 1) {
+        parent = dependencyLoaders[0];
+    } else {
+        parent = env->CallStaticObjectMethod(systemLoader.clazz, systemLoader.method);
+        if (!dependencyLoaders.empty()) {
+            jobject delegating = CreateDependencyClassLoader(env, parent, dependencyLoaders);
+            env->DeleteLocalRef(parent);
+            parent = delegating;
+        }
+        for (jobject dependencyLoader : dependencyLoaders) {
+            env->DeleteLocalRef(dependencyLoader);
+        }
+    }
+    if (!parent) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    
+    // new URLClassLoader(new URL[] {new File(jarPath).toURI().toURL()}, parent)
+    jobject loader = nullptr;
+    jstring path = env->NewStringUTF(info.jarPath.c_str());
+    jobject file = path ? env->NewObject(fileInit.clazz, fileInit.method, path) : nullptr;
+    jobject uri = file ? env->CallObjectMethod(file, toUri.method) : nullptr;
+    jobject url = uri ? env->CallObjectMethod(uri, toUrl.method) : nullptr;
+    jobjectArray urls = url ? env->NewObjectArray(1, urlClass, url) : nullptr;
+    jobject local = urls && !env->ExceptionCheck()
+        ? env->NewObject(loaderInit.clazz, loaderInit.method, urls, parent) : nullptr;
+    if (local && !env->ExceptionCheck()) {
+        loader = env->NewGlobalRef(local);
+    }
+    env->ExceptionClear();
+    
+    for (jobject ref : {local, static_cast<jobject>(urls), url, uri, file, static_cast<jobject>(path), parent}) {
+        if (ref) {
+            env->DeleteLocalRef(ref);
+        }
+    }
+    return loader;
+}
+
+jobject JavaModRuntime::CreateDependencyClassLoader(JNIEnv* env, jobject parent,
+                                                    const std::vector<jobject>& dependencyLoaders) {
+    jclass loaderClass;
+    jclass classLoaderClass;
+    {
+        std::lock_guard<std::mutex> lock(methodCacheMutex_);
+        loaderClass = FindDependencyLoaderClass(env);
+        classLoaderClass = FindCachedClass(env, "java/lang/ClassLoader");
+    }
+    if (!loaderClass || !classLoaderClass) {
+        return nullptr;
+    }
+    jmethodID init = env->GetMethodID(loaderClass, "<init>", "(Ljava/lang/ClassLoader;)V");
+    if (!init) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    
+    // new DependencyClassLoader(parent)，再写入dependencies字段
+    jobjectArray loaders = env->NewObjectArray(static_cast<jsize>(dependencyLoaders.size()), classLoaderClass, nullptr);
+    if (!loaders) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    for (size_t i = 0; i < dependencyLoaders.size(); i++) {
+        env->SetObjectArrayElement(loaders, static_cast<jsize>(i), dependencyLoaders[i]);
+    }
+    jobject loader = env->NewObject(loaderClass, init, parent);
+    if (loader && !env->ExceptionCheck()) {
+        env->SetObjectField(loader, g_dependencyLoader.dependencies, loaders);
+    } else {
+        env->ExceptionClear();
+        loader = nullptr;
+    }
+    env->DeleteLocalRef(loaders);
+    return loader;
+}
+
+jclass JavaModRuntime::FindDependencyLoaderClass(JNIEnv* env) {
+    // 调用方持有methodCacheMutex_
+    auto it = classCache_.find(kDependencyClassLoaderClass);
+    if (it != classCache_.end()) {
+        return it->second;
+    }
+    
+    // 清空方法缓存后，之前定义在系统类加载器中的类仍可找到
+    jclass local = env->FindClass(kDependencyClassLoaderClass);
+    if (!local) {
+        env->ExceptionClear();
+        local = DefineDependencyLoaderClass(env);
+        if (!local) {
+            return nullptr;
+        }
+    }
+    jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    classCache_[kDependencyClassLoaderClass] = global;
+    return global;
+}
+
+std::vector<jclass> JavaModRuntime::ResolveEntryClasses(JNIEnv* env, const JavaModInfo& info, jobject loader) {
+    std::vector<jclass> entryClasses;
+    JavaMethodHandle loadClass;
+    if (!PrepareCall("java/lang/ClassLoader", "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;", false, loadClass)) {
+        return entryClasses;
+    }
+    
+    // 通过模组的类加载器加载（ClassLoader.loadClass使用二进制名称）
+    auto addClass = [&](const std::string& className) {
+        ModProfileScope profile("java", info.modId, "load_class");
+        std::string binaryName = className;
+        std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+        jstring name = env->NewStringUTF(binaryName.c_str());
+        jobject modClass = env->CallObjectMethod(loader, loadClass.method, name);
+        env->DeleteLocalRef(name);
+        if (!modClass || env->ExceptionCheck()) {
+            // ClassNotFoundException
+            env->ExceptionClear();
+            return false;
+        }
+        entryClasses.push_back(static_cast<jclass>(env->NewGlobalRef(modClass)));
+        env->DeleteLocalRef(modClass);
+        return true;
+    };
+    
+    for (const auto& className : info.entryPoints) {
+        addClass(className);
+    }
+    if (!info.entryPoints.empty()) {
+        return entryClasses;
+    }
+    
+    // 描述文件与类文件中都没有入口信息（例如没有描述文件的JAR），按常见命名模式探测
+    std::string mainClass = info.modId;
+    std::replace(mainClass.begin(), mainClass.end(), '.', '/');
+    std::vector<std::string> possibleMainClasses = {
+        mainClass,
+        mainClass + "/ModMain",
+        mainClass + "/Main",
+        mainClass + "/Core",
+        "com/" + info.modId + "/ModMain",
+        "net/" + info.modId + "/ModMain",
+        "io/github/" + info.modId + "/ModMain"
+    };
+    for (const auto& className : possibleMainClasses) {
+        if (addClass(className)) {
+            break;
+        }
+    }
+    return entryClasses;
+}
+
+void JavaModRuntime::CloseModClassLoader(JNIEnv* env, ModClassLoader& modLoader) {
+    for (jclass modClass : modLoader.entryClasses) {
+        env->DeleteGlobalRef(modClass);
+    }
+    modLoader.entryClasses.clear();
+    if (!modLoader.loader) {
+        return;
+    }
+    
+    // 关闭JAR文件句柄；加载器不再可达后，其类与元空间由GC回收
+    JavaMethodHandle close;
+    if (PrepareCall("java/net/URLClassLoader", "close", "()V", false, close)) {
+        env->CallVoidMethod(modLoader.loader, close.method);
+        env->ExceptionClear();
+    }
+    env->DeleteGlobalRef(modLoader.loader);
+    modLoader.loader = nullptr;
+}
+
+void JavaModRuntime::ReleaseModLoaders() {
+    JNIEnv* env = GetEnv();
+    std::lock_guard<std::mutex> lock(modLoadersMutex_);
+    if (env) {
+        for (const auto& [modId, modLoader] : modLoaders_) {
+            for (jclass modClass : modLoader.entryClasses) {
+                env->DeleteGlobalRef(modClass);
+            }
+            env->DeleteGlobalRef(modLoader.loader);
+        }
+    }
+    modLoaders_.clear();
+}
+
+size_t JavaModRuntime::LoadAll(const std::string& directory, ModLoadReport* report) {
+    ModLoadReport localReport;
+    ModLoadReport& result = report ? *report : localReport;
+    result = ModLoadReport();
+    if (!initialized_ || !workerPool_) {
+        return 0;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    
+    // 并行读取元数据，建立依赖图（已加载的模组视为已满足的依赖）
+    std::vector<JavaModInfo> found;
+    ScanModsDirectory(directory, found);
+    std::unordered_map<std::string, JavaModInfo> mods;
+    ModDependencyGraph graph;
+    for (auto& info : found) {
+        if (loadedMods_.count(info.modId) || mods.count(info.modId)) {
+            continue;
+        }
+        std::vector<std::string> dependencies;
+        for (const auto& dep : info.dependencies) {
+            if (!loadedMods_.count(dep)) {
+                dependencies.push_back(dep);
+            }
+        }
+        graph.AddMod(info.modId, dependencies);
+        mods[info.modId] = std::move(info);
+    }
+    
+    // 逐层加载，同层模组互不依赖，在工作线程上并行初始化
+    return graph.LoadLevels(result, start,
+        [this, &mods](const std::string& modId) {
+            const JavaModInfo& info = mods.at(modId);
+            ModProfileScope profile("java", modId, "load");
+            return RunModTask([this, &info](JNIEnv*) { return InitializeMod(info); });
+        },
+        [this, &mods](const std::string& modId) {
+            JavaModInfo& info = mods.at(modId);
+            loadedMods_[modId] = info;
+            TriggerEvent("mod_loaded", &info);
+        },
+        [this](size_t count, const std::function<void(size_t)>& body) {
+            workerPool_->ParallelFor(0, count, body);
+        });
+}
+
 bool JavaModRuntime::UnloadMod(const std::string& modId) {
     auto it = loadedMods_.find(modId);
     if (it == loadedMods_.end()) {
@@ -213,46 +742,50 @@ bool JavaModRuntime::UnloadMod(const std::string& modId) {
         }
     }
     
+    JNIEnv* env = GetEnv();
+    if (!env) {
+        return false;
+    }
+    
     // 触发模组卸载事件
     TriggerEvent("mod_unloaded", &it->second);
     
-    // 尝试调用模组的卸载方法
-    std::string mainClass = it->second.modId;
-    std::replace(mainClass.begin(), mainClass.end(), '.', '/');
-    
-    // 尝试常见的模组主类命名模式
-    std::vector<std::string> possibleMainClasses = {
-        mainClass,
-        mainClass + "/ModMain",
-        mainClass + "/Main",
-        mainClass + "/Core",
-        "com/" + it->second.modId + "/ModMain",
-        "net/" + it->second.modId + "/ModMain",
-        "io/github/" + it->second.modId + "/ModMain"
-    };
+    // 在初始化时解析的入口类上调用卸载方法
+    ModClassLoader modLoader;
+    {
+        std::lock_guard<std::mutex> lock(modLoadersMutex_);
+        auto loader = modLoaders_.find(modId);
+        if (loader != modLoaders_.end()) {
+            modLoader = std::move(loader->second);
+            modLoaders_.erase(loader);
+        }
+    }
     
-    for (const auto& className : possibleMainClasses) {
-        jclass modClass = env_->FindClass(className.c_str());
-        if (modClass) {
-            // 尝试调用onUnload方法
-            jmethodID unloadMethod = env_->GetStaticMethodID(modClass, "onUnload", "()V");
-            if (unloadMethod) {
-                env_->CallStaticVoidMethod(modClass, unloadMethod);
-                break;
-            }
-            
+    for (jclass modClass : modLoader.entryClasses) {
+        // 尝试调用onUnload方法
+        jmethodID unloadMethod = env->GetStaticMethodID(modClass, "onUnload", "()V");
+        env->ExceptionClear();
+        if (unloadMethod) {
+            env->CallStaticVoidMethod(modClass, unloadMethod);
+        } else {
             // 尝试调用disable方法
-            jmethodID disableMethod = env_->GetStaticMethodID(modClass, "disable", "()V");
+            jmethodID disableMethod = env->GetStaticMethodID(modClass, "disable", "()V");
+            env->ExceptionClear();
             if (disableMethod) {
-                env_->CallStaticVoidMethod(modClass, disableMethod);
-                break;
+                env->CallStaticVoidMethod(modClass, disableMethod);
             }
         }
+        if (env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
     }
     
-    // 从类路径中移除
-    // 注意：JVM不支持动态移除类路径，这里只是逻辑上的移除
-    // 实际的类卸载需要依赖垃圾回收器
+    // 丢弃入口类与类加载器的全局引用
+    CloseModClassLoader(env, modLoader);
+    
+    // 缓存的全局引用会阻止模组的类被回收，卸载时整体清空，调用方需重新PrepareCall
+    ClearMethodCache();
     
     loadedMods_.erase(it);
     return true;
@@ -275,48 +808,31 @@ bool JavaModRuntime::LoadModFromJar(const std::string& jarPath, JavaModInfo& inf
 }
 
 bool JavaModRuntime::ParseModManifest(const std::string& jarPath, JavaModInfo& info) {
-    // 尝试从JAR文件中读取mod配置
-    // 可能的配置文件：mcmod.info（Forge旧版）、mods.toml（Forge新版）、fabric.mod.json（Fabric）
-    
-    // 使用系统命令解压JAR文件中的配置
-    std::string tempDir = "/tmp/mcu_mod_" + std::to_string(std::time(nullptr));
-    fs::create_directories(tempDir);
-    
-    // 尝试提取mcmod.info（Forge旧版）
-    std::string cmd = "cd " + tempDir + " && jar xf " + jarPath + " mcmod.info 2>/dev/null";
-    system(cmd.c_str());
+    ModProfileScope profile("java", fs::path(jarPath).stem().string(), "parse_manifest");
+    
+    // 在内存中读取JAR的中央目录与配置文件，结果按JAR哈希缓存
+    JarMetadata metadata;
+    jarScanner_.Scan(jarPath, metadata);
+    bool parsed = ParseModMetadata(jarPath, metadata, info);
+    profile.SetModId(info.modId);
+    return parsed;
+}
+
+bool JavaModRuntime::ParseModMetadata(const std::string& jarPath, const JarMetadata& metadata,
+                                      JavaModInfo& info) {
+    info.entryPoints = metadata.entryPoints;
     
-    if (fs::exists(tempDir + "/mcmod.info")) {
-        if (ParseMcmodInfo(tempDir + "/mcmod.info", info)) {
-            fs::remove_all(tempDir);
-            return true;
-        }
+    // 可能的配置文件：mcmod.info（Forge旧版）、mods.toml（Forge新版）、fabric.mod.json（Fabric）
+    if (!metadata.mcmodInfo.empty() && ParseMcmodInfo(metadata.mcmodInfo, info)) {
+        return true;
     }
-    
-    // 尝试提取mods.toml（Forge新版）
-    cmd = "cd " + tempDir + " && jar xf " + jarPath + " META-INF/mods.toml 2>/dev/null";
-    system(cmd.c_str());
-    
-    if (fs::exists(tempDir + "/META-INF/mods.toml")) {
-        if (ParseModsToml(tempDir + "/META-INF/mods.toml", info)) {
-            fs::remove_all(tempDir);
-            return true;
-        }
+    if (!metadata.modsToml.empty() && ParseModsToml(metadata.modsToml, info)) {
+        return true;
     }
-    
-    // 尝试提取fabric.mod.json（Fabric）
-    cmd = "cd " + tempDir + " && jar xf " + jarPath + " fabric.mod.json 2>/dev/null";
-    system(cmd.c_str());
-    
-    if (fs::exists(tempDir + "/fabric.mod.json")) {
-        if (ParseFabricModJson(tempDir + "/fabric.mod.json", info)) {
-            fs::remove_all(tempDir);
-            return true;
-        }
+    if (!metadata.fabricModJson.empty() && ParseFabricModJson(metadata.fabricModJson, info)) {
+        return true;
     }
     
-    fs::remove_all(tempDir);
-    
     // 如果没有找到配置文件，使用文件名作为模组ID
     fs::path path(jarPath);
     info.modId = path.stem().string();
@@ -327,168 +843,423 @@ bool JavaModRuntime::ParseModManifest(const std::string& jarPath, JavaModInfo& i
     return true;
 }
 
+size_t JavaModRuntime::ScanModsDirectory(const std::string& directory, std::vector<JavaModInfo>& mods) {
+    std::vector<std::string> jarPaths = ListJarFiles(directory);
+    
+    // 各JAR并行读取，解析描述文件很快，按顺序进行
+    std::vector<JarMetadata> metadata;
+    {
+        ModProfileScope profile("java", "", "scan_jars");
+        metadata = jarScanner_.ScanAll(jarPaths);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < jarPaths.size(); i++) {
+        if (!metadata[i].valid) {
+            continue;
+        }
+        JavaModInfo info;
+        info.jarPath = jarPaths[i];
+        ModProfileScope profile("java", fs::path(jarPaths[i]).stem().string(), "parse_manifest");
+        ParseModMetadata(jarPaths[i], metadata[i], info);
+        profile.SetModId(info.modId);
+        mods.push_back(std::move(info));
+        count++;
+    }
+    return count;
+}
+
 bool JavaModRuntime::CallJavaMethod(const std::string& className,
                                    const std::string& methodName,
                                    const std::string& signature,
                                    ...) {
-    if (!initialized_ || !env_) {
+    JavaMethodHandle handle;
+    if (!PrepareCall(className, methodName, signature, false, handle)) {
         return false;
     }
     
-    // 查找类
-    jclass clazz = env_->FindClass(className.c_str());
-    if (!clazz) {
-        return false;
-    }
-    
-    // 查找方法
-    jmethodID method = env_->GetMethodID(clazz, methodName.c_str(), signature.c_str());
-    if (!method) {
+    va_list args;
+    va_start(args, signature);
+    bool result = InvokeV(handle, nullptr, args);
+    va_end(args);
+    return result;
+}
+
+bool JavaModRuntime::CallStaticJavaMethod(const std::string& className,
+                                         const std::string& methodName,
+                                         const std::string& signature,
+                                         ...) {
+    JavaMethodHandle handle;
+    if (!PrepareCall(className, methodName, signature, true, handle)) {
         return false;
     }
     
-    // 准备参数
     va_list args;
     va_start(args, signature);
+    bool result = InvokeV(handle, nullptr, args);
+    va_end(args);
+    return result;
+}
+
+JNIEnv* JavaModRuntime::GetEnv() {
+    if (!jvm_) {
+        return nullptr;
+    }
     
-    // 根据返回类型调用不同类型的方法
-    char returnType = signature[signature.find(')') + 1];
+    ThreadEnv& current = t_threadEnv;
+    uint64_t generation = g_jvmGeneration.load();
+    if (current.env && current.generation == generation) {
+        return current.env;
+    }
     
-    switch (returnType) {
-        case 'V': // void
-            env_->CallVoidMethodV(nullptr, method, args);
-            break;
-        case 'Z': // boolean
-            env_->CallBooleanMethodV(nullptr, method, args);
-            break;
-        case 'B': // byte
-            env_->CallByteMethodV(nullptr, method, args);
-            break;
-        case 'C': // char
-            env_->CallCharMethodV(nullptr, method, args);
-            break;
-        case 'S': // short
-            env_->CallShortMethodV(nullptr, method, args);
-            break;
-        case 'I': // int
-            env_->CallIntMethodV(nullptr, method, args);
-            break;
-        case 'J': // long
-            env_->CallLongMethodV(nullptr, method, args);
-            break;
-        case 'F': // float
-            env_->CallFloatMethodV(nullptr, method, args);
-            break;
-        case 'D': // double
-            env_->CallDoubleMethodV(nullptr, method, args);
-            break;
-        case 'L': // object
-        case '[': // array
-            env_->CallObjectMethodV(nullptr, method, args);
-            break;
-        default:
-            va_end(args);
-            return false;
+    JNIEnv* env = nullptr;
+    bool attached = false;
+    jint res = jvm_->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8);
+    if (res == JNI_EDETACHED) {
+        // 以守护线程附加，不阻塞DestroyJavaVM
+        JavaVMAttachArgs args;
+        args.version = JNI_VERSION_1_8;
+        args.name = const_cast<char*>("mcu-mod-worker");
+        args.group = nullptr;
+        if (jvm_->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), &args) != JNI_OK) {
+            return nullptr;
+        }
+        attached = true;
+    } else if (res != JNI_OK) {
+        return nullptr;
     }
     
-    va_end(args);
+    current.vm = jvm_;
+    current.env = env;
+    current.generation = generation;
+    current.attached = attached;
+    return env;
+}
+
+std::future<bool> JavaModRuntime::SubmitModTask(ModTask task) {
+    if (!initialized_ || !workerPool_) {
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
     
-    // 检查异常
-    if (env_->ExceptionCheck()) {
-        env_->ExceptionDescribe();
-        env_->ExceptionClear();
+    return workerPool_->Submit([this, task = std::move(task)]() {
+        return RunModTask(task);
+    });
+}
+
+size_t JavaModRuntime::RunModTasks(const std::vector<ModTask>& tasks) {
+    if (!initialized_ || !workerPool_) {
+        return 0;
+    }
+    
+    std::atomic<size_t> succeeded(0);
+    workerPool_->ParallelFor(0, tasks.size(), [&](size_t i) {
+        if (RunModTask(tasks[i])) {
+            succeeded++;
+        }
+    });
+    return succeeded.load();
+}
+
+bool JavaModRuntime::RunModTask(const ModTask& task) {
+    JNIEnv* env = GetEnv();
+    if (!env || !task) {
         return false;
     }
     
-    return true;
+    // 工作线程不会返回Java，局部引用需要手动释放
+    if (env->PushLocalFrame(16) != JNI_OK) {
+        env->ExceptionClear();
+        return false;
+    }
+    bool result = task(env);
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        result = false;
+    }
+    env->PopLocalFrame(nullptr);
+    return result;
 }
 
-bool JavaModRuntime::CallStaticJavaMethod(const std::string& className,
-                                         const std::string& methodName,
-                                         const std::string& signature,
-                                         ...) {
-    if (!initialized_ || !env_) {
+bool JavaModRuntime::PrepareCall(const std::string& className,
+                                 const std::string& methodName,
+                                 const std::string& signature,
+                                 bool isStatic,
+                                 JavaMethodHandle& handle) {
+    JNIEnv* env = GetEnv();
+    if (!initialized_ || !env) {
         return false;
     }
     
+    size_t close = signature.find(')');
+    if (close == std::string::npos || close + 1 >= signature.size()) {
+        return false;
+    }
+    
+    std::string key;
+    key.reserve(className.size() + methodName.size() + signature.size() + 3);
+    key += isStatic ? 'S' : 'I';
+    key += className;
+    key += '.';
+    key += methodName;
+    key += signature;
+    
+    std::lock_guard<std::mutex> lock(methodCacheMutex_);
+    auto it = methodCache_.find(key);
+    if (it != methodCache_.end()) {
+        handle = it->second;
+        return true;
+    }
+    
     // 查找类
-    jclass clazz = env_->FindClass(className.c_str());
+    jclass clazz = FindCachedClass(env, className);
     if (!clazz) {
         return false;
     }
     
     // 查找方法
-    jmethodID method = env_->GetStaticMethodID(clazz, methodName.c_str(), signature.c_str());
+    jmethodID method = isStatic
+        ? env->GetStaticMethodID(clazz, methodName.c_str(), signature.c_str())
+        : env->GetMethodID(clazz, methodName.c_str(), signature.c_str());
     if (!method) {
+        // NoSuchMethodError
+        env->ExceptionClear();
         return false;
     }
     
-    // 准备参数
+    handle.clazz = clazz;
+    handle.method = method;
+    handle.returnType = signature[close + 1];
+    handle.isStatic = isStatic;
+    handle.generation = methodCacheGeneration_.load();
+    methodCache_[key] = handle;
+    return true;
+}
+
+bool JavaModRuntime::Invoke(const JavaMethodHandle& handle, jobject object, ...) {
     va_list args;
-    va_start(args, signature);
+    va_start(args, object);
+    bool result = InvokeV(handle, object, args);
+    va_end(args);
+    return result;
+}
+
+bool JavaModRuntime::InvokeV(const JavaMethodHandle& handle, jobject object, va_list args) {
+    if (!initialized_ || !handle.IsValid() || handle.generation != methodCacheGeneration_.load()) {
+        return false;
+    }
+    JNIEnv* env = GetEnv();
+    if (!env) {
+        return false;
+    }
     
-    // 根据返回类型调用不同类型的静态方法
-    char returnType = signature[signature.find(')') + 1];
+    jclass clazz = handle.clazz;
+    jmethodID method = handle.method;
     
-    switch (returnType) {
-        case 'V': // void
-            env_->CallStaticVoidMethodV(clazz, method, args);
-            break;
-        case 'Z': // boolean
-            env_->CallStaticBooleanMethodV(clazz, method, args);
-            break;
-        case 'B': // byte
-            env_->CallStaticByteMethodV(clazz, method, args);
-            break;
-        case 'C': // char
-            env_->CallStaticCharMethodV(clazz, method, args);
-            break;
-        case 'S': // short
-            env_->CallStaticShortMethodV(clazz, method, args);
-            break;
-        case 'I': // int
-            env_->CallStaticIntMethodV(clazz, method, args);
-            break;
-        case 'J': // long
-            env_->CallStaticLongMethodV(clazz, method, args);
-            break;
-        case 'F': // float
-            env_->CallStaticFloatMethodV(clazz, method, args);
-            break;
-        case 'D': // double
-            env_->CallStaticDoubleMethodV(clazz, method, args);
-            break;
-        case 'L': // object
-        case '[': // array
-            env_->CallStaticObjectMethodV(clazz, method, args);
-            break;
-        default:
-            va_end(args);
-            return false;
+    // 根据返回类型调用不同类型的方法
+    if (handle.isStatic) {
+        switch (handle.returnType) {
+            case 'V': // void
+                env->CallStaticVoidMethodV(clazz, method, args);
+                break;
+            case 'Z': // boolean
+                env->CallStaticBooleanMethodV(clazz, method, args);
+                break;
+            case 'B': // byte
+                env->CallStaticByteMethodV(clazz, method, args);
+                break;
+            case 'C': // char
+                env->CallStaticCharMethodV(clazz, method, args);
+                break;
+            case 'S': // short
+                env->CallStaticShortMethodV(clazz, method, args);
+                break;
+            case 'I': // int
+                env->CallStaticIntMethodV(clazz, method, args);
+                break;
+            case 'J': // long
+                env->CallStaticLongMethodV(clazz, method, args);
+                break;
+            case 'F': // float
+                env->CallStaticFloatMethodV(clazz, method, args);
+                break;
+            case 'D': // double
+                env->CallStaticDoubleMethodV(clazz, method, args);
+                break;
+            case 'L': // object
+            case '[': // array
+                env->DeleteLocalRef(env->CallStaticObjectMethodV(clazz, method, args));
+                break;
+            default:
+                return false;
+        }
+    } else {
+        switch (handle.returnType) {
+            case 'V': // void
+                env->CallVoidMethodV(object, method, args);
+                break;
+            case 'Z': // boolean
+                env->CallBooleanMethodV(object, method, args);
+                break;
+            case 'B': // byte
+                env->CallByteMethodV(object, method, args);
+                break;
+            case 'C': // char
+                env->CallCharMethodV(object, method, args);
+                break;
+            case 'S': // short
+                env->CallShortMethodV(object, method, args);
+                break;
+            case 'I': // int
+                env->CallIntMethodV(object, method, args);
+                break;
+            case 'J': // long
+                env->CallLongMethodV(object, method, args);
+                break;
+            case 'F': // float
+                env->CallFloatMethodV(object, method, args);
+                break;
+            case 'D': // double
+                env->CallDoubleMethodV(object, method, args);
+                break;
+            case 'L': // object
+            case '[': // array
+                env->DeleteLocalRef(env->CallObjectMethodV(object, method, args));
+                break;
+            default:
+                return false;
+        }
     }
     
-    va_end(args);
-    
     // 检查异常
-    if (env_->ExceptionCheck()) {
-        env_->ExceptionDescribe();
-        env_->ExceptionClear();
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
         return false;
     }
     
     return true;
 }
 
+jclass JavaModRuntime::FindCachedClass(JNIEnv* env, const std::string& className) {
+    // 调用方持有methodCacheMutex_
+    auto it = classCache_.find(className);
+    if (it != classCache_.end()) {
+        return it->second;
+    }
+    
+    jclass local = env->FindClass(className.c_str());
+    if (!local) {
+        // NoClassDefFoundError，模组的类只能通过其类加载器找到
+        env->ExceptionClear();
+        local = FindModClass(env, className);
+        if (!local) {
+            return nullptr;
+        }
+    }
+    
+    // 局部引用在本地帧结束后失效，缓存全局引用
+    jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    classCache_[className] = global;
+    return global;
+}
+
+jclass JavaModRuntime::FindModClass(JNIEnv* env, const std::string& className) {
+    // 调用方持有methodCacheMutex_，不能经由PrepareCall
+    jclass loaderClass = FindCachedClass(env, "java/lang/ClassLoader");
+    jmethodID loadClass = loaderClass
+        ? env->GetMethodID(loaderClass, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;") : nullptr;
+    if (!loadClass) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    
+    std::string binaryName = className;
+    std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+    jstring name = env->NewStringUTF(binaryName.c_str());
+    jclass result = nullptr;
+    std::lock_guard<std::mutex> lock(modLoadersMutex_);
+    for (const auto& [modId, modLoader] : modLoaders_) {
+        jobject modClass = env->CallObjectMethod(modLoader.loader, loadClass, name);
+        if (modClass && !env->ExceptionCheck()) {
+            result = static_cast<jclass>(modClass);
+            break;
+        }
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(name);
+    return result;
+}
+
+size_t JavaModRuntime::GetModClassLoaderCount() const {
+    std::lock_guard<std::mutex> lock(modLoadersMutex_);
+    return modLoaders_.size();
+}
+
+jclass JavaModRuntime::LoadModClass(const std::string& modId, const std::string& className) {
+    JNIEnv* env = GetEnv();
+    JavaMethodHandle loadClass;
+    if (!env || !PrepareCall("java/lang/ClassLoader", "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;", false, loadClass)) {
+        return nullptr;
+    }
+    jobject loader = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(modLoadersMutex_);
+        auto it = modLoaders_.find(modId);
+        if (it != modLoaders_.end()) {
+            loader = env->NewLocalRef(it->second.loader);
+        }
+    }
+    if (!loader) {
+        return nullptr;
+    }
+    
+    std::string binaryName = className;
+    std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+    jstring name = env->NewStringUTF(binaryName.c_str());
+    jobject result = name ? env->CallObjectMethod(loader, loadClass.method, name) : nullptr;
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        result = nullptr;
+    }
+    if (name) {
+        env->DeleteLocalRef(name);
+    }
+    env->DeleteLocalRef(loader);
+    return static_cast<jclass>(result);
+}
+
+void JavaModRuntime::ClearMethodCache() {
+    std::lock_guard<std::mutex> lock(methodCacheMutex_);
+    JNIEnv* env = GetEnv();
+    if (env) {
+        for (const auto& [name, clazz] : classCache_) {
+            env->DeleteGlobalRef(clazz);
+        }
+    }
+    classCache_.clear();
+    methodCache_.clear();
+    methodCacheGeneration_++;
+}
+
+size_t JavaModRuntime::GetCachedMethodCount() const {
+    std::lock_guard<std::mutex> lock(methodCacheMutex_);
+    return methodCache_.size();
+}
+
 bool JavaModRuntime::RegisterNativeMethod(const std::string& className,
                                          const std::string& methodName,
                                          const std::string& signature,
                                          void* func) {
-    if (!initialized_ || !env_) {
+    JNIEnv* env = GetEnv();
+    if (!initialized_ || !env) {
         return false;
     }
     
     // 查找类
-    jclass clazz = env_->FindClass(className.c_str());
+    jclass clazz = env->FindClass(className.c_str());
     if (!clazz) {
         return false;
     }
@@ -499,7 +1270,7 @@ bool JavaModRuntime::RegisterNativeMethod(const std::string& className,
     method.signature = const_cast<char*>(signature.c_str());
     method.fnPtr = func;
     
-    jint res = env_->RegisterNatives(clazz, &method, 1);
+    jint res = env->RegisterNatives(clazz, &method, 1);
     return res == JNI_OK;
 }
 
@@ -552,17 +1323,93 @@ void JavaModRuntime::TriggerEvent(const std::string& event, void* data) {
     }
 }
 
-bool JavaModRuntime::ParseMcmodInfo(const std::string& filePath, JavaModInfo& info) {
-    // 解析Forge旧版mcmod.info格式（JSON格式）
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;
+uint16_t JavaModRuntime::RegisterBatchedEvent(const std::string& event) {
+    return eventQueue_.RegisterEventType(event);
+}
+
+bool JavaModRuntime::QueueEvent(uint16_t type, const void* payload, uint32_t size) {
+    if (eventQueue_.Push(type, payload, size)) {
+        return true;
     }
     
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
+    // 缓冲区已满，提前分发后重试
+    FlushEvents();
+    return eventQueue_.Push(type, payload, size);
+}
+
+size_t JavaModRuntime::FlushEvents() {
+    JavaMethodHandle dispatch;
+    bool ready = PrepareCall(kEventDispatcherClass, "dispatchBatch", "(Ljava/nio/ByteBuffer;II)V", true, dispatch);
+    if (ready) {
+        SyncEventTypes();
+    }
     
+    return eventQueue_.Flush([&](const EventBatchQueue::Batch& batch) {
+        if (!ready) {
+            return;
+        }
+        jobject buffer = GetEventBuffer(batch.slab);
+        if (buffer) {
+            Invoke(dispatch, nullptr, buffer, static_cast<jint>(batch.bytes), static_cast<jint>(batch.count));
+        }
+    });
+}
+
+jobject JavaModRuntime::GetEventBuffer(size_t slab) {
+    JNIEnv* env = GetEnv();
+    if (!env) {
+        return nullptr;
+    }
+    if (eventBuffers_.size() != eventQueue_.GetSlabCount()) {
+        eventBuffers_.assign(eventQueue_.GetSlabCount(), nullptr);
+    }
+    if (!eventBuffers_[slab]) {
+        // 缓冲区地址固定，DirectByteBuffer只创建一次
+        jobject local = env->NewDirectByteBuffer(eventQueue_.GetSlabData(slab),
+                                                  static_cast<jlong>(eventQueue_.GetSlabSize()));
+        if (!local) {
+            env->ExceptionClear();
+            return nullptr;
+        }
+        eventBuffers_[slab] = env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+    }
+    return eventBuffers_[slab];
+}
+
+void JavaModRuntime::SyncEventTypes() {
+    std::vector<std::string> types = eventQueue_.GetEventTypes();
+    if (syncedEventTypes_ >= types.size()) {
+        return;
+    }
+    
+    JNIEnv* env = GetEnv();
+    JavaMethodHandle registerType;
+    if (!PrepareCall(kEventDispatcherClass, "registerEventType", "(ILjava/lang/String;)V", true, registerType)) {
+        return;
+    }
+    for (; syncedEventTypes_ < types.size(); syncedEventTypes_++) {
+        jstring name = env->NewStringUTF(types[syncedEventTypes_].c_str());
+        Invoke(registerType, nullptr, static_cast<jint>(syncedEventTypes_), name);
+        env->DeleteLocalRef(name);
+    }
+}
+
+void JavaModRuntime::ReleaseEventBuffers() {
+    JNIEnv* env = GetEnv();
+    if (env) {
+        for (jobject buffer : eventBuffers_) {
+            if (buffer) {
+                env->DeleteGlobalRef(buffer);
+            }
+        }
+    }
+    eventBuffers_.clear();
+    syncedEventTypes_ = 0;
+}
+
+bool JavaModRuntime::ParseMcmodInfo(const std::string& content, JavaModInfo& info) {
+    // 解析Forge旧版mcmod.info格式（JSON格式）
     // 简单的JSON解析（实际项目应使用JSON库）
     // 查找modid
     size_t pos = content.find("\"modid\"");
@@ -612,33 +1459,115 @@ bool JavaModRuntime::ParseMcmodInfo(const std::string& filePath, JavaModInfo& in
         }
     }
     
+    // 查找依赖（requiredMods或dependencies，形如"modid@[1.0,)"）
+    for (const char* key : {"\"requiredMods\"", "\"dependencies\""}) {
+        pos = content.find(key);
+        if (pos == std::string::npos) {
+            continue;
+        }
+        pos = content.find("[", pos);
+        size_t end = pos != std::string::npos ? content.find("]", pos) : std::string::npos;
+        if (end == std::string::npos) {
+            continue;
+        }
+        std::string deps = content.substr(pos + 1, end - pos - 1);
+        size_t start = 0;
+        while (true) {
+            size_t quoteStart = deps.find("\"", start);
+            if (quoteStart == std::string::npos) break;
+            
+            size_t quoteEnd = deps.find("\"", quoteStart + 1);
+            if (quoteEnd == std::string::npos) break;
+            
+            std::string dep = deps.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
+            AddModDependency(dep.substr(0, dep.find('@')), info);
+            
+            start = quoteEnd + 1;
+        }
+    }
+    
     return !info.modId.empty();
 }
 
-bool JavaModRuntime::ParseModsToml(const std::string& filePath, JavaModInfo& info) {
-    // 解析Forge新版mods.toml格式（TOML格式）
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;
+void JavaModRuntime::AddModDependency(const std::string& dependency, JavaModInfo& info) {
+    // 加载器与游戏本身不是模组
+    static const char* const kPlatformIds[] = {
+        "minecraft", "forge", "neoforge", "fml", "java", "fabricloader", "fabric", "fabric-api", "quilt_loader"
+    };
+    if (dependency.empty() || dependency == info.modId ||
+        std::find(std::begin(kPlatformIds), std::end(kPlatformIds), dependency) != std::end(kPlatformIds) ||
+        std::find(info.dependencies.begin(), info.dependencies.end(), dependency) != info.dependencies.end()) {
+        return;
     }
+    info.dependencies.push_back(dependency);
+}
+
+bool JavaModRuntime::ParseModsToml(const std::string& content, JavaModInfo& info) {
+    // 解析Forge新版mods.toml格式（TOML格式）
+    std::istringstream file(content);
     
     std::string line;
     bool inModSection = false;
+    bool inDependencySection = false;
+    bool modParsed = false;
+    std::string dependency;
+    bool mandatory = true;
+    auto flushDependency = [&]() {
+        if (!dependency.empty() && mandatory) {
+            AddModDependency(dependency, info);
+        }
+        dependency.clear();
+        mandatory = true;
+    };
     
     while (std::getline(file, line)) {
-        // 检查是否进入[[mods]]部分
+        // 检查是否进入[[mods]]部分（只解析第一个模组）
         if (line.find("[[mods]]") != std::string::npos) {
-            inModSection = true;
+            flushDependency();
+            inModSection = !modParsed;
+            inDependencySection = false;
+            modParsed = true;
             continue;
         }
         
-        if (!inModSection) {
+        // [[dependencies.<modId>]]：modId与mandatory（新版为type="required"）
+        if (line.find("[[dependencies") != std::string::npos) {
+            flushDependency();
+            inModSection = false;
+            inDependencySection = true;
             continue;
         }
         
-        // 检查是否离开mods部分
-        if (line.find("[[") != std::string::npos && line.find("[[mods]]") == std::string::npos) {
-            break;
+        if (line.find("[") != std::string::npos && line.find("=") == std::string::npos) {
+            flushDependency();
+            inModSection = false;
+            inDependencySection = false;
+            continue;
+        }
+        
+        if (inDependencySection) {
+            size_t pos = line.find("=");
+            if (pos == std::string::npos) {
+                continue;
+            }
+            std::string key = line.substr(0, pos);
+            std::string value = line.substr(pos + 1);
+            if (key.find("modId") != std::string::npos) {
+                size_t start = value.find("\"");
+                size_t end = start != std::string::npos ? value.find("\"", start + 1) : std::string::npos;
+                if (end != std::string::npos) {
+                    dependency = value.substr(start + 1, end - start - 1);
+                }
+            } else if (key.find("mandatory") != std::string::npos) {
+                mandatory = value.find("false") == std::string::npos;
+            } else if (key.find("type") != std::string::npos) {
+                mandatory = value.find("required") != std::string::npos;
+            }
+            continue;
+        }
+        
+        if (!inModSection) {
+            continue;
         }
         
         // 解析modId
@@ -702,22 +1631,13 @@ bool JavaModRuntime::ParseModsToml(const std::string& filePath, JavaModInfo& inf
             }
         }
     }
+    flushDependency();
     
-    file.close();
     return !info.modId.empty();
 }
 
-bool JavaModRuntime::ParseFabricModJson(const std::string& filePath, JavaModInfo& info) {
+bool JavaModRuntime::ParseFabricModJson(const std::string& content, JavaModInfo& info) {
     // 解析Fabric fabric.mod.json格式（JSON格式）
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
-    
     // 查找id
     size_t pos = content.find("\"id\"");
     if (pos != std::string::npos) {
@@ -766,6 +1686,35 @@ bool JavaModRuntime::ParseFabricModJson(const std::string& filePath, JavaModInfo
         }
     }
     
+    
+    // 查找depends（对象的键为依赖的模组ID）
+    pos = content.find("\"depends\"");
+    if (pos != std::string::npos) {
+        pos = content.find("{", pos);
+        size_t end = pos != std::string::npos ? content.find("}", pos) : std::string::npos;
+        if (end != std::string::npos) {
+            std::string deps = content.substr(pos + 1, end - pos - 1);
+            size_t start = 0;
+            while (true) {
+                size_t quoteStart = deps.find("\"", start);
+                if (quoteStart == std::string::npos) break;
+                
+                size_t quoteEnd = deps.find("\"", quoteStart + 1);
+                if (quoteEnd == std::string::npos) break;
+                AddModDependency(deps.substr(quoteStart + 1, quoteEnd - quoteStart - 1), info);
+                
+                // 跳过值（字符串或数组）
+                size_t next = deps.find_first_of(",", quoteEnd + 1);
+                size_t bracket = deps.find("[", quoteEnd + 1);
+                if (bracket != std::string::npos && (next == std::string::npos || bracket < next)) {
+                    size_t close = deps.find("]", bracket);
+                    next = close != std::string::npos ? deps.find(",", close) : std::string::npos;
+                }
+                if (next == std::string::npos) break;
+                start = next + 1;
+            }
+        }
+    }
     return !info.modId.empty();
 }
 
@@ -792,6 +1741,27 @@ int BedrockAPI::GetBlock(int x, int y, int z) {
     return 0;
 }
 
+void BedrockAPI::GetBlocks(int x, int y, int z, int sizeX, int sizeY, int sizeZ, int32_t* blockIds) {
+    // 引擎侧仍逐个方块访问，批量接口节省的是每个方块一次的JNI调用
+    for (int dy = 0; dy < sizeY; dy++) {
+        for (int dz = 0; dz < sizeZ; dz++) {
+            for (int dx = 0; dx < sizeX; dx++) {
+                *blockIds++ = GetBlock(x + dx, y + dy, z + dz);
+            }
+        }
+    }
+}
+
+void BedrockAPI::SetBlocks(int x, int y, int z, int sizeX, int sizeY, int sizeZ, const int32_t* blockIds) {
+    for (int dy = 0; dy < sizeY; dy++) {
+        for (int dz = 0; dz < sizeZ; dz++) {
+            for (int dx = 0; dx < sizeX; dx++) {
+                SetBlock(x + dx, y + dy, z + dz, *blockIds++);
+            }
+        }
+    }
+}
+
 void BedrockAPI::GetPlayerPosition(const char* playerId, float* x, float* y, float* z) {
     // TODO: 调用基岩版内部函数获取玩家位置
     *x = 0.0f;
@@ -837,6 +1807,83 @@ jint Java_GetBlock(JNIEnv* env, jclass clazz, jint x, jint y, jint z) {
     return BedrockAPI::GetBlock(x, y, z);
 }
 
+namespace {
+
+// 区域方块数，尺寸非正或超过int范围时返回-1
+int64_t RegionVolume(jint sizeX, jint sizeY, jint sizeZ) {
+    if (sizeX <= 0 || sizeY <= 0 || sizeZ <= 0) {
+        return -1;
+    }
+    int64_t volume = static_cast<int64_t>(sizeX) * sizeY;
+    if (volume > INT32_MAX || volume * sizeZ > INT32_MAX) {
+        return -1;
+    }
+    return volume * sizeZ;
+}
+
+// 固定Java数组后直接交给BedrockAPI（临界区内不能调用其他JNI函数）
+jint AccessBlockArray(JNIEnv* env, jint x, jint y, jint z, jint sizeX, jint sizeY, jint sizeZ,
+                      jintArray blocks, bool write) {
+    int64_t volume = RegionVolume(sizeX, sizeY, sizeZ);
+    if (volume < 0 || !blocks || env->GetArrayLength(blocks) < volume) {
+        return -1;
+    }
+    auto* data = static_cast<int32_t*>(env->GetPrimitiveArrayCritical(blocks, nullptr));
+    if (!data) {
+        return -1;
+    }
+    if (write) {
+        BedrockAPI::SetBlocks(x, y, z, sizeX, sizeY, sizeZ, data);
+    } else {
+        BedrockAPI::GetBlocks(x, y, z, sizeX, sizeY, sizeZ, data);
+    }
+    // 写入世界时数组未修改，无需复制回去
+    env->ReleasePrimitiveArrayCritical(blocks, data, write ? JNI_ABORT : 0);
+    return static_cast<jint>(volume);
+}
+
+jint AccessBlockBuffer(JNIEnv* env, jint x, jint y, jint z, jint sizeX, jint sizeY, jint sizeZ,
+                       jobject buffer, bool write) {
+    int64_t volume = RegionVolume(sizeX, sizeY, sizeZ);
+    if (volume < 0 || !buffer) {
+        return -1;
+    }
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacity < volume * static_cast<jlong>(sizeof(int32_t)) ||
+        reinterpret_cast<uintptr_t>(address) % alignof(int32_t) != 0) {
+        return -1;
+    }
+    if (write) {
+        BedrockAPI::SetBlocks(x, y, z, sizeX, sizeY, sizeZ, static_cast<const int32_t*>(address));
+    } else {
+        BedrockAPI::GetBlocks(x, y, z, sizeX, sizeY, sizeZ, static_cast<int32_t*>(address));
+    }
+    return static_cast<jint>(volume);
+}
+
+} // namespace
+
+jint Java_GetBlocks(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                    jint sizeX, jint sizeY, jint sizeZ, jintArray blocks) {
+    return AccessBlockArray(env, x, y, z, sizeX, sizeY, sizeZ, blocks, false);
+}
+
+jint Java_SetBlocks(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                    jint sizeX, jint sizeY, jint sizeZ, jintArray blocks) {
+    return AccessBlockArray(env, x, y, z, sizeX, sizeY, sizeZ, blocks, true);
+}
+
+jint Java_GetBlocksBuffer(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                          jint sizeX, jint sizeY, jint sizeZ, jobject buffer) {
+    return AccessBlockBuffer(env, x, y, z, sizeX, sizeY, sizeZ, buffer, false);
+}
+
+jint Java_SetBlocksBuffer(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                          jint sizeX, jint sizeY, jint sizeZ, jobject buffer) {
+    return AccessBlockBuffer(env, x, y, z, sizeX, sizeY, sizeZ, buffer, true);
+}
+
 void Java_GetPlayerPosition(JNIEnv* env, jclass clazz, jstring playerId, jfloatArray pos) {
     const char* playerIdStr = env->GetStringUTFChars(playerId, nullptr);
     
@@ -889,6 +1936,14 @@ void RegisterAllBridges(JavaModRuntime* runtime) {
                                   reinterpret_cast<void*>(Java_SetBlock));
     runtime->RegisterNativeMethod("net/minecraft/world/World", "getBlock", "(III)I",
                                   reinterpret_cast<void*>(Java_GetBlock));
+    runtime->RegisterNativeMethod("net/minecraft/world/World", "getBlocks", "(IIIIII[I)I",
+                                  reinterpret_cast<void*>(Java_GetBlocks));
+    runtime->RegisterNativeMethod("net/minecraft/world/World", "setBlocks", "(IIIIII[I)I",
+                                  reinterpret_cast<void*>(Java_SetBlocks));
+    runtime->RegisterNativeMethod("net/minecraft/world/World", "getBlocks", "(IIIIIILjava/nio/ByteBuffer;)I",
+                                  reinterpret_cast<void*>(Java_GetBlocksBuffer));
+    runtime->RegisterNativeMethod("net/minecraft/world/World", "setBlocks", "(IIIIIILjava/nio/ByteBuffer;)I",
+                                  reinterpret_cast<void*>(Java_SetBlocksBuffer));
     
     // 注册玩家相关方法
     runtime->RegisterNativeMethod("net/minecraft/entity/player/PlayerEntity", "getPosition",
@@ -5,13 +5,26 @@
 
 #pragma once
 #include <jni.h>
+#include "event_batch.h"
+#include "jar_scanner.h"
+#include "jvm_profile.h"
+#include "mod_dependency_graph.h"
+#include <cstdarg>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 namespace mcu {
+namespace common {
+class ThreadPool;
+}
+
 namespace core {
 namespace mods {
 
@@ -24,6 +37,18 @@ struct ApiMapping {
     std::string description;    // 描述
 };
 
+// 预先解析的Java方法（类为全局引用，由运行时持有）
+// 热点调用方保存句柄并通过Invoke调用，跳过类名与方法名查找
+struct JavaMethodHandle {
+    jclass clazz = nullptr;
+    jmethodID method = nullptr;
+    char returnType = 0;        // 签名中的返回类型字符
+    bool isStatic = false;
+    uint64_t generation = 0;    // 方法缓存代数，卸载模组后旧句柄失效
+
+    bool IsValid() const { return method != nullptr; }
+};
+
 // Java模组信息
 struct JavaModInfo {
     std::string modId;          // 模组ID
@@ -32,6 +57,7 @@ struct JavaModInfo {
     std::string description;    // 描述
     std::string jarPath;        // JAR文件路径
     std::vector<std::string> dependencies; // 依赖项
+    std::vector<std::string> entryPoints;  // 入口类的内部名称（来自JarMetadata）
 };
 
 // Java模组运行时
@@ -40,6 +66,21 @@ public:
     JavaModRuntime();
     ~JavaModRuntime();
 
+    // JVM启动配置（堆大小、垃圾收集器、CDS归档），在Initialize之前设置
+    void SetJvmProfile(const JvmProfile& profile) { jvmProfile_ = profile; }
+    const JvmProfile& GetJvmProfile() const { return jvmProfile_; }
+    bool LoadJvmProfile(const std::string& configPath);
+    
+    // 模组目录（-Dminecraft.mods.dir，也是CDS归档对应的模组集合），在Initialize之前设置
+    void SetModsDirectory(const std::string& directory) { modsDirectory_ = directory; }
+    
+    // 模组集合哈希：目录中各JAR的路径与内容哈希及类路径，模组增删或更新时改变
+    uint64_t ComputeModSetHash(const std::string& directory);
+    
+    // 本次启动JVM使用的参数与CDS归档方式
+    const std::vector<std::string>& GetJvmOptions() const { return jvmOptions_; }
+    CdsArchiveMode GetCdsArchiveMode() const { return cdsMode_; }
+    
     // 初始化JVM
     bool Initialize();
     
@@ -52,6 +93,16 @@ public:
     // 卸载模组
     bool UnloadMod(const std::string& modId);
     
+    // 加载目录中的所有模组：按依赖关系拓扑分层，同层模组在工作线程上并行初始化
+    // 依赖环上的模组与依赖加载失败的模组被跳过，report给出各模组耗时与关键路径，返回加载数
+    size_t LoadAll(const std::string& directory, ModLoadReport* report = nullptr);
+    
+    // 并行扫描目录中的JAR并解析模组信息（不加载模组，不需要JVM），返回模组数
+    size_t ScanModsDirectory(const std::string& directory, std::vector<JavaModInfo>& mods);
+    
+    // JAR元数据扫描器（可加载/保存缓存，使热启动无需解压）
+    JarScanner& GetJarScanner() { return jarScanner_; }
+    
     // 调用Java方法
     bool CallJavaMethod(const std::string& className,
                        const std::string& methodName,
@@ -64,6 +115,41 @@ public:
                              const std::string& signature,
                              ...);
     
+    // 获取当前线程的JNIEnv，未附加的线程自动附加（线程退出时自动分离）
+    // 以下调用接口均可在任意线程使用；加载与卸载模组仍应在同一线程进行
+    JNIEnv* GetEnv();
+    
+    // 在工作线程池上运行模组处理函数，工作线程首次使用时附加到JVM
+    // 处理函数在独立的局部引用帧中执行，返回false或留下Java异常视为失败
+    using ModTask = std::function<bool(JNIEnv* env)>;
+    std::future<bool> SubmitModTask(ModTask task);
+    
+    // 并行运行一组相互独立的处理函数，阻塞直到全部完成，返回成功数
+    size_t RunModTasks(const std::vector<ModTask>& tasks);
+    
+    // 解析方法并缓存（键为类名、方法名、签名），返回可重复使用的句柄
+    bool PrepareCall(const std::string& className,
+                     const std::string& methodName,
+                     const std::string& signature,
+                     bool isStatic,
+                     JavaMethodHandle& handle);
+    
+    // 通过句柄调用，object为实例方法的接收者（静态方法忽略）
+    // 句柄已失效（模组卸载后）返回false，需要重新PrepareCall
+    bool Invoke(const JavaMethodHandle& handle, jobject object, ...);
+    
+    // 清空类与方法缓存（释放全局引用），之前的句柄全部失效
+    void ClearMethodCache();
+    
+    // 已缓存的方法数
+    size_t GetCachedMethodCount() const;
+    
+    // 存活的模组类加载器数（每个已加载模组一个，卸载后释放）
+    size_t GetModClassLoaderCount() const;
+    
+    // 通过模组的类加载器加载类（className为内部名称），返回局部引用，找不到时返回nullptr
+    jclass LoadModClass(const std::string& modId, const std::string& className);
+    
     // 注册本地方法
     bool RegisterNativeMethod(const std::string& className,
                              const std::string& methodName,
@@ -88,10 +174,19 @@ public:
     
     // 触发事件
     void TriggerEvent(const std::string& event, void* data);
+    
+    // 批量事件：高频事件（如方块更新）先写入缓冲区，每tick调用FlushEvents
+    // 整批交给Java侧com/mcu/bridge/EventDispatcher分发，每批只跨越一次JNI
+    uint16_t RegisterBatchedEvent(const std::string& event);
+    bool QueueEvent(uint16_t type, const void* payload, uint32_t size);
+    
+    // 分发所有待处理事件，返回事件数（Java侧分发器不可用时事件被丢弃）
+    size_t FlushEvents();
 
 private:
     JavaVM* jvm_;
-    JNIEnv* env_;
+    JNIEnv* env_;               // 创建JVM的线程的JNIEnv，其他线程通过GetEnv获取
+    std::unique_ptr<common::ThreadPool> workerPool_;
     bool initialized_;
     
     std::unordered_map<std::string, JavaModInfo> loadedMods_;
@@ -100,16 +195,56 @@ private:
     
     std::string classPath_;
     std::string modsDirectory_;
+    JarScanner jarScanner_;
+    
+    JvmProfile jvmProfile_;
+    std::vector<std::string> jvmOptions_;
+    CdsArchiveMode cdsMode_;
+    
+    // 类与方法缓存：FindClass/GetMethodID只在首次调用时执行
+    mutable std::mutex methodCacheMutex_;
+    std::unordered_map<std::string, jclass> classCache_;
+    std::unordered_map<std::string, JavaMethodHandle> methodCache_;
+    std::atomic<uint64_t> methodCacheGeneration_;
+    
+    // 已加载模组的类加载器与入口类（全局引用）
+    struct ModClassLoader {
+        jobject loader = nullptr;       // URLClassLoader
+        std::vector<jclass> entryClasses;
+    };
+    mutable std::mutex modLoadersMutex_;
+    std::unordered_map<std::string, ModClassLoader> modLoaders_;
+    
+    // 批量事件：每个缓冲区对应一个DirectByteBuffer（全局引用）
+    EventBatchQueue eventQueue_;
+    std::vector<jobject> eventBuffers_;
+    size_t syncedEventTypes_;
     
     // 内部处理函数
     bool CreateJVM();
     bool LoadModFromJar(const std::string& jarPath, JavaModInfo& info);
+    bool InitializeMod(const JavaModInfo& info);
+    jobject CreateModClassLoader(JNIEnv* env, const JavaModInfo& info);
+    jobject CreateDependencyClassLoader(JNIEnv* env, jobject parent, const std::vector<jobject>& dependencyLoaders);
+    jclass FindDependencyLoaderClass(JNIEnv* env);
+    std::vector<jclass> ResolveEntryClasses(JNIEnv* env, const JavaModInfo& info, jobject loader);
+    void CloseModClassLoader(JNIEnv* env, ModClassLoader& modLoader);
+    void ReleaseModLoaders();
+    jclass FindModClass(JNIEnv* env, const std::string& className);
+    void AddModDependency(const std::string& dependency, JavaModInfo& info);
     bool ParseModManifest(const std::string& jarPath, JavaModInfo& info);
-    bool ParseMcmodInfo(const std::string& filePath, JavaModInfo& info);
-    bool ParseModsToml(const std::string& filePath, JavaModInfo& info);
-    bool ParseFabricModJson(const std::string& filePath, JavaModInfo& info);
+    bool ParseModMetadata(const std::string& jarPath, const JarMetadata& metadata, JavaModInfo& info);
+    bool ParseMcmodInfo(const std::string& content, JavaModInfo& info);
+    bool ParseModsToml(const std::string& content, JavaModInfo& info);
+    bool ParseFabricModJson(const std::string& content, JavaModInfo& info);
     void RegisterNativeMethods();
     void* FindNativeFunction(const std::string& className, const std::string& methodName);
+    jclass FindCachedClass(JNIEnv* env, const std::string& className);
+    bool InvokeV(const JavaMethodHandle& handle, jobject object, va_list args);
+    jobject GetEventBuffer(size_t slab);
+    void SyncEventTypes();
+    void ReleaseEventBuffers();
+    bool RunModTask(const ModTask& task);
 };
 
 // 基岩版API封装（供Java模组调用）
@@ -121,6 +256,12 @@ public:
     static void SetBlock(int x, int y, int z, int blockId);
     static int GetBlock(int x, int y, int z);
     
+    // 区域批量读写：起点(x, y, z)，大小sizeX*sizeY*sizeZ
+    // blockIds按YZX顺序排列（x变化最快，其次z，最后y，与区块段布局一致）
+    // 引擎侧目前仍通过GetBlock/SetBlock逐个访问
+    static void GetBlocks(int x, int y, int z, int sizeX, int sizeY, int sizeZ, int32_t* blockIds);
+    static void SetBlocks(int x, int y, int z, int sizeX, int sizeY, int sizeZ, const int32_t* blockIds);
+    
     // 玩家操作
     static void GetPlayerPosition(const char* playerId, float* x, float* y, float* z);
     static void SetPlayerPosition(const char* playerId, float x, float y, float z);
@@ -147,6 +288,19 @@ namespace bridge {
     void Java_SetBlock(JNIEnv* env, jclass clazz, jint x, jint y, jint z, jint blockId);
     jint Java_GetBlock(JNIEnv* env, jclass clazz, jint x, jint y, jint z);
     
+    // 批量方块：整个区域只跨越一次JNI，返回处理的方块数，区域或缓冲区无效时返回-1
+    // int[]版本通过GetPrimitiveArrayCritical直接读写Java数组，不复制
+    jint Java_GetBlocks(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                        jint sizeX, jint sizeY, jint sizeZ, jintArray blocks);
+    jint Java_SetBlocks(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                        jint sizeX, jint sizeY, jint sizeZ, jintArray blocks);
+    
+    // 直接ByteBuffer版本（本机字节序的int，地址需4字节对齐，allocateDirect分配的缓冲区满足）
+    jint Java_GetBlocksBuffer(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                              jint sizeX, jint sizeY, jint sizeZ, jobject buffer);
+    jint Java_SetBlocksBuffer(JNIEnv* env, jclass clazz, jint x, jint y, jint z,
+                              jint sizeX, jint sizeY, jint sizeZ, jobject buffer);
+    
     // 玩家相关
     void Java_GetPlayerPosition(JNIEnv* env, jclass clazz, jstring playerId, 
                                 jfloatArray pos);
@@ -0,0 +1,201 @@
+/**
+ * Minecraft Unifier - JVM Profile Implementation
+ * JVM启动配置实现
+ */
+
+#include "jvm_profile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+namespace {
+
+const char* kCdsArchivePrefix = "mods-";
+const char* kCdsArchiveSuffix = ".jsa";
+
+// 堆大小：数字加可选的k/m/g单位
+bool IsValidHeapSize(const std::string& size) {
+    if (size.empty() || !std::isdigit(static_cast<unsigned char>(size[0]))) {
+        return false;
+    }
+    size_t digits = 0;
+    while (digits < size.size() && std::isdigit(static_cast<unsigned char>(size[digits]))) {
+        digits++;
+    }
+    if (digits == size.size()) {
+        return true;
+    }
+    return digits + 1 == size.size() && std::strchr("kKmMgG", size[digits]) != nullptr;
+}
+
+// 删除目录中其他模组集合的归档
+void RemoveStaleArchives(const fs::path& directory, const fs::path& keep) {
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (it->path() != keep && name.rfind(kCdsArchivePrefix, 0) == 0 &&
+            it->path().extension() == kCdsArchiveSuffix) {
+            std::error_code removeError;
+            fs::remove(it->path(), removeError);
+        }
+    }
+}
+
+} // namespace
+
+bool ParseJvmGarbageCollector(const std::string& name, JvmGarbageCollector& gc) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "default") {
+        gc = JvmGarbageCollector::DEFAULT;
+    } else if (lower == "g1") {
+        gc = JvmGarbageCollector::G1;
+    } else if (lower == "zgc" || lower == "z") {
+        gc = JvmGarbageCollector::ZGC;
+    } else if (lower == "shenandoah") {
+        gc = JvmGarbageCollector::SHENANDOAH;
+    } else if (lower == "parallel") {
+        gc = JvmGarbageCollector::PARALLEL;
+    } else if (lower == "serial") {
+        gc = JvmGarbageCollector::SERIAL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool LoadJvmProfile(const std::string& configPath, JvmProfile& profile) {
+    std::ifstream file(configPath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    json config = json::parse(file, nullptr, false);
+    if (config.is_discarded() || !config.is_object()) {
+        return false;
+    }
+    if (!config.contains("jvm") || !config["jvm"].is_object()) {
+        return true;
+    }
+
+    const json& section = config["jvm"];
+    JvmProfile result = profile;
+
+    // 无效的堆大小会让JVM拒绝启动，整份配置作废
+    for (const auto& [key, target] : {std::make_pair("initial_heap", &result.initialHeap),
+                                      std::make_pair("max_heap", &result.maxHeap)}) {
+        if (!section.contains(key)) {
+            continue;
+        }
+        if (!section[key].is_string()) {
+            return false;
+        }
+        std::string size = section[key].get<std::string>();
+        if (!size.empty() && !IsValidHeapSize(size)) {
+            return false;
+        }
+        *target = size;
+    }
+
+    if (section.contains("gc")) {
+        if (!section["gc"].is_string() || !ParseJvmGarbageCollector(section["gc"].get<std::string>(), result.gc)) {
+            return false;
+        }
+    }
+
+    result.classDataSharing = section.value("cds", result.classDataSharing);
+    result.cdsDirectory = section.value("cds_directory", result.cdsDirectory);
+
+    if (section.contains("options") && section["options"].is_array()) {
+        result.extraOptions.clear();
+        for (const auto& item : section["options"]) {
+            if (item.is_string()) {
+                result.extraOptions.push_back(item.get<std::string>());
+            }
+        }
+    }
+
+    profile = result;
+    return true;
+}
+
+std::string GetCdsArchivePath(const JvmProfile& profile, uint64_t modSetHash) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%016llx%s", kCdsArchivePrefix,
+                  static_cast<unsigned long long>(modSetHash), kCdsArchiveSuffix);
+    return (fs::path(profile.cdsDirectory) / name).string();
+}
+
+std::vector<std::string> BuildJvmOptions(const JvmProfile& profile, uint64_t modSetHash, CdsArchiveMode& mode) {
+    std::vector<std::string> options;
+    mode = CdsArchiveMode::DISABLED;
+
+    if (!profile.initialHeap.empty()) {
+        options.push_back("-Xms" + profile.initialHeap);
+    }
+    if (!profile.maxHeap.empty()) {
+        options.push_back("-Xmx" + profile.maxHeap);
+    }
+
+    switch (profile.gc) {
+        case JvmGarbageCollector::G1:
+            options.push_back("-XX:+UseG1GC");
+            break;
+        case JvmGarbageCollector::ZGC:
+            // JDK 15之前ZGC与Shenandoah为实验特性
+            options.push_back("-XX:+UnlockExperimentalVMOptions");
+            options.push_back("-XX:+UseZGC");
+            break;
+        case JvmGarbageCollector::SHENANDOAH:
+            options.push_back("-XX:+UnlockExperimentalVMOptions");
+            options.push_back("-XX:+UseShenandoahGC");
+            break;
+        case JvmGarbageCollector::PARALLEL:
+            options.push_back("-XX:+UseParallelGC");
+            break;
+        case JvmGarbageCollector::SERIAL:
+            options.push_back("-XX:+UseSerialGC");
+            break;
+        case JvmGarbageCollector::DEFAULT:
+            break;
+    }
+
+    if (profile.classDataSharing && !profile.cdsDirectory.empty()) {
+        fs::path archive = GetCdsArchivePath(profile, modSetHash);
+        std::error_code ec;
+        if (fs::is_regular_file(archive, ec) && fs::file_size(archive, ec) > 0) {
+            // 归档与JVM版本不符时JVM会忽略它（-Xshare:auto），不影响启动
+            options.push_back("-XX:SharedArchiveFile=" + archive.string());
+            mode = CdsArchiveMode::USE;
+        } else {
+            // 动态归档：JVM退出时写入本次加载的类（含各模组类加载器加载的类）
+            // 目录无法创建时本次不生成归档
+            fs::create_directories(archive.parent_path(), ec);
+            if (fs::is_directory(archive.parent_path(), ec)) {
+                RemoveStaleArchives(archive.parent_path(), archive);
+                options.push_back("-XX:ArchiveClassesAtExit=" + archive.string());
+                mode = CdsArchiveMode::DUMP;
+            }
+        }
+    }
+
+    options.insert(options.end(), profile.extraOptions.begin(), profile.extraOptions.end());
+    return options;
+}
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,59 @@
+/**
+ * Minecraft Unifier - JVM Profile
+ * JVM启动配置 - 堆大小、垃圾收集器与AppCDS类数据共享归档
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+// 垃圾收集器
+enum class JvmGarbageCollector {
+    DEFAULT,        // 由JVM决定
+    G1,
+    ZGC,
+    SHENANDOAH,
+    PARALLEL,
+    SERIAL
+};
+
+// 类数据共享归档的使用方式
+enum class CdsArchiveMode {
+    DISABLED,       // 未启用或JVM不支持
+    DUMP,           // 归档不存在，JVM退出时写入（首次启动）
+    USE             // 映射已有归档
+};
+
+// JVM启动配置
+struct JvmProfile {
+    std::string initialHeap = "128M";       // -Xms，为空时不设置
+    std::string maxHeap = "512M";           // -Xmx，为空时不设置
+    JvmGarbageCollector gc = JvmGarbageCollector::G1;
+    bool classDataSharing = true;           // 为模组集合生成并复用AppCDS归档（JDK 13+）
+    std::string cdsDirectory = "./cds";     // 归档目录，按模组集合哈希命名
+    std::vector<std::string> extraOptions;  // 追加的JVM参数，原样传递
+};
+
+// 解析收集器名称（g1/zgc/shenandoah/parallel/serial/default，不区分大小写）
+bool ParseJvmGarbageCollector(const std::string& name, JvmGarbageCollector& gc);
+
+// 从配置文件的"jvm"节读取，缺少的字段保持原值
+// { "jvm": { "initial_heap": "256M", "max_heap": "2G", "gc": "zgc", "cds": true,
+//            "cds_directory": "./cds", "options": ["-XX:+AlwaysPreTouch"] } }
+bool LoadJvmProfile(const std::string& configPath, JvmProfile& profile);
+
+// 模组集合对应的归档路径：<cdsDirectory>/mods-<哈希>.jsa
+std::string GetCdsArchivePath(const JvmProfile& profile, uint64_t modSetHash);
+
+// 生成JVM参数（不含类路径等系统属性）
+// 启用CDS时归档存在则使用，否则在退出时写入新归档并删除其他模组集合的旧归档
+std::vector<std::string> BuildJvmOptions(const JvmProfile& profile, uint64_t modSetHash, CdsArchiveMode& mode);
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,329 @@
+/**
+ * Minecraft Unifier - Mod Dependency Graph Implementation
+ * 模组依赖图实现
+ */
+
+#include "mod_dependency_graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+void ModDependencyGraph::AddMod(const std::string& modId, const std::vector<std::string>& dependencies) {
+    if (!HasMod(modId)) {
+        order_.push_back(modId);
+    }
+    dependencies_[modId] = dependencies;
+}
+
+std::vector<std::string> ModDependencyGraph::GetDependencies(const std::string& modId) const {
+    std::vector<std::string> result;
+    auto it = dependencies_.find(modId);
+    if (it == dependencies_.end()) {
+        return result;
+    }
+    for (const auto& dep : it->second) {
+        if (dep != modId && HasMod(dep) && std::find(result.begin(), result.end(), dep) == result.end()) {
+            result.push_back(dep);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> ModDependencyGraph::GetMissingDependencies(const std::string& modId) const {
+    std::vector<std::string> result;
+    auto it = dependencies_.find(modId);
+    if (it == dependencies_.end()) {
+        return result;
+    }
+    for (const auto& dep : it->second) {
+        if (!HasMod(dep)) {
+            result.push_back(dep);
+        }
+    }
+    return result;
+}
+
+void ModDependencyGraph::BuildEdges(std::vector<std::vector<size_t>>& dependencies,
+                                    std::vector<std::vector<size_t>>& dependents) const {
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(order_.size());
+    for (size_t i = 0; i < order_.size(); i++) {
+        index[order_[i]] = i;
+    }
+
+    dependencies.assign(order_.size(), {});
+    dependents.assign(order_.size(), {});
+    for (size_t i = 0; i < order_.size(); i++) {
+        for (const auto& dep : dependencies_.at(order_[i])) {
+            auto it = index.find(dep);
+            if (it == index.end() || it->second == i ||
+                std::find(dependencies[i].begin(), dependencies[i].end(), it->second) != dependencies[i].end()) {
+                continue;
+            }
+            dependencies[i].push_back(it->second);
+            dependents[it->second].push_back(i);
+        }
+    }
+}
+
+size_t ModDependencyGraph::SortLevels(const std::vector<std::vector<size_t>>& dependencies,
+                                      const std::vector<std::vector<size_t>>& dependents,
+                                      std::vector<std::vector<size_t>>& levels,
+                                      std::vector<size_t>& pending) const {
+    // Kahn算法，逐层剥离入度为0的模组
+    levels.clear();
+    pending.resize(order_.size());
+    std::vector<size_t> current;
+    for (size_t i = 0; i < order_.size(); i++) {
+        pending[i] = dependencies[i].size();
+        if (pending[i] == 0) {
+            current.push_back(i);
+        }
+    }
+
+    size_t sorted = 0;
+    while (!current.empty()) {
+        std::vector<size_t> next;
+        for (size_t mod : current) {
+            for (size_t dependent : dependents[mod]) {
+                if (--pending[dependent] == 0) {
+                    next.push_back(dependent);
+                }
+            }
+        }
+        sorted += current.size();
+        levels.push_back(std::move(current));
+
+        // 层内保持添加顺序，结果稳定
+        std::sort(next.begin(), next.end());
+        current = std::move(next);
+    }
+    return sorted;
+}
+
+bool ModDependencyGraph::BuildLevels(std::vector<std::vector<std::string>>& levels,
+                                     std::vector<std::string>& cycle) const {
+    levels.clear();
+    cycle.clear();
+
+    std::vector<std::vector<size_t>> dependencies;
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<std::vector<size_t>> sortedLevels;
+    std::vector<size_t> pending;
+    BuildEdges(dependencies, dependents);
+    size_t sorted = SortLevels(dependencies, dependents, sortedLevels, pending);
+    for (const auto& level : sortedLevels) {
+        levels.emplace_back();
+        levels.back().reserve(level.size());
+        for (size_t mod : level) {
+            levels.back().push_back(order_[mod]);
+        }
+    }
+    if (sorted == order_.size()) {
+        return true;
+    }
+
+    // 剩余模组都在环上或依赖环：从任一剩余模组沿未排序的依赖前进，必然回到走过的模组
+    size_t node = 0;
+    while (pending[node] == 0) {
+        node++;
+    }
+    std::vector<size_t> path;
+    std::vector<size_t> visited(order_.size(), SIZE_MAX);
+    while (visited[node] == SIZE_MAX) {
+        visited[node] = path.size();
+        path.push_back(node);
+        for (size_t dep : dependencies[node]) {
+            if (pending[dep] > 0) {
+                node = dep;
+                break;
+            }
+        }
+    }
+    for (size_t i = visited[node]; i < path.size(); i++) {
+        cycle.push_back(order_[path[i]]);
+    }
+    cycle.push_back(order_[node]);
+    return false;
+}
+
+std::vector<std::string> ModDependencyGraph::GetCriticalPath(
+    const std::unordered_map<std::string, double>& durations, double& totalMs) const {
+    totalMs = 0.0;
+    std::vector<std::vector<size_t>> dependencies;
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<std::vector<size_t>> levels;
+    std::vector<size_t> pending;
+    BuildEdges(dependencies, dependents);
+    SortLevels(dependencies, dependents, levels, pending);
+
+    // 按拓扑顺序计算最早完成时刻，记录决定完成时刻的依赖
+    const size_t none = SIZE_MAX;
+    std::vector<double> finish(order_.size(), 0.0);
+    std::vector<size_t> previous(order_.size(), none);
+    size_t last = none;
+    for (const auto& level : levels) {
+        for (size_t mod : level) {
+            double ready = 0.0;
+            for (size_t dep : dependencies[mod]) {
+                if (previous[mod] == none || finish[dep] > ready) {
+                    ready = finish[dep];
+                    previous[mod] = dep;
+                }
+            }
+            auto duration = durations.find(order_[mod]);
+            finish[mod] = ready + (duration != durations.end() ? duration->second : 0.0);
+            if (last == none || finish[mod] > finish[last]) {
+                last = mod;
+            }
+        }
+    }
+
+    std::vector<std::string> path;
+    if (last == none) {
+        return path;
+    }
+    totalMs = finish[last];
+    for (size_t node = last; node != none; node = previous[node]) {
+        path.push_back(order_[node]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+size_t ModDependencyGraph::LoadLevels(ModLoadReport& report,
+                                      std::chrono::steady_clock::time_point start,
+                                      const ModInitializer& initialize,
+                                      const std::function<void(const std::string& modId)>& onLoaded,
+                                      const LevelRunner& runLevel) const {
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+
+    for (const auto& modId : order_) {
+        std::vector<std::string> missing = GetMissingDependencies(modId);
+        if (!missing.empty()) {
+            report.missingDependencies[modId] = missing;
+        }
+    }
+    BuildLevels(report.levels, report.cycle);
+
+    // 逐层加载，依赖加载失败的模组随之跳过
+    std::unordered_set<std::string> failed;
+    std::unordered_map<std::string, double> durations;
+    for (size_t level = 0; level < report.levels.size(); level++) {
+        std::vector<std::string> ready;
+        for (const auto& modId : report.levels[level]) {
+            bool blocked = false;
+            for (const auto& dep : GetDependencies(modId)) {
+                blocked = blocked || failed.count(dep) > 0;
+            }
+            if (blocked) {
+                failed.insert(modId);
+                report.skipped.push_back(modId);
+            } else {
+                ready.push_back(modId);
+            }
+        }
+
+        std::vector<ModLoadTiming> timings(ready.size());
+        auto body = [&](size_t i) {
+            Clock::time_point modStart = Clock::now();
+            timings[i].loaded = initialize(ready[i]);
+            Clock::time_point modEnd = Clock::now();
+            timings[i].modId = ready[i];
+            timings[i].level = level;
+            timings[i].startMs = elapsedMs(start, modStart);
+            timings[i].durationMs = elapsedMs(modStart, modEnd);
+        };
+        if (runLevel) {
+            runLevel(ready.size(), body);
+        } else {
+            for (size_t i = 0; i < ready.size(); i++) {
+                body(i);
+            }
+        }
+
+        // 登记与回调在调用线程上按层内顺序进行
+        for (const auto& timing : timings) {
+            durations[timing.modId] = timing.durationMs;
+            report.timings.push_back(timing);
+            if (!timing.loaded) {
+                failed.insert(timing.modId);
+                continue;
+            }
+            onLoaded(timing.modId);
+            report.loadedCount++;
+        }
+    }
+
+    // 环上及依赖环的模组未出现在任何一层
+    for (const auto& modId : order_) {
+        if (!durations.count(modId) && !failed.count(modId)) {
+            report.skipped.push_back(modId);
+        }
+    }
+
+    std::sort(report.timings.begin(), report.timings.end(), [](const ModLoadTiming& a, const ModLoadTiming& b) {
+        return a.startMs < b.startMs;
+    });
+    report.criticalPath = GetCriticalPath(durations, report.criticalPathMs);
+    report.totalMs = elapsedMs(start, Clock::now());
+    return report.loadedCount;
+}
+
+std::string ModLoadReport::ToString() const {
+    std::unordered_map<std::string, const ModLoadTiming*> byMod;
+    for (const auto& timing : timings) {
+        byMod[timing.modId] = &timing;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "Loaded " << loadedCount << " mods in " << levels.size() << " levels, " << totalMs << " ms\n";
+    out << "Critical path (" << criticalPathMs << " ms):";
+    for (const auto& modId : criticalPath) {
+        auto it = byMod.find(modId);
+        out << " " << modId << " (" << (it != byMod.end() ? it->second->durationMs : 0.0) << " ms)";
+    }
+    out << "\n";
+
+    // 每层最慢的模组决定该层的结束时刻
+    for (size_t i = 0; i < levels.size(); i++) {
+        const ModLoadTiming* slowest = nullptr;
+        for (const auto& modId : levels[i]) {
+            auto it = byMod.find(modId);
+            if (it != byMod.end() && (!slowest || it->second->durationMs > slowest->durationMs)) {
+                slowest = it->second;
+            }
+        }
+        out << "Level " << i << ": " << levels[i].size() << " mods";
+        if (slowest) {
+            out << ", slowest " << slowest->modId << " (" << slowest->durationMs << " ms)";
+        }
+        out << "\n";
+    }
+
+    if (!cycle.empty()) {
+        out << "Dependency cycle:";
+        for (const auto& modId : cycle) {
+            out << " " << modId;
+        }
+        out << "\n";
+    }
+    for (const auto& modId : skipped) {
+        out << "Skipped " << modId << "\n";
+    }
+    return out.str();
+}
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
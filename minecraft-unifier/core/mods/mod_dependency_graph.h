@@ -0,0 +1,96 @@
+/**
+ * Minecraft Unifier - Mod Dependency Graph
+ * 模组依赖图 - 拓扑分层、环检测与加载耗时的关键路径
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+// 单个模组的加载耗时
+struct ModLoadTiming {
+    std::string modId;
+    size_t level = 0;               // 所在拓扑层
+    double startMs = 0.0;           // 相对LoadAll开始的时刻
+    double durationMs = 0.0;
+    bool loaded = false;
+};
+
+// LoadAll的结果与耗时分解
+struct ModLoadReport {
+    std::vector<std::vector<std::string>> levels;   // 拓扑层，同层模组互不依赖
+    std::vector<std::string> cycle;                 // 检测到的依赖环（首尾相同），环上及依赖环的模组不加载
+    std::vector<std::string> skipped;               // 因依赖环或依赖加载失败而跳过的模组
+    std::unordered_map<std::string, std::vector<std::string>> missingDependencies; // 目录中不存在的依赖（忽略）
+    std::vector<ModLoadTiming> timings;             // 按开始时刻排序
+    std::vector<std::string> criticalPath;          // 依赖链上累计耗时最长的路径
+    double criticalPathMs = 0.0;
+    double totalMs = 0.0;
+    size_t loadedCount = 0;
+
+    // 可读的耗时报告（关键路径与各层最慢的模组）
+    std::string ToString() const;
+};
+
+// 模组依赖图（有向边从依赖指向被依赖者）
+class ModDependencyGraph {
+public:
+    // 添加模组，重复添加时覆盖依赖
+    void AddMod(const std::string& modId, const std::vector<std::string>& dependencies);
+
+    bool HasMod(const std::string& modId) const { return dependencies_.count(modId) > 0; }
+    size_t GetModCount() const { return order_.size(); }
+
+    // 图中存在的依赖
+    std::vector<std::string> GetDependencies(const std::string& modId) const;
+
+    // 图中不存在的依赖
+    std::vector<std::string> GetMissingDependencies(const std::string& modId) const;
+
+    // 按拓扑层分组（层内按添加顺序），无法排序的模组（环上或依赖环）不出现在结果中
+    // 存在环时返回false，cycle为其中一个环
+    bool BuildLevels(std::vector<std::vector<std::string>>& levels, std::vector<std::string>& cycle) const;
+
+    // 关键路径：模组最早完成时刻 = 依赖的最晚完成时刻 + 自身耗时，返回完成最晚的依赖链
+    std::vector<std::string> GetCriticalPath(const std::unordered_map<std::string, double>& durations,
+                                             double& totalMs) const;
+
+    // 初始化单个模组，可能在工作线程上调用
+    using ModInitializer = std::function<bool(const std::string& modId)>;
+    // 以body(0..count-1)执行一层中互不依赖的模组，可在工作线程上并行；为空时在调用线程上依次执行
+    using LevelRunner = std::function<void(size_t count, const std::function<void(size_t)>& body)>;
+
+    // 按拓扑层加载图中的全部模组并填写report（耗时从start起算），返回加载数
+    // 依赖环上、依赖环或依赖加载失败的模组被跳过；初始化成功的模组在调用线程上按层内顺序传给onLoaded
+    size_t LoadLevels(ModLoadReport& report,
+                      std::chrono::steady_clock::time_point start,
+                      const ModInitializer& initialize,
+                      const std::function<void(const std::string& modId)>& onLoaded,
+                      const LevelRunner& runLevel = nullptr) const;
+
+private:
+    std::vector<std::string> order_;
+    std::unordered_map<std::string, std::vector<std::string>> dependencies_;
+
+    // 按添加顺序编号的邻接表（只含图中存在的依赖，已去重）
+    void BuildEdges(std::vector<std::vector<size_t>>& dependencies,
+                    std::vector<std::vector<size_t>>& dependents) const;
+
+    // 拓扑分层（模组编号），返回已排序的模组数
+    size_t SortLevels(const std::vector<std::vector<size_t>>& dependencies,
+                      const std::vector<std::vector<size_t>>& dependents,
+                      std::vector<std::vector<size_t>>& levels,
+                      std::vector<size_t>& pending) const;
+};
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
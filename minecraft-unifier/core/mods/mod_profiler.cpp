@@ -0,0 +1,262 @@
+/**
+ * Minecraft Unifier - Mod Profiler Implementation
+ * 模组启动性能分析实现
+ */
+
+#include "mod_profiler.h"
+#include "json_writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <unordered_map>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+namespace {
+
+// 每个线程当前最内层的区间
+thread_local ModProfileScope* t_currentScope = nullptr;
+
+std::atomic<uint32_t> g_nextThreadId(1);
+
+uint32_t CurrentThreadId() {
+    thread_local uint32_t id = g_nextThreadId++;
+    return id;
+}
+
+double ThreadCpuUs() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// 折叠栈的帧名不能含分隔符与空格
+std::string FrameName(const std::string& modId, const char* phase) {
+    std::string frame = (modId.empty() ? std::string("?") : modId) + ":" + phase;
+    std::replace(frame.begin(), frame.end(), ';', '_');
+    std::replace(frame.begin(), frame.end(), ' ', '_');
+    return frame;
+}
+
+} // namespace
+
+// ==================== ModProfiler ====================
+
+ModProfiler::ModProfiler()
+    : enabled_(false)
+    , origin_(std::chrono::steady_clock::now()) {
+}
+
+ModProfiler& ModProfiler::GetInstance() {
+    static ModProfiler instance;
+    return instance;
+}
+
+void ModProfiler::Enable() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    origin_ = std::chrono::steady_clock::now();
+    enabled_ = true;
+}
+
+void ModProfiler::Disable() {
+    enabled_ = false;
+}
+
+void ModProfiler::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+}
+
+void ModProfiler::Record(ModProfileEvent&& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(std::move(event));
+}
+
+std::vector<ModProfileEvent> ModProfiler::GetEvents() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+std::vector<ModProfileSummary> ModProfiler::GetModSummaries() const {
+    std::unordered_map<std::string, ModProfileSummary> byMod;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& event : events_) {
+            if (!event.outermost || event.modId.empty()) {
+                continue;
+            }
+            ModProfileSummary& summary = byMod[event.modId];
+            summary.modId = event.modId;
+            summary.wallMs += event.wallUs / 1000.0;
+            summary.cpuMs += event.cpuUs / 1000.0;
+        }
+    }
+
+    std::vector<ModProfileSummary> result;
+    result.reserve(byMod.size());
+    for (auto& [modId, summary] : byMod) {
+        result.push_back(std::move(summary));
+    }
+    std::sort(result.begin(), result.end(), [](const ModProfileSummary& a, const ModProfileSummary& b) {
+        return a.wallMs != b.wallMs ? a.wallMs > b.wallMs : a.modId < b.modId;
+    });
+    return result;
+}
+
+bool ModProfiler::WriteChromeTrace(const std::string& path) const {
+    std::vector<ModProfileEvent> events = GetEvents();
+    std::sort(events.begin(), events.end(), [](const ModProfileEvent& a, const ModProfileEvent& b) {
+        return a.startUs < b.startUs;
+    });
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    // 完整事件（ph=X），时间单位为微秒
+    bool ok;
+    {
+        common::JsonWriter writer(file);
+        writer.BeginObject();
+        writer.Key("traceEvents");
+        writer.BeginArray();
+        for (const auto& event : events) {
+            writer.BeginObject();
+            writer.Key("name");
+            writer.String(event.modId.empty() ? event.phase : event.modId + ":" + event.phase);
+            writer.Key("cat");
+            writer.String(event.runtime);
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("ts");
+            writer.Number(event.startUs);
+            writer.Key("dur");
+            writer.Number(event.wallUs);
+            writer.Key("pid");
+            writer.Int(1);
+            writer.Key("tid");
+            writer.Int(event.threadId);
+            writer.Key("args");
+            writer.BeginObject();
+            writer.Key("mod");
+            writer.String(event.modId);
+            writer.Key("phase");
+            writer.String(event.phase);
+            writer.Key("cpu_us");
+            writer.Number(event.cpuUs);
+            writer.EndObject();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.Key("displayTimeUnit");
+        writer.String("ms");
+        writer.EndObject();
+        ok = writer.Flush();
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+bool ModProfiler::WriteCollapsedStacks(const std::string& path) const {
+    // 相同栈的自身时间合并，按栈名排序输出
+    std::map<std::string, double> stacks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& event : events_) {
+            stacks[event.stack] += event.selfUs;
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = true;
+    for (const auto& [stack, selfUs] : stacks) {
+        long long value = static_cast<long long>(selfUs + 0.5);
+        if (value > 0) {
+            ok = std::fprintf(file, "%s %lld\n", stack.c_str(), value) > 0 && ok;
+        }
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+// ==================== ModProfileScope ====================
+
+ModProfileScope::ModProfileScope(const char* runtime, const std::string& modId, const char* phase)
+    : active_(ModProfiler::GetInstance().IsEnabled())
+    , runtime_(runtime)
+    , phase_(phase)
+    , parent_(nullptr)
+    , depth_(0)
+    , cpuStartUs_(0.0)
+    , childUs_(0.0) {
+    if (!active_) {
+        return;
+    }
+    modId_ = modId;
+    parent_ = t_currentScope;
+    depth_ = parent_ ? parent_->depth_ + 1 : 0;
+    t_currentScope = this;
+    cpuStartUs_ = ThreadCpuUs();
+    start_ = std::chrono::steady_clock::now();
+}
+
+ModProfileScope::~ModProfileScope() {
+    if (!active_) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double cpuEndUs = ThreadCpuUs();
+    t_currentScope = parent_;
+
+    ModProfiler& profiler = ModProfiler::GetInstance();
+    ModProfileEvent event;
+    event.runtime = runtime_;
+    event.modId = modId_;
+    event.phase = phase_;
+    event.threadId = CurrentThreadId();
+    event.depth = depth_;
+    event.startUs = std::chrono::duration<double, std::micro>(start_ - profiler.origin_).count();
+    event.wallUs = std::chrono::duration<double, std::micro>(end - start_).count();
+    event.cpuUs = cpuEndUs - cpuStartUs_;
+    event.selfUs = std::max(0.0, event.wallUs - childUs_);
+    event.outermost = !parent_ || parent_->modId_ != modId_;
+
+    // 自根向下拼接折叠栈
+    std::vector<const ModProfileScope*> chain;
+    for (const ModProfileScope* scope = this; scope; scope = scope->parent_) {
+        chain.push_back(scope);
+    }
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!event.stack.empty()) {
+            event.stack += ';';
+        }
+        event.stack += FrameName((*it)->modId_, (*it)->phase_);
+    }
+
+    if (parent_) {
+        parent_->childUs_ += event.wallUs;
+    }
+    profiler.Record(std::move(event));
+}
+
+void ModProfileScope::SetModId(const std::string& modId) {
+    if (!active_) {
+        return;
+    }
+    std::string previous = modId_;
+    for (ModProfileScope* scope = this; scope && scope->modId_ == previous; scope = scope->parent_) {
+        scope->modId_ = modId;
+    }
+}
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
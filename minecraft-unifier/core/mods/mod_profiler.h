@@ -0,0 +1,103 @@
+/**
+ * Minecraft Unifier - Mod Profiler
+ * 模组启动性能分析 - 记录各模组各阶段的墙钟与CPU时间，导出Chrome trace与折叠栈
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace mods {
+
+// 一个已结束的计时区间
+struct ModProfileEvent {
+    std::string runtime;        // "java" / "netease"
+    std::string modId;          // 区间开始时未知的模组可为空
+    std::string phase;          // parse_manifest / load_class / init / import 等
+    std::string stack;          // 折叠栈，帧间以';'分隔，帧为"模组:阶段"
+    uint32_t threadId = 0;      // 分析器内的线程编号
+    uint32_t depth = 0;         // 同一线程内的嵌套深度
+    double startUs = 0.0;       // 相对分析器启用时刻
+    double wallUs = 0.0;
+    double cpuUs = 0.0;         // 当前线程消耗的CPU时间
+    double selfUs = 0.0;        // 扣除子区间后的墙钟时间
+    bool outermost = false;     // 该模组在本线程上的最外层区间
+};
+
+// 单个模组的汇总（只累计最外层区间，嵌套的阶段不重复计入）
+struct ModProfileSummary {
+    std::string modId;
+    double wallMs = 0.0;
+    double cpuMs = 0.0;
+};
+
+// 进程级启动分析器，默认关闭，关闭时计时区间不做任何记录
+class ModProfiler {
+public:
+    static ModProfiler& GetInstance();
+
+    // 启用时清空已有记录并以当前时刻为零点
+    void Enable();
+    void Disable();
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void Clear();
+
+    std::vector<ModProfileEvent> GetEvents() const;
+
+    // 按墙钟时间降序
+    std::vector<ModProfileSummary> GetModSummaries() const;
+
+    // Chrome trace-event格式（chrome://tracing、Perfetto、speedscope可直接打开）
+    bool WriteChromeTrace(const std::string& path) const;
+
+    // 折叠栈格式（"帧;帧;帧 自身微秒数"，供flamegraph.pl、speedscope等使用）
+    bool WriteCollapsedStacks(const std::string& path) const;
+
+private:
+    friend class ModProfileScope;
+
+    ModProfiler();
+
+    std::atomic<bool> enabled_;
+    std::chrono::steady_clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<ModProfileEvent> events_;
+
+    void Record(ModProfileEvent&& event);
+};
+
+// 计时区间（RAII），在同一线程内按栈嵌套
+class ModProfileScope {
+public:
+    ModProfileScope(const char* runtime, const std::string& modId, const char* phase);
+    ~ModProfileScope();
+
+    ModProfileScope(const ModProfileScope&) = delete;
+    ModProfileScope& operator=(const ModProfileScope&) = delete;
+
+    // 解析出模组ID后补记，外层以同一临时名称开始的区间一并更新
+    void SetModId(const std::string& modId);
+
+private:
+    bool active_;
+    const char* runtime_;
+    const char* phase_;
+    std::string modId_;
+    ModProfileScope* parent_;
+    uint32_t depth_;
+    std::chrono::steady_clock::time_point start_;
+    double cpuStartUs_;
+    double childUs_;
+};
+
+} // namespace mods
+} // namespace core
+} // namespace mcu
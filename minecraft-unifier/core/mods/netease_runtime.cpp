@@ -4,6 +4,9 @@
  */
 
 #include "netease_runtime.h"
+#include "mod_profiler.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -71,6 +74,8 @@ bool NeteaseModRuntime::LoadMod(const std::string& modPath) {
         return false;
     }
     
+    // 模组ID在解析描述文件后才知道，先以目录名记录
+    ModProfileScope profile("netease", fs::path(modPath).filename().string(), "load");
     NeteaseModInfo info;
     if (!LoadModFromPath(modPath, info)) {
         return false;
@@ -91,15 +96,33 @@ bool NeteaseModRuntime::LoadMod(const std::string& modPath) {
         }
     }
     
+    if (!InitializeMod(info)) {
+        return false;
+    }
+    
+    loadedMods_[info.modId] = info;
+    
+    // 触发模组加载事件
+    TriggerEvent("mod_loaded", &info);
+    
+    return true;
+}
+
+bool NeteaseModRuntime::InitializeMod(const NeteaseModInfo& info) {
+    const std::string& modPath = info.modPath;
+    
     // 添加模组路径到Python搜索路径
     std::string pathCmd = "sys.path.insert(0, '" + modPath + "')";
     PyRun_SimpleString(pathCmd.c_str());
     
     // 导入Python模块
-    std::string importCmd = "import " + info.modId;
-    if (PyRun_SimpleString(importCmd.c_str()) != 0) {
-        PyErr_Print();
-        return false;
+    {
+        ModProfileScope profile("netease", info.modId, "import");
+        std::string importCmd = "import " + info.modId;
+        if (PyRun_SimpleString(importCmd.c_str()) != 0) {
+            PyErr_Print();
+            return false;
+        }
     }
     
     // 尝试调用模组的初始化函数
@@ -107,6 +130,7 @@ bool NeteaseModRuntime::LoadMod(const std::string& modPath) {
     bool initCalled = false;
     
     for (const auto& func : initFunctions) {
+        ModProfileScope profile("netease", info.modId, func.c_str());
         std::string initCmd = info.modId + "." + func + "()";
         if (PyRun_SimpleString(initCmd.c_str()) == 0) {
             initCalled = true;
@@ -119,12 +143,55 @@ bool NeteaseModRuntime::LoadMod(const std::string& modPath) {
         // 某些模组可能通过事件系统初始化
     }
     
-    loadedMods_[info.modId] = info;
+    return true;
+}
+
+size_t NeteaseModRuntime::LoadAll(const std::string& directory, ModLoadReport* report) {
+    ModLoadReport localReport;
+    ModLoadReport& result = report ? *report : localReport;
+    result = ModLoadReport();
+    if (!initialized_ || !fs::is_directory(directory)) {
+        return 0;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     
-    // 触发模组加载事件
-    TriggerEvent("mod_loaded", &info);
+    // 每个子目录是一个模组
+    std::vector<std::string> modPaths;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (entry.is_directory()) {
+            modPaths.push_back(entry.path().string());
+        }
+    }
+    std::sort(modPaths.begin(), modPaths.end());
     
-    return true;
+    std::unordered_map<std::string, NeteaseModInfo> mods;
+    ModDependencyGraph graph;
+    for (const auto& modPath : modPaths) {
+        NeteaseModInfo info;
+        if (!LoadModFromPath(modPath, info) || loadedMods_.count(info.modId) || mods.count(info.modId)) {
+            continue;
+        }
+        std::vector<std::string> dependencies;
+        for (const auto& dep : info.dependencies) {
+            if (!loadedMods_.count(dep)) {
+                dependencies.push_back(dep);
+            }
+        }
+        graph.AddMod(info.modId, dependencies);
+        mods[info.modId] = std::move(info);
+    }
+    
+    // 嵌入式解释器受GIL约束，按拓扑顺序逐个初始化
+    return graph.LoadLevels(result, start,
+        [this, &mods](const std::string& modId) {
+            ModProfileScope profile("netease", modId, "load");
+            return InitializeMod(mods.at(modId));
+        },
+        [this, &mods](const std::string& modId) {
+            NeteaseModInfo& info = mods.at(modId);
+            loadedMods_[modId] = info;
+            TriggerEvent("mod_loaded", &info);
+        });
 }
 
 bool NeteaseModRuntime::UnloadMod(const std::string& modId) {
@@ -181,6 +248,7 @@ bool NeteaseModRuntime::LoadModFromPath(const std::string& modPath, NeteaseModIn
     info.modPath = modPath;
     
     // 解析模组manifest
+    ModProfileScope profile("netease", fs::path(modPath).filename().string(), "parse_manifest");
     if (!ParseModManifest(modPath, info)) {
         // 使用默认值
         fs::path path(modPath);
@@ -189,6 +257,7 @@ bool NeteaseModRuntime::LoadModFromPath(const std::string& modPath, NeteaseModIn
         info.version = "1.0.0";
         info.description = "Unknown mod";
     }
+    profile.SetModId(info.modId);
     
     return true;
 }
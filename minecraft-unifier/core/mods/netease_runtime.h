@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include "mod_dependency_graph.h"
 
 namespace mcu {
 namespace core {
@@ -40,6 +41,10 @@ public:
     // 加载模组
     bool LoadMod(const std::string& modPath);
     
+    // 加载目录中的所有模组（每个子目录一个），按依赖关系拓扑顺序逐个初始化
+    // 依赖环上的模组与依赖加载失败的模组被跳过，返回加载数
+    size_t LoadAll(const std::string& directory, ModLoadReport* report = nullptr);
+    
     // 卸载模组
     bool UnloadMod(const std::string& modId);
     
@@ -82,6 +87,7 @@ private:
     // 内部处理函数
     bool InitPythonInterpreter();
     bool LoadModFromPath(const std::string& modPath, NeteaseModInfo& info);
+    bool InitializeMod(const NeteaseModInfo& info);
     bool ParseModManifest(const std::string& modPath, NeteaseModInfo& info);
     bool ParseModJson(const std::string& filePath, NeteaseModInfo& info);
     bool ParseModPy(const std::string& filePath, NeteaseModInfo& info);
@@ -0,0 +1,1013 @@
+/**
+ * Minecraft Unifier - GLSL Preprocessor Implementation
+ * GLSL预处理器实现 - 文件只解析一次，展开时按程序各自的宏状态求值
+ */
+
+#include "glsl_preprocessor.h"
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// 行类型
+enum class GLSLLineKind {
+    TEXT,
+    DEFINE,
+    UNDEF,
+    IFDEF,
+    IFNDEF,
+    IF,
+    ELIF,
+    ELSE,
+    ENDIF,
+    INCLUDE,
+    ERROR_DIRECTIVE,
+    OPTION_OFF,     // 注释掉的开关选项：//#define NAME
+    DIRECTIVE       // 其余指令（#version、#extension等）原样输出
+};
+
+// 条件表达式运算符
+enum class GLSLExprOp : uint8_t {
+    NONE,
+    LPAREN, RPAREN,
+    NOT, BITNOT,
+    MUL, DIV, MOD, ADD, SUB, SHL, SHR,
+    LT, GT, LE, GE, EQ, NE,
+    BITAND, XOR, BITOR, AND, OR,
+    QUESTION, COLON
+};
+
+struct GLSLExprToken {
+    enum Type : uint8_t { NUMBER, IDENTIFIER, DEFINED, OPERATOR, END } type;
+    GLSLExprOp op;
+    double number;
+    std::string name;           // 标识符/defined的宏名
+};
+
+struct GLSLExpression {
+    std::vector<GLSLExprToken> tokens;
+    std::string error;          // 非空表示无法记号化（仅在#if中使用时报错）
+};
+
+struct GLSLLine {
+    GLSLLineKind kind = GLSLLineKind::TEXT;
+    std::string text;           // 原始文本（含续行）
+    std::string name;           // 宏名
+    std::string argument;       // 宏值/条件表达式/包含路径
+    std::shared_ptr<const GLSLExpression> expression;   // 预先记号化的条件或宏值
+    bool functionLike = false;
+};
+
+struct GLSLSourceFile {
+    std::string path;
+    std::vector<GLSLLine> lines;
+};
+
+// 条件编译栈
+struct GLSLConditional {
+    bool parentActive;
+    bool active;
+    bool taken;
+    bool sawElse;
+};
+
+struct GLSLPreprocessor::ExpandState {
+    std::unordered_map<std::string, Macro> macros;
+    std::vector<GLSLConditional> conditionals;
+    std::vector<std::string> includeStack;
+    std::vector<std::shared_ptr<const GLSLSourceFile>> files;   // 保持宏值引用的文件存活
+    std::vector<const GLSLExprToken*> scratch;                   // 复用的展开结果
+    std::vector<const std::string*> expanding;                   // 正在展开的宏
+    std::vector<GLSLOptionReference>* referencedOptions = nullptr;  // 查询过的选项
+    std::string error;                                           // 本次展开的错误信息
+
+    bool Active() const {
+        return conditionals.empty() || conditionals.back().active;
+    }
+};
+
+namespace {
+
+const size_t kMaxIncludeDepth = 64;
+const int kMaxExpressionDepth = 256;
+
+inline bool IsIdentStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+inline bool IsIdentChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string Trim(const std::string& text) {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+// 去掉指令参数中的注释，并更新跨行块注释状态
+std::string StripComments(const std::string& text, bool& inComment) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (inComment) {
+            if (text[i] == '*' && i + 1 < text.size() && text[i + 1] == '/') {
+                inComment = false;
+                i++;
+                result.push_back(' ');
+            }
+            continue;
+        }
+        if (text[i] == '/' && i + 1 < text.size()) {
+            if (text[i + 1] == '/') {
+                break;
+            }
+            if (text[i + 1] == '*') {
+                inComment = true;
+                i++;
+                continue;
+            }
+        }
+        result.push_back(text[i]);
+    }
+    return result;
+}
+
+bool ReadWholeFile(const std::string& path, std::string& content) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    content.clear();
+    char buffer[64 * 1024];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, count);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+// 记号化条件表达式或宏值
+std::shared_ptr<GLSLExpression> LexExpression(const std::string& text) {
+    static const struct {
+        const char* text;
+        GLSLExprOp op;
+    } kOperators[] = {
+        {"&&", GLSLExprOp::AND}, {"||", GLSLExprOp::OR}, {"==", GLSLExprOp::EQ}, {"!=", GLSLExprOp::NE},
+        {"<=", GLSLExprOp::LE}, {">=", GLSLExprOp::GE}, {"<<", GLSLExprOp::SHL}, {">>", GLSLExprOp::SHR},
+        {"(", GLSLExprOp::LPAREN}, {")", GLSLExprOp::RPAREN}, {"!", GLSLExprOp::NOT}, {"~", GLSLExprOp::BITNOT},
+        {"*", GLSLExprOp::MUL}, {"/", GLSLExprOp::DIV}, {"%", GLSLExprOp::MOD}, {"+", GLSLExprOp::ADD},
+        {"-", GLSLExprOp::SUB}, {"<", GLSLExprOp::LT}, {">", GLSLExprOp::GT}, {"&", GLSLExprOp::BITAND},
+        {"^", GLSLExprOp::XOR}, {"|", GLSLExprOp::BITOR}, {"?", GLSLExprOp::QUESTION}, {":", GLSLExprOp::COLON},
+    };
+
+    auto expression = std::make_shared<GLSLExpression>();
+    auto push = [&](GLSLExprToken::Type type, GLSLExprOp op, double number, std::string name) {
+        expression->tokens.push_back({type, op, number, std::move(name)});
+    };
+    auto skipSpaces = [&](size_t& i) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+    };
+
+    // 空开关宏在条件中按1处理
+    size_t i = 0;
+    skipSpaces(i);
+    if (i == text.size()) {
+        push(GLSLExprToken::NUMBER, GLSLExprOp::NONE, 1.0, "");
+        return expression;
+    }
+
+    while (i < text.size()) {
+        char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+            continue;
+        }
+        if (IsIdentStart(c)) {
+            size_t start = i;
+            while (i < text.size() && IsIdentChar(text[i])) {
+                i++;
+            }
+            std::string identifier = text.substr(start, i - start);
+            if (identifier != "defined") {
+                push(GLSLExprToken::IDENTIFIER, GLSLExprOp::NONE, 0.0, std::move(identifier));
+                continue;
+            }
+            // defined NAME / defined(NAME)
+            skipSpaces(i);
+            bool parenthesized = i < text.size() && text[i] == '(';
+            if (parenthesized) {
+                i++;
+                skipSpaces(i);
+            }
+            size_t nameStart = i;
+            while (i < text.size() && IsIdentChar(text[i])) {
+                i++;
+            }
+            if (nameStart == i) {
+                expression->error = "defined缺少宏名";
+                return expression;
+            }
+            std::string name = text.substr(nameStart, i - nameStart);
+            if (parenthesized) {
+                skipSpaces(i);
+                if (i >= text.size() || text[i] != ')') {
+                    expression->error = "defined缺少')'";
+                    return expression;
+                }
+                i++;
+            }
+            push(GLSLExprToken::DEFINED, GLSLExprOp::NONE, 0.0, std::move(name));
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1])))) {
+            const char* begin = text.c_str() + i;
+            char* end = nullptr;
+            double value;
+            size_t digits = std::strspn(begin, "0123456789");
+            char after = i + digits < text.size() ? text[i + digits] : '\0';
+            bool hex = c == '0' && (after == 'x' || after == 'X') && digits == 1;
+            bool octal = c == '0' && digits > 1 && after != '.' && after != 'e' && after != 'E';
+            if (hex || octal) {
+                value = static_cast<double>(std::strtoll(begin, &end, hex ? 16 : 8));
+            } else {
+                value = std::strtod(begin, &end);
+            }
+            i += end - begin;
+            // 跳过整型/浮点后缀
+            while (i < text.size() && (text[i] == 'u' || text[i] == 'U' || text[i] == 'l' ||
+                                       text[i] == 'L' || text[i] == 'f' || text[i] == 'F')) {
+                i++;
+            }
+            push(GLSLExprToken::NUMBER, GLSLExprOp::NONE, value, "");
+            continue;
+        }
+        bool matched = false;
+        for (const auto& op : kOperators) {
+            size_t length = op.text[1] ? 2 : 1;
+            if (text.compare(i, length, op.text) == 0) {
+                push(GLSLExprToken::OPERATOR, op.op, 0.0, "");
+                i += length;
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            expression->error = std::string("条件表达式中的无效字符: ") + c;
+            return expression;
+        }
+    }
+    return expression;
+}
+
+// 解析指令行
+void ParseDirective(GLSLLine& line, const std::string& body) {
+    size_t pos = 0;
+    while (pos < body.size() && std::isspace(static_cast<unsigned char>(body[pos]))) {
+        pos++;
+    }
+    size_t nameEnd = pos;
+    while (nameEnd < body.size() && IsIdentChar(body[nameEnd])) {
+        nameEnd++;
+    }
+    std::string directive = body.substr(pos, nameEnd - pos);
+    std::string rest = body.substr(nameEnd);
+
+    // 读取宏名，返回其后的位置
+    auto readName = [&](size_t& cursor) {
+        while (cursor < rest.size() && std::isspace(static_cast<unsigned char>(rest[cursor]))) {
+            cursor++;
+        }
+        size_t start = cursor;
+        while (cursor < rest.size() && IsIdentChar(rest[cursor])) {
+            cursor++;
+        }
+        return rest.substr(start, cursor - start);
+    };
+
+    size_t cursor = 0;
+    if (directive == "define") {
+        line.name = readName(cursor);
+        line.kind = line.name.empty() ? GLSLLineKind::DIRECTIVE : GLSLLineKind::DEFINE;
+        line.functionLike = cursor < rest.size() && rest[cursor] == '(';
+        line.argument = Trim(rest.substr(cursor));
+        if (!line.functionLike) {
+            line.expression = LexExpression(line.argument);
+        }
+    } else if (directive == "undef") {
+        line.kind = GLSLLineKind::UNDEF;
+        line.name = readName(cursor);
+    } else if (directive == "ifdef" || directive == "ifndef") {
+        line.kind = directive == "ifdef" ? GLSLLineKind::IFDEF : GLSLLineKind::IFNDEF;
+        line.name = readName(cursor);
+    } else if (directive == "if" || directive == "elif") {
+        line.kind = directive == "if" ? GLSLLineKind::IF : GLSLLineKind::ELIF;
+        line.argument = Trim(rest);
+        line.expression = LexExpression(line.argument);
+    } else if (directive == "else") {
+        line.kind = GLSLLineKind::ELSE;
+    } else if (directive == "endif") {
+        line.kind = GLSLLineKind::ENDIF;
+    } else if (directive == "include") {
+        std::string target = Trim(rest);
+        if (target.size() >= 2 && ((target.front() == '"' && target.back() == '"') ||
+                                   (target.front() == '<' && target.back() == '>'))) {
+            line.kind = GLSLLineKind::INCLUDE;
+            line.argument = target.substr(1, target.size() - 2);
+        } else {
+            line.kind = GLSLLineKind::ERROR_DIRECTIVE;
+            line.argument = "无效的#include: " + target;
+        }
+    } else if (directive == "error") {
+        line.kind = GLSLLineKind::ERROR_DIRECTIVE;
+        line.argument = "#error " + Trim(rest);
+    } else {
+        line.kind = GLSLLineKind::DIRECTIVE;
+    }
+}
+
+// 识别OptiFine开关选项的关闭形式：//#define NAME
+bool ParseDisabledOption(const std::string& text, size_t pos, std::string& name) {
+    if (text.compare(pos, 2, "//") != 0) {
+        return false;
+    }
+    pos += 2;
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+        pos++;
+    }
+    if (text.compare(pos, 7, "#define") != 0) {
+        return false;
+    }
+    pos += 7;
+    size_t start = pos;
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+        pos++;
+    }
+    if (pos == start) {
+        return false;
+    }
+    start = pos;
+    while (pos < text.size() && IsIdentChar(text[pos])) {
+        pos++;
+    }
+    if (pos == start) {
+        return false;
+    }
+    // 只接受无值的开关，允许其后跟随注释
+    size_t tail = pos;
+    while (tail < text.size() && (text[tail] == ' ' || text[tail] == '\t')) {
+        tail++;
+    }
+    if (tail < text.size() && text.compare(tail, 2, "//") != 0) {
+        return false;
+    }
+    name = text.substr(start, pos - start);
+    return true;
+}
+
+std::shared_ptr<GLSLSourceFile> ParseSource(const std::string& path, const std::string& content) {
+    auto file = std::make_shared<GLSLSourceFile>();
+    file->path = path;
+
+    size_t pos = 0;
+    // 跳过UTF-8 BOM
+    if (content.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        pos = 3;
+    }
+
+    bool inComment = false;
+    while (pos < content.size()) {
+        size_t end = content.find('\n', pos);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+        std::string text = content.substr(pos, end - pos);
+        if (!text.empty() && text.back() == '\r') {
+            text.pop_back();
+        }
+        pos = end + 1;
+
+        GLSLLine line;
+        size_t first = 0;
+        while (first < text.size() && (text[first] == ' ' || text[first] == '\t')) {
+            first++;
+        }
+
+        if (!inComment && first < text.size() && text[first] == '#') {
+            // 合并续行：原文保留换行，解析用的副本以空格连接
+            std::string joined = text.substr(first + 1);
+            while (!text.empty() && text.back() == '\\' && pos < content.size()) {
+                size_t next = content.find('\n', pos);
+                if (next == std::string::npos) {
+                    next = content.size();
+                }
+                std::string continuation = content.substr(pos, next - pos);
+                if (!continuation.empty() && continuation.back() == '\r') {
+                    continuation.pop_back();
+                }
+                text += '\n';
+                text += continuation;
+                joined.back() = ' ';
+                joined += continuation;
+                pos = next + 1;
+            }
+            ParseDirective(line, StripComments(joined, inComment));
+        } else {
+            if (!inComment && ParseDisabledOption(text, first, line.name)) {
+                line.kind = GLSLLineKind::OPTION_OFF;
+            }
+            StripComments(text, inComment);
+        }
+
+        line.text = std::move(text);
+        file->lines.push_back(std::move(line));
+    }
+    return file;
+}
+
+// ==================== 条件表达式 ====================
+
+// 递归下降求值，输入为已展开宏的记号序列
+class ExpressionEvaluator {
+public:
+    ExpressionEvaluator(const std::vector<const GLSLExprToken*>& tokens)
+        : tokens_(tokens), position_(0) {
+    }
+
+    bool Evaluate(double& result) {
+        position_ = 0;
+        if (!Ternary(result, 0)) {
+            return false;
+        }
+        if (Peek().type != GLSLExprToken::END) {
+            return Fail("条件表达式中有多余的记号");
+        }
+        return true;
+    }
+
+    const std::string& GetError() const { return error_; }
+
+private:
+    const std::vector<const GLSLExprToken*>& tokens_;
+    size_t position_;
+    std::string error_;
+
+    const GLSLExprToken& Peek() const {
+        return *tokens_[position_];
+    }
+
+    bool Accept(GLSLExprOp op) {
+        if (Peek().type == GLSLExprToken::OPERATOR && Peek().op == op) {
+            position_++;
+            return true;
+        }
+        return false;
+    }
+
+    bool Fail(const char* message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    static int64_t Int(double value) {
+        return static_cast<int64_t>(value);
+    }
+
+    // 二元运算符优先级，数值越大越优先
+    static int Precedence(GLSLExprOp op) {
+        switch (op) {
+            case GLSLExprOp::OR: return 1;
+            case GLSLExprOp::AND: return 2;
+            case GLSLExprOp::BITOR: return 3;
+            case GLSLExprOp::XOR: return 4;
+            case GLSLExprOp::BITAND: return 5;
+            case GLSLExprOp::EQ: case GLSLExprOp::NE: return 6;
+            case GLSLExprOp::LT: case GLSLExprOp::GT: case GLSLExprOp::LE: case GLSLExprOp::GE: return 7;
+            case GLSLExprOp::SHL: case GLSLExprOp::SHR: return 8;
+            case GLSLExprOp::ADD: case GLSLExprOp::SUB: return 9;
+            case GLSLExprOp::MUL: case GLSLExprOp::DIV: case GLSLExprOp::MOD: return 10;
+            default: return 0;
+        }
+    }
+
+    bool Ternary(double& value, int depth) {
+        if (depth > kMaxExpressionDepth) {
+            return Fail("条件表达式嵌套过深");
+        }
+        if (!Binary(value, 1, depth)) {
+            return false;
+        }
+        if (Accept(GLSLExprOp::QUESTION)) {
+            double whenTrue;
+            double whenFalse;
+            if (!Ternary(whenTrue, depth + 1)) {
+                return false;
+            }
+            if (!Accept(GLSLExprOp::COLON)) {
+                return Fail("条件表达式缺少':'");
+            }
+            if (!Ternary(whenFalse, depth + 1)) {
+                return false;
+            }
+            value = value != 0 ? whenTrue : whenFalse;
+        }
+        return true;
+    }
+
+    bool Binary(double& lhs, int minPrecedence, int depth) {
+        if (!Unary(lhs, depth)) {
+            return false;
+        }
+        while (Peek().type == GLSLExprToken::OPERATOR) {
+            GLSLExprOp op = Peek().op;
+            int precedence = Precedence(op);
+            if (precedence == 0 || precedence < minPrecedence) {
+                break;
+            }
+            position_++;
+            double rhs;
+            if (!Binary(rhs, precedence + 1, depth + 1)) {
+                return false;
+            }
+            if (!Apply(op, lhs, rhs)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Apply(GLSLExprOp op, double& lhs, double rhs) {
+        switch (op) {
+            case GLSLExprOp::OR: lhs = (lhs != 0 || rhs != 0) ? 1 : 0; break;
+            case GLSLExprOp::AND: lhs = (lhs != 0 && rhs != 0) ? 1 : 0; break;
+            case GLSLExprOp::BITOR: lhs = static_cast<double>(Int(lhs) | Int(rhs)); break;
+            case GLSLExprOp::XOR: lhs = static_cast<double>(Int(lhs) ^ Int(rhs)); break;
+            case GLSLExprOp::BITAND: lhs = static_cast<double>(Int(lhs) & Int(rhs)); break;
+            case GLSLExprOp::EQ: lhs = lhs == rhs ? 1 : 0; break;
+            case GLSLExprOp::NE: lhs = lhs != rhs ? 1 : 0; break;
+            case GLSLExprOp::LT: lhs = lhs < rhs ? 1 : 0; break;
+            case GLSLExprOp::GT: lhs = lhs > rhs ? 1 : 0; break;
+            case GLSLExprOp::LE: lhs = lhs <= rhs ? 1 : 0; break;
+            case GLSLExprOp::GE: lhs = lhs >= rhs ? 1 : 0; break;
+            case GLSLExprOp::SHL: lhs = static_cast<double>(Int(lhs) << (Int(rhs) & 63)); break;
+            case GLSLExprOp::SHR: lhs = static_cast<double>(Int(lhs) >> (Int(rhs) & 63)); break;
+            case GLSLExprOp::ADD: lhs = lhs + rhs; break;
+            case GLSLExprOp::SUB: lhs = lhs - rhs; break;
+            case GLSLExprOp::MUL: lhs = lhs * rhs; break;
+            case GLSLExprOp::DIV:
+            case GLSLExprOp::MOD: {
+                if (rhs == 0) {
+                    return Fail("条件表达式除以零");
+                }
+                bool integral = lhs == std::floor(lhs) && rhs == std::floor(rhs);
+                if (op == GLSLExprOp::MOD) {
+                    lhs = static_cast<double>(Int(lhs) % Int(rhs));
+                } else {
+                    lhs = integral ? static_cast<double>(Int(lhs) / Int(rhs)) : lhs / rhs;
+                }
+                break;
+            }
+            default:
+                return Fail("未知的运算符");
+        }
+        return true;
+    }
+
+    bool Unary(double& value, int depth) {
+        if (depth > kMaxExpressionDepth) {
+            return Fail("条件表达式嵌套过深");
+        }
+        if (Accept(GLSLExprOp::NOT)) {
+            if (!Unary(value, depth + 1)) return false;
+            value = value == 0 ? 1 : 0;
+            return true;
+        }
+        if (Accept(GLSLExprOp::BITNOT)) {
+            if (!Unary(value, depth + 1)) return false;
+            value = static_cast<double>(~Int(value));
+            return true;
+        }
+        if (Accept(GLSLExprOp::SUB)) {
+            if (!Unary(value, depth + 1)) return false;
+            value = -value;
+            return true;
+        }
+        if (Accept(GLSLExprOp::ADD)) {
+            return Unary(value, depth + 1);
+        }
+        if (Accept(GLSLExprOp::LPAREN)) {
+            if (!Ternary(value, depth + 1)) {
+                return false;
+            }
+            if (!Accept(GLSLExprOp::RPAREN)) {
+                return Fail("条件表达式缺少')'");
+            }
+            return true;
+        }
+        if (Peek().type == GLSLExprToken::NUMBER) {
+            value = Peek().number;
+            position_++;
+            return true;
+        }
+        return Fail("条件表达式不完整");
+    }
+};
+
+const GLSLExprToken kZeroToken = {GLSLExprToken::NUMBER, GLSLExprOp::NONE, 0.0, ""};
+const GLSLExprToken kOneToken = {GLSLExprToken::NUMBER, GLSLExprOp::NONE, 1.0, ""};
+const GLSLExprToken kEndToken = {GLSLExprToken::END, GLSLExprOp::NONE, 0.0, ""};
+
+} // namespace
+
+// ==================== GLSLPreprocessor ====================
+
+GLSLPreprocessor::GLSLPreprocessor(const std::string& shadersRoot)
+    : root_(fs::path(shadersRoot).lexically_normal().generic_string()), parseCount_(0) {
+    while (root_.size() > 1 && root_.back() == '/') {
+        root_.pop_back();
+    }
+}
+
+GLSLPreprocessor::~GLSLPreprocessor() {
+}
+
+void GLSLPreprocessor::Define(const std::string& name, const std::string& value) {
+    Macro macro;
+    macro.expression = LexExpression(value);
+    predefined_[name] = macro;
+}
+
+void GLSLPreprocessor::SetOption(const std::string& name, const std::string& value) {
+    Option option;
+    option.value = value;
+    option.expression = LexExpression(value);
+    options_[name] = option;
+}
+
+void GLSLPreprocessor::SetOptions(const std::unordered_map<std::string, std::string>& options) {
+    for (const auto& [name, value] : options) {
+        SetOption(name, value);
+    }
+}
+
+std::string GLSLPreprocessor::GetOptionState(const GLSLOptionReference& reference) const {
+    auto option = options_.find(reference.name);
+    bool enabled = option != options_.end() && option->second.value == "true";
+    if (reference.toggle) {
+        return enabled ? "on" : "off";
+    }
+    // #define行：未设置或"true"保留默认值，"false"注释掉，其余替换为选项值
+    if (option == options_.end() || enabled) {
+        return "default";
+    }
+    if (option->second.value == "false") {
+        return "off";
+    }
+    return "=" + option->second.value;
+}
+
+size_t GLSLPreprocessor::GetParseCount() const {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return parseCount_;
+}
+
+void GLSLPreprocessor::ClearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_.clear();
+}
+
+std::shared_ptr<const GLSLSourceFile> GLSLPreprocessor::LoadFile(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache_.find(path);
+        if (it != cache_.end()) {
+            return it->second;
+        }
+    }
+
+    // 读取与解析不持锁，其他线程可同时加载别的文件
+    std::string content;
+    if (!ReadWholeFile(path, content)) {
+        return nullptr;
+    }
+    std::shared_ptr<const GLSLSourceFile> file = ParseSource(path, content);
+
+    // 并发加载同一文件时保留先插入的结果，只统计进入缓存的解析
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto inserted = cache_.emplace(path, file);
+    if (inserted.second) {
+        parseCount_++;
+    }
+    return inserted.first->second;
+}
+
+std::string GLSLPreprocessor::ResolveInclude(const std::string& includer, const std::string& target) const {
+    // OptiFine约定："/"开头的路径相对于shaders目录
+    fs::path resolved;
+    if (!target.empty() && target[0] == '/') {
+        resolved = fs::path(root_ + target);
+    } else {
+        resolved = fs::path(includer).parent_path() / target;
+    }
+    return resolved.lexically_normal().generic_string();
+}
+
+bool GLSLPreprocessor::Process(const std::string& path, std::string& output, std::string* error,
+                               std::vector<GLSLOptionReference>* referencedOptions) {
+    std::string normalized = fs::path(path).lexically_normal().generic_string();
+    auto file = LoadFile(normalized);
+    if (!file) {
+        if (error) {
+            *error = "无法读取着色器: " + path;
+        }
+        return false;
+    }
+
+    ExpandState state;
+    state.macros = predefined_;
+    state.includeStack.push_back(normalized);
+    state.files.push_back(file);
+    state.referencedOptions = referencedOptions;
+
+    output.clear();
+    output.reserve(file->lines.size() * 48);
+    if (!ExpandFile(*file, state, output)) {
+        if (error) {
+            *error = std::move(state.error);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool GLSLPreprocessor::ExpandFile(const GLSLSourceFile& file, ExpandState& state, std::string& output) {
+    const size_t baseDepth = state.conditionals.size();
+    size_t lineNumber = 0;
+
+    auto fail = [&](const std::string& message) {
+        state.error = file.path + ":" + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    for (const GLSLLine& line : file.lines) {
+        lineNumber++;
+        switch (line.kind) {
+            case GLSLLineKind::IFDEF:
+            case GLSLLineKind::IFNDEF: {
+                bool parent = state.Active();
+                bool defined = state.macros.count(line.name) > 0;
+                bool active = parent && (line.kind == GLSLLineKind::IFDEF ? defined : !defined);
+                state.conditionals.push_back({parent, active, active, false});
+                continue;
+            }
+            case GLSLLineKind::IF: {
+                bool parent = state.Active();
+                bool active = false;
+                if (parent && !EvaluateCondition(*line.expression, state, active)) {
+                    return fail(state.error);
+                }
+                state.conditionals.push_back({parent, active, active, false});
+                continue;
+            }
+            case GLSLLineKind::ELIF: {
+                if (state.conditionals.size() <= baseDepth) {
+                    return fail("#elif缺少对应的#if");
+                }
+                GLSLConditional& conditional = state.conditionals.back();
+                if (conditional.sawElse) {
+                    return fail("#elif出现在#else之后");
+                }
+                bool active = false;
+                if (conditional.parentActive && !conditional.taken &&
+                    !EvaluateCondition(*line.expression, state, active)) {
+                    return fail(state.error);
+                }
+                conditional.active = active;
+                conditional.taken = conditional.taken || active;
+                continue;
+            }
+            case GLSLLineKind::ELSE: {
+                if (state.conditionals.size() <= baseDepth) {
+                    return fail("#else缺少对应的#if");
+                }
+                GLSLConditional& conditional = state.conditionals.back();
+                if (conditional.sawElse) {
+                    return fail("重复的#else");
+                }
+                conditional.active = conditional.parentActive && !conditional.taken;
+                conditional.taken = true;
+                conditional.sawElse = true;
+                continue;
+            }
+            case GLSLLineKind::ENDIF:
+                if (state.conditionals.size() <= baseDepth) {
+                    return fail("#endif缺少对应的#if");
+                }
+                state.conditionals.pop_back();
+                continue;
+            default:
+                break;
+        }
+
+        if (!state.Active()) {
+            continue;
+        }
+
+        switch (line.kind) {
+            case GLSLLineKind::DEFINE: {
+                Macro macro;
+                macro.expression = line.expression;
+                macro.functionLike = line.functionLike;
+                if (!line.functionLike && state.referencedOptions) {
+                    state.referencedOptions->push_back({line.name, false});
+                }
+                auto option = line.functionLike ? options_.end() : options_.find(line.name);
+                if (option == options_.end() || option->second.value == "true") {
+                    state.macros[line.name] = macro;
+                    output += line.text;
+                } else if (option->second.value == "false") {
+                    // 关闭开关选项
+                    state.macros.erase(line.name);
+                    output += "//";
+                    output += line.text;
+                } else {
+                    // 用选项值替换默认值
+                    macro.expression = option->second.expression;
+                    state.macros[line.name] = macro;
+                    output += "#define ";
+                    output += line.name;
+                    output += ' ';
+                    output += option->second.value;
+                }
+                output += '\n';
+                break;
+            }
+            case GLSLLineKind::OPTION_OFF: {
+                if (state.referencedOptions) {
+                    state.referencedOptions->push_back({line.name, true});
+                }
+                auto option = options_.find(line.name);
+                if (option != options_.end() && option->second.value == "true") {
+                    Macro macro;
+                    macro.expression = option->second.expression;
+                    state.macros[line.name] = macro;
+                    output += "#define ";
+                    output += line.name;
+                } else {
+                    output += line.text;
+                }
+                output += '\n';
+                break;
+            }
+            case GLSLLineKind::UNDEF:
+                state.macros.erase(line.name);
+                output += line.text;
+                output += '\n';
+                break;
+            case GLSLLineKind::INCLUDE: {
+                std::string target = ResolveInclude(file.path, line.argument);
+                if (state.includeStack.size() >= kMaxIncludeDepth) {
+                    return fail("包含层级过深: " + line.argument);
+                }
+                for (const std::string& including : state.includeStack) {
+                    if (including == target) {
+                        return fail("循环包含: " + line.argument);
+                    }
+                }
+                auto included = LoadFile(target);
+                if (!included) {
+                    return fail("找不到包含文件: " + line.argument);
+                }
+                state.includeStack.push_back(target);
+                state.files.push_back(included);
+                if (!ExpandFile(*included, state, output)) {
+                    return false;
+                }
+                state.includeStack.pop_back();
+                break;
+            }
+            case GLSLLineKind::ERROR_DIRECTIVE:
+                return fail(line.argument);
+            default:
+                output += line.text;
+                output += '\n';
+                break;
+        }
+    }
+
+    if (state.conditionals.size() != baseDepth) {
+        return fail("未闭合的#if");
+    }
+    return true;
+}
+
+bool GLSLPreprocessor::EvaluateCondition(const GLSLExpression& expression, ExpandState& state, bool& result) {
+    std::string error;
+
+    // 展开对象宏，正在展开的宏不再递归展开，未定义的标识符按0处理
+    std::function<bool(const GLSLExpression&)> expand = [&](const GLSLExpression& source) -> bool {
+        if (!source.error.empty()) {
+            error = source.error;
+            return false;
+        }
+        const std::vector<GLSLExprToken>& tokens = source.tokens;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            const GLSLExprToken& token = tokens[i];
+            if (token.type == GLSLExprToken::DEFINED) {
+                state.scratch.push_back(state.macros.count(token.name) ? &kOneToken : &kZeroToken);
+                continue;
+            }
+            if (token.type != GLSLExprToken::IDENTIFIER) {
+                state.scratch.push_back(&token);
+                continue;
+            }
+
+            auto macro = state.macros.find(token.name);
+            bool recursive = false;
+            for (const std::string* name : state.expanding) {
+                recursive = recursive || *name == token.name;
+            }
+            if (macro == state.macros.end() || recursive) {
+                state.scratch.push_back(&kZeroToken);
+                continue;
+            }
+            if (macro->second.functionLike) {
+                // 条件中不展开函数宏，跳过其实参并按0处理
+                if (i + 1 < tokens.size() && tokens[i + 1].type == GLSLExprToken::OPERATOR &&
+                    tokens[i + 1].op == GLSLExprOp::LPAREN) {
+                    int depth = 0;
+                    for (i++; i < tokens.size(); i++) {
+                        if (tokens[i].type != GLSLExprToken::OPERATOR) {
+                            continue;
+                        }
+                        if (tokens[i].op == GLSLExprOp::LPAREN) {
+                            depth++;
+                        } else if (tokens[i].op == GLSLExprOp::RPAREN && --depth == 0) {
+                            break;
+                        }
+                    }
+                }
+                state.scratch.push_back(&kZeroToken);
+                continue;
+            }
+            if (state.expanding.size() >= static_cast<size_t>(kMaxExpressionDepth)) {
+                error = "宏展开层级过深";
+                return false;
+            }
+            // 与C预处理器一致，按记号原样替换，不额外加括号
+            state.expanding.push_back(&token.name);
+            bool ok = expand(*macro->second.expression);
+            state.expanding.pop_back();
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    state.scratch.clear();
+    state.expanding.clear();
+    double value = 0;
+    bool ok = expand(expression);
+    if (ok) {
+        state.scratch.push_back(&kEndToken);
+        ExpressionEvaluator evaluator(state.scratch);
+        ok = evaluator.Evaluate(value);
+        if (!ok) {
+            error = evaluator.GetError();
+        }
+    }
+    if (!ok) {
+        state.error = "无法求值条件表达式: " + error;
+        return false;
+    }
+    result = value != 0;
+    return true;
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
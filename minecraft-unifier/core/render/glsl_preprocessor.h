@@ -0,0 +1,95 @@
+/**
+ * Minecraft Unifier - GLSL Preprocessor
+ * GLSL预处理器 - 展开OptiFine光影包的#include与条件编译，缓存已解析的包含文件
+ */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// 已解析的源文件（按行划分并识别指令，可被多个程序共享）
+struct GLSLSourceFile;
+
+// 预先记号化的条件表达式/宏值
+struct GLSLExpression;
+
+// 展开时查询过的选项
+struct GLSLOptionReference {
+    std::string name;
+    bool toggle;    // 注释掉的开关（//#define NAME），只区分是否为"true"
+
+    bool operator<(const GLSLOptionReference& other) const {
+        return name != other.name ? name < other.name : toggle < other.toggle;
+    }
+    bool operator==(const GLSLOptionReference& other) const {
+        return name == other.name && toggle == other.toggle;
+    }
+};
+
+// GLSL预处理器
+class GLSLPreprocessor {
+public:
+    // shadersRoot：光影包shaders目录，"/lib/x.glsl"形式的包含路径相对于它解析
+    explicit GLSLPreprocessor(const std::string& shadersRoot);
+    ~GLSLPreprocessor();
+
+    // 预定义宏（对所有程序生效）
+    void Define(const std::string& name, const std::string& value = "");
+
+    // 设置选项值，覆盖源码中同名的#define（"true"/"false"切换开关选项）
+    void SetOption(const std::string& name, const std::string& value);
+    void SetOptions(const std::unordered_map<std::string, std::string>& options);
+
+    // 展开单个程序，成功返回true；失败时error非空则写入本次调用的错误信息（可多线程同时调用）
+    // referencedOptions非空时记录展开过程中查询过的选项（可能重复），
+    // 这些选项的GetOptionState()不变时展开结果不变
+    bool Process(const std::string& path, std::string& output, std::string* error = nullptr,
+                 std::vector<GLSLOptionReference>* referencedOptions = nullptr);
+
+    // 选项对展开结果的实际作用（未设置与"true"等价）
+    std::string GetOptionState(const GLSLOptionReference& reference) const;
+
+    // 实际解析的文件数（缓存命中不计入）
+    size_t GetParseCount() const;
+
+    // 清除包含文件缓存
+    void ClearCache();
+
+private:
+    struct Macro {
+        std::shared_ptr<const GLSLExpression> expression;
+        bool functionLike = false;
+    };
+
+    struct Option {
+        std::string value;
+        std::shared_ptr<const GLSLExpression> expression;
+    };
+
+    struct ExpandState;
+
+    std::string root_;
+    std::unordered_map<std::string, Macro> predefined_;
+    std::unordered_map<std::string, Option> options_;
+
+    mutable std::mutex cacheMutex_;
+    std::unordered_map<std::string, std::shared_ptr<const GLSLSourceFile>> cache_;
+    size_t parseCount_;
+
+    std::shared_ptr<const GLSLSourceFile> LoadFile(const std::string& path);
+    std::string ResolveInclude(const std::string& includer, const std::string& target) const;
+    bool ExpandFile(const GLSLSourceFile& file, ExpandState& state, std::string& output);
+    bool EvaluateCondition(const GLSLExpression& expression, ExpandState& state, bool& result);
+};
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,477 @@
+/**
+ * Minecraft Unifier - GLSL Rewriter Implementation
+ * GLSL改写器实现 - 按首字符分派的单遍扫描，替换规则由映射表驱动
+ */
+
+#include "glsl_rewriter.h"
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+// 声明映射：关键字 类型 名称; → 替换文本
+struct DeclMapping {
+    const char* type;
+    const char* name;
+    const char* replacement;
+};
+
+// 函数调用映射：名称\s*( → 替换文本
+struct CallMapping {
+    const char* name;
+    const char* replacement;
+};
+
+const DeclMapping kUniformMappings[] = {
+    // 矩阵
+    {"mat4", "gbufferModelView", "uniform mat4 u_modelViewMatrix;"},
+    {"mat4", "gbufferProjection", "uniform mat4 u_projectionMatrix;"},
+    {"mat4", "gbufferProjectionInverse", "uniform mat4 u_projectionMatrixInverse;"},
+    {"mat4", "gbufferModelViewInverse", "uniform mat4 u_modelViewMatrixInverse;"},
+    {"mat4", "gbufferPreviousModelView", "uniform mat4 u_previousModelViewMatrix;"},
+    {"mat4", "gbufferPreviousProjection", "uniform mat4 u_previousProjectionMatrix;"},
+    {"mat4", "gbufferTextureMatrix", "uniform mat4 u_textureMatrix;"},
+    // 时间
+    {"float", "frameTimeCounter", "uniform float u_time;"},
+    {"float", "sunAngle", "uniform float u_sunAngle;"},
+    {"float", "shadowAngle", "uniform float u_shadowAngle;"},
+    // 视口
+    {"vec2", "viewWidth", "uniform vec2 u_viewportSize;"},
+    {"vec2", "viewHeight", "uniform vec2 u_viewportSize;"},
+    // 相机
+    {"vec3", "cameraPosition", "uniform vec3 u_cameraPosition;"},
+    {"vec3", "previousCameraPosition", "uniform vec3 u_previousCameraPosition;"},
+    // 光照
+    {"vec3", "sunPosition", "uniform vec3 u_sunPosition;"},
+    {"vec3", "moonPosition", "uniform vec3 u_moonPosition;"},
+    {"vec3", "shadowLightPosition", "uniform vec3 u_shadowLightPosition;"},
+    // 纹理采样器
+    {"sampler2D", "texture", "uniform sampler2D u_texture;"},
+    {"sampler2D", "normals", "uniform sampler2D u_normalMap;"},
+    {"sampler2D", "specular", "uniform sampler2D u_specularMap;"},
+    {"sampler2D", "shadow", "uniform sampler2D u_shadowMap;"},
+    {"sampler2D", "shadowcolor0", "uniform sampler2D u_shadowColorMap;"},
+    {"sampler2D", "shadowcolor1", "uniform sampler2D u_shadowColorMap1;"},
+};
+
+// 仅顶点着色器
+const DeclMapping kAttributeMappings[] = {
+    {"vec3", "position", "in vec3 a_position;"},
+    {"vec4", "color", "in vec4 a_color;"},
+    {"vec2", "texcoord", "in vec2 a_texCoord;"},
+    {"vec2", "lmcoord", "in vec2 a_lightMapCoord;"},
+    {"vec3", "normal", "in vec3 a_normal;"},
+    {"vec4", "tangent", "in vec4 a_tangent;"},
+};
+
+const CallMapping kCallMappings[] = {
+    {"texture2D", "texture("},
+    {"texture2DLod", "textureLod("},
+    {"shadow2D", "texture("},
+    {"shadow2DLod", "textureLod("},
+};
+
+const char kVersionReplacement[] = "#version 330 core";
+const char kFragColorDecl[] = "out vec4 fragColor;";
+
+// core profile没有gl_ModelViewMatrix/gl_Vertex，ftransform()改用映射后的矩阵与属性
+const char kFTransformReplacement[] = "(u_projectionMatrix * u_modelViewMatrix * vec4(a_position, 1.0))";
+const char* const kFTransformDecls[] = {
+    "uniform mat4 u_projectionMatrix;",
+    "uniform mat4 u_modelViewMatrix;",
+    "in vec3 a_position;",
+};
+
+// 与std::regex的\s、\w字符类保持一致
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline bool IsWord(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && IsSpace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+inline const char* SkipWord(const char* p, const char* end) {
+    while (p < end && IsWord(*p)) {
+        p++;
+    }
+    return p;
+}
+
+inline bool HasLiteral(const char* p, const char* end, const char* literal, size_t length) {
+    return static_cast<size_t>(end - p) >= length && std::memcmp(p, literal, length) == 0;
+}
+
+// 追加标识符，片段着色器中将gl_FragColor改为fragColor
+void AppendIdentifier(std::string& out, std::string_view word, bool renameFragColor) {
+    static const std::string_view kFragColor = "gl_FragColor";
+    if (!renameFragColor) {
+        out.append(word);
+        return;
+    }
+    size_t start = 0;
+    size_t pos;
+    while ((pos = word.find(kFragColor, start)) != std::string_view::npos) {
+        out.append(word.substr(start, pos - start));
+        out.append("fragColor");
+        start = pos + kFragColor.size();
+    }
+    out.append(word.substr(start));
+}
+
+class Rewriter {
+public:
+    Rewriter(const std::string& source, ShaderStage stage)
+        : begin_(source.data()), end_(source.data() + source.size()),
+          vertex_(stage == ShaderStage::VERTEX), fragment_(stage == ShaderStage::FRAGMENT),
+          versionEnd_(std::string::npos), usesFTransform_(false), structEnd_(nullptr) {
+        // 只有可能开始一次匹配的首字符才需要尝试规则
+        std::memset(trigger_, 0, sizeof(trigger_));
+        trigger_[static_cast<unsigned char>('#')] = true;
+        trigger_[static_cast<unsigned char>('u')] = true;
+        trigger_[static_cast<unsigned char>('f')] = true;
+        trigger_[static_cast<unsigned char>('t')] = true;
+        trigger_[static_cast<unsigned char>('s')] = true;
+        trigger_[static_cast<unsigned char>('a')] = vertex_;
+        trigger_[static_cast<unsigned char>('v')] = vertex_ || fragment_;
+        trigger_[static_cast<unsigned char>('g')] = fragment_;
+    }
+
+    std::string Run() {
+        std::string out;
+        out.reserve((end_ - begin_) + (end_ - begin_) / 8 + sizeof(kFragColorDecl) + 1);
+
+        const char* copyFrom = begin_;
+        const char* p = begin_;
+        while (p < end_) {
+            if (!trigger_[static_cast<unsigned char>(*p)]) {
+                p++;
+                continue;
+            }
+            const char* next = Match(p);
+            if (!next) {
+                p++;
+                continue;
+            }
+            out.append(copyFrom, p - copyFrom);
+            out.append(replacement_);
+            if (*p == '#' && versionEnd_ == std::string::npos) {
+                versionEnd_ = out.size();
+            }
+            p = next;
+            copyFrom = p;
+        }
+        out.append(copyFrom, end_ - copyFrom);
+
+        // 补充缺少的声明：如果没有定义fragColor，添加它；ftransform()需要矩阵与位置属性
+        std::string header;
+        if (fragment_ && out.find(kFragColorDecl) == std::string::npos) {
+            header += kFragColorDecl;
+            header += '\n';
+        }
+        if (vertex_ && usesFTransform_) {
+            for (const char* decl : kFTransformDecls) {
+                if (out.find(decl) == std::string::npos) {
+                    header += decl;
+                    header += '\n';
+                }
+            }
+        }
+        if (!header.empty()) {
+            out.insert(HeaderPosition(out), header);
+        }
+        return out;
+    }
+
+private:
+    const char* begin_;
+    const char* end_;
+    bool vertex_;
+    bool fragment_;
+    bool trigger_[256];
+    std::string replacement_;
+    size_t versionEnd_;         // 输出中#version指令的结束位置
+    bool usesFTransform_;
+    const char* structEnd_;     // 当前结构体定义的'}'，其中的字段声明不改名
+    std::vector<std::pair<std::string_view, std::string_view>> renames_;  // 已改名的声明：原名 → 新名
+
+    // #version必须是第一条语句，声明插在它及紧随的#extension之后
+    size_t HeaderPosition(std::string& out) const {
+        if (versionEnd_ == std::string::npos) {
+            return 0;
+        }
+        size_t pos = out.find('\n', versionEnd_);
+        if (pos == std::string::npos) {
+            out.push_back('\n');
+            return out.size();
+        }
+        pos++;
+        while (true) {
+            size_t start = out.find_first_not_of(" \t", pos);
+            if (start == std::string::npos || out.compare(start, 10, "#extension") != 0) {
+                return pos;
+            }
+            size_t lineEnd = out.find('\n', start);
+            if (lineEnd == std::string::npos) {
+                out.push_back('\n');
+                return out.size();
+            }
+            pos = lineEnd + 1;
+        }
+    }
+
+    // 尝试在p处匹配任一规则，成功时返回匹配结束位置并填充replacement_
+    const char* Match(const char* p) {
+        const char* next = MatchRule(p);
+        return next ? next : MatchRename(p);
+    }
+
+    const char* MatchRule(const char* p) {
+        switch (*p) {
+            case '#':
+                return MatchVersion(p);
+            case 'u':
+                return MatchDecl(p, "uniform", kUniformMappings, std::size(kUniformMappings));
+            // 改名的引用也会打开这些首字符，阶段相关的规则需再判断阶段
+            case 'a':
+                return vertex_ ? MatchDecl(p, "attribute", kAttributeMappings, std::size(kAttributeMappings)) : nullptr;
+            case 'v':
+                return vertex_ || fragment_ ? MatchVarying(p) : nullptr;
+            case 'g':
+                return fragment_ ? MatchLiteral(p, "gl_FragColor", "fragColor") : nullptr;
+            case 'f': {
+                const char* next = MatchLiteral(p, "ftransform()", kFTransformReplacement);
+                usesFTransform_ = usesFTransform_ || next != nullptr;
+                return next;
+            }
+            case 's':
+                SkipStructBody(p);
+                return MatchCall(p);
+            case 't':
+                return MatchCall(p);
+            default:
+                return nullptr;
+        }
+    }
+
+    // #version\s+\d+([ \t]+(core|compatibility|es))? 不吞掉行尾换行
+    const char* MatchVersion(const char* p) {
+        static const char kKeyword[] = "#version";
+        if (!HasLiteral(p, end_, kKeyword, sizeof(kKeyword) - 1)) {
+            return nullptr;
+        }
+        const char* q = p + sizeof(kKeyword) - 1;
+        const char* r = SkipSpaces(q, end_);
+        if (r == q) {
+            return nullptr;
+        }
+        q = r;
+        while (r < end_ && IsDigit(*r)) {
+            r++;
+        }
+        if (r == q) {
+            return nullptr;
+        }
+        replacement_.assign(kVersionReplacement);
+        q = r;
+        while (r < end_ && (*r == ' ' || *r == '\t')) {
+            r++;
+        }
+        if (r == q) {
+            return q;
+        }
+        static const char* const kProfiles[] = {"core", "compatibility", "es"};
+        for (const char* profile : kProfiles) {
+            size_t length = std::strlen(profile);
+            if (HasLiteral(r, end_, profile, length) && (r + length == end_ || !IsWord(r[length]))) {
+                return r + length;
+            }
+        }
+        return q;
+    }
+
+    // 关键字\s+类型\s+名称; 按映射表整体替换
+    const char* MatchDecl(const char* p, const char* keyword, const DeclMapping* mappings, size_t count) {
+        std::string_view type;
+        std::string_view name;
+        const char* next = MatchDeclShape(p, keyword, type, name);
+        if (!next) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (type == mappings[i].type && name == mappings[i].name) {
+                replacement_.assign(mappings[i].replacement);
+                AddRename(mappings[i]);
+                return next;
+            }
+        }
+        return nullptr;
+    }
+
+    // 声明改名后，之后对该变量的引用随之改名
+    void AddRename(const DeclMapping& mapping) {
+        std::string_view replacement(mapping.replacement);
+        size_t start = replacement.rfind(' ') + 1;
+        renames_.emplace_back(mapping.name, replacement.substr(start, replacement.size() - start - 1));
+        trigger_[static_cast<unsigned char>(mapping.name[0])] = true;
+    }
+
+    // 完整标识符，不是函数调用也不是成员访问（结构体字段、分量）：\b名称\b(?!\s*\()，且前面不是'.'
+    const char* MatchRename(const char* p) {
+        if (renames_.empty() || (p > begin_ && IsWord(p[-1])) || p < structEnd_) {
+            return nullptr;
+        }
+        const char* before = p;
+        while (before > begin_ && IsSpace(before[-1])) {
+            before--;
+        }
+        if (before > begin_ && before[-1] == '.') {
+            return nullptr;
+        }
+        const char* q = SkipWord(p, end_);
+        std::string_view word(p, q - p);
+        for (const auto& [from, to] : renames_) {
+            if (word != from) {
+                continue;
+            }
+            const char* r = SkipSpaces(q, end_);
+            if (r < end_ && *r == '(') {
+                return nullptr;
+            }
+            replacement_.assign(to);
+            return q;
+        }
+        return nullptr;
+    }
+
+    // struct关键字：记录结构体体的结束位置（GLSL结构体内不能再有花括号）
+    void SkipStructBody(const char* p) {
+        static const char kStruct[] = "struct";
+        const size_t length = sizeof(kStruct) - 1;
+        if ((p > begin_ && IsWord(p[-1])) || !HasLiteral(p, end_, kStruct, length) ||
+            (p + length < end_ && IsWord(p[length]))) {
+            return;
+        }
+        const void* close = std::memchr(p, '}', end_ - p);
+        structEnd_ = close ? static_cast<const char*>(close) : end_;
+    }
+
+    // varying\s+(\w+)\s+(\w+); → out/in $1 $2;
+    const char* MatchVarying(const char* p) {
+        std::string_view type;
+        std::string_view name;
+        const char* next = MatchDeclShape(p, "varying", type, name);
+        if (!next) {
+            return nullptr;
+        }
+        replacement_.assign(vertex_ ? "out " : "in ");
+        AppendIdentifier(replacement_, type, fragment_);
+        replacement_.push_back(' ');
+        AppendIdentifier(replacement_, name, fragment_);
+        replacement_.push_back(';');
+        return next;
+    }
+
+    const char* MatchDeclShape(const char* p, const char* keyword, std::string_view& type, std::string_view& name) {
+        size_t keywordLength = std::strlen(keyword);
+        if (!HasLiteral(p, end_, keyword, keywordLength)) {
+            return nullptr;
+        }
+        const char* q = p + keywordLength;
+        const char* r = SkipSpaces(q, end_);
+        if (r == q) {
+            return nullptr;
+        }
+        q = SkipWord(r, end_);
+        if (q == r) {
+            return nullptr;
+        }
+        type = std::string_view(r, q - r);
+        r = SkipSpaces(q, end_);
+        if (r == q) {
+            return nullptr;
+        }
+        q = SkipWord(r, end_);
+        if (q == r || q == end_ || *q != ';') {
+            return nullptr;
+        }
+        name = std::string_view(r, q - r);
+        return q + 1;
+    }
+
+    const char* MatchLiteral(const char* p, const char* literal, const char* replacement) {
+        size_t length = std::strlen(literal);
+        if (!HasLiteral(p, end_, literal, length)) {
+            return nullptr;
+        }
+        replacement_.assign(replacement);
+        return p + length;
+    }
+
+    // 名称\s*\(
+    const char* MatchCall(const char* p) {
+        for (const CallMapping& mapping : kCallMappings) {
+            size_t length = std::strlen(mapping.name);
+            if (!HasLiteral(p, end_, mapping.name, length)) {
+                continue;
+            }
+            const char* q = SkipSpaces(p + length, end_);
+            if (q < end_ && *q == '(') {
+                replacement_.assign(mapping.replacement);
+                return q + 1;
+            }
+            // 原替换链先展开ftransform()，其结果以"("开头，会再被视为调用
+            static const char kFTransform[] = "ftransform()";
+            if (HasLiteral(q, end_, kFTransform, sizeof(kFTransform) - 1)) {
+                replacement_.assign(mapping.replacement);
+                replacement_.append(kFTransformReplacement + 1);
+                usesFTransform_ = true;
+                return q + sizeof(kFTransform) - 1;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace
+
+std::string RewriteGLSLForRenderDragon(const std::string& source, ShaderStage stage) {
+    return Rewriter(source, stage).Run();
+}
+
+ShaderStage ShaderStageFromPath(const std::string& path) {
+    std::string ext = fs::path(path).extension().string();
+    if (ext == ".fsh") {
+        return ShaderStage::FRAGMENT;
+    } else if (ext == ".gsh") {
+        return ShaderStage::GEOMETRY;
+    } else if (ext == ".csh") {
+        return ShaderStage::COMPUTE;
+    }
+    return ShaderStage::VERTEX;
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,22 @@
+/**
+ * Minecraft Unifier - GLSL Rewriter
+ * GLSL改写器 - 单遍扫描，将Java版光影语法改写为Render Dragon格式
+ */
+
+#pragma once
+#include "shader_converter.h"
+#include <string>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// 单遍改写GLSL源码为GLSL 330 core，补充的声明插在#version行之后
+std::string RewriteGLSLForRenderDragon(const std::string& source, ShaderStage stage);
+
+// 根据文件扩展名推断着色器阶段（.vsh/.fsh/.gsh/.csh，其余视为顶点）
+ShaderStage ShaderStageFromPath(const std::string& path);
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,680 @@
+/**
+ * Minecraft Unifier - Shader Cache Implementation
+ * 着色器缓存实现
+ */
+
+#include "shader_cache.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+// 主文件布局：头部 | 条目数据 | 索引（按键升序）
+const char kCacheMagic[8] = {'M', 'C', 'U', 'S', 'H', 'C', 'H', 'E'};
+const uint32_t kCacheFormatVersion = 2;
+const size_t kCacheHeaderSize = 48;
+const size_t kCacheIndexEntrySize = 32;     // key | offset | size | crc | lastUse
+
+// 日志记录：magic | size | key | lastUse | crc | 记录头crc | 条目数据
+const uint32_t kJournalMagic = 0x4A55434D;  // "MCUJ"
+const size_t kJournalRecordHeaderSize = 32;
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    return static_cast<uint32_t>(crc32(crc, data, static_cast<uInt>(size)));
+}
+
+template <typename T>
+T ReadValue(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void WriteValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void WriteString(std::vector<uint8_t>& out, const std::string& value) {
+    WriteValue<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// 带边界检查的顺序读取
+struct EntryReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    
+    template <typename T>
+    bool Read(T& value) {
+        if (size - pos < sizeof(T)) {
+            return false;
+        }
+        value = ReadValue<T>(data + pos);
+        pos += sizeof(T);
+        return true;
+    }
+    
+    bool ReadString(std::string& value) {
+        uint32_t length;
+        if (!Read(length) || size - pos < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+};
+
+void SerializeShader(const ShaderInfo& shader, std::vector<uint8_t>& out) {
+    WriteValue<uint32_t>(out, static_cast<uint32_t>(shader.stage));
+    WriteString(out, shader.entryPoint);
+    WriteString(out, shader.source);
+    WriteValue<uint32_t>(out, static_cast<uint32_t>(shader.spirv.size()));
+    const uint8_t* words = reinterpret_cast<const uint8_t*>(shader.spirv.data());
+    out.insert(out.end(), words, words + shader.spirv.size() * sizeof(uint32_t));
+    for (const auto* table : {&shader.uniforms, &shader.attributes}) {
+        WriteValue<uint32_t>(out, static_cast<uint32_t>(table->size()));
+        for (const auto& [name, location] : *table) {
+            WriteString(out, name);
+            WriteValue<int32_t>(out, location);
+        }
+    }
+}
+
+// 内存占用估算（用于内存预算）
+size_t EstimateShaderSize(const ShaderInfo& shader) {
+    size_t bytes = sizeof(ShaderInfo) + shader.entryPoint.size() + shader.source.size() +
+                   shader.spirv.size() * sizeof(uint32_t);
+    for (const auto* table : {&shader.uniforms, &shader.attributes}) {
+        for (const auto& [name, location] : *table) {
+            bytes += name.size() + sizeof(location) + 32;
+        }
+    }
+    return bytes;
+}
+
+bool DeserializeShader(const uint8_t* data, size_t size, ShaderInfo& shader) {
+    EntryReader reader{data, size, 0};
+    uint32_t stage;
+    uint32_t spirvCount;
+    if (!reader.Read(stage) || stage > static_cast<uint32_t>(ShaderStage::COMPUTE) ||
+        !reader.ReadString(shader.entryPoint) || !reader.ReadString(shader.source) ||
+        !reader.Read(spirvCount) || (size - reader.pos) / sizeof(uint32_t) < spirvCount) {
+        return false;
+    }
+    shader.stage = static_cast<ShaderStage>(stage);
+    shader.spirv.resize(spirvCount);
+    if (spirvCount > 0) {
+        std::memcpy(shader.spirv.data(), data + reader.pos, spirvCount * sizeof(uint32_t));
+    }
+    reader.pos += spirvCount * sizeof(uint32_t);
+    
+    for (auto* table : {&shader.uniforms, &shader.attributes}) {
+        uint32_t count;
+        if (!reader.Read(count)) {
+            return false;
+        }
+        table->clear();
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name;
+            int32_t location;
+            if (!reader.ReadString(name) || !reader.Read(location)) {
+                return false;
+            }
+            (*table)[name] = location;
+        }
+    }
+    return reader.pos == size;
+}
+
+} // namespace
+
+uint64_t ComputeShaderCacheKey(const std::string& source, ShaderStage stage,
+                               const std::string& options) {
+    // FNV-1a 64位，各字段带长度前缀避免拼接歧义
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    uint32_t header[4] = {kShaderConverterVersion, static_cast<uint32_t>(stage),
+                          static_cast<uint32_t>(options.size()),
+                          static_cast<uint32_t>(source.size())};
+    mix(header, sizeof(header));
+    mix(options.data(), options.size());
+    mix(source.data(), source.size());
+    return hash;
+}
+
+ShaderCache::ShaderCache()
+    : clock_(0)
+    , memoryBytes_(0)
+    , memoryBudget_(0)
+    , diskBudget_(0)
+    , mapped_(std::make_unique<common::MappedFile>())
+    , index_(nullptr)
+    , indexCount_(0)
+    , journal_(std::make_unique<common::MappedFile>())
+    , journalSize_(0) {
+    cachePath_ = fs::temp_directory_path().string() + "/shader_cache";
+    fs::create_directories(cachePath_);
+}
+
+ShaderCache::~ShaderCache() {
+    WaitForCompaction();
+    bool dirty;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty = !pending_.empty();
+    }
+    if (dirty) {
+        SaveToDisk(cachePath_ + "/cache.bin");
+        WaitForCompaction();
+    }
+}
+
+bool ShaderCache::HasCached(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StoredEntry stored;
+    return cache_.find(key) != cache_.end() || FindStored(key, stored);
+}
+
+bool ShaderCache::GetCached(uint64_t key, ShaderInfo& shader) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        Touch(key, it->second);
+        shader = it->second.shader;
+        stats_.hits++;
+        return true;
+    }
+    
+    // 按需从映射文件解码
+    StoredEntry stored;
+    ShaderInfo decoded;
+    if (!FindStored(key, stored) || Crc32(stored.payload, stored.size) != stored.crc ||
+        !DeserializeShader(stored.payload, stored.size, decoded)) {
+        stats_.misses++;
+        return false;
+    }
+    shader = decoded;
+    Insert(key, std::move(decoded));
+    stats_.hits++;
+    return true;
+}
+
+void ShaderCache::SetCached(uint64_t key, const ShaderInfo& shader) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 键由内容决定，磁盘上已有的条目无需再次写入
+    StoredEntry stored;
+    if (!FindStored(key, stored)) {
+        pending_.insert(key);
+    }
+    Insert(key, shader);
+}
+
+void ShaderCache::Clear() {
+    WaitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    lru_.clear();
+    pending_.clear();
+    lastUse_.clear();
+    memoryBytes_ = 0;
+    ReleaseMappings();
+}
+
+size_t ShaderCache::GetEntryCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = cache_.size();
+    for (size_t i = 0; i < indexCount_; i++) {
+        uint64_t key = ReadValue<uint64_t>(index_ + i * kCacheIndexEntrySize);
+        if (cache_.find(key) == cache_.end() && journalIndex_.find(key) == journalIndex_.end()) {
+            count++;
+        }
+    }
+    for (const auto& [key, stored] : journalIndex_) {
+        if (cache_.find(key) == cache_.end()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ShaderCache::SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memoryBudget_ = bytes;
+    EvictToBudget();
+}
+
+void ShaderCache::SetDiskBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    diskBudget_ = bytes;
+}
+
+ShaderCacheStats ShaderCache::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ShaderCacheStats stats = stats_;
+    stats.memoryBytes = memoryBytes_;
+    stats.journalBytes = journalSize_;
+    stats.diskBytes = mapped_->Size() + journalSize_;
+    return stats;
+}
+
+bool ShaderCache::SaveToDisk(const std::string& cachePath) {
+    WaitForCompaction();
+    
+    bool needCompaction;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        needCompaction = mappedPath_ != cachePath;
+        if (!needCompaction) {
+            // 增量保存：只追加新条目
+            if (!AppendJournal()) {
+                return false;
+            }
+            size_t mainSize = mapped_->Size();
+            bool overBudget = diskBudget_ > 0 && mainSize + journalSize_ > diskBudget_;
+            if (journalSize_ <= mainSize / 2 && !overBudget) {
+                return true;
+            }
+        }
+    }
+    
+    // 首次保存或换了路径时同步写入完整主文件
+    if (needCompaction) {
+        return Compact(cachePath);
+    }
+    
+    // 日志过大或超出磁盘预算时后台压缩
+    // 使用独立线程而非线程池，避免在池内线程中等待压缩时死锁
+    std::lock_guard<std::mutex> lock(compactionMutex_);
+    compaction_ = std::async(std::launch::async, [this, cachePath]() {
+        return Compact(cachePath);
+    });
+    return true;
+}
+
+bool ShaderCache::LoadFromDisk(const std::string& cachePath) {
+    WaitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return MapFile(cachePath);
+}
+
+bool ShaderCache::Compact(const std::string& cachePath) {
+    std::vector<uint8_t> data(kCacheHeaderSize, 0);
+    std::vector<uint64_t> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        // 收集全部条目：日志覆盖主文件，尚未落盘的条目现场序列化
+        std::vector<StoredEntry> entries;
+        std::vector<std::vector<uint8_t>> serialized;
+        auto lastUseOf = [this](uint64_t key, uint64_t stored) {
+            auto it = lastUse_.find(key);
+            return it != lastUse_.end() ? it->second : stored;
+        };
+        for (size_t i = 0; i < indexCount_; i++) {
+            StoredEntry entry = ReadIndexEntry(i);
+            if (journalIndex_.find(entry.key) == journalIndex_.end()) {
+                entries.push_back(entry);
+            }
+        }
+        for (const auto& [key, entry] : journalIndex_) {
+            entries.push_back(entry);
+        }
+        for (const auto& [key, entry] : cache_) {
+            StoredEntry stored;
+            if (FindStored(key, stored)) {
+                continue;
+            }
+            serialized.emplace_back();
+            SerializeShader(entry.shader, serialized.back());
+            const std::vector<uint8_t>& payload = serialized.back();
+            entries.push_back({key, payload.data(), static_cast<uint32_t>(payload.size()),
+                               Crc32(payload.data(), payload.size()), 0});
+        }
+        
+        // 丢弃已损坏的条目
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const StoredEntry& entry) {
+            return Crc32(entry.payload, entry.size) != entry.crc;
+        }), entries.end());
+        for (StoredEntry& entry : entries) {
+            entry.lastUse = lastUseOf(entry.key, entry.lastUse);
+            snapshot.push_back(entry.key);
+        }
+        
+        // 超出磁盘预算时只保留最近使用的条目
+        if (diskBudget_ > 0) {
+            std::sort(entries.begin(), entries.end(), [](const StoredEntry& a, const StoredEntry& b) {
+                return a.lastUse > b.lastUse;
+            });
+            size_t total = kCacheHeaderSize;
+            size_t kept = 0;
+            for (; kept < entries.size(); kept++) {
+                size_t bytes = entries[kept].size + kCacheIndexEntrySize + 8;
+                if (total + bytes > diskBudget_) {
+                    break;
+                }
+                total += bytes;
+            }
+            stats_.diskEvictions += entries.size() - kept;
+            entries.resize(kept);
+        }
+        
+        // 条目数据
+        std::sort(entries.begin(), entries.end(), [](const StoredEntry& a, const StoredEntry& b) {
+            return a.key < b.key;
+        });
+        std::vector<uint64_t> offsets;
+        offsets.reserve(entries.size());
+        for (const StoredEntry& entry : entries) {
+            offsets.push_back(data.size());
+            data.insert(data.end(), entry.payload, entry.payload + entry.size);
+        }
+        
+        // 索引按8字节对齐，加载时可直接二分查找
+        data.resize((data.size() + 7) & ~static_cast<size_t>(7), 0);
+        uint64_t indexOffset = data.size();
+        for (size_t i = 0; i < entries.size(); i++) {
+            WriteValue<uint64_t>(data, entries[i].key);
+            WriteValue<uint64_t>(data, offsets[i]);
+            WriteValue<uint32_t>(data, entries[i].size);
+            WriteValue<uint32_t>(data, entries[i].crc);
+            WriteValue<uint64_t>(data, entries[i].lastUse);
+        }
+        
+        // 头部
+        std::vector<uint8_t> header;
+        header.insert(header.end(), kCacheMagic, kCacheMagic + sizeof(kCacheMagic));
+        WriteValue<uint32_t>(header, kCacheFormatVersion);
+        WriteValue<uint32_t>(header, kShaderConverterVersion);
+        WriteValue<uint64_t>(header, indexOffset);
+        WriteValue<uint64_t>(header, data.size());
+        WriteValue<uint32_t>(header, static_cast<uint32_t>(entries.size()));
+        WriteValue<uint32_t>(header, Crc32(data.data() + indexOffset, data.size() - indexOffset));
+        WriteValue<uint32_t>(header, 0);
+        WriteValue<uint32_t>(header, Crc32(header.data(), header.size()));
+        std::copy(header.begin(), header.end(), data.begin());
+    }
+    
+    // 写入临时文件时不持锁，查询可继续使用旧映射
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file.good()) {
+            return false;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Windows下被映射的文件不能被替换，先解除映射，替换后映射新文件
+    std::string previousPath = mappedPath_;
+    ReleaseMappings();
+    std::error_code ec;
+    fs::rename(tempPath, cachePath, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        if (!previousPath.empty()) {
+            MapFile(previousPath);
+        }
+        return false;
+    }
+    
+    // 新主文件已包含日志中的全部条目
+    fs::remove(cachePath + ".journal", ec);
+    for (uint64_t key : snapshot) {
+        pending_.erase(key);
+    }
+    stats_.compactions++;
+    if (!MapFile(cachePath)) {
+        return false;
+    }
+    
+    // 写入磁盘的条目可以淘汰了
+    EvictToBudget();
+    return true;
+}
+
+void ShaderCache::WaitForCompaction() {
+    std::lock_guard<std::mutex> lock(compactionMutex_);
+    if (compaction_.valid()) {
+        compaction_.get();
+    }
+}
+
+bool ShaderCache::MapFile(const std::string& cachePath) {
+    auto mapped = std::make_unique<common::MappedFile>();
+    if (!mapped->Open(cachePath) || mapped->Size() < kCacheHeaderSize) {
+        return false;
+    }
+    
+    // 校验头部
+    const uint8_t* data = mapped->Data();
+    size_t size = mapped->Size();
+    if (std::memcmp(data, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        ReadValue<uint32_t>(data + 8) != kCacheFormatVersion ||
+        ReadValue<uint32_t>(data + 12) != kShaderConverterVersion ||
+        ReadValue<uint32_t>(data + 44) != Crc32(data, 44)) {
+        return false;
+    }
+    uint64_t indexOffset = ReadValue<uint64_t>(data + 16);
+    uint64_t fileSize = ReadValue<uint64_t>(data + 24);
+    uint32_t count = ReadValue<uint32_t>(data + 32);
+    if (fileSize != size || indexOffset < kCacheHeaderSize || indexOffset % 8 != 0 ||
+        indexOffset > size || (size - indexOffset) != count * kCacheIndexEntrySize ||
+        ReadValue<uint32_t>(data + 36) != Crc32(data + indexOffset, size - indexOffset)) {
+        return false;
+    }
+    
+    // 校验索引：键有序且条目位于数据区内（条目内容在访问时校验）
+    const uint8_t* index = data + indexOffset;
+    uint64_t clock = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* raw = index + i * kCacheIndexEntrySize;
+        uint64_t offset = ReadValue<uint64_t>(raw + 8);
+        uint32_t entrySize = ReadValue<uint32_t>(raw + 16);
+        if (offset < kCacheHeaderSize || offset > indexOffset || entrySize > indexOffset - offset ||
+            (i > 0 && ReadValue<uint64_t>(raw - kCacheIndexEntrySize) >= ReadValue<uint64_t>(raw))) {
+            return false;
+        }
+        clock = std::max(clock, ReadValue<uint64_t>(raw + 24));
+    }
+    
+    ReleaseMappings();
+    mapped_ = std::move(mapped);
+    mappedPath_ = cachePath;
+    index_ = index;
+    indexCount_ = count;
+    clock_ = std::max(clock_, clock);
+    MapJournal(cachePath + ".journal");
+    return true;
+}
+
+void ShaderCache::MapJournal(const std::string& journalPath) {
+    journal_->Close();
+    journalIndex_.clear();
+    journalSize_ = 0;
+    if (!journal_->Open(journalPath)) {
+        return;
+    }
+    
+    // 逐条校验记录头，遇到不完整的记录（写入中断）即停止
+    const uint8_t* data = journal_->Data();
+    size_t size = journal_->Size();
+    size_t pos = 0;
+    while (size - pos >= kJournalRecordHeaderSize) {
+        const uint8_t* record = data + pos;
+        if (ReadValue<uint32_t>(record) != kJournalMagic ||
+            ReadValue<uint32_t>(record + 28) != Crc32(record, 28)) {
+            break;
+        }
+        uint32_t entrySize = ReadValue<uint32_t>(record + 4);
+        if (entrySize > size - pos - kJournalRecordHeaderSize) {
+            break;
+        }
+        StoredEntry entry{ReadValue<uint64_t>(record + 8), record + kJournalRecordHeaderSize,
+                          entrySize, ReadValue<uint32_t>(record + 24), ReadValue<uint64_t>(record + 16)};
+        journalIndex_[entry.key] = entry;
+        clock_ = std::max(clock_, entry.lastUse);
+        pos += kJournalRecordHeaderSize + entrySize;
+    }
+    journalSize_ = pos;
+}
+
+bool ShaderCache::AppendJournal() {
+    if (pending_.empty()) {
+        return true;
+    }
+    
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> payload;
+    for (uint64_t key : pending_) {
+        auto it = cache_.find(key);
+        if (it == cache_.end()) {
+            continue;
+        }
+        payload.clear();
+        SerializeShader(it->second.shader, payload);
+        size_t start = data.size();
+        WriteValue<uint32_t>(data, kJournalMagic);
+        WriteValue<uint32_t>(data, static_cast<uint32_t>(payload.size()));
+        WriteValue<uint64_t>(data, key);
+        WriteValue<uint64_t>(data, lastUse_[key]);
+        WriteValue<uint32_t>(data, Crc32(payload.data(), payload.size()));
+        WriteValue<uint32_t>(data, Crc32(data.data() + start, 28));
+        data.insert(data.end(), payload.begin(), payload.end());
+    }
+    
+    std::string journalPath = mappedPath_ + ".journal";
+    journal_->Close();
+    
+    // 截掉上次写入中断留下的不完整记录，保证新记录紧接在有效记录之后
+    std::error_code ec;
+    if (fs::exists(journalPath, ec) && fs::file_size(journalPath, ec) != journalSize_) {
+        fs::resize_file(journalPath, journalSize_, ec);
+    }
+    
+    bool written;
+    {
+        std::ofstream file(journalPath, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        written = file.good();
+    }
+    
+    MapJournal(journalPath);
+    if (written) {
+        pending_.clear();
+        EvictToBudget();
+    }
+    return written;
+}
+
+bool ShaderCache::FindStored(uint64_t key, StoredEntry& entry) const {
+    auto it = journalIndex_.find(key);
+    if (it != journalIndex_.end()) {
+        entry = it->second;
+        return true;
+    }
+    
+    size_t low = 0;
+    size_t high = indexCount_;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        uint64_t midKey = ReadValue<uint64_t>(index_ + mid * kCacheIndexEntrySize);
+        if (midKey < key) {
+            low = mid + 1;
+        } else if (midKey > key) {
+            high = mid;
+        } else {
+            entry = ReadIndexEntry(mid);
+            return true;
+        }
+    }
+    return false;
+}
+
+ShaderCache::StoredEntry ShaderCache::ReadIndexEntry(size_t i) const {
+    const uint8_t* raw = index_ + i * kCacheIndexEntrySize;
+    return {ReadValue<uint64_t>(raw), mapped_->Data() + ReadValue<uint64_t>(raw + 8),
+            ReadValue<uint32_t>(raw + 16), ReadValue<uint32_t>(raw + 20), ReadValue<uint64_t>(raw + 24)};
+}
+
+void ShaderCache::Insert(uint64_t key, ShaderInfo shader) {
+    size_t bytes = EstimateShaderSize(shader);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        memoryBytes_ = memoryBytes_ - it->second.bytes + bytes;
+        it->second.shader = std::move(shader);
+        it->second.bytes = bytes;
+        Touch(key, it->second);
+    } else {
+        lru_.push_front(key);
+        cache_.emplace(key, MemoryEntry{std::move(shader), bytes, lru_.begin()});
+        memoryBytes_ += bytes;
+        lastUse_[key] = ++clock_;
+    }
+    EvictToBudget();
+}
+
+void ShaderCache::Touch(uint64_t key, MemoryEntry& entry) {
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    lastUse_[key] = ++clock_;
+}
+
+void ShaderCache::EvictToBudget() {
+    // 至少保留最近使用的一个条目；尚未写入磁盘的条目保留到写入之后，否则只能重新转换
+    auto it = lru_.end();
+    while (memoryBudget_ > 0 && memoryBytes_ > memoryBudget_ && it != lru_.begin()) {
+        --it;
+        if (it == lru_.begin()) {
+            break;
+        }
+        uint64_t key = *it;
+        if (pending_.count(key)) {
+            continue;
+        }
+        auto entry = cache_.find(key);
+        memoryBytes_ -= entry->second.bytes;
+        cache_.erase(entry);
+        lastUse_.erase(key);
+        it = lru_.erase(it);
+        stats_.evictions++;
+    }
+}
+
+void ShaderCache::ReleaseMappings() {
+    mapped_->Close();
+    journal_->Close();
+    mappedPath_.clear();
+    index_ = nullptr;
+    indexCount_ = 0;
+    journalIndex_.clear();
+    journalSize_ = 0;
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,139 @@
+/**
+ * Minecraft Unifier - Shader Cache
+ * 着色器缓存 - 内容哈希键、内存映射加载、LRU淘汰与追加日志
+ */
+
+#pragma once
+#include "shader_converter.h"
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mcu {
+namespace common {
+class MappedFile;
+}
+
+namespace core {
+namespace render {
+
+// 计算缓存键：预处理后的源码、阶段、转换器版本与编译选项的内容哈希
+uint64_t ComputeShaderCacheKey(const std::string& source, ShaderStage stage,
+                               const std::string& options = "");
+
+// 缓存统计
+struct ShaderCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;        // 超出内存预算被淘汰的条目
+    uint64_t diskEvictions = 0;    // 压缩时超出磁盘预算被丢弃的条目
+    uint64_t compactions = 0;
+    size_t memoryBytes = 0;        // 内存中已解码条目的估算大小
+    size_t diskBytes = 0;          // 主文件与日志合计
+    size_t journalBytes = 0;
+};
+
+// 着色器缓存
+// 磁盘上由主文件（头部 | 条目数据 | 按键排序的索引）与追加日志组成：
+// 加载时只映射文件并校验头部与索引，条目在首次访问时才解码并校验；
+// 保存时仅把新条目追加到日志，日志过大或超出磁盘预算时在后台压缩为新的主文件
+class ShaderCache {
+public:
+    ShaderCache();
+    ~ShaderCache();
+
+    // 检查缓存
+    bool HasCached(uint64_t key);
+
+    // 获取缓存，条目损坏时视为未命中
+    bool GetCached(uint64_t key, ShaderInfo& shader);
+
+    // 保存缓存
+    void SetCached(uint64_t key, const ShaderInfo& shader);
+
+    // 清除缓存（同时解除文件映射）
+    void Clear();
+
+    // 条目数量（内存、主文件与日志合计）
+    size_t GetEntryCount();
+
+    // 内存预算（字节，0为不限），超出时按LRU淘汰已解码条目，未保存的条目保存后才会被淘汰
+    void SetMemoryBudget(size_t bytes);
+
+    // 磁盘预算（字节，0为不限），压缩时保留最近使用的条目
+    void SetDiskBudget(size_t bytes);
+
+    // 获取统计
+    ShaderCacheStats GetStats();
+
+    // 保存到磁盘：已映射同一文件时只追加新条目到日志，否则写入完整主文件
+    bool SaveToDisk(const std::string& cachePath);
+
+    // 从磁盘加载，头部或索引校验失败时返回false
+    bool LoadFromDisk(const std::string& cachePath);
+
+    // 合并主文件与日志，丢弃超出磁盘预算的条目（先写临时文件再替换）
+    bool Compact(const std::string& cachePath);
+
+    // 等待后台压缩完成
+    void WaitForCompaction();
+
+private:
+    // 磁盘上的条目（payload指向映射内存）
+    struct StoredEntry {
+        uint64_t key;
+        const uint8_t* payload;
+        uint32_t size;
+        uint32_t crc;
+        uint64_t lastUse;
+    };
+
+    struct MemoryEntry {
+        ShaderInfo shader;
+        size_t bytes;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<uint64_t, MemoryEntry> cache_;  // 新写入或已解码的条目
+    std::list<uint64_t> lru_;                          // 最近使用的在前
+    std::unordered_set<uint64_t> pending_;             // 尚未写入磁盘的条目
+    std::unordered_map<uint64_t, uint64_t> lastUse_;   // 内存中条目的使用时刻，随淘汰删除
+    uint64_t clock_;
+    size_t memoryBytes_;
+    size_t memoryBudget_;
+    size_t diskBudget_;
+    ShaderCacheStats stats_;
+
+    std::unique_ptr<common::MappedFile> mapped_;       // 主文件
+    std::string mappedPath_;
+    const uint8_t* index_;
+    size_t indexCount_;
+    std::unique_ptr<common::MappedFile> journal_;
+    std::unordered_map<uint64_t, StoredEntry> journalIndex_;
+    size_t journalSize_;                               // 日志中完整记录的字节数
+
+    std::mutex compactionMutex_;
+    std::future<bool> compaction_;
+    std::string cachePath_;
+
+    bool MapFile(const std::string& cachePath);
+    void MapJournal(const std::string& journalPath);
+    bool AppendJournal();
+    bool FindStored(uint64_t key, StoredEntry& entry) const;
+    StoredEntry ReadIndexEntry(size_t i) const;
+    void Insert(uint64_t key, ShaderInfo shader);
+    void Touch(uint64_t key, MemoryEntry& entry);
+    void EvictToBudget();
+    void ReleaseMappings();
+};
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,173 @@
+/**
+ * Minecraft Unifier - Shader Compile Queue Implementation
+ * 着色器编译队列实现
+ */
+
+#include "shader_compile_queue.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+// Prioritize()提升后的优先级，高于任何程序
+const int kFrontPriority = INT_MIN;
+
+// 主世界中最常见的可见几何体，按覆盖的屏幕面积大致排序
+const char* const kVisibleGbuffers[] = {
+    "gbuffers_terrain",
+    "gbuffers_basic",
+    "gbuffers_textured",
+    "gbuffers_textured_lit",
+    "gbuffers_skybasic",
+    "gbuffers_skytextured",
+    "gbuffers_entities",
+    "gbuffers_block",
+    "gbuffers_hand",
+    "gbuffers_water",
+    "gbuffers_clouds",
+    "gbuffers_weather",
+};
+
+// 解析"prefix"或"prefixN"形式的名称，返回序号（无序号为0），不匹配返回-1
+int MatchIndexed(const std::string& name, const char* prefix) {
+    size_t length = std::char_traits<char>::length(prefix);
+    if (name.compare(0, length, prefix) != 0) {
+        return -1;
+    }
+    int index = 0;
+    for (size_t i = length; i < name.size(); i++) {
+        if (!std::isdigit(static_cast<unsigned char>(name[i])) || index > 99) {
+            return -1;
+        }
+        index = index * 10 + (name[i] - '0');
+    }
+    return index;
+}
+
+} // namespace
+
+int GetProgramPriority(const std::string& programName) {
+    int visible = 0;
+    for (const char* name : kVisibleGbuffers) {
+        if (programName == name) {
+            return visible;
+        }
+        visible++;
+    }
+    if (programName.compare(0, 9, "gbuffers_") == 0) {
+        return 50;
+    }
+    if (programName.compare(0, 6, "shadow") == 0) {
+        return 100;
+    }
+    int index = MatchIndexed(programName, "deferred");
+    if (index >= 0) {
+        return 200 + index;
+    }
+    index = MatchIndexed(programName, "composite");
+    if (index >= 0) {
+        return 400 + index;
+    }
+    if (programName == "final") {
+        return 600;
+    }
+    return 700;
+}
+
+ShaderCompileQueue::ShaderCompileQueue(common::ThreadPool* pool)
+    : pool_(pool ? pool : &common::ThreadPool::GetDefault())
+    , running_(0)
+    , sequence_(0) {
+}
+
+ShaderCompileQueue::~ShaderCompileQueue() {
+    WaitAll();
+}
+
+std::shared_future<bool> ShaderCompileQueue::Submit(const std::string& name, int priority,
+                                                    std::function<bool()> task) {
+    std::shared_future<bool> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = futures_.find(name);
+        if (it != futures_.end()) {
+            return it->second;
+        }
+
+        auto promise = std::make_shared<std::promise<bool>>();
+        future = promise->get_future().share();
+        queued_.push_back({name, priority, sequence_++, std::move(task), std::move(promise)});
+        futures_[name] = future;
+    }
+
+    pool_->Submit([this]() { RunNext(); });
+    return future;
+}
+
+bool ShaderCompileQueue::Prioritize(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Job& job : queued_) {
+        if (job.name == name) {
+            // 后提升的排在先提升的之后
+            job.priority = kFrontPriority;
+            job.sequence = sequence_++;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_future<bool> ShaderCompileQueue::GetFuture(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = futures_.find(name);
+    if (it != futures_.end()) {
+        return it->second;
+    }
+    return std::shared_future<bool>();
+}
+
+size_t ShaderCompileQueue::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_.size() + running_;
+}
+
+void ShaderCompileQueue::WaitAll() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return queued_.empty() && running_ == 0; });
+}
+
+void ShaderCompileQueue::RunNext() {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_.empty()) {
+            return;
+        }
+
+        // 队列通常只有几十到几百个程序，线性查找即可
+        auto best = std::min_element(queued_.begin(), queued_.end(), [](const Job& a, const Job& b) {
+            return a.priority != b.priority ? a.priority < b.priority : a.sequence < b.sequence;
+        });
+        job = std::move(*best);
+        queued_.erase(best);
+        running_++;
+    }
+
+    bool result = job.task();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    job.promise->set_value(result);
+    futures_.erase(job.name);
+    running_--;
+    idle_.notify_all();
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
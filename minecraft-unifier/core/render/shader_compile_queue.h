@@ -0,0 +1,79 @@
+/**
+ * Minecraft Unifier - Shader Compile Queue
+ * 着色器编译队列 - 按优先级在后台线程编译材质，每个材质对应一个future
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace common {
+class ThreadPool;
+}
+
+namespace core {
+namespace render {
+
+// 程序编译优先级（越小越先编译）：可见几何体（gbuffers_terrain等）在前，
+// 阴影、deferred、composite依次在后，final最后
+int GetProgramPriority(const std::string& programName);
+
+// 优先级编译队列
+// 每提交一个任务向线程池投递一个执行单元，执行单元运行时取当前优先级最高的任务，
+// 因此排队中的任务可以被重新排序
+class ShaderCompileQueue {
+public:
+    // pool为nullptr时使用默认线程池
+    explicit ShaderCompileQueue(common::ThreadPool* pool = nullptr);
+    ~ShaderCompileQueue();
+
+    ShaderCompileQueue(const ShaderCompileQueue&) = delete;
+    ShaderCompileQueue& operator=(const ShaderCompileQueue&) = delete;
+
+    // 提交任务，同名任务尚未完成时返回已有的future
+    std::shared_future<bool> Submit(const std::string& name, int priority, std::function<bool()> task);
+
+    // 将排队中的任务提到最前（例如渲染线程需要绘制该材质），任务不在队列中返回false
+    bool Prioritize(const std::string& name);
+
+    // 获取任务的future，任务未提交或已完成返回无效的future
+    std::shared_future<bool> GetFuture(const std::string& name) const;
+
+    // 排队与正在执行的任务数
+    size_t GetPendingCount() const;
+
+    // 等待全部任务完成（不要在线程池的工作线程中调用）
+    void WaitAll();
+
+private:
+    struct Job {
+        std::string name;
+        int priority;
+        uint64_t sequence;
+        std::function<bool()> task;
+        std::shared_ptr<std::promise<bool>> promise;
+    };
+
+    common::ThreadPool* pool_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::vector<Job> queued_;
+    std::unordered_map<std::string, std::shared_future<bool>> futures_;
+    size_t running_;
+    uint64_t sequence_;
+
+    void RunNext();
+};
+
+} // namespace render
+} // namespace core
+} // namespace mcu
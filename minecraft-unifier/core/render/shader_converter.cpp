@@ -4,6 +4,14 @@
  */
 
 #include "shader_converter.h"
+#include "glsl_rewriter.h"
+#include "glsl_preprocessor.h"
+#include "spirv_compiler.h"
+#include "shader_cache.h"
+#include "shader_compile_queue.h"
+#include "shader_source_cache.h"
+#include "thread_pool.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -18,10 +26,13 @@ namespace render {
 // ==================== ShaderConverter ====================
 
 ShaderConverter::ShaderConverter()
-    : initialized_(false) {
+    : initialized_(false), threadPool_(nullptr), shaderCache_(nullptr)
+    , fallbackHandle_(nullptr), fallbackCreated_(false), variantSequence_(0) {
 }
 
 ShaderConverter::~ShaderConverter() {
+    // 后台任务引用本对象的材质表
+    WaitForCompilation();
 }
 
 bool ShaderConverter::Initialize() {
@@ -44,10 +55,16 @@ bool ShaderConverter::LoadJavaShaderpack(const std::string& shaderpackPath) {
         return false;
     }
     
+    // 之后glShaderSource Hook才转换游戏上传的源代码
+    ShaderSourceCache::GetInstance().SetJavaShaderpackLoaded(true);
+    
     return true;
 }
 
 bool ShaderConverter::ParseShaderpack(const std::string& shaderpackPath) {
+    // 后台编译读取材质表，重新解析前需等待其完成
+    WaitForCompilation();
+    
     // 检查光影包目录
     if (!fs::exists(shaderpackPath)) {
         return false;
@@ -58,95 +75,315 @@ bool ShaderConverter::ParseShaderpack(const std::string& shaderpackPath) {
         return false;
     }
     
-    // 遍历着色器文件
+    // 先读取配置文件，其中的选项参与预处理
+    std::unordered_map<std::string, std::string> properties;
+    std::string configPath = shadersDir + "/shaders.properties";
+    if (!fs::exists(configPath)) {
+        configPath = shaderpackPath + "/shaders.properties";
+    }
+    if (fs::exists(configPath)) {
+        std::ifstream configFile(configPath);
+        std::stringstream buffer;
+        buffer << configFile.rdbuf();
+        std::string content = buffer.str();
+        configFile.close();
+        
+        // 解析配置
+        std::regex propRegex("^(\\w+)=(.+)$");
+        std::smatch match;
+        std::istringstream stream(content);
+        std::string line;
+        
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (std::regex_match(line, match, propRegex)) {
+                properties[match[1].str()] = match[2].str();
+            }
+        }
+    }
+    
+    // 收集程序文件：gbuffers_terrain.vsh, gbuffers_terrain.fsh等
+    std::vector<ShaderProgram> programs;
+    
+    static const std::regex shaderRegex("^(\\w+)\\.(vsh|fsh|gsh)$");
     for (const auto& entry : fs::directory_iterator(shadersDir)) {
         std::string filename = entry.path().filename().string();
-        std::string ext = entry.path().extension().string();
-        
-        // 解析着色器文件名格式：gbuffers_terrain.vsh, gbuffers_terrain.fsh等
-        std::regex shaderRegex("^(\\w+)\\.(vsh|fsh|gsh)$");
         std::smatch match;
         
         if (std::regex_match(filename, match, shaderRegex)) {
-            std::string materialName = match[1].str();
-            std::string stageStr = match[2].str();
-            
             // 确定着色器阶段
+            std::string stageStr = match[2].str();
             ShaderStage stage;
             if (stageStr == "vsh") {
                 stage = ShaderStage::VERTEX;
             } else if (stageStr == "fsh") {
                 stage = ShaderStage::FRAGMENT;
-            } else if (stageStr == "gsh") {
-                stage = ShaderStage::GEOMETRY;
             } else {
-                continue;
-            }
-            
-            // 读取着色器源代码
-            std::string source;
-            if (!ReadShaderFile(entry.path().string(), source)) {
-                continue;
-            }
-            
-            // 创建或获取材质
-            if (materials_.find(materialName) == materials_.end()) {
-                MaterialInfo material;
-                material.name = materialName;
-                material.renderDragonHandle = nullptr;
-                materials_[materialName] = material;
+                stage = ShaderStage::GEOMETRY;
             }
-            
-            // 添加着色器
-            ShaderInfo shader;
-            shader.stage = stage;
-            shader.source = source;
-            shader.entryPoint = "main";
-            
-            // 编译为SPIR-V
-            if (!CompileGLSLToSPIRV(shader)) {
+            ShaderProgram program;
+            program.path = entry.path().string();
+            program.materialName = match[1].str();
+            program.stage = stage;
+            program.current = -1;
+            programs.push_back(std::move(program));
+        }
+    }
+    
+    // 按路径排序，保证合并结果与目录遍历顺序无关
+    std::sort(programs.begin(), programs.end(), [](const ShaderProgram& a, const ShaderProgram& b) {
+        return a.path < b.path;
+    });
+    
+    // 同一光影包的所有程序共享预处理器，包含文件只解析一次，切换选项时继续复用
+    preprocessor_ = std::make_unique<GLSLPreprocessor>(shadersDir);
+    preprocessor_->SetOptions(properties);
+    options_ = std::move(properties);
+    programs_ = std::move(programs);
+    materials_.clear();
+    materialVariantKeys_.clear();
+    {
+        // 后台编译已在开头等待完成，销毁旧光影包编译出的全部材质，保留后备材质
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        for (auto it = handleLayouts_.begin(); it != handleLayouts_.end();) {
+            if (it->first == fallbackHandle_) {
+                ++it;
                 continue;
             }
-            
-            // 解析Uniform和属性
-            ParseUniforms(shader);
-            ParseAttributes(shader);
-            
-            materials_[materialName].shaders.push_back(shader);
+            RenderDragonAPI::GetInstance().DestroyMaterial(it->first);
+            it = handleLayouts_.erase(it);
         }
+        readyHandles_.clear();
+        variantHandles_.clear();
     }
     
-    // 读取配置文件
-    std::string configPath = shaderpackPath + "/shaders.properties";
-    if (fs::exists(configPath)) {
-        std::ifstream configFile(configPath);
-        std::stringstream buffer;
-        buffer << configFile.rdbuf();
-        std::string content = buffer.str();
-        configFile.close();
-        
-        // 解析配置
-        std::regex propRegex("^(\\w+)=(.+)$");
-        std::smatch match;
-        std::istringstream stream(content);
-        std::string line;
+    // 缓存键包含编译方式：未链接glslang时条目中没有SPIR-V
+    const std::string cacheOptions = IsSPIRVCompilerAvailable() ? "spirv" : "glsl";
+    
+    // 各程序并行预处理、转换与解析，结果写入各自的变体列表
+    common::ThreadPool& pool = threadPool_ ? *threadPool_ : common::ThreadPool::GetDefault();
+    pool.ParallelFor(0, programs_.size(), [&](size_t i) {
+        ConvertProgram(programs_[i], cacheOptions);
+    });
+    
+    // 按排序后的顺序合并到材质表
+    std::vector<std::string> materialNames;
+    for (const auto& program : programs_) {
+        materialNames.push_back(program.materialName);
+    }
+    std::sort(materialNames.begin(), materialNames.end());
+    materialNames.erase(std::unique(materialNames.begin(), materialNames.end()), materialNames.end());
+    for (const auto& name : materialNames) {
+        RebuildMaterial(name);
+    }
+    
+    return true;
+}
+
+bool ShaderConverter::ApplyShaderOptions(const std::unordered_map<std::string, std::string>& options) {
+    if (!preprocessor_) {
+        return false;
+    }
+    
+    // 后台编译读取材质表
+    WaitForCompilation();
+    
+    for (const auto& [name, value] : options) {
+        options_[name] = value;
+        preprocessor_->SetOption(name, value);
+    }
+    
+    // 引用的选项取值未变的阶段保持不变，其余先在已有变体中查找
+    std::vector<std::string> changed;
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < programs_.size(); i++) {
+        int previous = programs_[i].current;
+        if (!SelectVariant(programs_[i])) {
+            pending.push_back(i);
+        } else if (programs_[i].current != previous) {
+            changed.push_back(programs_[i].materialName);
+        }
+    }
+    
+    // 只转换新出现的变体
+    const std::string cacheOptions = IsSPIRVCompilerAvailable() ? "spirv" : "glsl";
+    std::vector<char> converted(pending.size(), 0);
+    common::ThreadPool& pool = threadPool_ ? *threadPool_ : common::ThreadPool::GetDefault();
+    pool.ParallelFor(0, pending.size(), [&](size_t i) {
+        converted[i] = ConvertProgram(programs_[pending[i]], cacheOptions) ? 1 : 0;
+    });
+    
+    bool success = true;
+    for (size_t i = 0; i < pending.size(); i++) {
+        success = success && converted[i];
+        changed.push_back(programs_[pending[i]].materialName);
+    }
+    
+    // 重建受影响的材质，已编译过的材质重新排队编译（之前编译过的组合直接复用句柄）
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    for (const auto& name : changed) {
+        auto it = materials_.find(name);
+        bool compiled = it != materials_.end() && it->second.renderDragonHandle != nullptr;
+        RebuildMaterial(name);
+        it = materials_.find(name);
+        if (compiled && it != materials_.end() && !it->second.renderDragonHandle) {
+            CompileToRenderDragonAsync(name);
+        }
+    }
+    
+    for (auto& [name, material] : materials_) {
+        material.properties = options_;
+    }
+    return success;
+}
+
+bool ShaderConverter::SetShaderOption(const std::string& name, const std::string& value) {
+    return ApplyShaderOptions({{name, value}});
+}
+
+const std::unordered_map<std::string, std::string>& ShaderConverter::GetShaderOptions() const {
+    return options_;
+}
+
+size_t ShaderConverter::GetVariantCount() const {
+    size_t count = 0;
+    for (const auto& program : programs_) {
+        count += program.variants.size();
+    }
+    return count;
+}
+
+bool ShaderConverter::ConvertProgram(ShaderProgram& program, const std::string& cacheOptions) {
+    program.current = -1;
+    
+    ShaderVariant variant;
+    ShaderInfo& shader = variant.shader;
+    shader.stage = program.stage;
+    shader.entryPoint = "main";
+    
+    // 读取并预处理着色器源代码（展开#include与条件编译），记录决定该变体的选项
+    if (!preprocessor_->Process(program.path, shader.source, nullptr, &variant.options)) {
+        return false;
+    }
+    std::sort(variant.options.begin(), variant.options.end());
+    variant.options.erase(std::unique(variant.options.begin(), variant.options.end()), variant.options.end());
+    variant.optionStates = GetOptionStates(variant.options);
+    
+    // 缓存命中时跳过转换与编译
+    uint64_t cacheKey = 0;
+    bool cached = false;
+    if (shaderCache_) {
+        cacheKey = ComputeShaderCacheKey(shader.source, shader.stage, cacheOptions);
+        cached = shaderCache_->GetCached(cacheKey, shader);
+    }
+    if (!cached) {
+        // 编译为SPIR-V，失败时保留转换后的GLSL与编译信息，该程序仍按GLSL使用
+        std::string log;
+        bool compiled = CompileGLSLToSPIRV(shader, log);
+        if (!compiled) {
+            shader.compileLog = log;
+        }
         
-        while (std::getline(stream, line)) {
-            if (std::regex_match(line, match, propRegex)) {
-                std::string key = match[1].str();
-                std::string value = match[2].str();
-                
-                // 将配置应用到所有材质
-                for (auto& [name, material] : materials_) {
-                    material.properties[key] = value;
-                }
-            }
+        // 解析Uniform和属性
+        ParseUniforms(shader);
+        ParseAttributes(shader);
+        if (shaderCache_ && compiled) {
+            shaderCache_->SetCached(cacheKey, shader);
         }
     }
     
+    variant.id = variantSequence_++;
+    program.variants.push_back(std::move(variant));
+    program.current = static_cast<int>(program.variants.size()) - 1;
     return true;
 }
 
+bool ShaderConverter::SelectVariant(ShaderProgram& program) const {
+    // 变体引用的选项作用全部相同时展开结果相同，当前变体优先比较
+    if (program.current >= 0) {
+        const ShaderVariant& current = program.variants[program.current];
+        if (GetOptionStates(current.options) == current.optionStates) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < program.variants.size(); i++) {
+        if (GetOptionStates(program.variants[i].options) == program.variants[i].optionStates) {
+            program.current = static_cast<int>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string ShaderConverter::GetOptionStates(const std::vector<GLSLOptionReference>& options) const {
+    // 每个选项一行，取值不同但作用相同的取值（如未设置与"true"）视为同一变体
+    std::string states;
+    for (const auto& option : options) {
+        states += option.name;
+        states += ' ';
+        states += preprocessor_->GetOptionState(option);
+        states += '\n';
+    }
+    return states;
+}
+
+void ShaderConverter::RebuildMaterial(const std::string& materialName) {
+    MaterialInfo material;
+    material.name = materialName;
+    material.renderDragonHandle = nullptr;
+    
+    std::string variantKey = materialName;
+    for (const auto& program : programs_) {
+        if (program.materialName != materialName || program.current < 0) {
+            continue;
+        }
+        const ShaderVariant& variant = program.variants[program.current];
+        material.shaders.push_back(variant.shader);
+        variantKey += ':';
+        variantKey += std::to_string(variant.id);
+    }
+    if (material.shaders.empty()) {
+        materials_.erase(materialName);
+        materialVariantKeys_.erase(materialName);
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        readyHandles_.erase(materialName);
+        return;
+    }
+    
+    material.properties = options_;
+    auto layout = std::make_shared<UniformLayout>();
+    for (const auto& shader : material.shaders) {
+        layout->AddFromSource(shader.source, shader.uniforms);
+    }
+    material.uniformLayout = layout;
+    
+    // 同一组阶段变体编译过时直接复用句柄及其布局
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        auto handle = variantHandles_.find(variantKey);
+        if (handle != variantHandles_.end()) {
+            material.renderDragonHandle = handle->second;
+            material.uniformLayout = handleLayouts_[handle->second];
+            readyHandles_[materialName] = handle->second;
+        } else {
+            readyHandles_.erase(materialName);
+        }
+    }
+    materials_[materialName] = std::move(material);
+    materialVariantKeys_[materialName] = variantKey;
+}
+
+void ShaderConverter::SetThreadPool(common::ThreadPool* pool) {
+    threadPool_ = pool;
+}
+
+void ShaderConverter::SetShaderCache(ShaderCache* cache) {
+    shaderCache_ = cache;
+}
+
 bool ShaderConverter::ReadShaderFile(const std::string& filePath, std::string& content) {
     std::ifstream file(filePath);
     if (!file.is_open()) {
@@ -161,21 +398,29 @@ bool ShaderConverter::ReadShaderFile(const std::string& filePath, std::string& c
     return true;
 }
 
-bool ShaderConverter::CompileGLSLToSPIRV(ShaderInfo& shader) {
+bool ShaderConverter::CompileGLSLToSPIRV(ShaderInfo& shader, std::string& log) {
     // 转换GLSL到Render Dragon兼容格式
     std::string convertedSource = ConvertGLSLToRenderDragon(shader.source, shader.stage);
     
     // 存储转换后的源代码
     shader.source = convertedSource;
     
-    // TODO: 使用glslang库编译GLSL到SPIR-V
-    // 这里需要集成glslang库进行实际的SPIR-V编译
-    // 当前实现：直接存储转换后的源代码
+    // 未链接glslang时仅保留转换后的源代码
+    log.clear();
+    if (!IsSPIRVCompilerAvailable()) {
+        return true;
+    }
     
-    return true;
+    // 失败时spirv为空，log为glslang的错误信息
+    return CompileSPIRV(shader.source, shader.stage, shader.spirv, log);
 }
 
 bool ShaderConverter::ParseUniforms(ShaderInfo& shader) {
+    // 已编译的着色器直接从SPIR-V反射
+    if (!shader.spirv.empty()) {
+        return ReflectSPIRV(shader.spirv, shader.stage, &shader.uniforms, nullptr);
+    }
+    
     // 解析着色器中的Uniform变量
     std::regex uniformRegex("uniform\\s+(\\w+)\\s+(\\w+)(?:\\[(\\d+)\\])?;");
     std::smatch match;
@@ -198,6 +443,11 @@ bool ShaderConverter::ParseUniforms(ShaderInfo& shader) {
 }
 
 bool ShaderConverter::ParseAttributes(ShaderInfo& shader) {
+    // 已编译的着色器直接从SPIR-V反射
+    if (!shader.spirv.empty()) {
+        return ReflectSPIRV(shader.spirv, shader.stage, nullptr, &shader.attributes);
+    }
+    
     // 解析着色器中的属性变量
     std::regex attrRegex("attribute\\s+(\\w+)\\s+(\\w+);");
     std::smatch match;
@@ -220,181 +470,24 @@ bool ShaderConverter::ParseAttributes(ShaderInfo& shader) {
 }
 
 std::string ShaderConverter::ConvertGLSLToRenderDragon(const std::string& glslSource, ShaderStage stage) {
-    std::string converted = glslSource;
-    
-    // 转换版本声明
-    converted = std::regex_replace(converted, 
-        std::regex("#version\\s+\\d+\\s+(core|compatibility|es)?"),
-        "#version 330 core");
-    
-    // 转换Java版特定的Uniform变量到Render Dragon格式
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferModelView;"),
-        "uniform mat4 u_modelViewMatrix;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferProjection;"),
-        "uniform mat4 u_projectionMatrix;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferProjectionInverse;"),
-        "uniform mat4 u_projectionMatrixInverse;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferModelViewInverse;"),
-        "uniform mat4 u_modelViewMatrixInverse;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferPreviousModelView;"),
-        "uniform mat4 u_previousModelViewMatrix;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferPreviousProjection;"),
-        "uniform mat4 u_previousProjectionMatrix;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+mat4\\s+gbufferTextureMatrix;"),
-        "uniform mat4 u_textureMatrix;");
-    
-    // 转换时间相关Uniform
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+float\\s+frameTimeCounter;"),
-        "uniform float u_time;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+float\\s+sunAngle;"),
-        "uniform float u_sunAngle;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+float\\s+shadowAngle;"),
-        "uniform float u_shadowAngle;");
-    
-    // 转换视口相关Uniform
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec2\\s+viewWidth;"),
-        "uniform vec2 u_viewportSize;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec2\\s+viewHeight;"),
-        "uniform vec2 u_viewportSize;");
-    
-    // 转换相机相关Uniform
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec3\\s+cameraPosition;"),
-        "uniform vec3 u_cameraPosition;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec3\\s+previousCameraPosition;"),
-        "uniform vec3 u_previousCameraPosition;");
-    
-    // 转换光照相关Uniform
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec3\\s+sunPosition;"),
-        "uniform vec3 u_sunPosition;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec3\\s+moonPosition;"),
-        "uniform vec3 u_moonPosition;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+vec3\\s+shadowLightPosition;"),
-        "uniform vec3 u_shadowLightPosition;");
-    
-    // 转换纹理采样器
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+texture;"),
-        "uniform sampler2D u_texture;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+normals;"),
-        "uniform sampler2D u_normalMap;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+specular;"),
-        "uniform sampler2D u_specularMap;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+shadow;"),
-        "uniform sampler2D u_shadowMap;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+shadowcolor0;"),
-        "uniform sampler2D u_shadowColorMap;");
-    
-    converted = std::regex_replace(converted,
-        std::regex("uniform\\s+sampler2D\\s+shadowcolor1;"),
-        "uniform sampler2D u_shadowColorMap1;");
-    
-    // 转换顶点属性
-    if (stage == ShaderStage::VERTEX) {
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec3\\s+position;"),
-            "in vec3 a_position;");
-        
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec4\\s+color;"),
-            "in vec4 a_color;");
-        
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec2\\s+texcoord;"),
-            "in vec2 a_texCoord;");
-        
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec2\\s+lmcoord;"),
-            "in vec2 a_lightMapCoord;");
-        
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec3\\s+normal;"),
-            "in vec3 a_normal;");
-        
-        converted = std::regex_replace(converted,
-            std::regex("attribute\\s+vec4\\s+tangent;"),
-            "in vec4 a_tangent;");
-        
-        // 转换varying到out
-        converted = std::regex_replace(converted,
-            std::regex("varying\\s+(\\w+)\\s+(\\w+);"),
-            "out $1 $2;");
-    } else if (stage == ShaderStage::FRAGMENT) {
-        // 转换varying到in
-        converted = std::regex_replace(converted,
-            std::regex("varying\\s+(\\w+)\\s+(\\w+);"),
-            "in $1 $2;");
-        
-        // 转换gl_FragColor到输出变量
-        converted = std::regex_replace(converted,
-            std::regex("gl_FragColor"),
-            "fragColor");
-        
-        // 如果没有定义fragColor，添加它
-        if (converted.find("out vec4 fragColor;") == std::string::npos) {
-            converted = "out vec4 fragColor;\n" + converted;
-        }
+    // 单遍改写，替代逐条regex_replace
+    return RewriteGLSLForRenderDragon(glslSource, stage);
+}
+
+bool ShaderConverter::ConvertGLSLToRenderDragon(const std::string& inputPath, const std::string& outputPath) {
+    std::string source;
+    if (!ReadShaderFile(inputPath, source)) {
+        return false;
     }
     
-    // 转换内置函数
-    converted = std::regex_replace(converted,
-        std::regex("ftransform\\(\\)"),
-        "(gl_ProjectionMatrix * gl_ModelViewMatrix * gl_Vertex)");
-    
-    // 转换纹理函数
-    converted = std::regex_replace(converted,
-        std::regex("texture2D\\s*\\("),
-        "texture(");
+    std::string converted = ConvertGLSLToRenderDragon(source, ShaderStageFromPath(inputPath));
     
-    converted = std::regex_replace(converted,
-        std::regex("texture2DLod\\s*\\("),
-        "textureLod(");
-    
-    converted = std::regex_replace(converted,
-        std::regex("shadow2D\\s*\\("),
-        "texture(");
-    
-    converted = std::regex_replace(converted,
-        std::regex("shadow2DLod\\s*\\("),
-        "textureLod(");
-    
-    return converted;
+    std::ofstream file(outputPath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(converted.data(), converted.size());
+    return file.good();
 }
 
 bool ShaderConverter::CompileToRenderDragon(const std::string& materialName) {
@@ -403,29 +496,168 @@ bool ShaderConverter::CompileToRenderDragon(const std::string& materialName) {
         return false;
     }
     
-    MaterialInfo& material = it->second;
+    void* handle = BuildRenderDragonMaterial(it->second);
+    if (!handle) {
+        return false;
+    }
     
+    std::lock_guard<std::mutex> lock(handleMutex_);
+    it->second.renderDragonHandle = handle;
+    readyHandles_[materialName] = handle;
+    handleLayouts_[handle] = it->second.uniformLayout;
+    auto variant = materialVariantKeys_.find(materialName);
+    if (variant != materialVariantKeys_.end()) {
+        variantHandles_[variant->second] = handle;
+    }
+    return true;
+}
+
+std::shared_future<bool> ShaderConverter::CompileToRenderDragonAsync(const std::string& materialName) {
+    ShaderCompileQueue* queue;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        if (!compileQueue_) {
+            compileQueue_ = std::make_unique<ShaderCompileQueue>(threadPool_);
+        }
+        queue = compileQueue_.get();
+    }
+    return queue->Submit(materialName, GetProgramPriority(materialName), [this, materialName]() {
+        return CompileToRenderDragon(materialName);
+    });
+}
+
+std::unordered_map<std::string, std::shared_future<bool>> ShaderConverter::CompileAllToRenderDragonAsync() {
+    std::unordered_map<std::string, std::shared_future<bool>> futures;
+    for (const auto& [name, material] : materials_) {
+        futures[name] = CompileToRenderDragonAsync(name);
+    }
+    return futures;
+}
+
+void* ShaderConverter::AcquireMaterial(const std::string& materialName) {
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        auto it = readyHandles_.find(materialName);
+        if (it != readyHandles_.end()) {
+            return it->second;
+        }
+    }
+    
+    // 正在被绘制的材质优先编译，编译队列在后台编译开始时创建
+    ShaderCompileQueue* queue;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        queue = compileQueue_.get();
+    }
+    if (queue) {
+        queue->Prioritize(materialName);
+    }
+    return GetFallbackMaterial();
+}
+
+void ShaderConverter::WaitForCompilation() {
+    ShaderCompileQueue* queue;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        queue = compileQueue_.get();
+    }
+    if (queue) {
+        queue->WaitAll();
+    }
+}
+
+void* ShaderConverter::BuildRenderDragonMaterial(const MaterialInfo& material) {
     // 创建Render Dragon材质
-    material.renderDragonHandle = CreateRenderDragonMaterial(material);
-    if (!material.renderDragonHandle) {
-        return false;
+    void* handle = CreateRenderDragonMaterial(material);
+    if (!handle) {
+        return nullptr;
     }
     
     // 设置着色器阶段
     for (const auto& shader : material.shaders) {
-        if (!SetRenderDragonShaderStage(material.renderDragonHandle, shader)) {
-            return false;
+        if (!SetRenderDragonShaderStage(handle, shader)) {
+            RenderDragonAPI::GetInstance().DestroyMaterial(handle);
+            return nullptr;
         }
     }
     
-    // 添加Uniform
+    // 添加Uniform：先按布局顺序登记数值Uniform（与UploadUniforms的缓冲区一致），再登记采样器
+    const UniformLayout& layout = *material.uniformLayout;
+    for (const auto& slot : layout.GetSlots()) {
+        AddRenderDragonUniform(handle, slot.name, slot.location);
+    }
     for (const auto& shader : material.shaders) {
         for (const auto& [name, location] : shader.uniforms) {
-            AddRenderDragonUniform(material.renderDragonHandle, name, location);
+            if (layout.FindSlot(name) < 0) {
+                AddRenderDragonUniform(handle, name, location);
+            }
         }
     }
     
-    return true;
+    return handle;
+}
+
+void* ShaderConverter::GetFallbackMaterial() {
+    std::lock_guard<std::mutex> lock(handleMutex_);
+    if (fallbackCreated_) {
+        return fallbackHandle_;
+    }
+    fallbackCreated_ = true;
+    
+    // 后备材质：纹理乘顶点颜色，不依赖光影包
+    MaterialInfo fallback;
+    fallback.name = "mcu_fallback";
+    fallback.renderDragonHandle = nullptr;
+    auto layout = std::make_shared<UniformLayout>();
+    
+    ShaderInfo vertex;
+    vertex.stage = ShaderStage::VERTEX;
+    vertex.entryPoint = "main";
+    vertex.source =
+        "#version 330 core\n"
+        "in vec3 a_position;\n"
+        "in vec4 a_color;\n"
+        "in vec2 a_texCoord;\n"
+        "uniform mat4 u_modelViewMatrix;\n"
+        "uniform mat4 u_projectionMatrix;\n"
+        "out vec4 v_color;\n"
+        "out vec2 v_texCoord;\n"
+        "void main() {\n"
+        "    v_color = a_color;\n"
+        "    v_texCoord = a_texCoord;\n"
+        "    gl_Position = u_projectionMatrix * u_modelViewMatrix * vec4(a_position, 1.0);\n"
+        "}\n";
+    
+    ShaderInfo fragment;
+    fragment.stage = ShaderStage::FRAGMENT;
+    fragment.entryPoint = "main";
+    fragment.source =
+        "#version 330 core\n"
+        "uniform sampler2D u_texture;\n"
+        "in vec4 v_color;\n"
+        "in vec2 v_texCoord;\n"
+        "out vec4 fragColor;\n"
+        "void main() {\n"
+        "    fragColor = texture(u_texture, v_texCoord) * v_color;\n"
+        "}\n";
+    
+    for (ShaderInfo* shader : {&vertex, &fragment}) {
+        std::string log;
+        if (!CompileGLSLToSPIRV(*shader, log)) {
+            return nullptr;
+        }
+        ParseUniforms(*shader);
+        ParseAttributes(*shader);
+        layout->AddFromSource(shader->source, shader->uniforms);
+        fallback.shaders.push_back(std::move(*shader));
+    }
+    fallback.uniformLayout = layout;
+    
+    fallbackHandle_ = BuildRenderDragonMaterial(fallback);
+    if (fallbackHandle_) {
+        handleLayouts_[fallbackHandle_] = fallback.uniformLayout;
+    }
+    return fallbackHandle_;
 }
 
 void* ShaderConverter::CreateRenderDragonMaterial(const MaterialInfo& material) {
@@ -448,6 +680,30 @@ void ShaderConverter::UpdateUniforms(void* material, const std::unordered_map<st
     }
 }
 
+bool ShaderConverter::UploadUniforms(void* material, const UniformBuffer& buffer) {
+    // 切换选项后布局可能改变，旧缓冲区需要重建：布局必须是该句柄登记Uniform时使用的同一份
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        auto registered = handleLayouts_.find(material);
+        if (registered != handleLayouts_.end() && registered->second != buffer.GetSharedLayout()) {
+            return false;
+        }
+    }
+    
+    RenderDragonAPI& api = RenderDragonAPI::GetInstance();
+    if (api.SetUniformBuffer(material, buffer.Data(), buffer.Size())) {
+        return true;
+    }
+    
+    // 运行时未导出批量接口：按槽位逐个设置，名称与偏移已预先解析
+    bool success = true;
+    for (const auto& slot : buffer.GetLayout().GetSlots()) {
+        success &= api.SetUniformValue(material, slot.name.c_str(), buffer.Data() + slot.offset,
+                                       static_cast<int>(slot.count));
+    }
+    return success;
+}
+
 void ShaderConverter::BindMaterial(void* material) {
     RenderDragonAPI::GetInstance().BindMaterial(material);
 }
@@ -510,6 +766,8 @@ bool RenderDragonAPI::InitializeWindows() {
         GetProcAddress(hMod, "RenderDragon_AddUniform"));
     setUniformValueFunc_ = reinterpret_cast<decltype(setUniformValueFunc_)>(
         GetProcAddress(hMod, "RenderDragon_SetUniformValue"));
+    setUniformBufferFunc_ = reinterpret_cast<decltype(setUniformBufferFunc_)>(
+        GetProcAddress(hMod, "RenderDragon_SetUniformBuffer"));
     bindMaterialFunc_ = reinterpret_cast<decltype(bindMaterialFunc_)>(
         GetProcAddress(hMod, "RenderDragon_BindMaterial"));
     destroyMaterialFunc_ = reinterpret_cast<decltype(destroyMaterialFunc_)>(
@@ -536,6 +794,8 @@ bool RenderDragonAPI::InitializeLinux() {
         dlsym(handle, "RenderDragon_AddUniform"));
     setUniformValueFunc_ = reinterpret_cast<decltype(setUniformValueFunc_)>(
         dlsym(handle, "RenderDragon_SetUniformValue"));
+    setUniformBufferFunc_ = reinterpret_cast<decltype(setUniformBufferFunc_)>(
+        dlsym(handle, "RenderDragon_SetUniformBuffer"));
     bindMaterialFunc_ = reinterpret_cast<decltype(bindMaterialFunc_)>(
         dlsym(handle, "RenderDragon_BindMaterial"));
     destroyMaterialFunc_ = reinterpret_cast<decltype(destroyMaterialFunc_)>(
@@ -562,6 +822,8 @@ bool RenderDragonAPI::InitializeAndroid() {
         dlsym(handle, "RenderDragon_AddUniform"));
     setUniformValueFunc_ = reinterpret_cast<decltype(setUniformValueFunc_)>(
         dlsym(handle, "RenderDragon_SetUniformValue"));
+    setUniformBufferFunc_ = reinterpret_cast<decltype(setUniformBufferFunc_)>(
+        dlsym(handle, "RenderDragon_SetUniformBuffer"));
     bindMaterialFunc_ = reinterpret_cast<decltype(bindMaterialFunc_)>(
         dlsym(handle, "RenderDragon_BindMaterial"));
     destroyMaterialFunc_ = reinterpret_cast<decltype(destroyMaterialFunc_)>(
@@ -600,6 +862,13 @@ bool RenderDragonAPI::SetUniformValue(void* material, const char* name, const fl
     return setUniformValueFunc_(material, name, value, count);
 }
 
+bool RenderDragonAPI::SetUniformBuffer(void* material, const float* data, size_t count) {
+    if (!initialized_ || !setUniformBufferFunc_) {
+        return false;
+    }
+    return setUniformBufferFunc_(material, data, count);
+}
+
 bool RenderDragonAPI::BindMaterial(void* material) {
     if (!initialized_ || !bindMaterialFunc_) {
         return false;
@@ -614,103 +883,6 @@ bool RenderDragonAPI::DestroyMaterial(void* material) {
     return destroyMaterialFunc_(material);
 }
 
-// ==================== ShaderCache ====================
-
-ShaderCache::ShaderCache() {
-    cachePath_ = fs::temp_directory_path().string() + "/shader_cache";
-    fs::create_directories(cachePath_);
-}
-
-ShaderCache::~ShaderCache() {
-    SaveToDisk(cachePath_ + "/cache.bin");
-}
-
-bool ShaderCache::HasCached(const std::string& key) {
-    return cache_.find(key) != cache_.end();
-}
-
-std::vector<uint32_t> ShaderCache::GetCached(const std::string& key) {
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        return it->second;
-    }
-    return {};
-}
-
-void ShaderCache::SetCached(const std::string& key, const std::vector<uint32_t>& spirv) {
-    cache_[key] = spirv;
-}
-
-void ShaderCache::Clear() {
-    cache_.clear();
-}
-
-bool ShaderCache::SaveToDisk(const std::string& cachePath) {
-    std::ofstream file(cachePath, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    // 写入缓存数量
-    uint32_t count = cache_.size();
-    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
-    
-    // 写入每个缓存项
-    for (const auto& [key, spirv] : cache_) {
-        // 写入key长度
-        uint32_t keyLen = key.size();
-        file.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-        
-        // 写入key
-        file.write(key.c_str(), keyLen);
-        
-        // 写入SPIR-V大小
-        uint32_t spirvSize = spirv.size();
-        file.write(reinterpret_cast<const char*>(&spirvSize), sizeof(spirvSize));
-        
-        // 写入SPIR-V数据
-        file.write(reinterpret_cast<const char*>(spirv.data()), spirvSize * sizeof(uint32_t));
-    }
-    
-    file.close();
-    return true;
-}
-
-bool ShaderCache::LoadFromDisk(const std::string& cachePath) {
-    std::ifstream file(cachePath, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    // 读取缓存数量
-    uint32_t count;
-    file.read(reinterpret_cast<char*>(&count), sizeof(count));
-    
-    // 读取每个缓存项
-    for (uint32_t i = 0; i < count; i++) {
-        // 读取key长度
-        uint32_t keyLen;
-        file.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
-        
-        // 读取key
-        std::string key(keyLen, '\0');
-        file.read(&key[0], keyLen);
-        
-        // 读取SPIR-V大小
-        uint32_t spirvSize;
-        file.read(reinterpret_cast<char*>(&spirvSize), sizeof(spirvSize));
-        
-        // 读取SPIR-V数据
-        std::vector<uint32_t> spirv(spirvSize);
-        file.read(reinterpret_cast<char*>(spirv.data()), spirvSize * sizeof(uint32_t));
-        
-        cache_[key] = spirv;
-    }
-    
-    file.close();
-    return true;
-}
-
 } // namespace render
 } // namespace core
 } // namespace mcu
@@ -4,12 +4,22 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include "glsl_preprocessor.h"
+#include "uniform_layout.h"
 
 namespace mcu {
+namespace common {
+class ThreadPool;
+}
+
 namespace core {
 namespace render {
 
@@ -21,24 +31,52 @@ enum class ShaderStage {
     COMPUTE
 };
 
+// 转换器版本，改写规则或编译流程变化时递增以使旧缓存失效
+constexpr uint32_t kShaderConverterVersion = 2;
+
 // 着色器信息
 struct ShaderInfo {
     ShaderStage stage;
     std::string source;
     std::string entryPoint;
     std::vector<uint32_t> spirv; // SPIR-V字节码
+    std::string compileLog;      // glslang编译失败时的信息，此时spirv为空、source为转换后的GLSL
     std::unordered_map<std::string, int> uniforms;
     std::unordered_map<std::string, int> attributes;
 };
 
+// 材质句柄：后台编译线程写入，渲染线程可随时读取
+class MaterialHandle {
+public:
+    MaterialHandle() : handle_(nullptr) {}
+    MaterialHandle(void* handle) : handle_(handle) {}
+    MaterialHandle(const MaterialHandle& other) : handle_(other.handle_.load()) {}
+    MaterialHandle& operator=(const MaterialHandle& other) {
+        handle_.store(other.handle_.load());
+        return *this;
+    }
+    MaterialHandle& operator=(void* handle) {
+        handle_.store(handle);
+        return *this;
+    }
+    operator void*() const { return handle_.load(); }
+
+private:
+    std::atomic<void*> handle_;
+};
+
 // 材质信息
 struct MaterialInfo {
     std::string name;
     std::vector<ShaderInfo> shaders;
     std::unordered_map<std::string, std::string> properties;
-    void* renderDragonHandle; // 平台相关句柄
+    std::shared_ptr<const UniformLayout> uniformLayout; // Uniform槽位布局，解析光影包时构建
+    MaterialHandle renderDragonHandle; // 平台相关句柄
 };
 
+class ShaderCache;
+class ShaderCompileQueue;
+
 // 着色器转换器
 class ShaderConverter {
 public:
@@ -54,9 +92,24 @@ public:
     // 编译为Render Dragon材质
     bool CompileToRenderDragon(const std::string& materialName);
     
+    // 在后台线程编译材质，按程序优先级排队（gbuffers_terrain先于composite7）
+    std::shared_future<bool> CompileToRenderDragonAsync(const std::string& materialName);
+    
+    // 在后台线程编译全部材质
+    std::unordered_map<std::string, std::shared_future<bool>> CompileAllToRenderDragonAsync();
+    
+    // 获取可绘制的材质：尚未就绪时返回后备材质，并把该材质提到编译队列最前
+    void* AcquireMaterial(const std::string& materialName);
+    
+    // 等待所有后台编译完成
+    void WaitForCompilation();
+    
     // 更新Uniform值
     void UpdateUniforms(void* material, const std::unordered_map<std::string, float>& values);
     
+    // 上传打包的Uniform缓冲区（缓冲区需按该材质的uniformLayout构建，布局已被替换时返回false），每个材质每帧一次调用
+    bool UploadUniforms(void* material, const UniformBuffer& buffer);
+    
     // 绑定材质
     void BindMaterial(void* material);
     
@@ -65,19 +118,82 @@ public:
     
     // 获取材质信息
     const MaterialInfo* GetMaterialInfo(const std::string& name) const;
+    
+    // 转换单个着色器文件，阶段由扩展名推断
+    bool ConvertGLSLToRenderDragon(const std::string& inputPath, const std::string& outputPath);
+    
+    // 解析并转换光影包中的所有程序（不依赖Render Dragon运行时）
+    bool ParseShaderpack(const std::string& shaderpackPath);
+    
+    // 设置转换程序使用的线程池（nullptr使用默认线程池）
+    void SetThreadPool(common::ThreadPool* pool);
+    
+    // 设置着色器缓存，命中时跳过转换与编译（nullptr禁用缓存）
+    void SetShaderCache(ShaderCache* cache);
+    
+    // 修改光影选项（游戏内设置界面切换选项时调用）
+    // 只重新转换引用了变化选项的着色器阶段，之前用过的变体与已编译的材质直接复用
+    bool ApplyShaderOptions(const std::unordered_map<std::string, std::string>& options);
+    bool SetShaderOption(const std::string& name, const std::string& value);
+    
+    // 当前选项值（shaders.properties及之后的修改）
+    const std::unordered_map<std::string, std::string>& GetShaderOptions() const;
+    
+    // 已转换的着色器变体数
+    size_t GetVariantCount() const;
 
 private:
+    // 着色器变体：程序在一组选项取值下的转换结果
+    struct ShaderVariant {
+        uint64_t id;
+        std::vector<GLSLOptionReference> options;  // 展开时引用的选项（已排序去重）
+        std::string optionStates;                  // 生成时这些选项的作用
+        ShaderInfo shader;
+    };
+    
+    // 光影包中的程序文件（一个着色器阶段）
+    struct ShaderProgram {
+        std::string path;
+        std::string materialName;
+        ShaderStage stage;
+        std::vector<ShaderVariant> variants;
+        int current;                        // 当前选项下的变体，-1表示转换失败
+    };
+    
     std::unordered_map<std::string, MaterialInfo> materials_;
     bool initialized_;
+    common::ThreadPool* threadPool_;
+    ShaderCache* shaderCache_;
+    
+    // 后台编译完成的材质句柄（渲染线程读取）
+    mutable std::mutex handleMutex_;
+    std::unordered_map<std::string, void*> readyHandles_;
+    void* fallbackHandle_;
+    bool fallbackCreated_;
+    std::unique_ptr<ShaderCompileQueue> compileQueue_;
+    
+    // 选项变体
+    std::unique_ptr<GLSLPreprocessor> preprocessor_;
+    std::unordered_map<std::string, std::string> options_;
+    std::vector<ShaderProgram> programs_;
+    std::atomic<uint64_t> variantSequence_;
+    std::unordered_map<std::string, std::string> materialVariantKeys_; // 材质名 -> 各阶段变体id
+    std::unordered_map<std::string, void*> variantHandles_;            // 已编译的材质变体
+    std::unordered_map<void*, std::shared_ptr<const UniformLayout>> handleLayouts_; // 句柄登记Uniform时使用的布局
     
     // 内部处理函数
-    bool ParseShaderpack(const std::string& shaderpackPath);
     bool ReadShaderFile(const std::string& filePath, std::string& content);
-    bool CompileGLSLToSPIRV(ShaderInfo& shader);
+    bool ConvertProgram(ShaderProgram& program, const std::string& cacheOptions);
+    bool SelectVariant(ShaderProgram& program) const;
+    std::string GetOptionStates(const std::vector<GLSLOptionReference>& options) const;
+    void RebuildMaterial(const std::string& materialName);
+    bool CompileGLSLToSPIRV(ShaderInfo& shader, std::string& log);
     std::string ConvertGLSLToRenderDragon(const std::string& glslSource, ShaderStage stage);
     bool ParseUniforms(ShaderInfo& shader);
     bool ParseAttributes(ShaderInfo& shader);
     void* CreateRenderDragonMaterial(const MaterialInfo& material);
+    void* BuildRenderDragonMaterial(const MaterialInfo& material);
+    void* GetFallbackMaterial();
     bool SetRenderDragonShaderStage(void* material, const ShaderInfo& shader);
     bool AddRenderDragonUniform(void* material, const std::string& name, int location);
 };
@@ -102,6 +218,9 @@ public:
     // 设置Uniform值
     bool SetUniformValue(void* material, const char* name, const float* value, int count);
     
+    // 一次设置全部Uniform值，data按AddUniform的登记顺序紧密排列
+    bool SetUniformBuffer(void* material, const float* data, size_t count);
+    
     // 绑定材质
     bool BindMaterial(void* material);
     
@@ -119,6 +238,7 @@ private:
     bool (*setShaderStageFunc_)(void*, int, const uint32_t*, size_t) = nullptr;
     bool (*addUniformFunc_)(void*, const char*, int) = nullptr;
     bool (*setUniformValueFunc_)(void*, const char*, const float*, int) = nullptr;
+    bool (*setUniformBufferFunc_)(void*, const float*, size_t) = nullptr;
     bool (*bindMaterialFunc_)(void*) = nullptr;
     bool (*destroyMaterialFunc_)(void*) = nullptr;
     
@@ -128,35 +248,6 @@ private:
     bool InitializeAndroid();
 };
 
-// 着色器缓存
-class ShaderCache {
-public:
-    ShaderCache();
-    ~ShaderCache();
-    
-    // 检查缓存
-    bool HasCached(const std::string& key);
-    
-    // 获取缓存
-    std::vector<uint32_t> GetCached(const std::string& key);
-    
-    // 保存缓存
-    void SetCached(const std::string& key, const std::vector<uint32_t>& spirv);
-    
-    // 清除缓存
-    void Clear();
-    
-    // 保存到磁盘
-    bool SaveToDisk(const std::string& cachePath);
-    
-    // 从磁盘加载
-    bool LoadFromDisk(const std::string& cachePath);
-
-private:
-    std::unordered_map<std::string, std::vector<uint32_t>> cache_;
-    std::string cachePath_;
-};
-
 } // namespace render
 } // namespace core
 } // namespace mcu
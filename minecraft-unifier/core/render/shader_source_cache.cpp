@@ -0,0 +1,231 @@
+/**
+ * Minecraft Unifier - Shader Source Cache Implementation
+ * 运行时着色器源代码缓存实现
+ */
+
+#include "shader_source_cache.h"
+#include "glsl_rewriter.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+// GL着色器类型常量（不依赖GL头文件）
+const unsigned int kGLFragmentShader = 0x8B30;
+const unsigned int kGLVertexShader = 0x8B31;
+const unsigned int kGLGeometryShader = 0x8DD9;
+const unsigned int kGLComputeShader = 0x91B9;
+
+// 按8字节处理的流式哈希，结果与片段如何划分无关
+// 同时计算两个乘数不同的哈希：hash用于查找与分片，check用于确认命中
+class SourceHasher {
+public:
+    void Update(const char* data, size_t size) {
+        while (size > 0 && pendingBytes_ > 0) {
+            Push(static_cast<uint8_t>(*data++));
+            size--;
+        }
+        while (size >= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            MixWord(word);
+            data += sizeof(word);
+            size -= sizeof(word);
+        }
+        while (size > 0) {
+            Push(static_cast<uint8_t>(*data++));
+            size--;
+        }
+    }
+
+    void Finish(uint64_t& hash, uint64_t& check) {
+        if (pendingBytes_ > 0) {
+            MixWord(pending_);
+        }
+        hash = Finalize(hash_);
+        check = Finalize(check_);
+    }
+
+private:
+    uint64_t hash_ = 0;
+    uint64_t check_ = 0;
+    uint64_t pending_ = 0;
+    size_t pendingBytes_ = 0;
+
+    void MixWord(uint64_t word) {
+        hash_ = (((hash_ << 5) | (hash_ >> 59)) ^ word) * 0x9E3779B97F4A7C15ULL;
+        check_ = (((check_ << 7) | (check_ >> 57)) ^ word) * 0xC2B2AE3D27D4EB4FULL;
+    }
+
+    // splitmix64终结，打散低位以便按哈希分片
+    static uint64_t Finalize(uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+        return hash;
+    }
+
+    void Push(uint8_t byte) {
+        pending_ |= static_cast<uint64_t>(byte) << (8 * pendingBytes_);
+        if (++pendingBytes_ == sizeof(uint64_t)) {
+            MixWord(pending_);
+            pending_ = 0;
+            pendingBytes_ = 0;
+        }
+    }
+};
+
+inline size_t FragmentLength(const char* const* strings, const int* lengths, int index) {
+    return lengths && lengths[index] >= 0 ? static_cast<size_t>(lengths[index]) : std::strlen(strings[index]);
+}
+
+} // namespace
+
+bool ShaderStageFromGLType(unsigned int glType, ShaderStage& stage) {
+    switch (glType) {
+        case kGLVertexShader:
+            stage = ShaderStage::VERTEX;
+            return true;
+        case kGLFragmentShader:
+            stage = ShaderStage::FRAGMENT;
+            return true;
+        case kGLGeometryShader:
+            stage = ShaderStage::GEOMETRY;
+            return true;
+        case kGLComputeShader:
+            stage = ShaderStage::COMPUTE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+ShaderSourceCache& ShaderSourceCache::GetInstance() {
+    static ShaderSourceCache instance;
+    return instance;
+}
+
+ShaderSourceCache::ShaderSourceCache()
+    : javaShaderpackLoaded_(false)
+    , hits_(0)
+    , misses_(0) {
+}
+
+void ShaderSourceCache::SetJavaShaderpackLoaded(bool loaded) {
+    // 新光影包的程序与之前的转换结果无关
+    Clear();
+    javaShaderpackLoaded_.store(loaded, std::memory_order_release);
+}
+
+bool ShaderSourceCache::ShouldTranslate(int count, const char* const* strings, const int* lengths) const {
+    if (!IsJavaShaderpackLoaded()) {
+        return false;
+    }
+    if (count <= 0 || !strings) {
+        return true;
+    }
+
+    // #version必须在注释之外的第一行，取开头的一段即可（可能跨片段）
+    const size_t kHeaderLimit = 1024;
+    std::string header;
+    for (int i = 0; i < count && header.size() < kHeaderLimit; i++) {
+        size_t length = std::min(FragmentLength(strings, lengths, i), kHeaderLimit - header.size());
+        header.append(strings[i], length);
+    }
+
+    size_t pos = header.find("#version");
+    if (pos == std::string::npos) {
+        return true; // 无#version即GLSL 1.10
+    }
+    size_t end = header.find('\n', pos);
+    std::istringstream line(header.substr(pos + 8, end == std::string::npos ? std::string::npos : end - pos - 8));
+    int version = 0;
+    std::string profile;
+    line >> version >> profile;
+    // "100"是GLSL ES 1.00，不带es后缀
+    return profile != "es" && version != 100;
+}
+
+std::shared_ptr<const std::string> ShaderSourceCache::Translate(int count, const char* const* strings,
+                                                                const int* lengths, ShaderStage stage) {
+    if (count < 0 || (count > 0 && !strings)) {
+        count = 0;
+    }
+
+    // 直接对各片段计算哈希，命中时无需拼接；键包含阶段与总长度
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += FragmentLength(strings, lengths, i);
+    }
+    SourceHasher hasher;
+    uint64_t header[2] = {static_cast<uint64_t>(stage), static_cast<uint64_t>(total)};
+    hasher.Update(reinterpret_cast<const char*>(header), sizeof(header));
+    for (int i = 0; i < count; i++) {
+        hasher.Update(strings[i], FragmentLength(strings, lengths, i));
+    }
+    uint64_t hash;
+    uint64_t check;
+    hasher.Finish(hash, check);
+
+    Shard& shard = shards_[hash % kShardCount];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(hash);
+        if (it != shard.entries.end() && it->second.length == total && it->second.check == check) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second.translated;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    // 未命中：拼接并在锁外转换
+    std::string source;
+    source.reserve(total);
+    for (int i = 0; i < count; i++) {
+        source.append(strings[i], FragmentLength(strings, lengths, i));
+    }
+    auto translated = std::make_shared<const std::string>(RewriteGLSLForRenderDragon(source, stage));
+
+    // 多个线程同时转换同一源代码时保留先插入的结果；哈希冲突时以新源代码替换
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry& entry = shard.entries[hash];
+    if (!entry.translated || entry.length != total || entry.check != check) {
+        entry.length = total;
+        entry.check = check;
+        entry.translated = std::move(translated);
+    }
+    return entry.translated;
+}
+
+std::shared_ptr<const std::string> ShaderSourceCache::Translate(const std::string& source, ShaderStage stage) {
+    const char* data = source.data();
+    int length = static_cast<int>(source.size());
+    return Translate(1, &data, &length, stage);
+}
+
+size_t ShaderSourceCache::GetEntryCount() const {
+    size_t count = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
+    }
+    return count;
+}
+
+void ShaderSourceCache::Clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
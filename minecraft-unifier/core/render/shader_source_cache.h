@@ -0,0 +1,76 @@
+/**
+ * Minecraft Unifier - Shader Source Cache
+ * 运行时着色器源代码缓存 - glShaderSource Hook按源代码哈希复用已转换的结果
+ */
+
+#pragma once
+#include "shader_converter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// GL着色器类型（GL_VERTEX_SHADER等）转换为着色器阶段，未知类型返回false
+bool ShaderStageFromGLType(unsigned int glType, ShaderStage& stage);
+
+// 进程内共享的转换结果缓存，可被多个线程（多个GL上下文）同时使用
+// 上下文丢失或窗口大小变化时游戏会重新上传相同的源代码，命中时只需计算一次哈希
+class ShaderSourceCache {
+public:
+    static ShaderSourceCache& GetInstance();
+
+    ShaderSourceCache();
+
+    // 是否已加载Java版光影包，只有加载后Hook才转换源代码（加载新光影包时清空缓存）
+    void SetJavaShaderpackLoaded(bool loaded);
+    bool IsJavaShaderpackLoaded() const { return javaShaderpackLoaded_.load(std::memory_order_acquire); }
+
+    // 是否应转换这份源代码：需已加载Java版光影包，且#version不是GLSL ES（游戏自身的ES着色器原样传递）
+    bool ShouldTranslate(int count, const char* const* strings, const int* lengths) const;
+
+    // 转换glShaderSource的源代码片段（lengths为nullptr或元素为负数时片段以'\0'结尾）
+    // 只在未命中时拼接源代码并调用RewriteGLSLForRenderDragon
+    std::shared_ptr<const std::string> Translate(int count, const char* const* strings, const int* lengths,
+                                                 ShaderStage stage);
+    std::shared_ptr<const std::string> Translate(const std::string& source, ShaderStage stage);
+
+    // 统计
+    size_t GetEntryCount() const;
+    uint64_t GetHitCount() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t GetMissCount() const { return misses_.load(std::memory_order_relaxed); }
+
+    // 清空缓存（例如切换光影包后）
+    void Clear();
+
+private:
+    // 按哈希分片加锁，减少多个上下文同时编译时的竞争
+    static const size_t kShardCount = 16;
+
+    // 以哈希为键，另存源代码长度与第二个独立哈希，两者都相同才算命中
+    struct Entry {
+        size_t length;
+        uint64_t check;
+        std::shared_ptr<const std::string> translated;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    Shard shards_[kShardCount];
+    std::atomic<bool> javaShaderpackLoaded_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,365 @@
+/**
+ * Minecraft Unifier - SPIR-V Compiler Implementation
+ * SPIR-V编译器实现
+ */
+
+#include "spirv_compiler.h"
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+#ifdef MCU_HAVE_GLSLANG
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+#endif
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+// SPIR-V常量（仅反射用到的部分）
+const uint32_t kSpvMagic = 0x07230203;
+const size_t kSpvHeaderWords = 5;
+
+enum SpvOp : uint32_t {
+    OP_NAME = 5,
+    OP_MEMBER_NAME = 6,
+    OP_TYPE_ARRAY = 28,
+    OP_TYPE_RUNTIME_ARRAY = 29,
+    OP_TYPE_STRUCT = 30,
+    OP_TYPE_POINTER = 32,
+    OP_VARIABLE = 59,
+    OP_DECORATE = 71,
+    OP_MEMBER_DECORATE = 72
+};
+
+enum SpvDecoration : uint32_t {
+    DECORATION_BLOCK = 2,
+    DECORATION_BUILTIN = 11,
+    DECORATION_LOCATION = 30,
+    DECORATION_BINDING = 33
+};
+
+enum SpvStorageClass : uint32_t {
+    STORAGE_UNIFORM_CONSTANT = 0,
+    STORAGE_INPUT = 1,
+    STORAGE_UNIFORM = 2
+};
+
+// 读取指令中的字面字符串（以0结尾，按小端打包在字中）
+std::string ReadLiteralString(const uint32_t* words, size_t count) {
+    std::string result;
+    for (size_t i = 0; i < count; i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            char c = static_cast<char>((words[i] >> shift) & 0xFF);
+            if (c == '\0') {
+                return result;
+            }
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+struct SpvVariable {
+    uint32_t id;
+    uint32_t pointerType;
+    uint32_t storageClass;
+};
+
+struct SpvModuleInfo {
+    std::unordered_map<uint32_t, std::string> names;
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::string>> memberNames;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> structMembers;
+    std::unordered_map<uint32_t, uint32_t> pointee;       // 指针类型 → 指向类型
+    std::unordered_map<uint32_t, uint32_t> arrayElement;  // 数组类型 → 元素类型
+    std::unordered_map<uint32_t, int> locations;
+    std::unordered_map<uint32_t, int> bindings;
+    std::unordered_map<uint32_t, bool> builtins;          // 变量或结构体成员含BuiltIn
+    std::unordered_map<uint32_t, bool> blocks;
+    std::vector<SpvVariable> variables;                   // 按模块中出现的顺序
+};
+
+bool ScanModule(const std::vector<uint32_t>& spirv, SpvModuleInfo& info) {
+    if (spirv.size() < kSpvHeaderWords || spirv[0] != kSpvMagic) {
+        return false;
+    }
+
+    size_t pos = kSpvHeaderWords;
+    while (pos < spirv.size()) {
+        uint32_t wordCount = spirv[pos] >> 16;
+        uint32_t opcode = spirv[pos] & 0xFFFF;
+        if (wordCount == 0 || pos + wordCount > spirv.size()) {
+            return false;
+        }
+        const uint32_t* operands = spirv.data() + pos + 1;
+        size_t operandCount = wordCount - 1;
+
+        switch (opcode) {
+        case OP_NAME:
+            if (operandCount >= 2) {
+                info.names[operands[0]] = ReadLiteralString(operands + 1, operandCount - 1);
+            }
+            break;
+        case OP_MEMBER_NAME:
+            if (operandCount >= 3) {
+                info.memberNames[operands[0]][operands[1]] =
+                    ReadLiteralString(operands + 2, operandCount - 2);
+            }
+            break;
+        case OP_TYPE_ARRAY:
+        case OP_TYPE_RUNTIME_ARRAY:
+            if (operandCount >= 2) {
+                info.arrayElement[operands[0]] = operands[1];
+            }
+            break;
+        case OP_TYPE_STRUCT:
+            if (operandCount >= 1) {
+                info.structMembers[operands[0]].assign(operands + 1, operands + operandCount);
+            }
+            break;
+        case OP_TYPE_POINTER:
+            if (operandCount >= 3) {
+                info.pointee[operands[0]] = operands[2];
+            }
+            break;
+        case OP_VARIABLE:
+            if (operandCount >= 3) {
+                info.variables.push_back({operands[1], operands[0], operands[2]});
+            }
+            break;
+        case OP_DECORATE:
+            if (operandCount >= 2) {
+                uint32_t target = operands[0];
+                uint32_t decoration = operands[1];
+                if (decoration == DECORATION_LOCATION && operandCount >= 3) {
+                    info.locations[target] = static_cast<int>(operands[2]);
+                } else if (decoration == DECORATION_BINDING && operandCount >= 3) {
+                    info.bindings[target] = static_cast<int>(operands[2]);
+                } else if (decoration == DECORATION_BUILTIN) {
+                    info.builtins[target] = true;
+                } else if (decoration == DECORATION_BLOCK) {
+                    info.blocks[target] = true;
+                }
+            }
+            break;
+        case OP_MEMBER_DECORATE:
+            // gl_PerVertex等内置块以成员BuiltIn标记
+            if (operandCount >= 3 && operands[2] == DECORATION_BUILTIN) {
+                info.builtins[operands[0]] = true;
+            }
+            break;
+        default:
+            break;
+        }
+
+        pos += wordCount;
+    }
+    return true;
+}
+
+// 去掉数组包装，得到变量的基础类型
+uint32_t ResolveBaseType(const SpvModuleInfo& info, uint32_t pointerType) {
+    auto ptr = info.pointee.find(pointerType);
+    if (ptr == info.pointee.end()) {
+        return 0;
+    }
+    uint32_t type = ptr->second;
+    for (auto it = info.arrayElement.find(type); it != info.arrayElement.end();
+         it = info.arrayElement.find(type)) {
+        type = it->second;
+    }
+    return type;
+}
+
+bool IsBuiltin(const SpvModuleInfo& info, uint32_t id, uint32_t baseType) {
+    auto name = info.names.find(id);
+    if (name != info.names.end() && name->second.compare(0, 3, "gl_") == 0) {
+        return true;
+    }
+    return info.builtins.count(id) > 0 || info.builtins.count(baseType) > 0;
+}
+
+// 下一个未被显式location占用的编号
+int NextFreeLocation(const std::unordered_set<int>& used, int& next) {
+    while (used.count(next)) {
+        next++;
+    }
+    return next++;
+}
+
+#ifdef MCU_HAVE_GLSLANG
+EShLanguage ToGlslangStage(ShaderStage stage) {
+    switch (stage) {
+    case ShaderStage::VERTEX: return EShLangVertex;
+    case ShaderStage::FRAGMENT: return EShLangFragment;
+    case ShaderStage::GEOMETRY: return EShLangGeometry;
+    case ShaderStage::COMPUTE: return EShLangCompute;
+    }
+    return EShLangVertex;
+}
+
+// glslang进程级初始化只需一次，TShader/TProgram本身可在多线程中独立使用
+void EnsureGlslangInitialized() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        glslang::InitializeProcess();
+    });
+}
+#endif
+
+} // namespace
+
+bool IsSPIRVCompilerAvailable() {
+#ifdef MCU_HAVE_GLSLANG
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CompileSPIRV(const std::string& source, ShaderStage stage, std::vector<uint32_t>& spirv,
+                  std::string& log, const SPIRVCompileOptions& options) {
+    spirv.clear();
+    log.clear();
+
+#ifdef MCU_HAVE_GLSLANG
+    EnsureGlslangInitialized();
+
+    EShLanguage language = ToGlslangStage(stage);
+    glslang::TShader shader(language);
+    const char* text = source.c_str();
+    int length = static_cast<int>(source.size());
+    shader.setStringsWithLengths(&text, &length, 1);
+    shader.setEntryPoint("main");
+
+    // 光影包面向OpenGL，按OpenGL语义生成SPIR-V
+    shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientOpenGL, 100);
+    shader.setEnvClient(glslang::EShClientOpenGL, glslang::EShTargetOpenGL_450);
+    shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+
+    // 光影包几乎不写layout(location)，由glslang自动分配
+    shader.setAutoMapLocations(true);
+    shader.setAutoMapBindings(true);
+
+    EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules);
+    if (!shader.parse(GetDefaultResources(), options.defaultVersion, ECoreProfile,
+                      false, false, messages)) {
+        log = shader.getInfoLog();
+        return false;
+    }
+
+    glslang::TProgram program;
+    program.addShader(&shader);
+    if (!program.link(messages) || !program.mapIO()) {
+        log = program.getInfoLog();
+        return false;
+    }
+
+    glslang::SpvOptions spvOptions;
+    spvOptions.disableOptimizer = !options.optimize;
+    spvOptions.optimizeSize = options.optimizeSize;
+
+    spv::SpvBuildLogger logger;
+    std::vector<unsigned int> words;
+    glslang::GlslangToSpv(*program.getIntermediate(language), words, &logger, &spvOptions);
+    log = logger.getAllMessages();
+    if (words.empty()) {
+        return false;
+    }
+
+    spirv.assign(words.begin(), words.end());
+    return true;
+#else
+    (void)source;
+    (void)stage;
+    (void)options;
+    log = "glslang not available";
+    return false;
+#endif
+}
+
+bool ReflectSPIRV(const std::vector<uint32_t>& spirv, ShaderStage stage,
+                  std::unordered_map<std::string, int>* uniforms,
+                  std::unordered_map<std::string, int>* attributes) {
+    SpvModuleInfo info;
+    if (!ScanModule(spirv, info)) {
+        return false;
+    }
+
+    // 先收集显式location，自动分配的编号跳过它们
+    std::unordered_set<int> usedUniforms;
+    std::unordered_set<int> usedAttributes;
+    for (const SpvVariable& variable : info.variables) {
+        auto loc = info.locations.find(variable.id);
+        auto binding = info.bindings.find(variable.id);
+        if (variable.storageClass == STORAGE_UNIFORM_CONSTANT) {
+            if (loc != info.locations.end()) {
+                usedUniforms.insert(loc->second);
+            } else if (binding != info.bindings.end()) {
+                usedUniforms.insert(binding->second);
+            }
+        } else if (variable.storageClass == STORAGE_INPUT && loc != info.locations.end()) {
+            usedAttributes.insert(loc->second);
+        }
+    }
+    int nextUniform = 0;
+    int nextAttribute = 0;
+
+    for (const SpvVariable& variable : info.variables) {
+        uint32_t baseType = ResolveBaseType(info, variable.pointerType);
+        auto nameIt = info.names.find(variable.id);
+        std::string name = nameIt != info.names.end() ? nameIt->second : std::string();
+
+        if (uniforms && variable.storageClass == STORAGE_UNIFORM_CONSTANT) {
+            // 采样器等不透明类型及OpenGL的散装uniform
+            if (name.empty()) {
+                continue;
+            }
+            auto loc = info.locations.find(variable.id);
+            auto binding = info.bindings.find(variable.id);
+            int location = loc != info.locations.end() ? loc->second
+                : binding != info.bindings.end() ? binding->second
+                : NextFreeLocation(usedUniforms, nextUniform);
+            (*uniforms)[name] = location;
+        } else if (uniforms && variable.storageClass == STORAGE_UNIFORM &&
+                   info.blocks.count(baseType)) {
+            // Uniform块按成员展开，默认块成员直接使用原名
+            auto members = info.structMembers.find(baseType);
+            if (members == info.structMembers.end()) {
+                continue;
+            }
+            auto blockName = info.names.find(baseType);
+            std::string prefix;
+            if (blockName != info.names.end() && blockName->second != "gl_DefaultUniformBlock") {
+                prefix = blockName->second + ".";
+            }
+            const auto& memberNames = info.memberNames[baseType];
+            for (uint32_t m = 0; m < members->second.size(); m++) {
+                auto memberName = memberNames.find(m);
+                if (memberName == memberNames.end()) {
+                    continue;
+                }
+                (*uniforms)[prefix + memberName->second] = NextFreeLocation(usedUniforms, nextUniform);
+            }
+        } else if (attributes && variable.storageClass == STORAGE_INPUT &&
+                   stage == ShaderStage::VERTEX) {
+            if (name.empty() || IsBuiltin(info, variable.id, baseType)) {
+                continue;
+            }
+            auto loc = info.locations.find(variable.id);
+            int location = loc != info.locations.end() ? loc->second
+                : NextFreeLocation(usedAttributes, nextAttribute);
+            (*attributes)[name] = location;
+        }
+    }
+
+    return true;
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
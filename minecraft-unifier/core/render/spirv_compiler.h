@@ -0,0 +1,38 @@
+/**
+ * Minecraft Unifier - SPIR-V Compiler
+ * SPIR-V编译器 - 通过glslang将GLSL编译为SPIR-V，并从SPIR-V反射Uniform与属性
+ */
+
+#pragma once
+#include "shader_converter.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// 编译选项
+struct SPIRVCompileOptions {
+    int defaultVersion = 330;       // 源码缺少#version时使用
+    bool optimize = true;           // 运行SPIR-V优化（需glslang带spirv-tools构建）
+    bool optimizeSize = true;       // 以体积为优化目标
+};
+
+// 是否链接了glslang
+bool IsSPIRVCompilerAvailable();
+
+// 编译GLSL为SPIR-V（OpenGL语义，自动分配location/binding），失败时log包含错误信息
+bool CompileSPIRV(const std::string& source, ShaderStage stage, std::vector<uint32_t>& spirv,
+                  std::string& log, const SPIRVCompileOptions& options = SPIRVCompileOptions());
+
+// 从SPIR-V反射Uniform与顶点属性（名称 → location），参数为nullptr时跳过
+bool ReflectSPIRV(const std::vector<uint32_t>& spirv, ShaderStage stage,
+                  std::unordered_map<std::string, int>* uniforms,
+                  std::unordered_map<std::string, int>* attributes);
+
+} // namespace render
+} // namespace core
+} // namespace mcu
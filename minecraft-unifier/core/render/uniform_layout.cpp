@@ -0,0 +1,153 @@
+/**
+ * Minecraft Unifier - Uniform Layout Implementation
+ * Uniform布局实现
+ */
+
+#include "uniform_layout.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+namespace {
+
+struct UniformType {
+    const char* name;
+    uint32_t count;
+};
+
+// 按float计的分量数（int/bool以同样宽度上传）
+const UniformType kUniformTypes[] = {
+    {"float", 1}, {"vec2", 2}, {"vec3", 3}, {"vec4", 4},
+    {"int", 1}, {"ivec2", 2}, {"ivec3", 3}, {"ivec4", 4},
+    {"uint", 1}, {"uvec2", 2}, {"uvec3", 3}, {"uvec4", 4},
+    {"bool", 1}, {"bvec2", 2}, {"bvec3", 3}, {"bvec4", 4},
+    {"mat2", 4}, {"mat3", 9}, {"mat4", 16},
+};
+
+bool IsIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+size_t SkipSpace(const std::string& source, size_t pos) {
+    while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos]))) {
+        pos++;
+    }
+    return pos;
+}
+
+size_t ReadIdentifier(const std::string& source, size_t pos, std::string& identifier) {
+    size_t end = pos;
+    while (end < source.size() && IsIdentifierChar(source[end])) {
+        end++;
+    }
+    identifier.assign(source, pos, end - pos);
+    return end;
+}
+
+} // namespace
+
+// ==================== UniformLayout ====================
+
+UniformLayout::UniformLayout()
+    : bufferSize_(0) {
+}
+
+int UniformLayout::Add(const std::string& name, uint32_t count, int location) {
+    auto it = slotIndex_.find(name);
+    if (it != slotIndex_.end()) {
+        return it->second;
+    }
+
+    int slot = static_cast<int>(slots_.size());
+    slots_.push_back({name, static_cast<uint32_t>(bufferSize_), count, location});
+    slotIndex_[name] = slot;
+    bufferSize_ += count;
+    return slot;
+}
+
+void UniformLayout::AddFromSource(const std::string& source,
+                                  const std::unordered_map<std::string, int>& locations) {
+    static const char kKeyword[] = "uniform";
+    const size_t keywordLength = sizeof(kKeyword) - 1;
+
+    size_t pos = 0;
+    while ((pos = source.find(kKeyword, pos)) != std::string::npos) {
+        size_t start = pos;
+        pos += keywordLength;
+        if ((start > 0 && IsIdentifierChar(source[start - 1])) ||
+            (pos < source.size() && IsIdentifierChar(source[pos]))) {
+            continue;
+        }
+
+        // uniform 类型 名称[数组长度];
+        std::string type;
+        std::string name;
+        size_t cursor = ReadIdentifier(source, SkipSpace(source, pos), type);
+        cursor = ReadIdentifier(source, SkipSpace(source, cursor), name);
+        if (type.empty() || name.empty()) {
+            continue;
+        }
+        auto known = std::find_if(std::begin(kUniformTypes), std::end(kUniformTypes),
+                                  [&type](const UniformType& t) { return type == t.name; });
+        if (known == std::end(kUniformTypes)) {
+            continue;
+        }
+
+        uint32_t arraySize = 1;
+        cursor = SkipSpace(source, cursor);
+        if (cursor < source.size() && source[cursor] == '[') {
+            arraySize = static_cast<uint32_t>(std::strtoul(source.c_str() + cursor + 1, nullptr, 10));
+            if (arraySize == 0) {
+                continue;
+            }
+        }
+
+        auto location = locations.find(name);
+        Add(name, known->count * arraySize,
+            location != locations.end() ? location->second : static_cast<int>(slots_.size()));
+    }
+}
+
+int UniformLayout::FindSlot(const std::string& name) const {
+    auto it = slotIndex_.find(name);
+    return it != slotIndex_.end() ? it->second : -1;
+}
+
+// ==================== UniformBuffer ====================
+
+UniformBuffer::UniformBuffer(std::shared_ptr<const UniformLayout> layout)
+    : layout_(std::move(layout))
+    , data_(layout_->GetBufferSize(), 0.0f) {
+}
+
+UniformBuffer::UniformBuffer(const UniformLayout& layout)
+    : UniformBuffer(std::make_shared<const UniformLayout>(layout)) {
+}
+
+void UniformBuffer::Set(int slot, const float* values, uint32_t count) {
+    if (slot < 0 || static_cast<size_t>(slot) >= layout_->GetSlotCount()) {
+        return;
+    }
+    const UniformSlot& target = layout_->GetSlot(slot);
+    if (target.offset + target.count > data_.size()) {
+        return;
+    }
+    std::memcpy(data_.data() + target.offset, values, std::min(count, target.count) * sizeof(float));
+}
+
+void UniformBuffer::Set(int slot, float value) {
+    Set(slot, &value, 1);
+}
+
+void UniformBuffer::CopyFrom(const float* data, size_t count) {
+    std::memcpy(data_.data(), data, std::min(count, data_.size()) * sizeof(float));
+}
+
+} // namespace render
+} // namespace core
+} // namespace mcu
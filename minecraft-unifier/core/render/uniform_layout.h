@@ -0,0 +1,81 @@
+/**
+ * Minecraft Unifier - Uniform Layout
+ * Uniform布局 - 名称在编译材质时一次性解析为槽位，每帧按槽位写入打包缓冲区
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace render {
+
+// Uniform槽位（偏移与长度以float计）
+struct UniformSlot {
+    std::string name;
+    uint32_t offset;
+    uint32_t count;
+    int location;
+};
+
+// 材质的Uniform布局：各Uniform按登记顺序紧密排列在一个float缓冲区中
+class UniformLayout {
+public:
+    UniformLayout();
+
+    // 登记Uniform，同名Uniform只保留第一次登记，返回槽位索引
+    int Add(const std::string& name, uint32_t count, int location);
+
+    // 扫描源代码中的uniform声明并登记（采样器等不透明类型跳过）
+    // locations为反射得到的location，缺失时按登记顺序分配
+    void AddFromSource(const std::string& source, const std::unordered_map<std::string, int>& locations);
+
+    // 查找槽位索引，不存在返回-1（在初始化时调用，不要放在每帧路径上）
+    int FindSlot(const std::string& name) const;
+
+    const UniformSlot& GetSlot(int slot) const { return slots_[slot]; }
+    const std::vector<UniformSlot>& GetSlots() const { return slots_; }
+    size_t GetSlotCount() const { return slots_.size(); }
+
+    // 缓冲区大小（float数）
+    size_t GetBufferSize() const { return bufferSize_; }
+
+private:
+    std::vector<UniformSlot> slots_;
+    std::unordered_map<std::string, int> slotIndex_;
+    size_t bufferSize_;
+};
+
+// 打包的Uniform缓冲区，每帧写入后整体上传（布局改变后需重新创建）
+// 缓冲区共享持有创建时的布局，材质重建后旧缓冲区仍可安全访问
+class UniformBuffer {
+public:
+    explicit UniformBuffer(std::shared_ptr<const UniformLayout> layout);
+    explicit UniformBuffer(const UniformLayout& layout);  // 复制一份布局
+
+    // 写入槽位，count超出槽位长度时截断
+    void Set(int slot, const float* values, uint32_t count);
+    void Set(int slot, float value);
+
+    // 从按布局排列的数据整体复制
+    void CopyFrom(const float* data, size_t count);
+
+    const UniformLayout& GetLayout() const { return *layout_; }
+    const std::shared_ptr<const UniformLayout>& GetSharedLayout() const { return layout_; }
+    float* Data() { return data_.data(); }
+    const float* Data() const { return data_.data(); }
+    size_t Size() const { return data_.size(); }
+
+private:
+    std::shared_ptr<const UniformLayout> layout_;
+    std::vector<float> data_;
+};
+
+} // namespace render
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,675 @@
+/**
+ * Minecraft Unifier - Audio Converter Implementation
+ * 音频转换实现 - SSE2/NEON加速的下混与重采样，可选libvorbis编码
+ */
+
+#include "audio_converter.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef MCU_HAVE_VORBIS
+#include <functional>
+#include <vorbis/vorbisenc.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// 重采样核：32抽头，256相位
+const int kTaps = 32;
+const int kHalfTaps = kTaps / 2;
+const int kPhases = 256;
+
+uint16_t ReadLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void WriteLE16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void WriteLE32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+}
+
+bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& data, size_t limit = SIZE_MAX) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        std::fclose(file);
+        return false;
+    }
+    data.resize(std::min(static_cast<size_t>(size), limit));
+    size_t read = std::fread(data.data(), 1, data.size(), file);
+    std::fclose(file);
+    return read == data.size();
+}
+
+std::string LowerExtension(const std::string& path) {
+    std::string ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext;
+}
+
+// 32抽头点积
+float DotTaps(const float* a, const float* b) {
+#if defined(__SSE2__)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (int k = 0; k < kTaps; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + k), _mm_loadu_ps(b + k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + k + 4), _mm_loadu_ps(b + k + 4)));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+#elif defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (int k = 0; k < kTaps; k += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + k), vld1q_f32(b + k));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + k + 4), vld1q_f32(b + k + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+    float acc = 0.0f;
+    for (int k = 0; k < kTaps; k++) {
+        acc += a[k] * b[k];
+    }
+    return acc;
+#endif
+}
+
+// 立体声 → 单声道
+void DownmixStereoToMono(const float* in, float* out, size_t frames) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + i * 2);
+        __m128 b = _mm_loadu_ps(in + i * 2 + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vld2q_f32(in + i * 2);
+        vst1q_f32(out + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+#endif
+    for (; i < frames; i++) {
+        out[i] = (in[i * 2] + in[i * 2 + 1]) * 0.5f;
+    }
+}
+
+// 浮点 → 16位整数（饱和）
+void FloatToPCM16(const float* in, int16_t* out, size_t count) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi), scale);
+        __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi), scale);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t scale = vdupq_n_f32(32767.0f);
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + i), lo), hi), scale);
+        float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), lo), hi), scale);
+        int16x8_t packed = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+        vst1q_s16(out + i, packed);
+    }
+#endif
+    for (; i < count; i++) {
+        float v = std::min(1.0f, std::max(-1.0f, in[i])) * 32767.0f;
+        out[i] = static_cast<int16_t>(std::lrint(v));
+    }
+}
+
+// 生成Blackman窗sinc多相滤波器表，cutoff为相对输入奈奎斯特频率的截止比例
+std::vector<float> BuildResampleKernel(double cutoff) {
+    std::vector<float> table((kPhases + 1) * kTaps);
+    for (int phase = 0; phase <= kPhases; phase++) {
+        double frac = static_cast<double>(phase) / kPhases;
+        double sum = 0.0;
+        float* row = table.data() + phase * kTaps;
+        for (int k = 0; k < kTaps; k++) {
+            // 抽头k对应输入样本 i0 - (kHalfTaps - 1) + k
+            double t = k - (kHalfTaps - 1) - frac;
+            double window = 0.42 + 0.5 * std::cos(kPi * t / kHalfTaps) + 0.08 * std::cos(2.0 * kPi * t / kHalfTaps);
+            double x = kPi * cutoff * t;
+            double sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(x) / x;
+            double h = std::fabs(t) >= kHalfTaps ? 0.0 : cutoff * sinc * window;
+            row[k] = static_cast<float>(h);
+            sum += h;
+        }
+        // 归一化直流增益
+        for (int k = 0; k < kTaps; k++) {
+            row[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+    return table;
+}
+
+#ifdef MCU_HAVE_VORBIS
+bool EncodeVorbisFile(const std::string& path, const AudioBuffer& buffer, float quality) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    vorbis_info info;
+    vorbis_info_init(&info);
+    if (vorbis_encode_init_vbr(&info, buffer.channels, buffer.sampleRate, quality) != 0) {
+        vorbis_info_clear(&info);
+        std::fclose(file);
+        return false;
+    }
+
+    vorbis_comment comment;
+    vorbis_comment_init(&comment);
+    vorbis_comment_add_tag(&comment, "ENCODER", "minecraft-unifier");
+
+    vorbis_dsp_state dsp;
+    vorbis_block block;
+    vorbis_analysis_init(&dsp, &info);
+    vorbis_block_init(&dsp, &block);
+
+    ogg_stream_state stream;
+    ogg_stream_init(&stream, static_cast<int>(std::hash<std::string>()(path) & 0x7FFFFFFF));
+
+    bool success = true;
+    auto writePage = [&](const ogg_page& page) {
+        if (std::fwrite(page.header, 1, page.header_len, file) != static_cast<size_t>(page.header_len) ||
+            std::fwrite(page.body, 1, page.body_len, file) != static_cast<size_t>(page.body_len)) {
+            success = false;
+        }
+    };
+
+    ogg_packet header, headerComment, headerCode;
+    vorbis_analysis_headerout(&dsp, &comment, &header, &headerComment, &headerCode);
+    ogg_stream_packetin(&stream, &header);
+    ogg_stream_packetin(&stream, &headerComment);
+    ogg_stream_packetin(&stream, &headerCode);
+    ogg_page page;
+    while (ogg_stream_flush(&stream, &page) != 0) {
+        writePage(page);
+    }
+
+    auto drain = [&]() {
+        ogg_packet packet;
+        while (vorbis_analysis_blockout(&dsp, &block) == 1) {
+            vorbis_analysis(&block, nullptr);
+            vorbis_bitrate_addblock(&block);
+            while (vorbis_bitrate_flushpacket(&dsp, &packet)) {
+                ogg_stream_packetin(&stream, &packet);
+                while (ogg_stream_pageout(&stream, &page) != 0) {
+                    writePage(page);
+                }
+            }
+        }
+    };
+
+    const size_t chunkFrames = 4096;
+    size_t frames = buffer.FrameCount();
+    for (size_t start = 0; start < frames && success; start += chunkFrames) {
+        size_t count = std::min(chunkFrames, frames - start);
+        float** planes = vorbis_analysis_buffer(&dsp, static_cast<int>(count));
+        for (size_t i = 0; i < count; i++) {
+            for (uint16_t c = 0; c < buffer.channels; c++) {
+                planes[c][i] = buffer.samples[(start + i) * buffer.channels + c];
+            }
+        }
+        vorbis_analysis_wrote(&dsp, static_cast<int>(count));
+        drain();
+    }
+    vorbis_analysis_wrote(&dsp, 0);
+    drain();
+    while (ogg_stream_flush(&stream, &page) != 0) {
+        writePage(page);
+    }
+
+    ogg_stream_clear(&stream);
+    vorbis_block_clear(&block);
+    vorbis_dsp_clear(&dsp);
+    vorbis_comment_clear(&comment);
+    vorbis_info_clear(&info);
+
+    if (std::fclose(file) != 0) {
+        success = false;
+    }
+    return success;
+}
+#endif
+
+} // namespace
+
+// ==================== WAV ====================
+
+bool ReadWAVInfo(const uint8_t* data, size_t size, WavInfo& info) {
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool haveFormat = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* id = data + pos;
+        uint32_t chunkSize = ReadLE32(data + pos + 4);
+        size_t body = pos + 8;
+
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || body + 16 > size) {
+                return false;
+            }
+            info.format = ReadLE16(data + body);
+            info.channels = ReadLE16(data + body + 2);
+            info.sampleRate = ReadLE32(data + body + 4);
+            info.bitsPerSample = ReadLE16(data + body + 14);
+            // WAVE_FORMAT_EXTENSIBLE：子格式GUID前两字节为实际格式
+            if (info.format == 0xFFFE && chunkSize >= 40 && body + 26 <= size) {
+                info.format = ReadLE16(data + body + 24);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (!haveFormat) {
+                return false;
+            }
+            info.dataOffset = body;
+            info.dataSize = std::min<size_t>(chunkSize, size - std::min(size, body));
+            bool pcm = info.format == 1 && (info.bitsPerSample == 8 || info.bitsPerSample == 16 ||
+                                             info.bitsPerSample == 24 || info.bitsPerSample == 32);
+            bool ieee = info.format == 3 && (info.bitsPerSample == 32 || info.bitsPerSample == 64);
+            return info.channels > 0 && info.sampleRate > 0 && (pcm || ieee);
+        }
+
+        // 块按偶数字节对齐
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+bool DecodeWAV(const uint8_t* data, size_t size, AudioBuffer& out) {
+    WavInfo info;
+    if (!ReadWAVInfo(data, size, info)) {
+        return false;
+    }
+
+    size_t bytesPerSample = info.bitsPerSample / 8;
+    size_t frames = info.dataSize / (bytesPerSample * info.channels);
+    size_t count = frames * info.channels;
+    const uint8_t* src = data + info.dataOffset;
+
+    out.sampleRate = info.sampleRate;
+    out.channels = info.channels;
+    out.samples.resize(count);
+    float* dst = out.samples.data();
+
+    if (info.format == 3) {
+        for (size_t i = 0; i < count; i++) {
+            if (bytesPerSample == 4) {
+                float v;
+                std::memcpy(&v, src + i * 4, 4);
+                dst[i] = v;
+            } else {
+                double v;
+                std::memcpy(&v, src + i * 8, 8);
+                dst[i] = static_cast<float>(v);
+            }
+        }
+        return true;
+    }
+
+    switch (info.bitsPerSample) {
+        case 8:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = (static_cast<int>(src[i]) - 128) / 128.0f;
+            }
+            break;
+        case 16:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<int16_t>(ReadLE16(src + i * 2)) / 32768.0f;
+            }
+            break;
+        case 24:
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t* p = src + i * 3;
+                int32_t v = static_cast<int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+                dst[i] = v / 8388608.0f;
+            }
+            break;
+        case 32:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<float>(static_cast<int32_t>(ReadLE32(src + i * 4)) / 2147483648.0);
+            }
+            break;
+    }
+    return true;
+}
+
+bool DecodeWAVFile(const std::string& path, AudioBuffer& out) {
+    std::vector<uint8_t> data;
+    if (!ReadFileBytes(path, data)) {
+        return false;
+    }
+    return DecodeWAV(data.data(), data.size(), out);
+}
+
+bool EncodePCM16WAVFile(const std::string& path, const AudioBuffer& buffer) {
+    if (buffer.channels == 0 || buffer.sampleRate == 0) {
+        return false;
+    }
+
+    uint32_t dataSize = static_cast<uint32_t>(buffer.samples.size() * 2);
+    uint8_t header[44];
+    std::memcpy(header, "RIFF", 4);
+    WriteLE32(header + 4, 36 + dataSize);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    WriteLE32(header + 16, 16);
+    WriteLE16(header + 20, 1);
+    WriteLE16(header + 22, buffer.channels);
+    WriteLE32(header + 24, buffer.sampleRate);
+    WriteLE32(header + 28, buffer.sampleRate * buffer.channels * 2);
+    WriteLE16(header + 32, static_cast<uint16_t>(buffer.channels * 2));
+    WriteLE16(header + 34, 16);
+    std::memcpy(header + 36, "data", 4);
+    WriteLE32(header + 40, dataSize);
+
+    std::vector<int16_t> pcm(buffer.samples.size());
+    FloatToPCM16(buffer.samples.data(), pcm.data(), pcm.size());
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool success = std::fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+                   std::fwrite(pcm.data(), 2, pcm.size(), file) == pcm.size();
+    return std::fclose(file) == 0 && success;
+}
+
+// ==================== 下混/重采样 ====================
+
+void DownmixAudio(const AudioBuffer& in, uint16_t channels, AudioBuffer& out) {
+    size_t frames = in.FrameCount();
+    out.sampleRate = in.sampleRate;
+    out.channels = channels;
+    out.samples.resize(frames * channels);
+
+    if (in.channels == channels) {
+        out.samples = in.samples;
+        return;
+    }
+    if (in.channels == 2 && channels == 1) {
+        DownmixStereoToMono(in.samples.data(), out.samples.data(), frames);
+        return;
+    }
+    if (in.channels == 1) {
+        for (size_t i = 0; i < frames; i++) {
+            for (uint16_t c = 0; c < channels; c++) {
+                out.samples[i * channels + c] = in.samples[i];
+            }
+        }
+        return;
+    }
+
+    // 多声道：前置左右直通，中置以-3dB分到两侧，其余声道按奇偶归入左右
+    // 只能下混到单声道或立体声
+    if (channels != 1 && channels != 2) {
+        channels = 2;
+        out.channels = channels;
+        out.samples.resize(frames * channels);
+    }
+    const float centerGain = 0.70710678f;
+    for (size_t i = 0; i < frames; i++) {
+        const float* src = in.samples.data() + i * in.channels;
+        float left = src[0];
+        float right = src[1];
+        for (uint16_t c = 2; c < in.channels; c++) {
+            if (c == 2) {
+                left += src[c] * centerGain;
+                right += src[c] * centerGain;
+            } else if (c == 3) {
+                continue; // LFE
+            } else if (c % 2 == 0) {
+                left += src[c] * centerGain;
+            } else {
+                right += src[c] * centerGain;
+            }
+        }
+        if (channels == 1) {
+            out.samples[i] = (left + right) * 0.5f;
+        } else {
+            out.samples[i * 2] = left;
+            out.samples[i * 2 + 1] = right;
+        }
+    }
+}
+
+void ResampleAudio(const AudioBuffer& in, uint32_t sampleRate, AudioBuffer& out) {
+    if (in.sampleRate == sampleRate || in.sampleRate == 0 || sampleRate == 0) {
+        out = in;
+        return;
+    }
+
+    size_t inFrames = in.FrameCount();
+    size_t outFrames = static_cast<size_t>((static_cast<uint64_t>(inFrames) * sampleRate + in.sampleRate - 1) / in.sampleRate);
+    out.sampleRate = sampleRate;
+    out.channels = in.channels;
+    out.samples.assign(outFrames * in.channels, 0.0f);
+
+    // 降采样时截止频率随比例下移以抑制混叠
+    double cutoff = std::min(1.0, static_cast<double>(sampleRate) / in.sampleRate);
+    std::vector<float> kernel = BuildResampleKernel(cutoff);
+
+    // 逐声道处理，两端补零
+    std::vector<float> planar(inFrames + kTaps + 1, 0.0f);
+    for (uint16_t c = 0; c < in.channels; c++) {
+        for (size_t i = 0; i < inFrames; i++) {
+            planar[i + kHalfTaps] = in.samples[i * in.channels + c];
+        }
+        for (size_t n = 0; n < outFrames; n++) {
+            uint64_t position = static_cast<uint64_t>(n) * in.sampleRate;
+            size_t i0 = static_cast<size_t>(position / sampleRate);
+            uint64_t remainder = position % sampleRate;
+            size_t phase = static_cast<size_t>((remainder * kPhases + sampleRate / 2) / sampleRate);
+            // 输入样本 i0 - (kHalfTaps - 1) 位于补零数组的 i0 + 1
+            out.samples[n * in.channels + c] = DotTaps(planar.data() + i0 + 1, kernel.data() + phase * kTaps);
+        }
+    }
+}
+
+bool IsVorbisEncoderAvailable() {
+#ifdef MCU_HAVE_VORBIS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ==================== AudioConverter ====================
+
+AudioConverter::AudioConverter() {
+}
+
+AudioConverter::~AudioConverter() {
+}
+
+void AudioConverter::SetOptions(const AudioConvertOptions& options) {
+    options_ = options;
+}
+
+AudioCodec AudioConverter::ResolveCodec() const {
+    if (options_.codec == AudioCodec::AUTO || (options_.codec == AudioCodec::VORBIS && !IsVorbisEncoderAvailable())) {
+        return IsVorbisEncoderAvailable() ? AudioCodec::VORBIS : AudioCodec::PCM16_WAV;
+    }
+    return options_.codec;
+}
+
+std::string AudioConverter::GetOutputExtension() const {
+    return ResolveCodec() == AudioCodec::VORBIS ? ".ogg" : ".wav";
+}
+
+bool AudioConverter::CanPassThrough(const std::string& inputPath, AudioCodec codec) const {
+    std::string ext = LowerExtension(inputPath);
+
+    // Ogg Vorbis基岩版可直接播放
+    if (ext == ".ogg") {
+        return true;
+    }
+
+    if (ext != ".wav" || codec != AudioCodec::PCM16_WAV) {
+        return false;
+    }
+
+    // 只读取头部判断是否已是目标格式
+    std::vector<uint8_t> header;
+    WavInfo info;
+    if (!ReadFileBytes(inputPath, header, 64 * 1024) || !ReadWAVInfo(header.data(), header.size(), info)) {
+        return false;
+    }
+    bool channelsMatch = options_.channels == 0 ? info.channels <= 2 : info.channels == options_.channels;
+    bool rateMatch = options_.sampleRate == 0 || info.sampleRate == options_.sampleRate;
+    return info.format == 1 && info.bitsPerSample == 16 && channelsMatch && rateMatch;
+}
+
+bool AudioConverter::Encode(const AudioBuffer& buffer, AudioCodec codec, const std::string& path) const {
+#ifdef MCU_HAVE_VORBIS
+    if (codec == AudioCodec::VORBIS) {
+        return EncodeVorbisFile(path, buffer, options_.quality);
+    }
+#endif
+    (void)codec;
+    return EncodePCM16WAVFile(path, buffer);
+}
+
+std::string AudioConverter::ConvertInternal(const std::string& inputPath, const std::string& outputPath,
+                                            bool& passedThrough) {
+    passedThrough = false;
+    AudioCodec codec = ResolveCodec();
+
+    // 快速路径：已是目标格式时直接复制
+    if (CanPassThrough(inputPath, codec)) {
+        fs::path target = fs::path(outputPath).replace_extension(fs::path(inputPath).extension());
+        std::error_code ec;
+        if (!fs::equivalent(inputPath, target, ec)) {
+            fs::copy_file(inputPath, target, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                return "";
+            }
+        }
+        passedThrough = true;
+        return target.string();
+    }
+
+    if (LowerExtension(inputPath) != ".wav") {
+        return "";
+    }
+
+    AudioBuffer buffer;
+    if (!DecodeWAVFile(inputPath, buffer)) {
+        return "";
+    }
+
+    if (options_.channels > 2) {
+        return "";
+    }
+    uint16_t channels = options_.channels != 0 ? options_.channels : std::min<uint16_t>(buffer.channels, 2);
+    if (channels != buffer.channels) {
+        AudioBuffer mixed;
+        DownmixAudio(buffer, channels, mixed);
+        buffer.samples.swap(mixed.samples);
+        buffer.channels = mixed.channels;
+    }
+
+    if (options_.sampleRate != 0 && options_.sampleRate != buffer.sampleRate) {
+        AudioBuffer resampled;
+        ResampleAudio(buffer, options_.sampleRate, resampled);
+        buffer.samples.swap(resampled.samples);
+        buffer.sampleRate = resampled.sampleRate;
+    }
+
+    std::string target = fs::path(outputPath).replace_extension(codec == AudioCodec::VORBIS ? ".ogg" : ".wav").string();
+    if (!Encode(buffer, codec, target)) {
+        return "";
+    }
+    return target;
+}
+
+std::string AudioConverter::Convert(const std::string& inputPath, const std::string& outputPath) {
+    bool passedThrough = false;
+    return ConvertInternal(inputPath, outputPath, passedThrough);
+}
+
+AudioConvertStats AudioConverter::ConvertBatch(const std::vector<AudioJob>& jobs) {
+    std::atomic<size_t> converted(0);
+    std::atomic<size_t> passedThrough(0);
+    std::atomic<size_t> failed(0);
+    std::vector<std::string> outputs(jobs.size());
+
+    // 每个文件独立解码/编码，按文件分配到线程池
+    common::ThreadPool::GetDefault().ParallelFor(0, jobs.size(), [&](size_t i) {
+        bool copied = false;
+        std::string result = ConvertInternal(jobs[i].inputPath, jobs[i].outputPath, copied);
+        outputs[i] = result;
+        if (result.empty()) {
+            failed++;
+        } else if (copied) {
+            passedThrough++;
+        } else {
+            converted++;
+        }
+    });
+
+    AudioConvertStats stats;
+    stats.converted = converted.load();
+    stats.passedThrough = passedThrough.load();
+    stats.failed = failed.load();
+    stats.outputs.swap(outputs);
+    return stats;
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,110 @@
+/**
+ * Minecraft Unifier - Audio Converter
+ * 音频转换 - WAV解析、下混、重采样与编码的批处理流水线
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// 交错排列的浮点PCM
+struct AudioBuffer {
+    uint32_t sampleRate = 0;
+    uint16_t channels = 0;
+    std::vector<float> samples;     // 帧数 = samples.size() / channels
+
+    size_t FrameCount() const { return channels ? samples.size() / channels : 0; }
+};
+
+// WAV格式信息（仅解析头部）
+struct WavInfo {
+    uint16_t format = 0;            // 1: PCM, 3: IEEE float
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t bitsPerSample = 0;
+    size_t dataOffset = 0;
+    size_t dataSize = 0;
+};
+
+// 输出编码
+enum class AudioCodec {
+    AUTO,           // 有libvorbis时输出Ogg Vorbis，否则输出PCM16 WAV
+    VORBIS,
+    PCM16_WAV
+};
+
+// 转换选项
+struct AudioConvertOptions {
+    uint32_t sampleRate = 0;        // 0表示保持原采样率
+    uint16_t channels = 0;          // 0表示保持（多于2声道时下混为立体声），只支持1或2
+    AudioCodec codec = AudioCodec::AUTO;
+    float quality = 0.4f;           // Vorbis VBR质量(-0.1 ~ 1.0)
+};
+
+// 单个转换任务
+struct AudioJob {
+    std::string inputPath;
+    std::string outputPath;         // 扩展名由编码决定，会被替换
+};
+
+// 批处理统计
+struct AudioConvertStats {
+    size_t converted = 0;
+    size_t passedThrough = 0;       // 已是目标格式，直接复制
+    size_t failed = 0;
+    std::vector<std::string> outputs;   // 与任务一一对应，失败的任务为空
+};
+
+// WAV解析
+bool ReadWAVInfo(const uint8_t* data, size_t size, WavInfo& info);
+bool DecodeWAV(const uint8_t* data, size_t size, AudioBuffer& out);
+bool DecodeWAVFile(const std::string& path, AudioBuffer& out);
+
+// 下混到目标声道数（1或2），多声道输入的其他目标按立体声处理
+void DownmixAudio(const AudioBuffer& in, uint16_t channels, AudioBuffer& out);
+
+// 带限sinc重采样
+void ResampleAudio(const AudioBuffer& in, uint32_t sampleRate, AudioBuffer& out);
+
+// 以16位PCM写出WAV
+bool EncodePCM16WAVFile(const std::string& path, const AudioBuffer& buffer);
+
+// 是否编译了Vorbis编码支持
+bool IsVorbisEncoderAvailable();
+
+// 音频转换器
+class AudioConverter {
+public:
+    AudioConverter();
+    ~AudioConverter();
+
+    void SetOptions(const AudioConvertOptions& options);
+    const AudioConvertOptions& GetOptions() const { return options_; }
+
+    // 当前编码对应的输出扩展名（".ogg" / ".wav"）
+    std::string GetOutputExtension() const;
+
+    // 转换单个文件，返回实际输出路径（失败时为空）
+    std::string Convert(const std::string& inputPath, const std::string& outputPath);
+
+    // 在线程池上并行转换多个文件
+    AudioConvertStats ConvertBatch(const std::vector<AudioJob>& jobs);
+
+private:
+    AudioConvertOptions options_;
+
+    AudioCodec ResolveCodec() const;
+    bool CanPassThrough(const std::string& inputPath, AudioCodec codec) const;
+    bool Encode(const AudioBuffer& buffer, AudioCodec codec, const std::string& path) const;
+    std::string ConvertInternal(const std::string& inputPath, const std::string& outputPath, bool& passedThrough);
+};
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
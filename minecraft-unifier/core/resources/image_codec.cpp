@@ -0,0 +1,334 @@
+/**
+ * Minecraft Unifier - Image Codec Implementation
+ * 图像编解码实现 - 基于zlib的PNG读写
+ */
+
+#include "image_codec.h"
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <cstdlib>
+#include <zlib.h>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+uint32_t ReadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+void WriteBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void WriteChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size) {
+    WriteBE32(out, static_cast<uint32_t>(size));
+    size_t typePos = out.size();
+    out.insert(out.end(), type, type + 4);
+    if (size > 0) {
+        out.insert(out.end(), data, data + size);
+    }
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, out.data() + typePos, static_cast<uInt>(size + 4));
+    WriteBE32(out, static_cast<uint32_t>(crc));
+}
+
+uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = int(a) + int(b) - int(c);
+    int pa = std::abs(p - int(a));
+    int pb = std::abs(p - int(b));
+    int pc = std::abs(p - int(c));
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+// 反向应用扫描线过滤器
+bool Unfilter(uint8_t* raw, uint32_t height, size_t rowBytes, size_t bpp, std::vector<uint8_t>& out) {
+    out.assign(rowBytes * height, 0);
+    const uint8_t* prev = nullptr;
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t filter = raw[y * (rowBytes + 1)];
+        const uint8_t* line = raw + y * (rowBytes + 1) + 1;
+        uint8_t* dst = out.data() + y * rowBytes;
+        for (size_t i = 0; i < rowBytes; i++) {
+            uint8_t a = i >= bpp ? dst[i - bpp] : 0;
+            uint8_t b = prev ? prev[i] : 0;
+            uint8_t c = (prev && i >= bpp) ? prev[i - bpp] : 0;
+            switch (filter) {
+                case 0: dst[i] = line[i]; break;
+                case 1: dst[i] = line[i] + a; break;
+                case 2: dst[i] = line[i] + b; break;
+                case 3: dst[i] = line[i] + static_cast<uint8_t>((int(a) + int(b)) / 2); break;
+                case 4: dst[i] = line[i] + Paeth(a, b, c); break;
+                default: return false;
+            }
+        }
+        prev = dst;
+    }
+    return true;
+}
+
+// 从扫描线中取出第index个样本（位深1/2/4/8/16，16位取高字节）
+uint8_t Sample(const uint8_t* row, size_t index, int bitDepth) {
+    switch (bitDepth) {
+        case 16: return row[index * 2];
+        case 8:  return row[index];
+        default: {
+            size_t bitPos = index * bitDepth;
+            uint8_t byte = row[bitPos / 8];
+            int shift = 8 - bitDepth - static_cast<int>(bitPos % 8);
+            return static_cast<uint8_t>((byte >> shift) & ((1 << bitDepth) - 1));
+        }
+    }
+}
+
+} // namespace
+
+bool DecodePNG(const uint8_t* data, size_t size, Image& out) {
+    if (size < 8 || std::memcmp(data, kPngSignature, 8) != 0) {
+        return false;
+    }
+
+    uint32_t width = 0, height = 0;
+    int bitDepth = 0, colorType = -1, interlace = 0;
+    std::vector<uint8_t> palette;      // RGB三元组
+    std::vector<uint8_t> paletteAlpha; // tRNS
+    std::vector<uint8_t> idat;
+
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        uint32_t len = ReadBE32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (len > size - pos - 12) {
+            return false;
+        }
+
+        if (std::memcmp(type, "IHDR", 4) == 0 && len >= 13) {
+            width = ReadBE32(body);
+            height = ReadBE32(body + 4);
+            bitDepth = body[8];
+            colorType = body[9];
+            interlace = body[12];
+        } else if (std::memcmp(type, "PLTE", 4) == 0) {
+            palette.assign(body, body + len);
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            paletteAlpha.assign(body, body + len);
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            idat.insert(idat.end(), body, body + len);
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + len;
+    }
+
+    // 暂不支持Adam7隔行扫描
+    if (width == 0 || height == 0 || interlace != 0 || idat.empty()) {
+        return false;
+    }
+
+    int channels;
+    switch (colorType) {
+        case 0: channels = 1; break; // 灰度
+        case 2: channels = 3; break; // RGB
+        case 3: channels = 1; break; // 调色板
+        case 4: channels = 2; break; // 灰度+Alpha
+        case 6: channels = 4; break; // RGBA
+        default: return false;
+    }
+    if (bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8 && bitDepth != 16) {
+        return false;
+    }
+
+    size_t rowBytes = (static_cast<size_t>(width) * channels * bitDepth + 7) / 8;
+    size_t bpp = std::max<size_t>(1, static_cast<size_t>(channels) * bitDepth / 8);
+
+    std::vector<uint8_t> raw((rowBytes + 1) * height);
+    uLongf rawSize = static_cast<uLongf>(raw.size());
+    if (uncompress(raw.data(), &rawSize, idat.data(), static_cast<uLong>(idat.size())) != Z_OK ||
+        rawSize != raw.size()) {
+        return false;
+    }
+
+    std::vector<uint8_t> scan;
+    if (!Unfilter(raw.data(), height, rowBytes, bpp, scan)) {
+        return false;
+    }
+
+    out.width = width;
+    out.height = height;
+    out.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    // 低位深灰度需要放大到0-255
+    int grayScale = bitDepth < 8 ? 255 / ((1 << bitDepth) - 1) : 1;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = scan.data() + y * rowBytes;
+        uint8_t* dst = out.pixels.data() + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++, dst += 4) {
+            switch (colorType) {
+                case 0: {
+                    uint8_t g = static_cast<uint8_t>(Sample(row, x, bitDepth) * grayScale);
+                    dst[0] = dst[1] = dst[2] = g;
+                    dst[3] = 255;
+                    break;
+                }
+                case 2:
+                    dst[0] = Sample(row, x * 3, bitDepth);
+                    dst[1] = Sample(row, x * 3 + 1, bitDepth);
+                    dst[2] = Sample(row, x * 3 + 2, bitDepth);
+                    dst[3] = 255;
+                    break;
+                case 3: {
+                    uint8_t index = Sample(row, x, bitDepth);
+                    if (static_cast<size_t>(index) * 3 + 2 >= palette.size()) {
+                        return false;
+                    }
+                    dst[0] = palette[index * 3];
+                    dst[1] = palette[index * 3 + 1];
+                    dst[2] = palette[index * 3 + 2];
+                    dst[3] = index < paletteAlpha.size() ? paletteAlpha[index] : 255;
+                    break;
+                }
+                case 4: {
+                    uint8_t g = Sample(row, x * 2, bitDepth);
+                    dst[0] = dst[1] = dst[2] = g;
+                    dst[3] = Sample(row, x * 2 + 1, bitDepth);
+                    break;
+                }
+                case 6:
+                    dst[0] = Sample(row, x * 4, bitDepth);
+                    dst[1] = Sample(row, x * 4 + 1, bitDepth);
+                    dst[2] = Sample(row, x * 4 + 2, bitDepth);
+                    dst[3] = Sample(row, x * 4 + 3, bitDepth);
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool DecodePNGFile(const std::string& path, Image& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    file.close();
+
+    return DecodePNG(data.data(), data.size(), out);
+}
+
+bool ReadPNGSize(const std::string& path, uint32_t& width, uint32_t& height) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 签名(8) + IHDR长度(4) + 类型(4) + 宽高(8)
+    uint8_t header[24];
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (file.gcount() != sizeof(header) ||
+        std::memcmp(header, kPngSignature, 8) != 0 ||
+        std::memcmp(header + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+
+    width = ReadBE32(header + 16);
+    height = ReadBE32(header + 20);
+    return true;
+}
+
+bool EncodePNG(const Image& image, std::vector<uint8_t>& out, int compressionLevel) {
+    if (image.Empty() || image.pixels.size() != static_cast<size_t>(image.width) * image.height * 4) {
+        return false;
+    }
+
+    // 每行使用Sub过滤器，对纹理图集这类大面积相近颜色效果较好
+    size_t rowBytes = static_cast<size_t>(image.width) * 4;
+    std::vector<uint8_t> raw((rowBytes + 1) * image.height);
+    for (uint32_t y = 0; y < image.height; y++) {
+        const uint8_t* src = image.pixels.data() + y * rowBytes;
+        uint8_t* dst = raw.data() + y * (rowBytes + 1);
+        dst[0] = 1;
+        for (size_t i = 0; i < rowBytes; i++) {
+            dst[i + 1] = static_cast<uint8_t>(src[i] - (i >= 4 ? src[i - 4] : 0));
+        }
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, raw.data(),
+                  static_cast<uLong>(raw.size()), compressionLevel) != Z_OK) {
+        return false;
+    }
+    compressed.resize(compressedSize);
+
+    out.clear();
+    out.reserve(compressed.size() + 64);
+    out.insert(out.end(), kPngSignature, kPngSignature + 8);
+
+    uint8_t ihdr[13];
+    ihdr[0] = static_cast<uint8_t>(image.width >> 24);
+    ihdr[1] = static_cast<uint8_t>(image.width >> 16);
+    ihdr[2] = static_cast<uint8_t>(image.width >> 8);
+    ihdr[3] = static_cast<uint8_t>(image.width);
+    ihdr[4] = static_cast<uint8_t>(image.height >> 24);
+    ihdr[5] = static_cast<uint8_t>(image.height >> 16);
+    ihdr[6] = static_cast<uint8_t>(image.height >> 8);
+    ihdr[7] = static_cast<uint8_t>(image.height);
+    ihdr[8] = 8;  // 位深
+    ihdr[9] = 6;  // RGBA
+    ihdr[10] = 0; // 压缩方法
+    ihdr[11] = 0; // 过滤方法
+    ihdr[12] = 0; // 非隔行
+
+    WriteChunk(out, "IHDR", ihdr, sizeof(ihdr));
+    WriteChunk(out, "IDAT", compressed.data(), compressed.size());
+    WriteChunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
+bool EncodePNGFile(const std::string& path, const Image& image, int compressionLevel) {
+    std::vector<uint8_t> data;
+    if (!EncodePNG(image, data, compressionLevel)) {
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+void BlitImage(const Image& src, Image& dst, uint32_t x, uint32_t y) {
+    if (x >= dst.width || y >= dst.height) {
+        return;
+    }
+    uint32_t copyWidth = std::min(src.width, dst.width - x);
+    uint32_t copyHeight = std::min(src.height, dst.height - y);
+    for (uint32_t row = 0; row < copyHeight; row++) {
+        std::memcpy(dst.pixels.data() + (static_cast<size_t>(y + row) * dst.width + x) * 4,
+                    src.pixels.data() + static_cast<size_t>(row) * src.width * 4,
+                    static_cast<size_t>(copyWidth) * 4);
+    }
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,40 @@
+/**
+ * Minecraft Unifier - Image Codec
+ * 图像编解码 - 基于zlib的PNG读写
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// RGBA8图像
+struct Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels; // RGBA8，行优先，无行间填充
+
+    bool Empty() const { return width == 0 || height == 0; }
+};
+
+// 解码PNG（支持所有非隔行颜色类型与位深，统一输出RGBA8）
+bool DecodePNG(const uint8_t* data, size_t size, Image& out);
+bool DecodePNGFile(const std::string& path, Image& out);
+
+// 读取PNG头部尺寸（无需解压像素数据）
+bool ReadPNGSize(const std::string& path, uint32_t& width, uint32_t& height);
+
+// 编码RGBA8图像为PNG
+bool EncodePNG(const Image& image, std::vector<uint8_t>& out, int compressionLevel = 6);
+bool EncodePNGFile(const std::string& path, const Image& image, int compressionLevel = 6);
+
+// 将src整体拷贝到dst的(x, y)位置
+void BlitImage(const Image& src, Image& dst, uint32_t x, uint32_t y);
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
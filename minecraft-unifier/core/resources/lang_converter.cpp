@@ -0,0 +1,217 @@
+/**
+ * Minecraft Unifier - Lang Converter Implementation
+ * 语言文件转换实现 - 基于SAX回调边读边写
+ */
+
+#include "lang_converter.h"
+#include "json_reader.h"
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+const size_t kFlushThreshold = 64 * 1024;
+
+void ReplaceAll(std::string& text, const char* from, size_t fromLength, const char* to) {
+    size_t pos = 0;
+    while ((pos = text.find(from, pos, fromLength)) != std::string::npos) {
+        text.replace(pos, fromLength, to);
+        pos += std::char_traits<char>::length(to);
+    }
+}
+
+// .lang以换行分隔条目，制表符后的##会被视为注释
+void AppendLangValue(std::string& out, const std::string& value) {
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); i++) {
+        char c = value[i];
+        if (c != '\n' && c != '\r' && c != '\t') {
+            continue;
+        }
+        out.append(value, start, i - start);
+        if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\t') {
+            out.push_back(' ');
+        }
+        start = i + 1;
+    }
+    out.append(value, start, std::string::npos);
+}
+
+// 只写出顶层对象中的字符串条目
+class LangWriter : public common::JsonSaxHandler {
+public:
+    LangWriter(std::FILE* output, LangConvertStats& stats)
+        : output_(output), stats_(stats), depth_(0), failed_(false) {
+        buffer_.reserve(kFlushThreshold + 1024);
+    }
+
+    ~LangWriter() override {
+        Flush();
+    }
+
+    bool StartObject() override {
+        depth_++;
+        if (depth_ == 2) {
+            stats_.skipped++;
+        }
+        return true;
+    }
+
+    bool EndObject() override {
+        depth_--;
+        return true;
+    }
+
+    bool StartArray() override {
+        // 顶层必须是对象
+        if (depth_ == 0) {
+            return false;
+        }
+        depth_++;
+        if (depth_ == 2) {
+            stats_.skipped++;
+        }
+        return true;
+    }
+
+    bool EndArray() override {
+        depth_--;
+        return true;
+    }
+
+    bool Key(const std::string& key) override {
+        if (depth_ == 1) {
+            key_ = key;
+        }
+        return true;
+    }
+
+    bool String(const std::string& value) override {
+        if (depth_ == 0) {
+            return false;
+        }
+        if (depth_ != 1) {
+            return true;
+        }
+        buffer_ += MapLangKey(key_);
+        buffer_.push_back('=');
+        AppendLangValue(buffer_, value);
+        buffer_.push_back('\n');
+        stats_.entries++;
+        if (buffer_.size() >= kFlushThreshold) {
+            Flush();
+        }
+        return true;
+    }
+
+    bool Number(const std::string&) override { return SkipScalar(); }
+    bool Bool(bool) override { return SkipScalar(); }
+    bool Null() override { return SkipScalar(); }
+
+    bool Flush() {
+        if (!buffer_.empty() && !failed_) {
+            if (std::fwrite(buffer_.data(), 1, buffer_.size(), output_) != buffer_.size()) {
+                failed_ = true;
+            }
+        }
+        buffer_.clear();
+        return !failed_;
+    }
+
+private:
+    std::FILE* output_;
+    LangConvertStats& stats_;
+    std::string buffer_;
+    std::string key_;
+    int depth_;
+    bool failed_;
+
+    bool SkipScalar() {
+        if (depth_ == 0) {
+            return false;
+        }
+        if (depth_ == 1) {
+            stats_.skipped++;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+std::string MapLangKey(const std::string& key) {
+    // 与原正则替换顺序一致，绝大多数键无需替换
+    if (key.find("minecraft.") == std::string::npos) {
+        return key;
+    }
+    std::string result = key;
+    ReplaceAll(result, "block.minecraft.", 16, "tile.");
+    ReplaceAll(result, "item.minecraft.", 15, "item.");
+    ReplaceAll(result, "entity.minecraft.", 17, "entity.");
+    return result;
+}
+
+std::string EscapeLangValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    AppendLangValue(result, value);
+    return result;
+}
+
+std::string BedrockLangName(const std::string& javaLocale) {
+    // 区域部分大写：en_us → en_US，zh_cn → zh_CN
+    std::string result = javaLocale;
+    size_t underscore = result.find('_');
+    for (size_t i = 0; i < result.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(result[i]);
+        result[i] = static_cast<char>(underscore != std::string::npos && i > underscore ? std::toupper(c) : std::tolower(c));
+    }
+    return result;
+}
+
+bool ConvertJsonLangFile(const std::string& jsonPath, const std::string& langPath, LangConvertStats* stats) {
+    std::FILE* input = std::fopen(jsonPath.c_str(), "rb");
+    if (!input) {
+        return false;
+    }
+    std::FILE* output = std::fopen(langPath.c_str(), "wb");
+    if (!output) {
+        std::fclose(input);
+        return false;
+    }
+
+    LangConvertStats localStats;
+    bool success;
+    {
+        LangWriter writer(output, localStats);
+        common::JsonSaxReader reader;
+        success = reader.Parse(input, writer);
+        success = writer.Flush() && success;
+    }
+
+    std::fclose(input);
+    if (std::fclose(output) != 0) {
+        success = false;
+    }
+    if (!success) {
+        fs::remove(langPath);
+        return false;
+    }
+    if (stats) {
+        *stats = localStats;
+    }
+    return true;
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
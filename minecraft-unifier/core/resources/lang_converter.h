@@ -0,0 +1,35 @@
+/**
+ * Minecraft Unifier - Lang Converter
+ * 语言文件转换 - Java版JSON语言文件流式转换为基岩版.lang
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// 转换统计
+struct LangConvertStats {
+    size_t entries = 0;         // 写出的条目数
+    size_t skipped = 0;         // 非字符串/嵌套值
+};
+
+// Java键名 → 基岩版键名（block.minecraft. → tile. 等）
+std::string MapLangKey(const std::string& key);
+
+// 转义值中基岩版.lang无法直接表示的字符（换行、制表符）
+std::string EscapeLangValue(const std::string& value);
+
+// Java语言代码 → 基岩版文件名（en_us → en_US）
+std::string BedrockLangName(const std::string& javaLocale);
+
+// 单遍流式转换JSON语言文件为.lang，不构建DOM
+bool ConvertJsonLangFile(const std::string& jsonPath, const std::string& langPath,
+                         LangConvertStats* stats = nullptr);
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
@@ -0,0 +1,630 @@
+/**
+ * Minecraft Unifier - Model Converter Implementation
+ * 模型转换实现 - 分块读取OBJ，面数据直接流式写出
+ */
+
+#include "model_converter.h"
+#include "json_writer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && IsSpace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// 罕见格式（超长尾数、大指数、nan/inf）交给strtod
+const char* ParseFloatSlow(const char* begin, const char* end, float& value) {
+    char text[64];
+    size_t length = std::min(static_cast<size_t>(end - begin), sizeof(text) - 1);
+    std::memcpy(text, begin, length);
+    text[length] = '\0';
+    char* stop = nullptr;
+    double result = std::strtod(text, &stop);
+    if (stop == text) {
+        return begin;
+    }
+    value = static_cast<float>(result);
+    return begin + (stop - text);
+}
+
+// 解析OBJ索引，支持负数（相对索引）
+const char* ParseIndex(const char* p, const char* end, long& value) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    long result = 0;
+    const char* digits = p;
+    while (p < end && IsDigit(*p)) {
+        if (result < std::numeric_limits<int32_t>::max()) {
+            result = result * 10 + (*p - '0');
+        }
+        p++;
+    }
+    if (p == digits) {
+        return start;
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+// 属性表：读入时即按值去重，每条OBJ属性只保留指向去重结果的索引
+template <size_t N>
+class AttributeTable {
+public:
+    using Value = std::array<float, N>;
+
+    void Add(Value value, float scale) {
+        for (float& v : value) {
+            v *= scale;
+        }
+        rawToUnique_.push_back(Intern(value));
+    }
+
+    size_t RawCount() const { return rawToUnique_.size(); }
+
+    // 将OBJ原始索引(0起)解析为输出索引
+    uint32_t Resolve(size_t rawIndex) const { return rawToUnique_[rawIndex]; }
+
+    // 按值查找或插入
+    uint32_t Intern(Value value) {
+        for (float& v : value) {
+            // 统一-0与+0，丢弃NaN，保证按位哈希与相等判断一致
+            v = (v == v) ? v + 0.0f : 0.0f;
+        }
+        if ((unique_.size() + 1) * 2 > slots_.size()) {
+            Grow();
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = Hash(value) & mask;; slot = (slot + 1) & mask) {
+            uint32_t index = slots_[slot];
+            if (index == kEmpty) {
+                index = static_cast<uint32_t>(unique_.size());
+                slots_[slot] = index;
+                unique_.push_back(value);
+                return index;
+            }
+            if (unique_[index] == value) {
+                return index;
+            }
+        }
+    }
+
+    const std::vector<Value>& Unique() const { return unique_; }
+
+private:
+    static const uint32_t kEmpty = 0xFFFFFFFFu;
+
+    static size_t Hash(const Value& value) {
+        uint64_t hash = 0;
+        for (float v : value) {
+            uint32_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            hash = (hash ^ bits) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 32;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    // 开放寻址表只存输出索引，负载因子不超过1/2
+    void Grow() {
+        std::vector<uint32_t> slots(std::max<size_t>(slots_.size() * 2, 1024), kEmpty);
+        size_t mask = slots.size() - 1;
+        for (uint32_t index = 0; index < unique_.size(); index++) {
+            size_t slot = Hash(unique_[index]) & mask;
+            while (slots[slot] != kEmpty) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = index;
+        }
+        slots_.swap(slots);
+    }
+
+    std::vector<uint32_t> rawToUnique_;
+    std::vector<Value> unique_;
+    std::vector<uint32_t> slots_;
+};
+
+struct FaceVertex {
+    uint32_t position;
+    uint32_t normal;
+    uint32_t uv;
+};
+
+// 单次转换的解析状态
+class ObjStreamParser {
+public:
+    ObjStreamParser(common::JsonWriter& writer, const ObjConvertOptions& options, ObjConvertStats& stats)
+        : writer_(writer), options_(options), stats_(stats) {
+        bboxMin_.fill(std::numeric_limits<float>::max());
+        bboxMax_.fill(std::numeric_limits<float>::lowest());
+    }
+
+    void ParseLine(const char* p, const char* end) {
+        stats_.lines++;
+        p = SkipSpaces(p, end);
+        if (p + 1 >= end) {
+            return;
+        }
+
+        if (p[0] == 'v') {
+            if (IsSpace(p[1])) {
+                std::array<float, 3> value = {0, 0, 0};
+                ParseFloats(p + 2, end, value.data(), 3);
+                positions_.Add(value, options_.scale);
+            } else if (p[1] == 'n' && p + 2 < end && IsSpace(p[2])) {
+                std::array<float, 3> value = {0, 0, 0};
+                ParseFloats(p + 3, end, value.data(), 3);
+                normals_.Add(value, 1.0f);
+            } else if (p[1] == 't' && p + 2 < end && IsSpace(p[2])) {
+                std::array<float, 2> value = {0, 0};
+                ParseFloats(p + 3, end, value.data(), 2);
+                uvs_.Add(value, 1.0f);
+            }
+        } else if (p[0] == 'f' && IsSpace(p[1])) {
+            ParseFace(p + 2, end);
+        }
+        // 其余指令（o/g/s/usemtl/mtllib/注释）与几何体无关，忽略
+    }
+
+    const AttributeTable<3>& Positions() const { return positions_; }
+    const AttributeTable<3>& Normals() const { return normals_; }
+    const AttributeTable<2>& UVs() const { return uvs_; }
+    const std::array<float, 3>& BoundsMin() const { return bboxMin_; }
+    const std::array<float, 3>& BoundsMax() const { return bboxMax_; }
+
+private:
+    common::JsonWriter& writer_;
+    const ObjConvertOptions& options_;
+    ObjConvertStats& stats_;
+
+    AttributeTable<3> positions_;
+    AttributeTable<3> normals_;
+    AttributeTable<2> uvs_;
+    // 面顶点的 v/vt/vn 原始索引，缺省为SIZE_MAX
+    struct RawVertex { size_t v, vt, vn; };
+
+    std::vector<RawVertex> rawFace_;        // 复用的面顶点缓冲（顶点数不限）
+    std::vector<FaceVertex> face_;
+    std::array<float, 3> bboxMin_;
+    std::array<float, 3> bboxMax_;
+
+    void ParseFloats(const char* p, const char* end, float* out, int count) {
+        for (int i = 0; i < count; i++) {
+            p = SkipSpaces(p, end);
+            const char* next = ParseFloat(p, end, out[i]);
+            if (next == p) {
+                return;
+            }
+            p = next;
+        }
+    }
+
+    // 将OBJ索引(1起，负数为相对)转换为0起索引
+    static bool ToRawIndex(long index, size_t count, size_t& rawIndex) {
+        long resolved = index > 0 ? index - 1 : static_cast<long>(count) + index;
+        if (index == 0 || resolved < 0 || static_cast<size_t>(resolved) >= count) {
+            return false;
+        }
+        rawIndex = static_cast<size_t>(resolved);
+        return true;
+    }
+
+    void ParseFace(const char* p, const char* end) {
+        face_.clear();
+        rawFace_.clear();
+        bool missingNormal = false;
+
+        while (true) {
+            p = SkipSpaces(p, end);
+            if (p >= end) {
+                break;
+            }
+            long index = 0;
+            const char* next = ParseIndex(p, end, index);
+            RawVertex raw = {SIZE_MAX, SIZE_MAX, SIZE_MAX};
+            if (next == p || !ToRawIndex(index, positions_.RawCount(), raw.v)) {
+                return; // 无效面，整体跳过
+            }
+            p = next;
+            if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/') {
+                    next = ParseIndex(p, end, index);
+                    if (next != p) {
+                        if (!ToRawIndex(index, uvs_.RawCount(), raw.vt)) {
+                            return;
+                        }
+                        p = next;
+                    }
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    next = ParseIndex(p, end, index);
+                    if (next != p) {
+                        if (!ToRawIndex(index, normals_.RawCount(), raw.vn)) {
+                            return;
+                        }
+                        p = next;
+                    }
+                }
+            }
+            // 跳过无法识别的残余字符
+            while (p < end && !IsSpace(*p)) {
+                p++;
+            }
+            rawFace_.push_back(raw);
+            missingNormal = missingNormal || raw.vn == SIZE_MAX;
+        }
+
+        size_t count = rawFace_.size();
+        if (count < 3) {
+            return;
+        }
+
+        uint32_t faceNormal = 0;
+        if (missingNormal) {
+            faceNormal = normals_.Intern(ComputeFaceNormal());
+        }
+        uint32_t defaultUV = 0;
+        bool hasDefaultUV = false;
+
+        for (size_t i = 0; i < count; i++) {
+            const RawVertex& raw = rawFace_[i];
+            FaceVertex vertex;
+            vertex.position = positions_.Resolve(raw.v);
+            vertex.normal = raw.vn != SIZE_MAX ? normals_.Resolve(raw.vn) : faceNormal;
+            if (raw.vt != SIZE_MAX) {
+                vertex.uv = uvs_.Resolve(raw.vt);
+            } else {
+                if (!hasDefaultUV) {
+                    defaultUV = uvs_.Intern({0.0f, 0.0f});
+                    hasDefaultUV = true;
+                }
+                vertex.uv = defaultUV;
+            }
+            const auto& pos = positions_.Unique()[vertex.position];
+            for (int c = 0; c < 3; c++) {
+                bboxMin_[c] = std::min(bboxMin_[c], pos[c]);
+                bboxMax_[c] = std::max(bboxMax_[c], pos[c]);
+            }
+            face_.push_back(vertex);
+        }
+
+        stats_.faces++;
+        if (count == 4) {
+            WritePoly(face_[0], face_[1], face_[2], face_[3]);
+        } else {
+            // 三角形重复末顶点补成四边形；多边形按扇形拆分
+            for (size_t i = 1; i + 1 < count; i++) {
+                WritePoly(face_[0], face_[i], face_[i + 1], face_[i + 1]);
+            }
+        }
+    }
+
+    std::array<float, 3> ComputeFaceNormal() {
+        // Newell法，对非平面多边形也稳定（顶点已缩放，方向不变）
+        std::array<float, 3> normal = {0, 0, 0};
+        size_t count = rawFace_.size();
+        const auto& unique = positions_.Unique();
+        for (size_t i = 0; i < count; i++) {
+            const auto& a = unique[positions_.Resolve(rawFace_[i].v)];
+            const auto& b = unique[positions_.Resolve(rawFace_[(i + 1) % count].v)];
+            normal[0] += (a[1] - b[1]) * (a[2] + b[2]);
+            normal[1] += (a[2] - b[2]) * (a[0] + b[0]);
+            normal[2] += (a[0] - b[0]) * (a[1] + b[1]);
+        }
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0) {
+            for (float& v : normal) {
+                v /= length;
+            }
+        }
+        return normal;
+    }
+
+    void WriteVertex(const FaceVertex& vertex) {
+        writer_.BeginArray();
+        writer_.Int(vertex.position);
+        writer_.Int(vertex.normal);
+        writer_.Int(vertex.uv);
+        writer_.EndArray();
+    }
+
+    void WritePoly(const FaceVertex& a, const FaceVertex& b, const FaceVertex& c, const FaceVertex& d) {
+        writer_.BeginArray();
+        WriteVertex(a);
+        WriteVertex(b);
+        WriteVertex(c);
+        WriteVertex(d);
+        writer_.EndArray();
+        stats_.polys++;
+    }
+};
+
+template <size_t N>
+void WriteAttributeArray(common::JsonWriter& writer, const std::string& key,
+                         const std::vector<std::array<float, N>>& values) {
+    writer.Key(key);
+    writer.BeginArray();
+    for (const auto& value : values) {
+        writer.BeginArray();
+        for (float v : value) {
+            writer.Number(v);
+        }
+        writer.EndArray();
+    }
+    writer.EndArray();
+}
+
+} // namespace
+
+const char* ParseFloat(const char* begin, const char* end, float& value) {
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    // 最多累积19位有效数字，超出部分只影响指数
+    uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    while (p < end && IsDigit(*p)) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) {
+                significant++;
+            }
+        } else {
+            exponent++;
+        }
+        anyDigit = true;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && IsDigit(*p)) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) {
+                    significant++;
+                }
+                exponent--;
+            }
+            anyDigit = true;
+            p++;
+        }
+    }
+    if (!anyDigit) {
+        return ParseFloatSlow(begin, end, value);
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool expNegative = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            expNegative = *q == '-';
+            q++;
+        }
+        int expValue = 0;
+        const char* expDigits = q;
+        while (q < end && IsDigit(*q)) {
+            if (expValue < 10000) {
+                expValue = expValue * 10 + (*q - '0');
+            }
+            q++;
+        }
+        if (q != expDigits) {
+            exponent += expNegative ? -expValue : expValue;
+            p = q;
+        }
+    }
+
+    // 尾数可精确表示且10的幂可精确表示时，一次乘除即得正确舍入结果
+    if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+        value = static_cast<float>(negative ? -result : result);
+        return p;
+    }
+    return ParseFloatSlow(begin, p, value);
+}
+
+// ==================== ObjModelConverter ====================
+
+ObjModelConverter::ObjModelConverter() {
+}
+
+ObjModelConverter::~ObjModelConverter() {
+}
+
+void ObjModelConverter::SetOptions(const ObjConvertOptions& options) {
+    options_ = options;
+}
+
+bool ObjModelConverter::Convert(const std::string& objPath, const std::string& geometryPath) {
+    stats_ = ObjConvertStats();
+
+    std::FILE* input = std::fopen(objPath.c_str(), "rb");
+    if (!input) {
+        return false;
+    }
+    std::FILE* output = std::fopen(geometryPath.c_str(), "wb");
+    if (!output) {
+        std::fclose(input);
+        return false;
+    }
+
+    std::string identifier = options_.identifier;
+    if (identifier.empty()) {
+        std::string stem = fs::path(objPath).stem().string();
+        identifier = "geometry." + stem;
+    }
+
+    bool success = true;
+    {
+        common::JsonWriter writer(output);
+        writer.BeginObject();
+        writer.Key("format_version");
+        writer.String("1.12.0");
+        writer.Key("minecraft:geometry");
+        writer.BeginArray();
+        writer.BeginObject();
+        writer.Key("bones");
+        writer.BeginArray();
+        writer.BeginObject();
+        writer.Key("name");
+        writer.String("root");
+        writer.Key("pivot");
+        writer.BeginArray();
+        writer.Int(0);
+        writer.Int(0);
+        writer.Int(0);
+        writer.EndArray();
+        writer.Key("poly_mesh");
+        writer.BeginObject();
+        writer.Key("normalized_uvs");
+        writer.Bool(true);
+
+        // 面在读取时即可确定输出索引，先写polys，属性数组最后写出
+        writer.Key("polys");
+        writer.BeginArray();
+
+        ObjStreamParser parser(writer, options_, stats_);
+        std::vector<char> buffer(std::max<size_t>(options_.readBufferSize, 4096));
+        size_t carry = 0;
+        while (true) {
+            size_t read = std::fread(buffer.data() + carry, 1, buffer.size() - carry, input);
+            const char* begin = buffer.data();
+            const char* end = begin + carry + read;
+            const char* line = begin;
+
+            while (true) {
+                const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+                if (!newline) {
+                    break;
+                }
+                parser.ParseLine(line, newline);
+                line = newline + 1;
+            }
+
+            carry = end - line;
+            if (read == 0) {
+                // 文件结束：处理无换行的末行
+                if (carry > 0) {
+                    parser.ParseLine(line, end);
+                }
+                break;
+            }
+            if (carry == buffer.size()) {
+                // 单行超过缓冲区，扩容
+                buffer.resize(buffer.size() * 2);
+            } else if (carry > 0) {
+                std::memmove(buffer.data(), line, carry);
+            }
+        }
+        if (std::ferror(input)) {
+            success = false;
+        }
+
+        writer.EndArray();
+
+        WriteAttributeArray(writer, "positions", parser.Positions().Unique());
+        WriteAttributeArray(writer, "normals", parser.Normals().Unique());
+        WriteAttributeArray(writer, "uvs", parser.UVs().Unique());
+        writer.EndObject(); // poly_mesh
+        writer.EndObject(); // bone
+        writer.EndArray();  // bones
+
+        stats_.positions = parser.Positions().Unique().size();
+        stats_.normals = parser.Normals().Unique().size();
+        stats_.uvs = parser.UVs().Unique().size();
+
+        // 可见包围盒（方块单位）
+        std::array<float, 3> bmin = parser.BoundsMin();
+        std::array<float, 3> bmax = parser.BoundsMax();
+        if (stats_.positions == 0) {
+            bmin.fill(0.0f);
+            bmax.fill(0.0f);
+        }
+        float extentXZ = std::max({std::fabs(bmin[0]), std::fabs(bmax[0]), std::fabs(bmin[2]), std::fabs(bmax[2])});
+        float boundsWidth = std::ceil(extentXZ * 2.0f / 16.0f) + 1.0f;
+        float boundsHeight = std::ceil((bmax[1] - bmin[1]) / 16.0f) + 1.0f;
+
+        writer.Key("description");
+        writer.BeginObject();
+        writer.Key("identifier");
+        writer.String(identifier);
+        writer.Key("texture_width");
+        writer.Int(16);
+        writer.Key("texture_height");
+        writer.Int(16);
+        writer.Key("visible_bounds_width");
+        writer.Number(boundsWidth);
+        writer.Key("visible_bounds_height");
+        writer.Number(boundsHeight);
+        writer.Key("visible_bounds_offset");
+        writer.BeginArray();
+        writer.Int(0);
+        writer.Number((bmin[1] + bmax[1]) / 2.0f / 16.0f);
+        writer.Int(0);
+        writer.EndArray();
+        writer.EndObject();
+
+        writer.EndObject(); // geometry
+        writer.EndArray();
+        writer.EndObject();
+
+        success = writer.Flush() && success;
+    }
+
+    std::fclose(input);
+    if (std::fclose(output) != 0) {
+        success = false;
+    }
+    if (!success) {
+        fs::remove(geometryPath);
+    }
+    return success;
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
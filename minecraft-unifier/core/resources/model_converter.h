@@ -0,0 +1,57 @@
+/**
+ * Minecraft Unifier - Model Converter
+ * 模型转换 - 流式解析OBJ并输出基岩版poly_mesh几何体
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// OBJ转换选项
+struct ObjConvertOptions {
+    std::string identifier;         // 几何体标识，为空时使用 geometry.<文件名>
+    float scale = 16.0f;            // OBJ单位为方块，基岩版几何体单位为像素
+    size_t readBufferSize = 1 << 20;
+};
+
+// OBJ转换统计
+struct ObjConvertStats {
+    size_t lines = 0;
+    size_t faces = 0;
+    size_t polys = 0;               // 输出多边形数（超过四边形的面被拆分为三角形）
+    size_t positions = 0;           // 去重后的顶点属性数
+    size_t normals = 0;
+    size_t uvs = 0;
+};
+
+// 手写浮点解析（不依赖locale/iostream），返回解析结束位置，失败返回begin
+const char* ParseFloat(const char* begin, const char* end, float& value);
+
+// OBJ → 基岩版几何体转换器
+// 面数据边读边写；顶点属性读入时去重，每条v/vn/vt行只额外占用4字节索引
+class ObjModelConverter {
+public:
+    ObjModelConverter();
+    ~ObjModelConverter();
+
+    void SetOptions(const ObjConvertOptions& options);
+
+    // 转换OBJ文件为 .geo.json
+    bool Convert(const std::string& objPath, const std::string& geometryPath);
+
+    // 获取上次转换的统计
+    const ObjConvertStats& GetStats() const { return stats_; }
+
+private:
+    ObjConvertOptions options_;
+    ObjConvertStats stats_;
+};
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
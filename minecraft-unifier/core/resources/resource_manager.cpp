@@ -4,12 +4,16 @@
  */
 
 #include "resource_manager.h"
+#include "model_converter.h"
+#include "lang_converter.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <nlohmann/json.hpp>
 
 namespace fs = std::filesystem;
+using json = nlohmann::json;
 
 namespace mcu {
 namespace core {
@@ -153,6 +157,13 @@ std::vector<ResourceInfo> ResourceManager::GetAllResources() const {
 }
 
 bool ResourceManager::ConvertResource(const std::string& originalPath, const std::string& outputPath) {
+    // 单个资源使用默认转换配置
+    ResourceConverter converter;
+    return ConvertResource(converter, originalPath, outputPath);
+}
+
+bool ResourceManager::ConvertResource(const ResourceConverter& converter, const std::string& originalPath,
+                                      const std::string& outputPath) {
     // 检测资源类型
     ResourceType type;
     if (!DetectResourceType(originalPath, type)) {
@@ -162,13 +173,13 @@ bool ResourceManager::ConvertResource(const std::string& originalPath, const std
     // 根据类型转换
     switch (type) {
         case ResourceType::TEXTURE:
-            return ConvertTexture(originalPath, outputPath);
+            return converter.ConvertTexture(originalPath, outputPath);
         case ResourceType::MODEL:
-            return ConvertModel(originalPath, outputPath);
+            return converter.ConvertModel(originalPath, outputPath);
         case ResourceType::SOUND:
-            return ConvertSound(originalPath, outputPath);
+            return converter.ConvertSound(originalPath, outputPath);
         case ResourceType::LANG:
-            return ConvertLang(originalPath, outputPath);
+            return converter.ConvertLang(originalPath, outputPath);
         default:
             return false;
     }
@@ -177,6 +188,13 @@ bool ResourceManager::ConvertResource(const std::string& originalPath, const std
 bool ResourceManager::BatchConvert(const std::string& inputDir, const std::string& outputDir) {
     fs::create_directories(outputDir);
     
+    // 资源包自带的转换配置，只作用于本次转换
+    ResourceConverter converter;
+    std::string packConfig = inputDir + "/pack_config.json";
+    if (fs::exists(packConfig)) {
+        converter.LoadPackConfig(packConfig);
+    }
+    
     int successCount = 0;
     int totalCount = 0;
     
@@ -191,7 +209,7 @@ bool ResourceManager::BatchConvert(const std::string& inputDir, const std::strin
             // 创建输出目录
             fs::create_directories(fs::path(outputPath).parent_path());
             
-            if (ConvertResource(inputPath, outputPath)) {
+            if (ConvertResource(converter, inputPath, outputPath)) {
                 successCount++;
             }
         }
@@ -294,22 +312,6 @@ bool ResourceManager::DetectResourceType(const std::string& path, ResourceType&
     return false;
 }
 
-bool ResourceManager::ConvertTexture(const std::string& inputPath, const std::string& outputPath) {
-    return ResourceConverter::ConvertTexture(inputPath, outputPath);
-}
-
-bool ResourceManager::ConvertModel(const std::string& inputPath, const std::string& outputPath) {
-    return ResourceConverter::ConvertModel(inputPath, outputPath);
-}
-
-bool ResourceManager::ConvertSound(const std::string& inputPath, const std::string& outputPath) {
-    return ResourceConverter::ConvertSound(inputPath, outputPath);
-}
-
-bool ResourceManager::ConvertLang(const std::string& inputPath, const std::string& outputPath) {
-    return ResourceConverter::ConvertLang(inputPath, outputPath);
-}
-
 #ifdef _WIN32
 HANDLE (WINAPI* ResourceManager::orig_CreateFileW)(LPCWSTR, DWORD, DWORD,
                                                     LPSECURITY_ATTRIBUTES, DWORD, DWORD, HANDLE) = nullptr;
@@ -362,7 +364,79 @@ ResourceConverter::ResourceConverter() {
 ResourceConverter::~ResourceConverter() {
 }
 
-bool ResourceConverter::ConvertTexture(const std::string& inputPath, const std::string& outputPath) {
+void ResourceConverter::SetTextureCompression(const TextureCompressionOptions& options) {
+    textureCompression_ = options;
+}
+
+void ResourceConverter::SetAudioOptions(const AudioConvertOptions& options) {
+    audioOptions_ = options;
+}
+
+bool ResourceConverter::LoadPackConfig(const std::string& configPath) {
+    std::ifstream file(configPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    json config = json::parse(file, nullptr, false);
+    if (config.is_discarded() || !config.is_object()) {
+        return false;
+    }
+    
+    // 上一个资源包的配置不延续到本次
+    textureCompression_ = TextureCompressionOptions();
+    audioOptions_ = AudioConvertOptions();
+    
+    // texture_compression: { "enabled": true, "preset": "balanced", "formats": ["etc2", "astc"] }
+    if (config.contains("texture_compression") && config["texture_compression"].is_object()) {
+        const json& section = config["texture_compression"];
+        TextureCompressionOptions options;
+        options.enabled = section.value("enabled", false);
+        
+        if (section.contains("preset") && section["preset"].is_string()) {
+            ParseCompressionPreset(section["preset"].get<std::string>(), options.preset);
+        }
+        
+        if (section.contains("formats") && section["formats"].is_array()) {
+            for (const auto& item : section["formats"]) {
+                CompressedFormat format;
+                if (item.is_string() && ParseCompressedFormat(item.get<std::string>(), format)) {
+                    options.formats.push_back(format);
+                }
+            }
+        }
+        
+        textureCompression_ = options;
+    }
+    
+    // audio: { "sample_rate": 44100, "channels": 1, "codec": "vorbis", "quality": 0.4 }
+    if (config.contains("audio") && config["audio"].is_object()) {
+        const json& section = config["audio"];
+        AudioConvertOptions options;
+        options.sampleRate = section.value("sample_rate", 0u);
+        
+        // 只支持单声道与立体声输出，其他声道数视为无效配置，音频保持默认选项
+        unsigned int channels = section.value("channels", 0u);
+        if (channels > 2) {
+            return false;
+        }
+        options.channels = static_cast<uint16_t>(channels);
+        options.quality = section.value("quality", options.quality);
+        
+        std::string codec = section.value("codec", "auto");
+        if (codec == "vorbis") {
+            options.codec = AudioCodec::VORBIS;
+        } else if (codec == "wav") {
+            options.codec = AudioCodec::PCM16_WAV;
+        }
+        
+        audioOptions_ = options;
+    }
+    
+    return true;
+}
+
+bool ResourceConverter::ConvertTexture(const std::string& inputPath, const std::string& outputPath) const {
     std::string ext = fs::path(inputPath).extension().string();
     
     if (ext == ".png") {
@@ -373,7 +447,7 @@ bool ResourceConverter::ConvertTexture(const std::string& inputPath, const std::
     return false;
 }
 
-bool ResourceConverter::ConvertModel(const std::string& inputPath, const std::string& outputPath) {
+bool ResourceConverter::ConvertModel(const std::string& inputPath, const std::string& outputPath) const {
     std::string ext = fs::path(inputPath).extension().string();
     
     if (ext == ".obj") {
@@ -384,7 +458,7 @@ bool ResourceConverter::ConvertModel(const std::string& inputPath, const std::st
     return false;
 }
 
-bool ResourceConverter::ConvertSound(const std::string& inputPath, const std::string& outputPath) {
+bool ResourceConverter::ConvertSound(const std::string& inputPath, const std::string& outputPath) const {
     std::string ext = fs::path(inputPath).extension().string();
     
     if (ext == ".wav") {
@@ -395,7 +469,7 @@ bool ResourceConverter::ConvertSound(const std::string& inputPath, const std::st
     return false;
 }
 
-bool ResourceConverter::ConvertLang(const std::string& inputPath, const std::string& outputPath) {
+bool ResourceConverter::ConvertLang(const std::string& inputPath, const std::string& outputPath) const {
     std::string ext = fs::path(inputPath).extension().string();
     
     if (ext == ".json") {
@@ -426,32 +500,59 @@ ResourceType ResourceConverter::DetectType(const std::string& path) {
     return ResourceType::UNKNOWN;
 }
 
-bool ResourceConverter::ConvertPNGToTexture(const std::string& inputPath, const std::string& outputPath) {
-    // TODO: 使用stb_image或其他库转换PNG纹理
-    // 这里只是简单复制文件
+bool ResourceConverter::ConvertPNGToTexture(const std::string& inputPath, const std::string& outputPath) const {
+    // 保留原始PNG，作为不支持压缩格式设备的回退
     fs::copy_file(inputPath, outputPath, fs::copy_options::overwrite_existing);
+    
+    if (!textureCompression_.enabled) {
+        return true;
+    }
+    
+    Image image;
+    if (!DecodePNGFile(inputPath, image)) {
+        return false;
+    }
+    
+    std::vector<CompressedFormat> formats = textureCompression_.formats;
+    if (formats.empty()) {
+        formats = DefaultCompressedFormats();
+    }
+    
+    // 输出 <name>.<格式>.ktx，与PNG并存
+    fs::path basePath = fs::path(outputPath).replace_extension();
+    for (CompressedFormat format : formats) {
+        std::vector<uint8_t> data;
+        if (!CompressImage(image, format, textureCompression_.preset, data)) {
+            return false;
+        }
+        std::string ktxPath = basePath.string() + "." + CompressedFormatSuffix(format) + ".ktx";
+        if (!WriteKTX(ktxPath, format, image.width, image.height, data)) {
+            return false;
+        }
+    }
+    
     return true;
 }
 
-bool ResourceConverter::ConvertOBJToModel(const std::string& inputPath, const std::string& outputPath) {
-    // TODO: 解析OBJ文件并转换为基岩版模型格式
-    // 这里只是简单复制文件
-    fs::copy_file(inputPath, outputPath, fs::copy_options::overwrite_existing);
-    return true;
+bool ResourceConverter::ConvertOBJToModel(const std::string& inputPath, const std::string& outputPath) const {
+    // 输出基岩版几何体 <name>.geo.json
+    fs::path geometryPath = fs::path(outputPath).replace_extension(".geo.json");
+    ObjModelConverter converter;
+    return converter.Convert(inputPath, geometryPath.string());
 }
 
-bool ResourceConverter::ConvertWAVToSound(const std::string& inputPath, const std::string& outputPath) {
-    // TODO: 转换WAV为基岩版支持的音频格式
-    // 这里只是简单复制文件
-    fs::copy_file(inputPath, outputPath, fs::copy_options::overwrite_existing);
-    return true;
+bool ResourceConverter::ConvertWAVToSound(const std::string& inputPath, const std::string& outputPath) const {
+    // 输出扩展名由编码决定（.ogg / .wav）
+    AudioConverter converter;
+    converter.SetOptions(audioOptions_);
+    return !converter.Convert(inputPath, outputPath).empty();
 }
 
-bool ResourceConverter::ConvertJSONToLang(const std::string& inputPath, const std::string& outputPath) {
-    // TODO: 转换JSON语言文件为基岩版格式
-    // 这里只是简单复制文件
-    fs::copy_file(inputPath, outputPath, fs::copy_options::overwrite_existing);
-    return true;
+bool ResourceConverter::ConvertJSONToLang(const std::string& inputPath, const std::string& outputPath) const {
+    // en_us.json → en_US.lang
+    fs::path output(outputPath);
+    std::string langName = BedrockLangName(output.stem().string()) + ".lang";
+    return ConvertJsonLangFile(inputPath, (output.parent_path() / langName).string());
 }
 
 // ==================== ResourcePackManager ====================
@@ -8,6 +8,8 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include "texture_compressor.h"
+#include "audio_converter.h"
 
 namespace mcu {
 namespace core {
@@ -42,6 +44,8 @@ struct ResourceInfo {
     uint64_t timestamp;         // 时间戳
 };
 
+class ResourceConverter;
+
 // 资源管理器
 class ResourceManager {
 public:
@@ -114,10 +118,8 @@ private:
     
     // 内部处理函数
     bool DetectResourceType(const std::string& path, ResourceType& type);
-    bool ConvertTexture(const std::string& inputPath, const std::string& outputPath);
-    bool ConvertModel(const std::string& inputPath, const std::string& outputPath);
-    bool ConvertSound(const std::string& inputPath, const std::string& outputPath);
-    bool ConvertLang(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertResource(const ResourceConverter& converter, const std::string& originalPath,
+                         const std::string& outputPath);
     
     // Hook回调函数
 #ifdef _WIN32
@@ -131,33 +133,47 @@ private:
 #endif
 };
 
-// 资源转换器
+// 资源转换器（转换配置属于实例，每次批量转换使用独立的转换器）
 class ResourceConverter {
 public:
     ResourceConverter();
     ~ResourceConverter();
     
     // 转换纹理
-    static bool ConvertTexture(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertTexture(const std::string& inputPath, const std::string& outputPath) const;
     
     // 转换模型
-    static bool ConvertModel(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertModel(const std::string& inputPath, const std::string& outputPath) const;
     
     // 转换声音
-    static bool ConvertSound(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertSound(const std::string& inputPath, const std::string& outputPath) const;
     
     // 转换语言文件
-    static bool ConvertLang(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertLang(const std::string& inputPath, const std::string& outputPath) const;
     
     // 检测资源类型
     static ResourceType DetectType(const std::string& path);
+    
+    // 设置/获取纹理压缩配置
+    void SetTextureCompression(const TextureCompressionOptions& options);
+    const TextureCompressionOptions& GetTextureCompression() const { return textureCompression_; }
+    
+    // 设置/获取声音转码配置
+    void SetAudioOptions(const AudioConvertOptions& options);
+    const AudioConvertOptions& GetAudioOptions() const { return audioOptions_; }
+    
+    // 从资源包配置(pack_config.json)加载转换选项，配置中未出现的节恢复默认值
+    bool LoadPackConfig(const std::string& configPath);
 
 private:
+    TextureCompressionOptions textureCompression_;
+    AudioConvertOptions audioOptions_;
+    
     // 内部转换函数
-    static bool ConvertPNGToTexture(const std::string& inputPath, const std::string& outputPath);
-    static bool ConvertOBJToModel(const std::string& inputPath, const std::string& outputPath);
-    static bool ConvertWAVToSound(const std::string& inputPath, const std::string& outputPath);
-    static bool ConvertJSONToLang(const std::string& inputPath, const std::string& outputPath);
+    bool ConvertPNGToTexture(const std::string& inputPath, const std::string& outputPath) const;
+    bool ConvertOBJToModel(const std::string& inputPath, const std::string& outputPath) const;
+    bool ConvertWAVToSound(const std::string& inputPath, const std::string& outputPath) const;
+    bool ConvertJSONToLang(const std::string& inputPath, const std::string& outputPath) const;
 };
 
 // 资源包管理器
@@ -0,0 +1,615 @@
+/**
+ * Minecraft Unifier - Texture Atlas Implementation
+ * 纹理图集实现 - Skyline装箱与增量重建
+ */
+
+#include "texture_atlas.h"
+#include "image_codec.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+uint32_t NextPowerOfTwo(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// 将纹理放入(x, y)处并把边缘像素向外扩展padding个像素
+void BlitWithPadding(const Image& src, Image& dst, uint32_t x, uint32_t y, uint32_t padding) {
+    uint32_t slotWidth = src.width + padding * 2;
+    uint32_t slotHeight = src.height + padding * 2;
+    for (uint32_t row = 0; row < slotHeight; row++) {
+        uint32_t srcRow = row < padding ? 0 : std::min(row - padding, src.height - 1);
+        uint8_t* out = dst.pixels.data() + (static_cast<size_t>(y + row) * dst.width + x) * 4;
+        const uint8_t* in = src.pixels.data() + static_cast<size_t>(srcRow) * src.width * 4;
+        for (uint32_t col = 0; col < slotWidth; col++) {
+            uint32_t srcCol = col < padding ? 0 : std::min(col - padding, src.width - 1);
+            std::copy(in + srcCol * 4, in + srcCol * 4 + 4, out + col * 4);
+        }
+    }
+}
+
+std::string PageFileName(const std::string& atlasName, size_t index) {
+    return atlasName + "_" + std::to_string(index) + ".png";
+}
+
+} // namespace
+
+uint64_t HashFileContent(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    char buffer[64 * 1024];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        std::streamsize n = file.gcount();
+        for (std::streamsize i = 0; i < n; i++) {
+            hash ^= static_cast<uint8_t>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+// ==================== SkylinePacker ====================
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+    : width_(width)
+    , height_(height)
+    , usedWidth_(0)
+    , usedHeight_(0)
+{
+    skyline_.push_back({0, 0, width});
+}
+
+bool SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const {
+    uint32_t x = skyline_[index].x;
+    if (x + width > width_) {
+        return false;
+    }
+
+    uint32_t y = skyline_[index].y;
+    uint32_t widthLeft = width;
+    size_t i = index;
+    while (widthLeft > 0) {
+        if (i >= skyline_.size()) {
+            return false;
+        }
+        y = std::max(y, skyline_[i].y);
+        if (y + height > height_) {
+            return false;
+        }
+        widthLeft -= std::min(widthLeft, skyline_[i].width);
+        i++;
+    }
+
+    outY = y;
+    return true;
+}
+
+void SkylinePacker::AddLevel(size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    skyline_.insert(skyline_.begin() + index, Node{x, y + height, width});
+
+    // 裁剪被新节点覆盖的后续节点
+    for (size_t i = index + 1; i < skyline_.size(); i++) {
+        const Node& prev = skyline_[i - 1];
+        uint32_t prevEnd = prev.x + prev.width;
+        if (skyline_[i].x >= prevEnd) {
+            break;
+        }
+        uint32_t shrink = prevEnd - skyline_[i].x;
+        if (skyline_[i].width <= shrink) {
+            skyline_.erase(skyline_.begin() + i);
+            i--;
+        } else {
+            skyline_[i].x += shrink;
+            skyline_[i].width -= shrink;
+            break;
+        }
+    }
+
+    // 合并相同高度的相邻节点
+    for (size_t i = 0; i + 1 < skyline_.size(); i++) {
+        if (skyline_[i].y == skyline_[i + 1].y) {
+            skyline_[i].width += skyline_[i + 1].width;
+            skyline_.erase(skyline_.begin() + i + 1);
+            i--;
+        }
+    }
+}
+
+bool SkylinePacker::Insert(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY) {
+    size_t bestIndex = skyline_.size();
+    uint32_t bestTop = UINT32_MAX;
+    uint32_t bestWidth = UINT32_MAX;
+    uint32_t bestY = 0;
+
+    for (size_t i = 0; i < skyline_.size(); i++) {
+        uint32_t y;
+        if (!Fit(i, width, height, y)) {
+            continue;
+        }
+        // 优先最低顶边，其次最窄节点
+        if (y + height < bestTop || (y + height == bestTop && skyline_[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = y + height;
+            bestWidth = skyline_[i].width;
+            bestY = y;
+        }
+    }
+
+    if (bestIndex == skyline_.size()) {
+        return false;
+    }
+
+    outX = skyline_[bestIndex].x;
+    outY = bestY;
+    AddLevel(bestIndex, outX, outY, width, height);
+
+    usedWidth_ = std::max(usedWidth_, outX + width);
+    usedHeight_ = std::max(usedHeight_, outY + height);
+    return true;
+}
+
+// ==================== TextureAtlasBuilder ====================
+
+TextureAtlasBuilder::TextureAtlasBuilder(const AtlasOptions& options)
+    : options_(options) {
+}
+
+TextureAtlasBuilder::~TextureAtlasBuilder() {
+}
+
+void TextureAtlasBuilder::AddTexture(const std::string& name, const std::string& path) {
+    inputs_.push_back({name, path});
+}
+
+size_t TextureAtlasBuilder::AddDirectory(const std::string& dir, const std::string& prefix) {
+    if (!fs::exists(dir)) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".png") {
+            continue;
+        }
+        fs::path relative = fs::relative(entry.path(), dir);
+        relative.replace_extension();
+        AddTexture(prefix + "/" + relative.generic_string(), entry.path().string());
+        count++;
+    }
+    return count;
+}
+
+std::vector<std::string> TextureAtlasBuilder::GetPackedSources() const {
+    std::vector<std::string> sources;
+    for (const auto& region : regions_) {
+        sources.push_back(region.sourcePath);
+    }
+    return sources;
+}
+
+bool TextureAtlasBuilder::Build(const std::string& outputDir, const std::string& atlasName) {
+    stats_ = AtlasBuildStats();
+    regions_.clear();
+    pages_.clear();
+
+    fs::create_directories(outputDir);
+
+    // 过滤掉不适合入图集的纹理（只读PNG头，不解码）
+    std::vector<Input> eligible;
+    for (const auto& input : inputs_) {
+        uint32_t width, height;
+        if (!ReadPNGSize(input.path, width, height) ||
+            width > options_.maxTextureSize || height > options_.maxTextureSize ||
+            (options_.skipAnimated && fs::exists(input.path + ".mcmeta"))) {
+            stats_.skipped++;
+            continue;
+        }
+        eligible.push_back(input);
+    }
+    inputs_.swap(eligible);
+
+    std::unordered_map<std::string, uint64_t> hashes;
+    for (const auto& input : inputs_) {
+        hashes[input.name] = HashFileContent(input.path);
+    }
+
+    bool result;
+    std::string mappingPath = outputDir + "/" + atlasName + ".atlas.json";
+    if (fs::exists(mappingPath) && BuildIncremental(outputDir, atlasName, hashes)) {
+        stats_.incremental = true;
+        result = true;
+    } else {
+        regions_.clear();
+        pages_.clear();
+        result = BuildFull(outputDir, atlasName, hashes);
+    }
+
+    inputs_.swap(eligible);
+    if (!result) {
+        return false;
+    }
+
+    stats_.packed = regions_.size();
+    stats_.pages = pages_.size();
+    return SaveMapping(mappingPath);
+}
+
+bool TextureAtlasBuilder::BuildFull(const std::string& outputDir, const std::string& atlasName,
+                                    std::unordered_map<std::string, uint64_t>& hashes) {
+    struct Decoded {
+        const Input* input;
+        Image image;
+        uint32_t page;
+        uint32_t x, y;
+    };
+
+    std::vector<Decoded> textures;
+    textures.reserve(inputs_.size());
+    for (const auto& input : inputs_) {
+        Decoded decoded{&input, Image(), 0, 0, 0};
+        if (!DecodePNGFile(input.path, decoded.image)) {
+            stats_.skipped++;
+            continue;
+        }
+        textures.push_back(std::move(decoded));
+    }
+
+    // 按高度、宽度降序排列，名称保证结果确定
+    std::sort(textures.begin(), textures.end(), [](const Decoded& a, const Decoded& b) {
+        if (a.image.height != b.image.height) return a.image.height > b.image.height;
+        if (a.image.width != b.image.width) return a.image.width > b.image.width;
+        return a.input->name < b.input->name;
+    });
+
+    uint32_t padding = options_.padding;
+    std::vector<SkylinePacker> packers;
+    for (auto& texture : textures) {
+        uint32_t slotWidth = texture.image.width + padding * 2;
+        uint32_t slotHeight = texture.image.height + padding * 2;
+        if (slotWidth > options_.maxPageSize || slotHeight > options_.maxPageSize) {
+            texture.input = nullptr;
+            stats_.skipped++;
+            continue;
+        }
+
+        bool placed = false;
+        for (size_t p = 0; p < packers.size() && !placed; p++) {
+            if (packers[p].Insert(slotWidth, slotHeight, texture.x, texture.y)) {
+                texture.page = static_cast<uint32_t>(p);
+                placed = true;
+            }
+        }
+        if (!placed) {
+            packers.emplace_back(options_.maxPageSize, options_.maxPageSize);
+            packers.back().Insert(slotWidth, slotHeight, texture.x, texture.y);
+            texture.page = static_cast<uint32_t>(packers.size() - 1);
+        }
+    }
+
+    // 页尺寸收缩到实际使用范围（取2的幂）
+    std::vector<Image> pageImages(packers.size());
+    for (size_t p = 0; p < packers.size(); p++) {
+        Image& page = pageImages[p];
+        page.width = NextPowerOfTwo(std::max(1u, packers[p].UsedWidth()));
+        page.height = NextPowerOfTwo(std::max(1u, packers[p].UsedHeight()));
+        page.pixels.assign(static_cast<size_t>(page.width) * page.height * 4, 0);
+        pages_.push_back({PageFileName(atlasName, p), page.width, page.height});
+    }
+
+    for (const auto& texture : textures) {
+        if (!texture.input) {
+            continue;
+        }
+        Image& page = pageImages[texture.page];
+        BlitWithPadding(texture.image, page, texture.x, texture.y, padding);
+
+        AtlasRegion region;
+        region.name = texture.input->name;
+        region.sourcePath = texture.input->path;
+        region.hash = hashes[region.name];
+        region.page = texture.page;
+        region.x = texture.x + padding;
+        region.y = texture.y + padding;
+        region.width = texture.image.width;
+        region.height = texture.image.height;
+        region.u0 = static_cast<float>(region.x) / page.width;
+        region.v0 = static_cast<float>(region.y) / page.height;
+        region.u1 = static_cast<float>(region.x + region.width) / page.width;
+        region.v1 = static_cast<float>(region.y + region.height) / page.height;
+        regions_.push_back(region);
+    }
+
+    for (size_t p = 0; p < pageImages.size(); p++) {
+        if (!EncodePNGFile(outputDir + "/" + pages_[p].file, pageImages[p])) {
+            return false;
+        }
+    }
+
+    // 清理上次构建残留的多余页
+    for (size_t p = pageImages.size(); fs::exists(outputDir + "/" + PageFileName(atlasName, p)); p++) {
+        fs::remove(outputDir + "/" + PageFileName(atlasName, p));
+    }
+
+    std::sort(regions_.begin(), regions_.end(), [](const AtlasRegion& a, const AtlasRegion& b) {
+        return a.name < b.name;
+    });
+    return true;
+}
+
+bool TextureAtlasBuilder::BuildIncremental(const std::string& outputDir, const std::string& atlasName,
+                                           std::unordered_map<std::string, uint64_t>& hashes) {
+    std::vector<AtlasPage> prevPages;
+    std::vector<AtlasRegion> prevRegions;
+    uint32_t prevPadding = 0;
+    if (!LoadMapping(outputDir + "/" + atlasName + ".atlas.json", prevPages, prevRegions, &prevPadding)) {
+        return false;
+    }
+
+    // 留白不同时槽位与UV都会变化，需要重新装箱
+    if (prevPadding != options_.padding) {
+        return false;
+    }
+
+    // 纹理集合必须完全一致
+    if (prevRegions.size() != inputs_.size()) {
+        return false;
+    }
+    std::unordered_map<std::string, size_t> byName;
+    for (size_t i = 0; i < prevRegions.size(); i++) {
+        byName[prevRegions[i].name] = i;
+    }
+
+    std::unordered_map<uint32_t, std::vector<size_t>> changedByPage;
+    for (const auto& input : inputs_) {
+        auto it = byName.find(input.name);
+        if (it == byName.end()) {
+            return false;
+        }
+        AtlasRegion& region = prevRegions[it->second];
+        region.sourcePath = input.path;
+        if (region.hash == hashes[input.name]) {
+            continue;
+        }
+
+        // 尺寸变化需要重新装箱
+        uint32_t width, height;
+        if (!ReadPNGSize(input.path, width, height) ||
+            width != region.width || height != region.height) {
+            return false;
+        }
+        if (region.page >= prevPages.size()) {
+            return false;
+        }
+        changedByPage[region.page].push_back(it->second);
+    }
+
+    for (const auto& page : prevPages) {
+        if (!fs::exists(outputDir + "/" + page.file)) {
+            return false;
+        }
+    }
+
+    // 只重写内容有变化的页
+    for (const auto& [pageIndex, changed] : changedByPage) {
+        const AtlasPage& pageInfo = prevPages[pageIndex];
+        Image page;
+        if (!DecodePNGFile(outputDir + "/" + pageInfo.file, page) ||
+            page.width != pageInfo.width || page.height != pageInfo.height) {
+            return false;
+        }
+
+        for (size_t index : changed) {
+            AtlasRegion& region = prevRegions[index];
+            Image texture;
+            if (!DecodePNGFile(region.sourcePath, texture)) {
+                return false;
+            }
+            if (region.x < options_.padding || region.y < options_.padding) {
+                return false;
+            }
+            BlitWithPadding(texture, page, region.x - options_.padding,
+                            region.y - options_.padding, options_.padding);
+            region.hash = hashes[region.name];
+            stats_.updated++;
+        }
+
+        if (!EncodePNGFile(outputDir + "/" + pageInfo.file, page)) {
+            return false;
+        }
+    }
+
+    pages_ = std::move(prevPages);
+    regions_ = std::move(prevRegions);
+    return true;
+}
+
+bool TextureAtlasBuilder::SaveMapping(const std::string& mappingPath) const {
+    json mapping;
+    mapping["version"] = 1;
+    mapping["padding"] = options_.padding;
+
+    json pages = json::array();
+    for (const auto& page : pages_) {
+        pages.push_back({{"file", page.file}, {"width", page.width}, {"height", page.height}});
+    }
+    mapping["pages"] = pages;
+
+    json textures = json::object();
+    for (const auto& region : regions_) {
+        textures[region.name] = {
+            {"page", region.page},
+            {"x", region.x},
+            {"y", region.y},
+            {"width", region.width},
+            {"height", region.height},
+            {"uv", {region.u0, region.v0, region.u1, region.v1}},
+            {"hash", region.hash}
+        };
+    }
+    mapping["textures"] = textures;
+
+    std::ofstream file(mappingPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << mapping.dump(2);
+    return file.good();
+}
+
+bool TextureAtlasBuilder::LoadMapping(const std::string& mappingPath,
+                                      std::vector<AtlasPage>& pages,
+                                      std::vector<AtlasRegion>& regions,
+                                      uint32_t* padding) {
+    std::ifstream file(mappingPath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        json mapping = json::parse(file);
+        if (padding) {
+            *padding = mapping.at("padding").get<uint32_t>();
+        }
+
+        pages.clear();
+        for (const auto& page : mapping.at("pages")) {
+            pages.push_back({page.at("file").get<std::string>(),
+                             page.at("width").get<uint32_t>(),
+                             page.at("height").get<uint32_t>()});
+        }
+
+        regions.clear();
+        for (auto& [name, value] : mapping.at("textures").items()) {
+            AtlasRegion region;
+            region.name = name;
+            region.hash = value.at("hash").get<uint64_t>();
+            region.page = value.at("page").get<uint32_t>();
+            region.x = value.at("x").get<uint32_t>();
+            region.y = value.at("y").get<uint32_t>();
+            region.width = value.at("width").get<uint32_t>();
+            region.height = value.at("height").get<uint32_t>();
+            const auto& uv = value.at("uv");
+            region.u0 = uv.at(0).get<float>();
+            region.v0 = uv.at(1).get<float>();
+            region.u1 = uv.at(2).get<float>();
+            region.v1 = uv.at(3).get<float>();
+            regions.push_back(region);
+        }
+    } catch (const json::exception& e) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WriteTextureDefinitions(const std::string& definitionPath,
+                             const std::string& textureName,
+                             const std::string& atlasPath,
+                             const std::vector<AtlasPage>& pages,
+                             const std::vector<AtlasRegion>& regions) {
+    json definitions = json::object();
+    std::ifstream input(definitionPath);
+    if (input.is_open()) {
+        definitions = json::parse(input, nullptr, false);
+        input.close();
+        if (!definitions.is_object()) {
+            return false;
+        }
+    }
+    if (!definitions.contains("texture_name")) {
+        definitions["texture_name"] = textureName;
+    }
+    json& textureData = definitions["texture_data"];
+    if (!textureData.is_object()) {
+        textureData = json::object();
+    }
+
+    // 纹理引用（不含扩展名） -> 图集中的位置
+    std::unordered_map<std::string, const AtlasRegion*> byPath;
+    for (const auto& region : regions) {
+        if (region.page < pages.size()) {
+            byPath["textures/" + region.name] = &region;
+        }
+    }
+    auto atlasEntry = [&](const AtlasRegion& region, json entry) {
+        std::string page = fs::path(pages[region.page].file).stem().string();
+        entry["path"] = atlasPath + "/" + page;
+        entry["uv"] = {region.x, region.y};
+        entry["uv_size"] = {region.width, region.height};
+        return entry;
+    };
+    std::unordered_set<const AtlasRegion*> referenced;
+    auto remap = [&](json& texture) {
+        bool isObject = texture.is_object() && texture.contains("path") && texture["path"].is_string();
+        if (!texture.is_string() && !isObject) {
+            return;
+        }
+        std::string path = isObject ? texture["path"].get<std::string>() : texture.get<std::string>();
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".png") == 0) {
+            path.resize(path.size() - 4);
+        }
+        auto it = byPath.find(path);
+        if (it != byPath.end()) {
+            texture = atlasEntry(*it->second, isObject ? texture : json::object());
+            referenced.insert(it->second);
+        }
+    };
+
+    // 已有条目：textures为字符串、对象或它们的数组
+    for (auto& [key, entry] : textureData.items()) {
+        if (!entry.is_object() || !entry.contains("textures")) {
+            continue;
+        }
+        json& textures = entry["textures"];
+        if (textures.is_array()) {
+            for (auto& texture : textures) {
+                remap(texture);
+            }
+        } else {
+            remap(textures);
+        }
+    }
+
+    // 未被引用的纹理以短名新增，已有同名条目时保留原条目
+    for (const auto& region : regions) {
+        if (region.page >= pages.size() || referenced.count(&region)) {
+            continue;
+        }
+        size_t slash = region.name.find('/');
+        std::string key = slash == std::string::npos ? region.name : region.name.substr(slash + 1);
+        if (!textureData.contains(key)) {
+            textureData[key] = {{"textures", atlasEntry(region, json::object())}};
+        }
+    }
+
+    std::ofstream output(definitionPath);
+    if (!output.is_open()) {
+        return false;
+    }
+    output << definitions.dump(2);
+    return output.good();
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
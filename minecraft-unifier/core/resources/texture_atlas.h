@@ -0,0 +1,142 @@
+/**
+ * Minecraft Unifier - Texture Atlas
+ * 纹理图集 - 将大量小纹理打包为少量大图
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// 图集配置
+struct AtlasOptions {
+    uint32_t maxPageSize = 2048;     // 单页最大边长
+    uint32_t maxTextureSize = 64;    // 超过此尺寸的纹理不入图集
+    uint32_t padding = 1;            // 纹理间留白（以边缘像素填充，防止采样串色）
+    bool skipAnimated = true;        // 跳过带.mcmeta的动画纹理
+};
+
+// 图集中单个纹理的位置
+struct AtlasRegion {
+    std::string name;       // 纹理名（相对路径，不含扩展名），如 "blocks/stone"
+    std::string sourcePath; // 源文件路径
+    uint64_t hash;          // 源文件内容哈希
+    uint32_t page;          // 所在页
+    uint32_t x, y;          // 像素坐标
+    uint32_t width, height; // 像素尺寸
+    float u0, v0, u1, v1;   // 归一化UV
+};
+
+// 图集页
+struct AtlasPage {
+    std::string file;       // 页文件名
+    uint32_t width;
+    uint32_t height;
+};
+
+// 构建统计
+struct AtlasBuildStats {
+    bool incremental = false;   // 是否走增量路径
+    size_t packed = 0;          // 入图集的纹理数
+    size_t updated = 0;         // 增量更新的纹理数
+    size_t skipped = 0;         // 未入图集的纹理数（过大/动画/解码失败）
+    size_t pages = 0;           // 页数
+};
+
+// Skyline装箱器（bottom-left策略）
+class SkylinePacker {
+public:
+    SkylinePacker(uint32_t width, uint32_t height);
+
+    // 放置矩形，成功返回true并写出坐标
+    bool Insert(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+    // 已使用的包围尺寸
+    uint32_t UsedWidth() const { return usedWidth_; }
+    uint32_t UsedHeight() const { return usedHeight_; }
+
+private:
+    struct Node {
+        uint32_t x, y, width;
+    };
+
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t usedWidth_;
+    uint32_t usedHeight_;
+    std::vector<Node> skyline_;
+
+    bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const;
+    void AddLevel(size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+};
+
+// 纹理图集构建器
+class TextureAtlasBuilder {
+public:
+    explicit TextureAtlasBuilder(const AtlasOptions& options = AtlasOptions());
+    ~TextureAtlasBuilder();
+
+    // 添加纹理（name为图集内的键）
+    void AddTexture(const std::string& name, const std::string& path);
+
+    // 添加目录下所有PNG纹理，键为"prefix/相对路径"
+    size_t AddDirectory(const std::string& dir, const std::string& prefix);
+
+    // 构建图集，输出 <atlasName>_N.png 与 <atlasName>.atlas.json
+    // 若输出目录中已有同名图集且纹理集合与尺寸未变，只重写内容变化的页
+    bool Build(const std::string& outputDir, const std::string& atlasName);
+
+    // 获取构建结果
+    const std::vector<AtlasRegion>& GetRegions() const { return regions_; }
+    const std::vector<AtlasPage>& GetPages() const { return pages_; }
+    const AtlasBuildStats& GetStats() const { return stats_; }
+
+    // 已入图集的源文件（可由调用方删除以减少文件数）
+    std::vector<std::string> GetPackedSources() const;
+
+    // 读取UV映射文件，padding非空时一并读出生成时的留白
+    static bool LoadMapping(const std::string& mappingPath,
+                            std::vector<AtlasPage>& pages,
+                            std::vector<AtlasRegion>& regions,
+                            uint32_t* padding = nullptr);
+
+private:
+    struct Input {
+        std::string name;
+        std::string path;
+    };
+
+    AtlasOptions options_;
+    std::vector<Input> inputs_;
+    std::vector<AtlasRegion> regions_;
+    std::vector<AtlasPage> pages_;
+    AtlasBuildStats stats_;
+
+    bool BuildFull(const std::string& outputDir, const std::string& atlasName,
+                   std::unordered_map<std::string, uint64_t>& hashes);
+    bool BuildIncremental(const std::string& outputDir, const std::string& atlasName,
+                          std::unordered_map<std::string, uint64_t>& hashes);
+    bool SaveMapping(const std::string& mappingPath) const;
+};
+
+// 文件内容哈希（FNV-1a 64位）
+uint64_t HashFileContent(const std::string& path);
+
+// 将基岩版纹理定义文件（terrain_texture.json/item_texture.json）改为引用图集
+// 路径为"textures/<纹理名>"的条目改为{"path": 图集页, "uv": [x, y], "uv_size": [w, h]}，
+// 未被引用的纹理以去掉类别前缀的纹理名新增条目；文件不存在时新建，textureName写入"texture_name"
+// atlasPath为页文件所在目录（相对资源包根，如"textures/atlas"）
+bool WriteTextureDefinitions(const std::string& definitionPath,
+                             const std::string& textureName,
+                             const std::string& atlasPath,
+                             const std::vector<AtlasPage>& pages,
+                             const std::vector<AtlasRegion>& regions);
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
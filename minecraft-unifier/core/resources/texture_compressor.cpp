@@ -0,0 +1,789 @@
+/**
+ * Minecraft Unifier - Texture Compressor Implementation
+ * 纹理压缩实现 - ETC2 RGBA8(EAC) / ASTC 4x4 / BC7(mode 6)块编码
+ */
+
+#include "texture_compressor.h"
+#include "thread_pool.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+namespace {
+
+// 4x4块像素，按行优先排列 p = y * 4 + x
+struct Block {
+    int px[16][4];
+};
+
+void ExtractBlock(const Image& image, uint32_t bx, uint32_t by, Block& block) {
+    for (int y = 0; y < 4; y++) {
+        uint32_t sy = std::min(by * 4 + y, image.height - 1);
+        for (int x = 0; x < 4; x++) {
+            uint32_t sx = std::min(bx * 4 + x, image.width - 1);
+            const uint8_t* src = image.pixels.data() + (static_cast<size_t>(sy) * image.width + sx) * 4;
+            for (int c = 0; c < 4; c++) {
+                block.px[y * 4 + x][c] = src[c];
+            }
+        }
+    }
+}
+
+int Clamp255(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+int Square(int v) {
+    return v * v;
+}
+
+// LSB优先的位写入器（BC7/ASTC）
+struct BitWriter {
+    uint8_t* data;
+    int pos = 0;
+
+    void Write(uint32_t value, int bits) {
+        for (int i = 0; i < bits; i++, pos++) {
+            if (value & (1u << i)) {
+                data[pos >> 3] |= static_cast<uint8_t>(1u << (pos & 7));
+            }
+        }
+    }
+
+    void SetBit(int bit, bool value) {
+        if (value) {
+            data[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+        }
+    }
+};
+
+void WriteBE64(uint8_t* out, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<uint8_t>(v >> (56 - i * 8));
+    }
+}
+
+// ==================== 端点选择 ====================
+
+// 沿主成分方向求端点（FAST预设退化为逐通道包围盒）
+void SelectEndpoints(const Block& block, CompressionPreset preset, float e0[4], float e1[4]) {
+    if (preset == CompressionPreset::FAST) {
+        for (int c = 0; c < 4; c++) {
+            e0[c] = 255.0f;
+            e1[c] = 0.0f;
+            for (int p = 0; p < 16; p++) {
+                e0[c] = std::min(e0[c], static_cast<float>(block.px[p][c]));
+                e1[c] = std::max(e1[c], static_cast<float>(block.px[p][c]));
+            }
+        }
+        return;
+    }
+
+    float mean[4] = {0, 0, 0, 0};
+    for (int p = 0; p < 16; p++) {
+        for (int c = 0; c < 4; c++) {
+            mean[c] += block.px[p][c];
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        mean[c] /= 16.0f;
+    }
+
+    float cov[4][4] = {};
+    for (int p = 0; p < 16; p++) {
+        float d[4];
+        for (int c = 0; c < 4; c++) {
+            d[c] = block.px[p][c] - mean[c];
+        }
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                cov[i][j] += d[i] * d[j];
+            }
+        }
+    }
+
+    // 幂迭代求主轴
+    float axis[4] = {1, 1, 1, 1};
+    for (int iter = 0; iter < 8; iter++) {
+        float next[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                next[i] += cov[i][j] * axis[j];
+            }
+        }
+        float len = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+        if (len < 1e-6f) {
+            break;
+        }
+        for (int i = 0; i < 4; i++) {
+            axis[i] = next[i] / len;
+        }
+    }
+
+    float tmin = std::numeric_limits<float>::max();
+    float tmax = std::numeric_limits<float>::lowest();
+    for (int p = 0; p < 16; p++) {
+        float t = 0;
+        for (int c = 0; c < 4; c++) {
+            t += (block.px[p][c] - mean[c]) * axis[c];
+        }
+        tmin = std::min(tmin, t);
+        tmax = std::max(tmax, t);
+    }
+
+    for (int c = 0; c < 4; c++) {
+        e0[c] = std::min(255.0f, std::max(0.0f, mean[c] + tmin * axis[c]));
+        e1[c] = std::min(255.0f, std::max(0.0f, mean[c] + tmax * axis[c]));
+    }
+}
+
+// 已知每像素插值权重(0..1)时，最小二乘求解端点
+void RefineEndpoints(const Block& block, const float weights[16], float e0[4], float e1[4]) {
+    float aa = 0, ab = 0, bb = 0;
+    float ax[4] = {0, 0, 0, 0};
+    float bx[4] = {0, 0, 0, 0};
+    for (int p = 0; p < 16; p++) {
+        float b = weights[p];
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < 4; c++) {
+            ax[c] += a * block.px[p][c];
+            bx[c] += b * block.px[p][c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) {
+        return;
+    }
+    for (int c = 0; c < 4; c++) {
+        e0[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) / det));
+        e1[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) / det));
+    }
+}
+
+// ==================== BC7 (mode 6) ====================
+
+const int kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Candidate {
+    int q[2][4];    // 7位端点
+    int p[2];       // p-bit
+    int indices[16];
+    int error;
+};
+
+// 以p-bit量化端点（7位 + 共享p-bit = 8位）
+void QuantizeBC7Endpoint(const float e[4], int q[4], int& pbit) {
+    int bestError = std::numeric_limits<int>::max();
+    for (int p = 0; p < 2; p++) {
+        int err = 0;
+        int tq[4];
+        for (int c = 0; c < 4; c++) {
+            tq[c] = std::min(127, std::max(0, static_cast<int>(std::lround((e[c] - p) / 2.0f))));
+            err += Square(((tq[c] << 1) | p) - static_cast<int>(std::lround(e[c])));
+        }
+        if (err < bestError) {
+            bestError = err;
+            pbit = p;
+            std::copy(tq, tq + 4, q);
+        }
+    }
+}
+
+void AssignBC7Indices(const Block& block, BC7Candidate& cand) {
+    int palette[16][4];
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            int a = (cand.q[0][c] << 1) | cand.p[0];
+            int b = (cand.q[1][c] << 1) | cand.p[1];
+            palette[i][c] = (a * (64 - kBC7Weights4[i]) + b * kBC7Weights4[i] + 32) >> 6;
+        }
+    }
+    cand.error = 0;
+    for (int p = 0; p < 16; p++) {
+        int best = 0;
+        int bestErr = std::numeric_limits<int>::max();
+        for (int i = 0; i < 16; i++) {
+            int err = 0;
+            for (int c = 0; c < 4; c++) {
+                err += Square(block.px[p][c] - palette[i][c]);
+            }
+            if (err < bestErr) {
+                bestErr = err;
+                best = i;
+            }
+        }
+        cand.indices[p] = best;
+        cand.error += bestErr;
+    }
+}
+
+void EncodeBC7Block(const Block& block, CompressionPreset preset, uint8_t out[16]) {
+    float e0[4], e1[4];
+    SelectEndpoints(block, preset, e0, e1);
+
+    BC7Candidate best;
+    QuantizeBC7Endpoint(e0, best.q[0], best.p[0]);
+    QuantizeBC7Endpoint(e1, best.q[1], best.p[1]);
+    AssignBC7Indices(block, best);
+
+    if (preset == CompressionPreset::QUALITY) {
+        for (int iter = 0; iter < 2 && best.error > 0; iter++) {
+            float weights[16];
+            for (int p = 0; p < 16; p++) {
+                weights[p] = kBC7Weights4[best.indices[p]] / 64.0f;
+            }
+            RefineEndpoints(block, weights, e0, e1);
+            BC7Candidate cand;
+            QuantizeBC7Endpoint(e0, cand.q[0], cand.p[0]);
+            QuantizeBC7Endpoint(e1, cand.q[1], cand.p[1]);
+            AssignBC7Indices(block, cand);
+            if (cand.error >= best.error) {
+                break;
+            }
+            best = cand;
+        }
+    }
+
+    // 锚点像素索引最高位隐含为0，必要时交换端点
+    if (best.indices[0] & 8) {
+        for (int c = 0; c < 4; c++) {
+            std::swap(best.q[0][c], best.q[1][c]);
+        }
+        std::swap(best.p[0], best.p[1]);
+        for (int p = 0; p < 16; p++) {
+            best.indices[p] = 15 - best.indices[p];
+        }
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.Write(1u << 6, 7); // mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.Write(best.q[0][c], 7);
+        writer.Write(best.q[1][c], 7);
+    }
+    writer.Write(best.p[0], 1);
+    writer.Write(best.p[1], 1);
+    writer.Write(best.indices[0], 3);
+    for (int p = 1; p < 16; p++) {
+        writer.Write(best.indices[p], 4);
+    }
+}
+
+// ==================== ASTC 4x4 ====================
+
+// 单分区、LDR RGBA直接端点(CEM 12)、4x4权重网格、2位权重(QUANT_4)、8位端点(QUANT_256)
+// 块模式0x42: R=100(QUANT_4), A=2(高度4), B=0(宽度4), H=0, D=0
+const uint32_t kASTCBlockMode = 0x42;
+const int kASTCWeights[4] = {0, 21, 43, 64};
+
+struct ASTCCandidate {
+    int e[2][4];
+    int weights[16];
+    int error;
+};
+
+int ASTCInterpolate(int a, int b, int w) {
+    // LDR解码：8位端点扩展为16位后插值，再取高8位
+    int a16 = a * 257;
+    int b16 = b * 257;
+    return ((a16 * (64 - w) + b16 * w + 32) >> 6) >> 8;
+}
+
+void AssignASTCWeights(const Block& block, ASTCCandidate& cand) {
+    int palette[4][4];
+    for (int i = 0; i < 4; i++) {
+        for (int c = 0; c < 4; c++) {
+            palette[i][c] = ASTCInterpolate(cand.e[0][c], cand.e[1][c], kASTCWeights[i]);
+        }
+    }
+    cand.error = 0;
+    for (int p = 0; p < 16; p++) {
+        int best = 0;
+        int bestErr = std::numeric_limits<int>::max();
+        for (int i = 0; i < 4; i++) {
+            int err = 0;
+            for (int c = 0; c < 4; c++) {
+                err += Square(block.px[p][c] - palette[i][c]);
+            }
+            if (err < bestErr) {
+                bestErr = err;
+                best = i;
+            }
+        }
+        cand.weights[p] = best;
+        cand.error += bestErr;
+    }
+}
+
+void RoundEndpoints(const float e0[4], const float e1[4], ASTCCandidate& cand) {
+    for (int c = 0; c < 4; c++) {
+        cand.e[0][c] = Clamp255(static_cast<int>(std::lround(e0[c])));
+        cand.e[1][c] = Clamp255(static_cast<int>(std::lround(e1[c])));
+    }
+}
+
+void EncodeASTCBlock(const Block& block, CompressionPreset preset, uint8_t out[16]) {
+    float e0[4], e1[4];
+    SelectEndpoints(block, preset, e0, e1);
+
+    ASTCCandidate best;
+    RoundEndpoints(e0, e1, best);
+    AssignASTCWeights(block, best);
+
+    if (preset == CompressionPreset::QUALITY) {
+        for (int iter = 0; iter < 2 && best.error > 0; iter++) {
+            float weights[16];
+            for (int p = 0; p < 16; p++) {
+                weights[p] = kASTCWeights[best.weights[p]] / 64.0f;
+            }
+            RefineEndpoints(block, weights, e0, e1);
+            ASTCCandidate cand;
+            RoundEndpoints(e0, e1, cand);
+            AssignASTCWeights(block, cand);
+            if (cand.error >= best.error) {
+                break;
+            }
+            best = cand;
+        }
+    }
+
+    // RGB和较小的端点必须在前，否则解码器会执行blue-contract
+    int sum0 = best.e[0][0] + best.e[0][1] + best.e[0][2];
+    int sum1 = best.e[1][0] + best.e[1][1] + best.e[1][2];
+    if (sum1 < sum0) {
+        for (int c = 0; c < 4; c++) {
+            std::swap(best.e[0][c], best.e[1][c]);
+        }
+        for (int p = 0; p < 16; p++) {
+            best.weights[p] = 3 - best.weights[p];
+        }
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.Write(kASTCBlockMode, 11);
+    writer.Write(0, 2);  // 分区数-1
+    writer.Write(12, 4); // CEM: LDR RGBA direct
+    for (int c = 0; c < 4; c++) {
+        writer.Write(best.e[0][c], 8);
+        writer.Write(best.e[1][c], 8);
+    }
+
+    // 权重流从块的最高位开始倒序存放
+    for (int p = 0; p < 16; p++) {
+        writer.SetBit(127 - p * 2, best.weights[p] & 1);
+        writer.SetBit(126 - p * 2, (best.weights[p] >> 1) & 1);
+    }
+}
+
+// ==================== ETC2 RGBA8 (EAC alpha + ETC1兼容颜色) ====================
+
+const int kEACTables[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+const int kETC1Tables[8][2] = {
+    {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+// ETC像素编号为列优先：k = x * 4 + y
+int EtcPixelIndex(int p) {
+    return (p % 4) * 4 + p / 4;
+}
+
+uint64_t EncodeEACAlpha(const Block& block, CompressionPreset preset) {
+    int amin = 255, amax = 0;
+    for (int p = 0; p < 16; p++) {
+        amin = std::min(amin, block.px[p][3]);
+        amax = std::max(amax, block.px[p][3]);
+    }
+
+    int bestError = std::numeric_limits<int>::max();
+    int bestBase = 0, bestMult = 1, bestTable = 0;
+    int bestIdx[16] = {};
+
+    int baseCenter = (amin + amax + 1) / 2;
+    int baseRadius = preset == CompressionPreset::QUALITY ? 2 : 0;
+    int multRadius = preset == CompressionPreset::FAST ? 0 : 1;
+
+    for (int table = 0; table < 16 && bestError > 0; table++) {
+        const int* mods = kEACTables[table];
+        int span = mods[7] - mods[3];
+        int multCenter = std::max(1, std::min(15, static_cast<int>(std::lround(float(amax - amin) / span))));
+        for (int base = baseCenter - baseRadius; base <= baseCenter + baseRadius; base++) {
+            if (base < 0 || base > 255) {
+                continue;
+            }
+            for (int mult = multCenter - multRadius; mult <= multCenter + multRadius; mult++) {
+                if (mult < 1 || mult > 15) {
+                    continue;
+                }
+                int error = 0;
+                int idx[16];
+                for (int p = 0; p < 16 && error < bestError; p++) {
+                    int bestPixErr = std::numeric_limits<int>::max();
+                    for (int i = 0; i < 8; i++) {
+                        int err = Square(block.px[p][3] - Clamp255(base + mods[i] * mult));
+                        if (err < bestPixErr) {
+                            bestPixErr = err;
+                            idx[p] = i;
+                        }
+                    }
+                    error += bestPixErr;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    bestBase = base;
+                    bestMult = mult;
+                    bestTable = table;
+                    std::copy(idx, idx + 16, bestIdx);
+                }
+            }
+        }
+    }
+
+    uint64_t bits = (uint64_t(bestBase) << 56) | (uint64_t(bestMult) << 52) | (uint64_t(bestTable) << 48);
+    for (int p = 0; p < 16; p++) {
+        int k = EtcPixelIndex(p);
+        bits |= uint64_t(bestIdx[p]) << (45 - k * 3);
+    }
+    return bits;
+}
+
+struct EtcSubBlock {
+    int table;
+    int modifier[8]; // 子块内像素的修正索引(0..3)
+    int error;
+};
+
+// 以给定基色(8位)为子块选择最佳修正表
+EtcSubBlock FitEtcSubBlock(const Block& block, const int* pixels, const int base[3]) {
+    EtcSubBlock best;
+    best.error = std::numeric_limits<int>::max();
+    for (int table = 0; table < 8; table++) {
+        const int mods[4] = {kETC1Tables[table][0], kETC1Tables[table][1],
+                             -kETC1Tables[table][0], -kETC1Tables[table][1]};
+        EtcSubBlock cand;
+        cand.table = table;
+        cand.error = 0;
+        for (int i = 0; i < 8 && cand.error < best.error; i++) {
+            const int* px = block.px[pixels[i]];
+            int bestPixErr = std::numeric_limits<int>::max();
+            for (int m = 0; m < 4; m++) {
+                int err = Square(px[0] - Clamp255(base[0] + mods[m])) +
+                          Square(px[1] - Clamp255(base[1] + mods[m])) +
+                          Square(px[2] - Clamp255(base[2] + mods[m]));
+                if (err < bestPixErr) {
+                    bestPixErr = err;
+                    cand.modifier[i] = m;
+                }
+            }
+            cand.error += bestPixErr;
+        }
+        if (cand.error < best.error) {
+            best = cand;
+        }
+    }
+    return best;
+}
+
+int Expand4(int v) { return (v << 4) | v; }
+int Expand5(int v) { return (v << 3) | (v >> 2); }
+
+struct EtcCandidate {
+    bool differential;
+    bool flip;
+    int q[2][3];    // 量化基色（4位或5位）
+    EtcSubBlock sub[2];
+    int pixels[2][8];
+    int error;
+};
+
+// 在量化基色附近做±1邻域搜索（QUALITY预设）
+void SearchEtcBase(const Block& block, const int* pixels, bool fiveBit, int q[3], EtcSubBlock& sub,
+                   int radius, const int* anchor) {
+    int maxQ = fiveBit ? 31 : 15;
+    int start[3] = {q[0], q[1], q[2]};
+    for (int dr = -radius; dr <= radius; dr++) {
+        for (int dg = -radius; dg <= radius; dg++) {
+            for (int db = -radius; db <= radius; db++) {
+                int tq[3] = {start[0] + dr, start[1] + dg, start[2] + db};
+                bool valid = true;
+                for (int c = 0; c < 3; c++) {
+                    if (tq[c] < 0 || tq[c] > maxQ) valid = false;
+                    // 差分模式下第二子块相对第一子块的差值限制在[-4, 3]
+                    if (anchor && (tq[c] - anchor[c] < -4 || tq[c] - anchor[c] > 3)) valid = false;
+                }
+                if (!valid) {
+                    continue;
+                }
+                int base[3];
+                for (int c = 0; c < 3; c++) {
+                    base[c] = fiveBit ? Expand5(tq[c]) : Expand4(tq[c]);
+                }
+                EtcSubBlock cand = FitEtcSubBlock(block, pixels, base);
+                if (cand.error < sub.error) {
+                    sub = cand;
+                    std::copy(tq, tq + 3, q);
+                }
+            }
+        }
+    }
+}
+
+EtcCandidate EncodeEtcMode(const Block& block, bool flip, bool differential, CompressionPreset preset) {
+    EtcCandidate cand;
+    cand.flip = flip;
+    cand.differential = differential;
+
+    int count[2] = {0, 0};
+    for (int p = 0; p < 16; p++) {
+        int x = p % 4, y = p / 4;
+        int s = flip ? (y < 2 ? 0 : 1) : (x < 2 ? 0 : 1);
+        cand.pixels[s][count[s]++] = p;
+    }
+
+    int maxQ = differential ? 31 : 15;
+    for (int s = 0; s < 2; s++) {
+        for (int c = 0; c < 3; c++) {
+            int sum = 0;
+            for (int i = 0; i < 8; i++) {
+                sum += block.px[cand.pixels[s][i]][c];
+            }
+            cand.q[s][c] = static_cast<int>(std::lround(sum / 8.0f * maxQ / 255.0f));
+        }
+    }
+
+    if (differential) {
+        for (int c = 0; c < 3; c++) {
+            int d = std::max(-4, std::min(3, cand.q[1][c] - cand.q[0][c]));
+            cand.q[1][c] = cand.q[0][c] + d;
+        }
+    }
+
+    int radius = preset == CompressionPreset::QUALITY ? 1 : 0;
+    cand.error = 0;
+    for (int s = 0; s < 2; s++) {
+        int base[3];
+        for (int c = 0; c < 3; c++) {
+            base[c] = differential ? Expand5(cand.q[s][c]) : Expand4(cand.q[s][c]);
+        }
+        cand.sub[s] = FitEtcSubBlock(block, cand.pixels[s], base);
+        if (radius > 0) {
+            SearchEtcBase(block, cand.pixels[s], differential, cand.q[s], cand.sub[s], radius,
+                          (differential && s == 1) ? cand.q[0] : nullptr);
+        }
+        cand.error += cand.sub[s].error;
+    }
+
+    // 第一子块基色改变后需重新校验差值范围
+    if (differential) {
+        for (int c = 0; c < 3; c++) {
+            int d = cand.q[1][c] - cand.q[0][c];
+            if (d < -4 || d > 3) {
+                cand.error = std::numeric_limits<int>::max();
+            }
+        }
+    }
+    return cand;
+}
+
+uint64_t EncodeEtcColor(const Block& block, CompressionPreset preset) {
+    EtcCandidate best{};
+    best.error = std::numeric_limits<int>::max();
+
+    for (int flip = 0; flip < 2; flip++) {
+        if (flip && preset == CompressionPreset::FAST) {
+            break;
+        }
+        for (int diff = 1; diff >= 0; diff--) {
+            if (!diff && preset == CompressionPreset::FAST && best.error != std::numeric_limits<int>::max()) {
+                break;
+            }
+            EtcCandidate cand = EncodeEtcMode(block, flip != 0, diff != 0, preset);
+            if (cand.error < best.error) {
+                best = cand;
+            }
+        }
+    }
+
+    uint64_t bits = 0;
+    if (best.differential) {
+        for (int c = 0; c < 3; c++) {
+            int d = (best.q[1][c] - best.q[0][c]) & 7;
+            bits |= uint64_t((best.q[0][c] << 3) | d) << (56 - c * 8);
+        }
+    } else {
+        for (int c = 0; c < 3; c++) {
+            bits |= uint64_t((best.q[0][c] << 4) | best.q[1][c]) << (56 - c * 8);
+        }
+    }
+    bits |= uint64_t(best.sub[0].table) << 37;
+    bits |= uint64_t(best.sub[1].table) << 34;
+    bits |= uint64_t(best.differential ? 1 : 0) << 33;
+    bits |= uint64_t(best.flip ? 1 : 0) << 32;
+
+    for (int s = 0; s < 2; s++) {
+        for (int i = 0; i < 8; i++) {
+            int k = EtcPixelIndex(best.pixels[s][i]);
+            int m = best.sub[s].modifier[i];
+            // 修正索引：0→+a, 1→+b, 2→-a, 3→-b（高位在bit 16+k，低位在bit k）
+            bits |= uint64_t(m >> 1) << (16 + k);
+            bits |= uint64_t(m & 1) << k;
+        }
+    }
+    return bits;
+}
+
+void EncodeETC2Block(const Block& block, CompressionPreset preset, uint8_t out[16]) {
+    WriteBE64(out, EncodeEACAlpha(block, preset));
+    WriteBE64(out + 8, EncodeEtcColor(block, preset));
+}
+
+} // namespace
+
+std::vector<CompressedFormat> DefaultCompressedFormats() {
+#ifdef __ANDROID__
+    return {CompressedFormat::ETC2_RGBA8, CompressedFormat::ASTC_4x4};
+#else
+    return {CompressedFormat::BC7};
+#endif
+}
+
+const char* CompressedFormatSuffix(CompressedFormat format) {
+    switch (format) {
+        case CompressedFormat::ETC2_RGBA8: return "etc2";
+        case CompressedFormat::ASTC_4x4:   return "astc";
+        case CompressedFormat::BC7:        return "bc7";
+    }
+    return "unknown";
+}
+
+bool ParseCompressedFormat(const std::string& str, CompressedFormat& format) {
+    if (str == "etc2") {
+        format = CompressedFormat::ETC2_RGBA8;
+    } else if (str == "astc") {
+        format = CompressedFormat::ASTC_4x4;
+    } else if (str == "bc7") {
+        format = CompressedFormat::BC7;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ParseCompressionPreset(const std::string& str, CompressionPreset& preset) {
+    if (str == "fast") {
+        preset = CompressionPreset::FAST;
+    } else if (str == "balanced") {
+        preset = CompressionPreset::BALANCED;
+    } else if (str == "quality") {
+        preset = CompressionPreset::QUALITY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool CompressImage(const Image& image, CompressedFormat format, CompressionPreset preset,
+                   std::vector<uint8_t>& out) {
+    if (image.Empty()) {
+        return false;
+    }
+
+    uint32_t blocksX = (image.width + 3) / 4;
+    uint32_t blocksY = (image.height + 3) / 4;
+    out.assign(static_cast<size_t>(blocksX) * blocksY * 16, 0);
+
+    // 按块行并行编码，各行输出区域互不重叠
+    common::ThreadPool::GetDefault().ParallelFor(0, blocksY, [&](size_t by) {
+        Block block;
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            ExtractBlock(image, bx, static_cast<uint32_t>(by), block);
+            uint8_t* dst = out.data() + (by * blocksX + bx) * 16;
+            switch (format) {
+                case CompressedFormat::ETC2_RGBA8:
+                    EncodeETC2Block(block, preset, dst);
+                    break;
+                case CompressedFormat::ASTC_4x4:
+                    EncodeASTCBlock(block, preset, dst);
+                    break;
+                case CompressedFormat::BC7:
+                    EncodeBC7Block(block, preset, dst);
+                    break;
+            }
+        }
+    });
+
+    return true;
+}
+
+bool WriteKTX(const std::string& path, CompressedFormat format,
+              uint32_t width, uint32_t height, const std::vector<uint8_t>& data) {
+    static const uint8_t kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    uint32_t internalFormat;
+    switch (format) {
+        case CompressedFormat::ETC2_RGBA8: internalFormat = 0x9278; break; // GL_COMPRESSED_RGBA8_ETC2_EAC
+        case CompressedFormat::ASTC_4x4:   internalFormat = 0x93B0; break; // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+        case CompressedFormat::BC7:        internalFormat = 0x8E8C; break; // GL_COMPRESSED_RGBA_BPTC_UNORM
+        default: return false;
+    }
+
+    const uint32_t header[13] = {
+        0x04030201,         // endianness
+        0,                  // glType
+        1,                  // glTypeSize
+        0,                  // glFormat
+        internalFormat,     // glInternalFormat
+        0x1908,             // glBaseInternalFormat (GL_RGBA)
+        width,
+        height,
+        0,                  // pixelDepth
+        0,                  // numberOfArrayElements
+        1,                  // numberOfFaces
+        1,                  // numberOfMipmapLevels
+        0                   // bytesOfKeyValueData
+    };
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint32_t imageSize = static_cast<uint32_t>(data.size());
+    file.write(reinterpret_cast<const char*>(kIdentifier), sizeof(kIdentifier));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&imageSize), sizeof(imageSize));
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
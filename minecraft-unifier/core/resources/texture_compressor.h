@@ -0,0 +1,55 @@
+/**
+ * Minecraft Unifier - Texture Compressor
+ * 纹理压缩 - 离线生成GPU可直接上传的ETC2/ASTC/BC7纹理
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "image_codec.h"
+
+namespace mcu {
+namespace core {
+namespace resources {
+
+// GPU压缩格式（均为4x4块、每块16字节）
+enum class CompressedFormat {
+    ETC2_RGBA8,     // Android（OpenGL ES 3.0必备）
+    ASTC_4x4,       // Android（较新设备）
+    BC7             // 桌面端
+};
+
+// 质量/速度预设
+enum class CompressionPreset {
+    FAST,           // 包围盒端点，单一分块方式
+    BALANCED,       // 主成分端点，尝试全部分块方式
+    QUALITY         // 在BALANCED基础上做端点最小二乘/邻域细化
+};
+
+// 纹理压缩配置（来自资源包配置 pack_config.json 的 texture_compression 段）
+struct TextureCompressionOptions {
+    bool enabled = false;
+    std::vector<CompressedFormat> formats;  // 为空时按当前平台选择
+    CompressionPreset preset = CompressionPreset::BALANCED;
+};
+
+// 当前平台的默认压缩格式（Android: ETC2+ASTC，桌面: BC7）
+std::vector<CompressedFormat> DefaultCompressedFormats();
+
+// 格式/预设与字符串互转
+const char* CompressedFormatSuffix(CompressedFormat format);
+bool ParseCompressedFormat(const std::string& str, CompressedFormat& format);
+bool ParseCompressionPreset(const std::string& str, CompressionPreset& preset);
+
+// 压缩整张图像，按块行分配到线程池并行编码
+bool CompressImage(const Image& image, CompressedFormat format, CompressionPreset preset,
+                   std::vector<uint8_t>& out);
+
+// 以KTX 1.1容器写出压缩数据（单级mipmap）
+bool WriteKTX(const std::string& path, CompressedFormat format,
+              uint32_t width, uint32_t height, const std::vector<uint8_t>& data);
+
+} // namespace resources
+} // namespace core
+} // namespace mcu
@@ -4,10 +4,12 @@
  */
 
 #include "elf_injector.h"
+#include <core/render/shader_source_cache.h>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 #include <elf.h>
+#include <dlfcn.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
@@ -879,12 +881,39 @@ int hooked_open(const char* pathname, int flags, mode_t mode) {
     return orig_open(pathname, flags, mode);
 }
 
+// glGetShaderiv不在Hook的导入表中，首次使用时解析
+const GLenum kGLShaderType = 0x8B4F; // GL_SHADER_TYPE
+using GetShaderivFunc = void (*)(GLuint, GLenum, GLint*);
+
+GetShaderivFunc ResolveGetShaderiv() {
+    static GetShaderivFunc func = reinterpret_cast<GetShaderivFunc>(dlsym(RTLD_DEFAULT, "glGetShaderiv"));
+    return func;
+}
+
 void (*orig_glShaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*) = nullptr;
 
 void hooked_glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
-    // 拦截着色器源代码，进行转换
-    // TODO: 实现GLSL转换逻辑
-    orig_glShaderSource(shader, count, string, length);
+    // 只转换已加载的Java版光影包的源代码，游戏自身（GLSL ES等）的着色器原样传递
+    auto& cache = core::render::ShaderSourceCache::GetInstance();
+    GetShaderivFunc getShaderiv = ResolveGetShaderiv();
+    if (!getShaderiv || !cache.ShouldTranslate(count, string, length)) {
+        orig_glShaderSource(shader, count, string, length);
+        return;
+    }
+    
+    // 按源代码哈希查找已转换的结果，未命中时才转换
+    GLint type = 0;
+    getShaderiv(shader, kGLShaderType, &type);
+    core::render::ShaderStage stage;
+    if (!core::render::ShaderStageFromGLType(static_cast<unsigned int>(type), stage)) {
+        orig_glShaderSource(shader, count, string, length);
+        return;
+    }
+    
+    auto translated = cache.Translate(count, string, length, stage);
+    const GLchar* source = translated->c_str();
+    GLint sourceLength = static_cast<GLint>(translated->size());
+    orig_glShaderSource(shader, 1, &source, &sourceLength);
 }
 
 bool InstallAllHooks() {
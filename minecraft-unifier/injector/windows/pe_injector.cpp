@@ -4,6 +4,7 @@
  */
 
 #include "pe_injector.h"
+#include <core/render/shader_source_cache.h>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -859,13 +860,43 @@ HANDLE WINAPI Hooked_CreateFileW(LPCWSTR lpFileName, DWORD dwDesiredAccess,
                            dwFlagsAndAttributes, hTemplateFile);
 }
 
+// glGetShaderiv是GL 2.0函数，opengl32.dll不导出，需在有当前上下文时通过wglGetProcAddress获取
+const GLenum kGLShaderType = 0x8B4F; // GL_SHADER_TYPE
+using GetShaderivFunc = void (APIENTRY*)(GLuint, GLenum, GLint*);
+
+GetShaderivFunc ResolveGetShaderiv() {
+    static GetShaderivFunc func = nullptr;
+    if (!func) {
+        func = reinterpret_cast<GetShaderivFunc>(wglGetProcAddress("glGetShaderiv"));
+    }
+    return func;
+}
+
 void (APIENTRY* orig_glShaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*) = nullptr;
 
 void APIENTRY Hooked_glShaderSource(GLuint shader, GLsizei count,
                                    const GLchar* const* string, const GLint* length) {
-    // 拦截着色器源代码，进行转换
-    // TODO: 实现GLSL转换逻辑
-    orig_glShaderSource(shader, count, string, length);
+    // 只转换已加载的Java版光影包的源代码，游戏自身（GLSL ES等）的着色器原样传递
+    auto& cache = core::render::ShaderSourceCache::GetInstance();
+    GetShaderivFunc getShaderiv = ResolveGetShaderiv();
+    if (!getShaderiv || !cache.ShouldTranslate(count, string, length)) {
+        orig_glShaderSource(shader, count, string, length);
+        return;
+    }
+    
+    // 按源代码哈希查找已转换的结果，未命中时才转换
+    GLint type = 0;
+    getShaderiv(shader, kGLShaderType, &type);
+    core::render::ShaderStage stage;
+    if (!core::render::ShaderStageFromGLType(static_cast<unsigned int>(type), stage)) {
+        orig_glShaderSource(shader, count, string, length);
+        return;
+    }
+    
+    auto translated = cache.Translate(count, string, length, stage);
+    const GLchar* source = translated->c_str();
+    GLint sourceLength = static_cast<GLint>(translated->size());
+    orig_glShaderSource(shader, 1, &source, &sourceLength);
 }
 
 bool InstallAllHooks() {
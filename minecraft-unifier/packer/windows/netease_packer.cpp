@@ -4,6 +4,10 @@
  */
 
 #include "netease_packer.h"
+#include "resources/texture_atlas.h"
+#include "resources/resource_manager.h"
+#include "resources/lang_converter.h"
+#include "thread_pool.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -353,6 +357,7 @@ bool NeteaseModConverter::CreateCmcPackage(const std::string& outputDir, const s
 JavaModConverter::JavaModConverter()
     : outputDir_("./output")
     , apiConfigPath_("./api_mappings.json")
+    , textureAtlasEnabled_(true)
 {
 }
 
@@ -371,6 +376,10 @@ void JavaModConverter::SetProgressCallback(ProgressCallback callback) {
     progressCallback_ = callback;
 }
 
+void JavaModConverter::SetTextureAtlasEnabled(bool enable) {
+    textureAtlasEnabled_ = enable;
+}
+
 bool JavaModConverter::Convert(const std::string& inputJarPath, const std::string& outputCmcPath) {
     if (progressCallback_) {
         progressCallback_(0, "开始转换Java模组...");
@@ -1287,14 +1296,9 @@ bool JavaModConverter::ConvertTextures(const std::string& assetsDir) {
                         texturePath = std::regex_replace(texturePath, 
                             std::regex("/entity/"), "/entity/");
                         
-                        // 创建新路径
-                        std::string targetDir = entry.path().parent_path().string();
-                        targetDir = std::regex_replace(targetDir, 
-                            std::regex("/assets/[^/]+/"), "/textures/");
-                        
-                        fs::create_directories(targetDir);
-                        std::string targetPath = targetDir + "/" + 
-                                                entry.path().filename().string();
+                        // 创建新路径（与assets同级的textures目录）
+                        std::string targetPath = newPath.substr(0, assetsPos) + "/" + texturePath;
+                        fs::create_directories(fs::path(targetPath).parent_path());
                         
                         // 移动文件
                         if (filePath != targetPath) {
@@ -1306,6 +1310,70 @@ bool JavaModConverter::ConvertTextures(const std::string& assetsDir) {
         }
     }
     
+    // 将小纹理打包为图集，游戏加载时只需读取少量大文件
+    if (textureAtlasEnabled_) {
+        std::string texturesDir = fs::path(assetsDir).parent_path().string() + "/textures";
+        if (fs::exists(texturesDir) && !BuildTextureAtlases(texturesDir)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool JavaModConverter::BuildTextureAtlases(const std::string& texturesDir) {
+    std::string atlasDir = texturesDir + "/atlas";
+    
+    // 类别 -> 基岩版纹理定义文件与其texture_name
+    const struct {
+        const char* category;
+        const char* definitionFile;
+        const char* textureName;
+    } kCategories[] = {
+        {"blocks", "terrain_texture.json", "atlas.terrain"},
+        {"items", "item_texture.json", "atlas.items"},
+    };
+    
+    for (const auto& category : kCategories) {
+        std::string categoryDir = texturesDir + "/" + category.category;
+        if (!fs::exists(categoryDir)) {
+            continue;
+        }
+        
+        core::resources::TextureAtlasBuilder builder;
+        if (builder.AddDirectory(categoryDir, category.category) == 0) {
+            continue;
+        }
+        
+        // 输出目录中已有图集时只重写变化的页
+        if (!builder.Build(atlasDir, category.category)) {
+            if (progressCallback_) {
+                progressCallback_(10, std::string("构建纹理图集失败: ") + category.category);
+            }
+            return false;
+        }
+        
+        // 纹理定义改为引用图集页与UV后，已入图集的散文件不再被读取
+        if (!core::resources::WriteTextureDefinitions(texturesDir + "/" + category.definitionFile,
+                                                      category.textureName, "textures/atlas",
+                                                      builder.GetPages(), builder.GetRegions())) {
+            if (progressCallback_) {
+                progressCallback_(10, std::string("写入纹理定义失败: ") + category.definitionFile);
+            }
+            return false;
+        }
+        for (const auto& source : builder.GetPackedSources()) {
+            fs::remove(source);
+        }
+        
+        if (progressCallback_) {
+            const auto& stats = builder.GetStats();
+            progressCallback_(10, std::string("纹理图集 ") + category.category + ": " +
+                             std::to_string(stats.packed) + " 个纹理, " +
+                             std::to_string(stats.pages) + " 页");
+        }
+    }
+    
     return true;
 }
 
@@ -1371,80 +1439,79 @@ bool JavaModConverter::ConvertModels(const std::string& assetsDir) {
 }
 
 bool JavaModConverter::ConvertLanguages(const std::string& assetsDir) {
-    // 遍历所有语言文件
+    // 收集lang目录下的JSON语言文件
+    std::vector<fs::path> langFiles;
     for (const auto& entry : fs::recursive_directory_iterator(assetsDir)) {
-        if (entry.path().extension() == ".json") {
-            std::string filePath = entry.path().string();
-            
-            // 检查是否在lang目录下
-            if (filePath.find("/lang/") != std::string::npos) {
-                // 读取JSON文件
-                std::ifstream file(filePath);
-                if (!file.is_open()) {
-                    continue;
-                }
-                
-                try {
-                    json lang = json::parse(file);
-                    file.close();
-                    
-                    // 语言文件格式基本兼容，但需要调整键名
-                    // Java版: block.minecraft.stone = Stone
-                    // 基岩版: tile.stone.name = Stone
-                    
-                    json convertedLang;
-                    for (auto& [key, value] : lang.items()) {
-                        if (value.is_string()) {
-                            std::string newKey = key;
-                            
-                            // 转换键名
-                            newKey = std::regex_replace(newKey, 
-                                std::regex("block\\.minecraft\\."), "tile.");
-                            newKey = std::regex_replace(newKey, 
-                                std::regex("item\\.minecraft\\."), "item.");
-                            newKey = std::regex_replace(newKey, 
-                                std::regex("entity\\.minecraft\\."), "entity.");
-                            
-                            convertedLang[newKey] = value;
-                        }
-                    }
-                    
-                    // 写回文件
-                    std::ofstream outFile(filePath);
-                    outFile << convertedLang.dump(4);
-                    outFile.close();
-                    
-                } catch (const json::exception& e) {
-                    // JSON解析失败，跳过
-                    continue;
-                }
-            }
+        if (entry.path().extension() == ".json" &&
+            entry.path().string().find("/lang/") != std::string::npos) {
+            langFiles.push_back(entry.path());
         }
     }
     
+    // 流式转换为基岩版.lang（en_us.json → en_US.lang），各文件互不依赖，并行处理
+    // Java版: block.minecraft.stone = Stone
+    // 基岩版: tile.stone = Stone
+    common::ThreadPool::GetDefault().ParallelFor(0, langFiles.size(), [&](size_t i) {
+        const fs::path& jsonPath = langFiles[i];
+        fs::path langPath = jsonPath.parent_path() /
+            (core::resources::BedrockLangName(jsonPath.stem().string()) + ".lang");
+        if (core::resources::ConvertJsonLangFile(jsonPath.string(), langPath.string())) {
+            fs::remove(jsonPath);
+        }
+        // JSON解析失败时保留原文件
+    });
+    
     return true;
 }
 
 bool JavaModConverter::ConvertSounds(const std::string& assetsDir) {
-    // 遍历所有声音文件
+    // 收集sounds目录下需要转码的声音文件
+    std::vector<core::resources::AudioJob> jobs;
+    std::vector<std::string> unsupported;
     for (const auto& entry : fs::recursive_directory_iterator(assetsDir)) {
         std::string ext = entry.path().extension().string();
+        std::string filePath = entry.path().string();
         
-        // 支持的声音格式
-        if (ext == ".ogg" || ext == ".mp3" || ext == ".wav") {
-            std::string filePath = entry.path().string();
-            
-            // 检查是否在sounds目录下
-            if (filePath.find("/sounds/") != std::string::npos) {
-                // 声音文件格式基本兼容，但可能需要转换
-                // 基岩版主要使用.ogg格式
-                
-                if (ext == ".mp3" || ext == ".wav") {
-                    // TODO: 转换为.ogg格式
-                    // 这里需要使用音频转换库如libavcodec
-                }
+        // 检查是否在sounds目录下
+        if (filePath.find("/sounds/") == std::string::npos) {
+            continue;
+        }
+        
+        // 基岩版主要使用.ogg格式，.ogg直接保留；没有.mp3解码器，.mp3原样保留并报告
+        if (ext == ".wav") {
+            jobs.push_back({filePath, filePath});
+        } else if (ext == ".mp3") {
+            unsupported.push_back(filePath);
+        }
+    }
+    
+    if (!unsupported.empty() && progressCallback_) {
+        std::string message = "警告: " + std::to_string(unsupported.size()) + " 个.mp3声音文件未转码，保持原样:";
+        for (const auto& path : unsupported) {
+            message += "\n  " + path;
+        }
+        progressCallback_(72, message);
+    }
+    
+    if (!jobs.empty()) {
+        if (progressCallback_) {
+            progressCallback_(75, "转码声音文件: " + std::to_string(jobs.size()) + " 个");
+        }
+        
+        // 在线程池上并行转码，sounds.json按名称引用声音，无需随扩展名更新
+        core::resources::AudioConverter converter;
+        auto stats = converter.ConvertBatch(jobs);
+        
+        // 只删除本次成功转码为其他格式的原始文件，同名输出预先存在时不算
+        for (size_t i = 0; i < jobs.size(); i++) {
+            const std::string& output = stats.outputs[i];
+            if (!output.empty() && fs::path(output).extension() != fs::path(jobs[i].inputPath).extension()) {
+                fs::remove(jobs[i].inputPath);
             }
         }
+        if (stats.failed > 0 && progressCallback_) {
+            progressCallback_(75, "警告: " + std::to_string(stats.failed) + " 个声音文件转码失败，保持原样");
+        }
     }
     
     // 转换sounds.json配置文件
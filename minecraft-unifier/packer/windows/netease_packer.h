@@ -79,12 +79,17 @@ public:
     // 进度回调
     using ProgressCallback = std::function<void(int percent, const std::string& message)>;
     void SetProgressCallback(ProgressCallback callback);
+    
+    // 启用纹理图集（默认开启）：小纹理打包为图集页，terrain_texture.json与item_texture.json
+    // 改为引用图集页与UV，已入图集的散纹理被删除
+    void SetTextureAtlasEnabled(bool enable);
 
 private:
     std::string outputDir_;
     std::string apiConfigPath_;
     ProgressCallback progressCallback_;
     JavaModInfo modInfo_;  // 存储解析到的模组信息
+    bool textureAtlasEnabled_;
     
     // 内部处理函数
     bool ExtractJar(const std::string& jarPath, const std::string& extractDir);
@@ -109,6 +114,7 @@ private:
     
     // 资源转换辅助函数
     bool ConvertTextures(const std::string& assetsDir);
+    bool BuildTextureAtlases(const std::string& texturesDir);
     bool ConvertModels(const std::string& assetsDir);
     bool ConvertLanguages(const std::string& assetsDir);
     bool ConvertSounds(const std::string& assetsDir);
@@ -0,0 +1,91 @@
+/**
+ * Minecraft Unifier - Test JAR Helper
+ * 测试辅助 - 生成测试用的JAR（ZIP归档）
+ */
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <zlib.h>
+
+namespace mcu {
+namespace test {
+
+// 创建测试用的JAR（ZIP归档），compress为true时条目使用deflate压缩
+inline std::string CreateTestJar(const std::string& jar_path, const std::map<std::string, std::string>& entries,
+                                 bool compress = true) {
+    auto put16 = [](std::string& out, uint16_t value) { out.append(reinterpret_cast<const char*>(&value), 2); };
+    auto put32 = [](std::string& out, uint32_t value) { out.append(reinterpret_cast<const char*>(&value), 4); };
+
+    std::string data;
+    std::string directory;
+    for (const auto& [name, content] : entries) {
+        std::string payload = content;
+        uint16_t method = 0;
+        if (compress) {
+            z_stream stream = {};
+            deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            payload.resize(deflateBound(&stream, content.size()));
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+            stream.avail_in = static_cast<uInt>(content.size());
+            stream.next_out = reinterpret_cast<Bytef*>(&payload[0]);
+            stream.avail_out = static_cast<uInt>(payload.size());
+            deflate(&stream, Z_FINISH);
+            payload.resize(stream.total_out);
+            deflateEnd(&stream);
+            method = 8;
+        }
+        uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(content.data()), static_cast<uInt>(content.size()));
+        uint32_t offset = static_cast<uint32_t>(data.size());
+
+        // 本地文件头
+        put32(data, 0x04034B50);
+        put16(data, 20);
+        put16(data, 0);
+        put16(data, method);
+        put32(data, 0);
+        put32(data, crc);
+        put32(data, static_cast<uint32_t>(payload.size()));
+        put32(data, static_cast<uint32_t>(content.size()));
+        put16(data, static_cast<uint16_t>(name.size()));
+        put16(data, 0);
+        data += name + payload;
+
+        // 中央目录记录
+        put32(directory, 0x02014B50);
+        put16(directory, 20);
+        put16(directory, 20);
+        put16(directory, 0);
+        put16(directory, method);
+        put32(directory, 0);
+        put32(directory, crc);
+        put32(directory, static_cast<uint32_t>(payload.size()));
+        put32(directory, static_cast<uint32_t>(content.size()));
+        put16(directory, static_cast<uint16_t>(name.size()));
+        put32(directory, 0);
+        put32(directory, 0);
+        put32(directory, 0);
+        put32(directory, offset);
+        directory += name;
+    }
+
+    // 中央目录结束记录
+    uint32_t directory_offset = static_cast<uint32_t>(data.size());
+    data += directory;
+    put32(data, 0x06054B50);
+    put32(data, 0);
+    put16(data, static_cast<uint16_t>(entries.size()));
+    put16(data, static_cast<uint16_t>(entries.size()));
+    put32(data, static_cast<uint32_t>(directory.size()));
+    put32(data, directory_offset);
+    put16(data, 0);
+
+    std::ofstream jar(jar_path, std::ios::binary | std::ios::trunc);
+    jar.write(data.data(), data.size());
+    return jar_path;
+}
+
+} // namespace test
+} // namespace mcu
@@ -5,18 +5,46 @@
 
 #include <gtest/gtest.h>
 #include <core/render/shader_converter.h>
+#include <core/render/glsl_rewriter.h>
+#include <core/render/glsl_preprocessor.h>
+#include <core/render/spirv_compiler.h>
+#include <core/render/shader_cache.h>
+#include <core/render/shader_compile_queue.h>
+#include <core/render/shader_source_cache.h>
 #include <core/mods/java_runtime.h>
+#include <core/mods/jar_scanner.h>
+#include <core/mods/mod_dependency_graph.h>
+#include <core/mods/mod_profiler.h>
+#include <core/mods/jvm_profile.h>
+#include <core/mods/event_batch.h>
 #include <core/mods/netease_runtime.h>
 #include <core/resources/resource_manager.h>
+#include <core/resources/texture_atlas.h>
+#include <core/resources/image_codec.h>
+#include <core/resources/texture_compressor.h>
+#include <core/resources/model_converter.h>
+#include <core/resources/audio_converter.h>
+#include <core/resources/lang_converter.h>
 #include <common/cmc_format.h>
+#include <common/json_reader.h>
+#include <common/thread_pool.h>
+#include <tests/common/test_jar.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <sstream>
+#include <thread>
 
 namespace mcu {
 namespace core {
 namespace test {
 
+using mcu::test::CreateTestJar;
+
 class CoreTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -203,6 +231,236 @@ TEST_F(CoreTest, ConvertGLSLShader) {
     EXPECT_TRUE(rd_content.find("out ") != std::string::npos || rd_content.find("in ") != std::string::npos) << "out/in should be present";
 }
 
+// 测试单遍GLSL改写的边界情况
+TEST_F(CoreTest, GLSLRewrite) {
+    using render::ShaderStage;
+    
+    // 版本声明：保留行尾换行
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("#version 120\n\nvoid main() {}", ShaderStage::VERTEX),
+              "#version 330 core\n\nvoid main() {}");
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("#version 120 compatibility", ShaderStage::VERTEX),
+              "#version 330 core");
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("#version 460 compatibility\n", ShaderStage::GEOMETRY),
+              "#version 330 core\n");
+    
+    // 声明映射要求类型与名称完全一致
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon(
+                  "uniform  mat4\tgbufferModelView;\nuniform mat4 gbufferModelViewX;\nuniform vec3 viewWidth;\n",
+                  ShaderStage::VERTEX),
+              "uniform mat4 u_modelViewMatrix;\nuniform mat4 gbufferModelViewX;\nuniform vec3 viewWidth;\n");
+    
+    // 改名的声明，其后的引用一同改名，同名函数调用保持不变
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon(
+                  "uniform sampler2D texture;\nvec4 c = texture2D(texture, uv) + texture (texture, uv) + mytexture;\n",
+                  ShaderStage::VERTEX),
+              "uniform sampler2D u_texture;\nvec4 c = texture(u_texture, uv) + texture (u_texture, uv) + mytexture;\n");
+    
+    // 结构体字段声明与成员访问不随之改名
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon(
+                  "attribute vec3 position;\nstruct Vertex { vec3 position; };\n"
+                  "vec3 p = v.position + v. position + v\n.position + position;\n",
+                  ShaderStage::VERTEX),
+              "in vec3 a_position;\nstruct Vertex { vec3 position; };\n"
+              "vec3 p = v.position + v. position + v\n.position + a_position;\n");
+    
+    // 顶点属性与varying
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("attribute vec3 position;\nattribute vec4 position;\nvarying  vec2\nuv;\n",
+                                                 ShaderStage::VERTEX),
+              "in vec3 a_position;\nattribute vec4 a_position;\nout vec2 uv;\n");
+    
+    // 片段着色器：varying名称中的gl_FragColor同样被替换，缺少输出声明时前置
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("varying vec4 gl_FragColor;\nvoid main() { gl_FragColor = texture2D (tex, uv); }\n",
+                                                 ShaderStage::FRAGMENT),
+              "out vec4 fragColor;\nin vec4 fragColor;\nvoid main() { fragColor = texture(tex, uv); }\n");
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("out vec4 gl_FragColor;\n", ShaderStage::FRAGMENT),
+              "out vec4 fragColor;\n");
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("void main() {}", ShaderStage::FRAGMENT),
+              "out vec4 fragColor;\nvoid main() {}");
+    
+    // 补充的声明插在#version及#extension之后
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("#version 120\n#extension GL_EXT_gpu_shader4 : enable\nvoid main() {}",
+                                                 ShaderStage::FRAGMENT),
+              "#version 330 core\n#extension GL_EXT_gpu_shader4 : enable\nout vec4 fragColor;\nvoid main() {}");
+    
+    // 纹理函数与ftransform
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("texture2DLod(a) shadow2DLod (b) shadow2D(c) texture2DX(d)",
+                                                 ShaderStage::COMPUTE),
+              "textureLod(a) textureLod(b) texture(c) texture2DX(d)");
+    // ftransform()改用映射后的矩阵与位置属性，缺少的声明随之补充
+    EXPECT_EQ(render::RewriteGLSLForRenderDragon("#version 120\nuniform mat4 gbufferProjection;\ngl_Position = ftransform();",
+                                                 ShaderStage::VERTEX),
+              "#version 330 core\nuniform mat4 u_modelViewMatrix;\nin vec3 a_position;\n"
+              "uniform mat4 u_projectionMatrix;\n"
+              "gl_Position = (u_projectionMatrix * u_modelViewMatrix * vec4(a_position, 1.0));");
+    
+    // 阶段推断
+    EXPECT_EQ(render::ShaderStageFromPath("shaders/gbuffers_terrain.fsh"), ShaderStage::FRAGMENT);
+    EXPECT_EQ(render::ShaderStageFromPath("shaders/gbuffers_terrain.vsh"), ShaderStage::VERTEX);
+    EXPECT_EQ(render::ShaderStageFromPath("shaders/shadow.gsh"), ShaderStage::GEOMETRY);
+}
+
+// 测试GLSL预处理器
+TEST_F(CoreTest, GLSLPreprocessor) {
+    std::string shaders_dir = temp_dir_ + "/preprocess_pack/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    
+    std::ofstream(shaders_dir + "/lib/settings.glsl")
+        << "#define SHADOW_QUALITY 2 // [1 2 3]\n"
+        << "//#define BLOOM\n"
+        << "#define WAVING_PLANTS\n";
+    std::ofstream(shaders_dir + "/lib/common.glsl")
+        << "#ifndef COMMON_GLSL\n"
+        << "#define COMMON_GLSL\n"
+        << "#include \"settings.glsl\"\n"
+        << "/* #error inside comment\n"
+        << "#endif */\n"
+        << "float luma(vec3 c) { return dot(c, vec3(0.299, 0.587, 0.114)); }\n"
+        << "#endif\n";
+    std::ofstream(shaders_dir + "/composite.fsh")
+        << "#version 120\n"
+        << "#include \"/lib/common.glsl\"\n"
+        << "#include \"/lib/common.glsl\"\n"
+        << "#if SHADOW_QUALITY > 1 && \\\n"
+        << "    defined(WAVING_PLANTS)\n"
+        << "const int shadowSamples = 16;\n"
+        << "#elif SHADOW_QUALITY == 1\n"
+        << "const int shadowSamples = 4;\n"
+        << "#else\n"
+        << "const int shadowSamples = 1;\n"
+        << "#endif\n"
+        << "#ifdef BLOOM\n"
+        << "vec3 bloom();\n"
+        << "#endif\n";
+    
+    std::string output;
+    std::string error;
+    render::GLSLPreprocessor preprocessor(shaders_dir);
+    ASSERT_TRUE(preprocessor.Process(shaders_dir + "/composite.fsh", output, &error)) << error;
+    EXPECT_EQ(output,
+              "#version 120\n"
+              "#define COMMON_GLSL\n"
+              "#define SHADOW_QUALITY 2 // [1 2 3]\n"
+              "//#define BLOOM\n"
+              "#define WAVING_PLANTS\n"
+              "/* #error inside comment\n"
+              "#endif */\n"
+              "float luma(vec3 c) { return dot(c, vec3(0.299, 0.587, 0.114)); }\n"
+              "const int shadowSamples = 16;\n");
+    
+    // 选项覆盖：数值选项替换默认值，开关选项可打开或关闭
+    render::GLSLPreprocessor configured(shaders_dir);
+    configured.SetOption("SHADOW_QUALITY", "1");
+    configured.SetOption("BLOOM", "true");
+    configured.SetOption("WAVING_PLANTS", "false");
+    ASSERT_TRUE(configured.Process(shaders_dir + "/composite.fsh", output, &error)) << error;
+    EXPECT_NE(output.find("#define SHADOW_QUALITY 1\n"), std::string::npos);
+    EXPECT_NE(output.find("const int shadowSamples = 4;"), std::string::npos);
+    EXPECT_NE(output.find("vec3 bloom();"), std::string::npos);
+    EXPECT_NE(output.find("//#define WAVING_PLANTS"), std::string::npos);
+    
+    // 包含文件在多个程序间只解析一次
+    for (int i = 0; i < 10; i++) {
+        std::string program = shaders_dir + "/gbuffers_" + std::to_string(i) + ".vsh";
+        std::ofstream(program) << "#include \"/lib/common.glsl\"\nvoid main() {}\n";
+        ASSERT_TRUE(preprocessor.Process(program, output, &error)) << error;
+    }
+    EXPECT_EQ(preprocessor.GetParseCount(), 13u);
+    
+    // 多线程共享同一预处理器，同一文件只进入缓存一次；每次调用的错误互不干扰
+    std::ofstream(shaders_dir + "/broken.fsh") << "#error broken program\n";
+    render::GLSLPreprocessor shared(shaders_dir);
+    std::vector<std::thread> workers;
+    std::atomic<int> processed(0);
+    std::atomic<int> reported(0);
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&]() {
+            std::string threadOutput;
+            std::string threadError;
+            for (int i = 0; i < 10; i++) {
+                std::string program = shaders_dir + "/gbuffers_" + std::to_string(i) + ".vsh";
+                if (shared.Process(program, threadOutput)) {
+                    processed++;
+                }
+                if (!shared.Process(shaders_dir + "/broken.fsh", threadOutput, &threadError) &&
+                    threadError == shaders_dir + "/broken.fsh:1: #error broken program") {
+                    reported++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(processed.load(), 40);
+    EXPECT_EQ(reported.load(), 40);
+    EXPECT_EQ(shared.GetParseCount(), 13u);
+    
+    // 错误：缺失的包含文件、循环包含、未闭合的条件
+    std::ofstream(shaders_dir + "/missing.fsh") << "#include \"/lib/none.glsl\"\n";
+    EXPECT_FALSE(preprocessor.Process(shaders_dir + "/missing.fsh", output));
+    std::ofstream(shaders_dir + "/lib/loop.glsl") << "#include \"loop.glsl\"\n";
+    EXPECT_FALSE(preprocessor.Process(shaders_dir + "/lib/loop.glsl", output, &error));
+    EXPECT_NE(error.find("循环包含"), std::string::npos);
+    std::ofstream(shaders_dir + "/open.fsh") << "#ifdef BLOOM\nvoid f();\n";
+    EXPECT_FALSE(preprocessor.Process(shaders_dir + "/open.fsh", output));
+}
+
+// 测试光影包并行转换的确定性
+TEST_F(CoreTest, ParallelShaderpackParsing) {
+    std::string pack_dir = temp_dir_ + "/parallel_pack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    
+    std::ofstream(shaders_dir + "/lib/uniforms.glsl")
+        << "uniform sampler2D texture;\n"
+        << "uniform float frameTimeCounter;\n";
+    std::ofstream(shaders_dir + "/shaders.properties") << "sunPathRotation=-40.0\n";
+    const int material_count = 24;
+    for (int i = 0; i < material_count; i++) {
+        std::string name = shaders_dir + "/gbuffers_" + std::to_string(i);
+        std::ofstream(name + ".vsh")
+            << "#include \"/lib/uniforms.glsl\"\n"
+            << "attribute vec2 texcoord;\n"
+            << "varying vec2 uv" << i << ";\n"
+            << "void main() { uv" << i << " = texcoord; }\n";
+        std::ofstream(name + ".fsh")
+            << "#include \"/lib/uniforms.glsl\"\n"
+            << "varying vec2 uv" << i << ";\n"
+            << "void main() { gl_FragColor = texture2D(texture, uv" << i << "); }\n";
+    }
+    std::ofstream(shaders_dir + "/broken.fsh") << "#include \"/lib/missing.glsl\"\n";
+    
+    common::ThreadPool single_pool(1);
+    render::ShaderConverter serial;
+    serial.SetThreadPool(&single_pool);
+    render::ShaderConverter parallel;
+    ASSERT_TRUE(serial.ParseShaderpack(pack_dir));
+    ASSERT_TRUE(parallel.ParseShaderpack(pack_dir));
+    
+    // 无法预处理的程序被跳过
+    EXPECT_EQ(parallel.GetMaterialInfo("broken"), nullptr);
+    ASSERT_EQ(parallel.GetMaterialList().size(), static_cast<size_t>(material_count));
+    
+    for (int i = 0; i < material_count; i++) {
+        std::string name = "gbuffers_" + std::to_string(i);
+        const render::MaterialInfo* expected = serial.GetMaterialInfo(name);
+        const render::MaterialInfo* actual = parallel.GetMaterialInfo(name);
+        ASSERT_NE(expected, nullptr);
+        ASSERT_NE(actual, nullptr);
+        
+        // 阶段顺序由文件名决定（.fsh在.vsh之前），与线程调度无关
+        ASSERT_EQ(actual->shaders.size(), 2u);
+        EXPECT_EQ(actual->shaders[0].stage, render::ShaderStage::FRAGMENT);
+        EXPECT_EQ(actual->shaders[1].stage, render::ShaderStage::VERTEX);
+        for (size_t s = 0; s < actual->shaders.size(); s++) {
+            EXPECT_EQ(actual->shaders[s].source, expected->shaders[s].source);
+            EXPECT_EQ(actual->shaders[s].uniforms, expected->shaders[s].uniforms);
+        }
+        EXPECT_NE(actual->shaders[0].source.find("uniform sampler2D u_texture;"), std::string::npos);
+        EXPECT_EQ(actual->properties.at("sunPathRotation"), "-40.0");
+    }
+}
+
 // 测试SPIR-V编译
 TEST_F(CoreTest, CompileSPIRV) {
     // 创建测试GLSL着色器
@@ -221,6 +479,131 @@ TEST_F(CoreTest, CompileSPIRV) {
     // ASSERT_TRUE(std::filesystem::exists(spirv_path)) << "SPIR-V file not created";
 }
 
+// 测试SPIR-V反射
+TEST_F(CoreTest, SPIRVReflection) {
+    // 手工组装SPIR-V模块
+    std::vector<uint32_t> module = {0x07230203, 0x00010000, 0, 20, 0};
+    auto emit = [&module](uint32_t opcode, std::vector<uint32_t> operands) {
+        module.push_back(static_cast<uint32_t>((operands.size() + 1) << 16) | opcode);
+        module.insert(module.end(), operands.begin(), operands.end());
+    };
+    auto literal = [](const std::string& text) {
+        std::vector<uint32_t> words((text.size() + 4) / 4, 0);
+        for (size_t i = 0; i < text.size(); i++) {
+            words[i / 4] |= static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << (8 * (i % 4));
+        }
+        return words;
+    };
+    auto name = [&](uint32_t id, const std::string& text) {
+        std::vector<uint32_t> operands = {id};
+        for (uint32_t word : literal(text)) operands.push_back(word);
+        emit(5, operands);
+    };
+    
+    name(10, "uTime");
+    name(11, "position");
+    name(12, "gl_VertexID");
+    name(13, "tex");
+    name(14, "Matrices");
+    std::vector<uint32_t> memberName = {14, 0};
+    for (uint32_t word : literal("mvp")) memberName.push_back(word);
+    emit(6, memberName);
+    
+    emit(71, {10, 30, 1});   // uTime: Location 1
+    emit(71, {11, 30, 2});   // position: Location 2
+    emit(71, {12, 11, 42});  // gl_VertexID: BuiltIn
+    emit(71, {14, 2});       // Matrices: Block
+    
+    emit(22, {1, 32});       // float
+    emit(23, {2, 1, 4});     // vec4
+    emit(30, {14, 2});       // struct Matrices { vec4 mvp; }
+    emit(32, {3, 0, 1});     // UniformConstant float*
+    emit(32, {4, 1, 2});     // Input vec4*
+    emit(32, {7, 2, 14});    // Uniform Matrices*
+    emit(59, {3, 10, 0});
+    emit(59, {3, 13, 0});
+    emit(59, {4, 11, 1});
+    emit(59, {4, 12, 1});
+    emit(59, {7, 16, 2});
+    
+    std::unordered_map<std::string, int> uniforms;
+    std::unordered_map<std::string, int> attributes;
+    ASSERT_TRUE(render::ReflectSPIRV(module, render::ShaderStage::VERTEX, &uniforms, &attributes));
+    
+    // 有Location装饰的使用装饰值，否则按顺序分配并跳过已被占用的编号
+    ASSERT_EQ(uniforms.size(), 3u);
+    EXPECT_EQ(uniforms.at("uTime"), 1);
+    EXPECT_EQ(uniforms.at("tex"), 0);
+    EXPECT_EQ(uniforms.at("Matrices.mvp"), 2);
+    
+    // 内置变量不计入顶点属性
+    ASSERT_EQ(attributes.size(), 1u);
+    EXPECT_EQ(attributes.at("position"), 2);
+    
+    // 片段着色器的输入不是顶点属性
+    attributes.clear();
+    ASSERT_TRUE(render::ReflectSPIRV(module, render::ShaderStage::FRAGMENT, nullptr, &attributes));
+    EXPECT_TRUE(attributes.empty());
+    
+    // 截断的模块
+    module.resize(module.size() - 2);
+    EXPECT_FALSE(render::ReflectSPIRV(module, render::ShaderStage::VERTEX, &uniforms, nullptr));
+    EXPECT_FALSE(render::ReflectSPIRV({1, 2, 3}, render::ShaderStage::VERTEX, &uniforms, nullptr));
+    
+    // 链接了glslang时编译真实着色器
+    if (render::IsSPIRVCompilerAvailable()) {
+        std::string source =
+            "#version 330 core\n"
+            "in vec3 vertexPos;\n"
+            "uniform mat4 modelViewMatrix;\n"
+            "void main() { gl_Position = modelViewMatrix * vec4(vertexPos, 1.0); }\n";
+        std::vector<uint32_t> spirv;
+        std::string log;
+        ASSERT_TRUE(render::CompileSPIRV(source, render::ShaderStage::VERTEX, spirv, log)) << log;
+        ASSERT_FALSE(spirv.empty());
+        EXPECT_EQ(spirv[0], 0x07230203u);
+        
+        uniforms.clear();
+        attributes.clear();
+        ASSERT_TRUE(render::ReflectSPIRV(spirv, render::ShaderStage::VERTEX, &uniforms, &attributes));
+        EXPECT_TRUE(uniforms.count("modelViewMatrix"));
+        EXPECT_TRUE(attributes.count("vertexPos"));
+        EXPECT_FALSE(attributes.count("gl_VertexID"));
+        
+        // 改写后的Java版光影着色器可直接编译
+        std::string vertex = render::RewriteGLSLForRenderDragon(
+            "#version 120\n"
+            "attribute vec2 texcoord;\n"
+            "varying vec2 uv;\n"
+            "void main() {\n"
+            "    uv = texcoord;\n"
+            "    gl_Position = ftransform();\n"
+            "}\n", render::ShaderStage::VERTEX);
+        ASSERT_TRUE(render::CompileSPIRV(vertex, render::ShaderStage::VERTEX, spirv, log)) << log << "\n" << vertex;
+        uniforms.clear();
+        attributes.clear();
+        ASSERT_TRUE(render::ReflectSPIRV(spirv, render::ShaderStage::VERTEX, &uniforms, &attributes));
+        EXPECT_TRUE(uniforms.count("u_projectionMatrix"));
+        EXPECT_TRUE(attributes.count("a_position"));
+        EXPECT_TRUE(attributes.count("a_texCoord"));
+        
+        std::string fragment = render::RewriteGLSLForRenderDragon(
+            "#version 120\n"
+            "uniform sampler2D texture;\n"
+            "varying vec2 uv;\n"
+            "void main() {\n"
+            "    gl_FragColor = texture2D(texture, uv);\n"
+            "}\n", render::ShaderStage::FRAGMENT);
+        ASSERT_TRUE(render::CompileSPIRV(fragment, render::ShaderStage::FRAGMENT, spirv, log)) << log << "\n" << fragment;
+        
+        // 编译失败时返回错误信息且不输出SPIR-V
+        EXPECT_FALSE(render::CompileSPIRV("#version 330 core\nvoid main() { undefined(); }\n",
+                                          render::ShaderStage::VERTEX, spirv, log));
+        EXPECT_TRUE(spirv.empty());
+        EXPECT_FALSE(log.empty());
+    }
+}
+
 // 测试着色器缓存
 TEST_F(CoreTest, ShaderCache) {
     // 创建测试GLSL着色器
@@ -240,6 +623,498 @@ TEST_F(CoreTest, ShaderCache) {
     ASSERT_TRUE(result2) << "Failed to convert GLSL shader (second time)";
 }
 
+// 测试着色器缓存持久化
+TEST_F(CoreTest, ShaderCachePersistence) {
+    render::ShaderInfo vertex;
+    vertex.stage = render::ShaderStage::VERTEX;
+    vertex.entryPoint = "main";
+    vertex.source = "#version 330 core\nin vec3 a_position;\nvoid main() {}\n";
+    vertex.spirv = {0x07230203, 0x00010000, 0, 8, 0};
+    vertex.uniforms = {{"u_modelViewMatrix", 0}, {"u_time", 1}};
+    vertex.attributes = {{"a_position", 0}};
+    render::ShaderInfo fragment = vertex;
+    fragment.stage = render::ShaderStage::FRAGMENT;
+    fragment.spirv.clear();
+    fragment.attributes.clear();
+    
+    // 键由源码、阶段与选项共同决定
+    uint64_t vertex_key = render::ComputeShaderCacheKey(vertex.source, render::ShaderStage::VERTEX);
+    uint64_t fragment_key = render::ComputeShaderCacheKey(vertex.source, render::ShaderStage::FRAGMENT);
+    EXPECT_NE(vertex_key, fragment_key);
+    EXPECT_NE(vertex_key, render::ComputeShaderCacheKey(vertex.source, render::ShaderStage::VERTEX, "spirv"));
+    EXPECT_EQ(vertex_key, render::ComputeShaderCacheKey(vertex.source, render::ShaderStage::VERTEX));
+    
+    std::string cache_path = output_dir_ + "/shaders.cache";
+    {
+        render::ShaderCache cache;
+        cache.SetCached(vertex_key, vertex);
+        cache.SetCached(fragment_key, fragment);
+        ASSERT_TRUE(cache.SaveToDisk(cache_path));
+    }
+    
+    // 加载后按需解码
+    render::ShaderCache loaded;
+    ASSERT_TRUE(loaded.LoadFromDisk(cache_path));
+    EXPECT_EQ(loaded.GetEntryCount(), 2u);
+    EXPECT_TRUE(loaded.HasCached(fragment_key));
+    EXPECT_FALSE(loaded.HasCached(vertex_key + 1));
+    render::ShaderInfo restored;
+    ASSERT_TRUE(loaded.GetCached(vertex_key, restored));
+    EXPECT_EQ(restored.stage, vertex.stage);
+    EXPECT_EQ(restored.source, vertex.source);
+    EXPECT_EQ(restored.spirv, vertex.spirv);
+    EXPECT_EQ(restored.uniforms, vertex.uniforms);
+    EXPECT_EQ(restored.attributes, vertex.attributes);
+    
+    // 重新保存到同一路径（文件仍处于映射状态）后条目不丢失
+    loaded.SetCached(vertex_key + 1, fragment);
+    ASSERT_TRUE(loaded.SaveToDisk(cache_path));
+    EXPECT_EQ(loaded.GetEntryCount(), 3u);
+    ASSERT_TRUE(loaded.GetCached(fragment_key, restored));
+    EXPECT_EQ(restored.stage, render::ShaderStage::FRAGMENT);
+    loaded.Clear();
+    
+    std::ifstream input(cache_path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    auto write_bytes = [&cache_path](const std::string& content) {
+        std::ofstream(cache_path, std::ios::binary | std::ios::trunc) << content;
+    };
+    
+    // 条目内容损坏只影响该条目
+    std::string corrupted = bytes;
+    size_t source_pos = corrupted.find("void main");
+    ASSERT_NE(source_pos, std::string::npos);
+    corrupted[source_pos] = 'V';
+    write_bytes(corrupted);
+    render::ShaderCache partial;
+    ASSERT_TRUE(partial.LoadFromDisk(cache_path));
+    int hits = 0;
+    for (uint64_t key : {vertex_key, fragment_key, vertex_key + 1}) {
+        hits += partial.GetCached(key, restored) ? 1 : 0;
+    }
+    EXPECT_EQ(hits, 2);
+    partial.Clear();
+    
+    // 头部损坏或文件截断时拒绝加载
+    corrupted = bytes;
+    corrupted[20] ^= 0x01;
+    write_bytes(corrupted);
+    render::ShaderCache bad_header;
+    EXPECT_FALSE(bad_header.LoadFromDisk(cache_path));
+    write_bytes(bytes.substr(0, bytes.size() - 1));
+    EXPECT_FALSE(bad_header.LoadFromDisk(cache_path));
+    write_bytes("");
+    EXPECT_FALSE(bad_header.LoadFromDisk(cache_path));
+    EXPECT_FALSE(bad_header.LoadFromDisk(output_dir_ + "/missing.cache"));
+    
+    // 热加载光影包：命中的程序直接取自缓存
+    std::string pack_dir = temp_dir_ + "/cached_pack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir);
+    std::ofstream(shaders_dir + "/gbuffers_basic.vsh")
+        << "attribute vec3 position;\nvoid main() { gl_Position = ftransform(); }\n";
+    std::ofstream(shaders_dir + "/gbuffers_basic.fsh")
+        << "void main() { gl_FragColor = vec4(1.0); }\n";
+    
+    render::ShaderCache pack_cache;
+    render::ShaderConverter cold;
+    cold.SetShaderCache(&pack_cache);
+    ASSERT_TRUE(cold.ParseShaderpack(pack_dir));
+    EXPECT_EQ(pack_cache.GetEntryCount(), 2u);
+    ASSERT_TRUE(pack_cache.SaveToDisk(cache_path));
+    
+    render::ShaderCache warm_cache;
+    ASSERT_TRUE(warm_cache.LoadFromDisk(cache_path));
+    std::string preprocessed;
+    render::GLSLPreprocessor preprocessor(shaders_dir);
+    ASSERT_TRUE(preprocessor.Process(shaders_dir + "/gbuffers_basic.fsh", preprocessed));
+    std::string options = render::IsSPIRVCompilerAvailable() ? "spirv" : "glsl";
+    uint64_t program_key = render::ComputeShaderCacheKey(preprocessed, render::ShaderStage::FRAGMENT, options);
+    ASSERT_TRUE(warm_cache.HasCached(program_key));
+    render::ShaderInfo marker;
+    ASSERT_TRUE(warm_cache.GetCached(program_key, marker));
+    marker.source = "// from cache\n";
+    warm_cache.SetCached(program_key, marker);
+    
+    render::ShaderConverter warm;
+    warm.SetShaderCache(&warm_cache);
+    ASSERT_TRUE(warm.ParseShaderpack(pack_dir));
+    const render::MaterialInfo* cold_material = cold.GetMaterialInfo("gbuffers_basic");
+    const render::MaterialInfo* warm_material = warm.GetMaterialInfo("gbuffers_basic");
+    ASSERT_NE(cold_material, nullptr);
+    ASSERT_NE(warm_material, nullptr);
+    ASSERT_EQ(warm_material->shaders.size(), 2u);
+    EXPECT_EQ(warm_material->shaders[0].source, "// from cache\n");
+    EXPECT_EQ(warm_material->shaders[1].source, cold_material->shaders[1].source);
+    EXPECT_EQ(warm_material->shaders[1].attributes, cold_material->shaders[1].attributes);
+    warm_cache.Clear();
+}
+
+// 测试着色器缓存淘汰、追加日志与压缩
+TEST_F(CoreTest, ShaderCacheEviction) {
+    auto make_shader = [](int i) {
+        render::ShaderInfo shader;
+        shader.stage = render::ShaderStage::FRAGMENT;
+        shader.entryPoint = "main";
+        shader.source = "// program " + std::to_string(i) + "\n" + std::string(10000, 'x');
+        return shader;
+    };
+    auto key_of = [](int i) { return static_cast<uint64_t>(1000 + i); };
+    
+    // 内存预算约容纳3个条目，尚未保存的条目不淘汰
+    render::ShaderCache memory_cache;
+    memory_cache.SetMemoryBudget(35000);
+    for (int i = 0; i < 3; i++) {
+        memory_cache.SetCached(key_of(i), make_shader(i));
+    }
+    render::ShaderInfo shader;
+    ASSERT_TRUE(memory_cache.GetCached(key_of(0), shader));
+    memory_cache.SetCached(key_of(3), make_shader(3));
+    render::ShaderCacheStats stats = memory_cache.GetStats();
+    EXPECT_EQ(stats.evictions, 0u);
+    EXPECT_GT(stats.memoryBytes, 35000u);
+    
+    // 保存后按LRU淘汰，被淘汰的条目仍可从磁盘读取
+    ASSERT_TRUE(memory_cache.SaveToDisk(output_dir_ + "/memory.cache"));
+    stats = memory_cache.GetStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_LE(stats.memoryBytes, 35000u);
+    EXPECT_TRUE(memory_cache.HasCached(key_of(1)));
+    ASSERT_TRUE(memory_cache.GetCached(key_of(1), shader));
+    EXPECT_EQ(shader.source, make_shader(1).source);
+    stats = memory_cache.GetStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_LE(stats.memoryBytes, 35000u);
+    
+    // 增量保存前新条目同样保留
+    memory_cache.SetCached(key_of(4), make_shader(4));
+    memory_cache.SetCached(key_of(5), make_shader(5));
+    ASSERT_TRUE(memory_cache.SaveToDisk(output_dir_ + "/memory.cache"));
+    EXPECT_LE(memory_cache.GetStats().memoryBytes, 35000u);
+    memory_cache.Clear();
+    ASSERT_TRUE(memory_cache.LoadFromDisk(output_dir_ + "/memory.cache"));
+    EXPECT_EQ(memory_cache.GetEntryCount(), 6u);
+    memory_cache.Clear();
+    
+    // 增量保存只追加日志，主文件不变
+    std::string cache_path = output_dir_ + "/eviction.cache";
+    std::string journal_path = cache_path + ".journal";
+    render::ShaderCache cache;
+    for (int i = 0; i < 8; i++) {
+        cache.SetCached(key_of(i), make_shader(i));
+    }
+    ASSERT_TRUE(cache.SaveToDisk(cache_path));
+    auto main_size = std::filesystem::file_size(cache_path);
+    EXPECT_FALSE(std::filesystem::exists(journal_path));
+    cache.SetCached(key_of(8), make_shader(8));
+    ASSERT_TRUE(cache.SaveToDisk(cache_path));
+    ASSERT_TRUE(cache.SaveToDisk(cache_path));
+    EXPECT_EQ(std::filesystem::file_size(cache_path), main_size);
+    ASSERT_TRUE(std::filesystem::exists(journal_path));
+    auto journal_size = std::filesystem::file_size(journal_path);
+    EXPECT_LT(journal_size, main_size / 4);
+    EXPECT_EQ(cache.GetStats().journalBytes, journal_size);
+    cache.Clear();
+    
+    // 日志末尾的不完整记录被忽略，下次追加前截掉
+    std::ofstream(journal_path, std::ios::binary | std::ios::app) << "MCUJ-torn";
+    render::ShaderCache reloaded;
+    ASSERT_TRUE(reloaded.LoadFromDisk(cache_path));
+    EXPECT_EQ(reloaded.GetEntryCount(), 9u);
+    ASSERT_TRUE(reloaded.GetCached(key_of(8), shader));
+    EXPECT_EQ(shader.source, make_shader(8).source);
+    reloaded.SetCached(key_of(9), make_shader(9));
+    ASSERT_TRUE(reloaded.SaveToDisk(cache_path));
+    reloaded.Clear();
+    ASSERT_TRUE(reloaded.LoadFromDisk(cache_path));
+    EXPECT_EQ(reloaded.GetEntryCount(), 10u);
+    ASSERT_TRUE(reloaded.GetCached(key_of(9), shader));
+    
+    // 压缩合并日志
+    ASSERT_TRUE(reloaded.Compact(cache_path));
+    EXPECT_FALSE(std::filesystem::exists(journal_path));
+    EXPECT_EQ(reloaded.GetEntryCount(), 10u);
+    EXPECT_EQ(reloaded.GetStats().compactions, 1u);
+    
+    // 日志超过主文件一半时在后台压缩
+    for (int i = 10; i < 20; i++) {
+        reloaded.SetCached(key_of(i), make_shader(i));
+    }
+    ASSERT_TRUE(reloaded.SaveToDisk(cache_path));
+    reloaded.WaitForCompaction();
+    EXPECT_FALSE(std::filesystem::exists(journal_path));
+    EXPECT_EQ(reloaded.GetStats().compactions, 2u);
+    EXPECT_EQ(reloaded.GetEntryCount(), 20u);
+    reloaded.Clear();
+    
+    // 磁盘预算：压缩时只保留最近使用的条目
+    render::ShaderCache bounded;
+    ASSERT_TRUE(bounded.LoadFromDisk(cache_path));
+    ASSERT_TRUE(bounded.GetCached(key_of(2), shader));
+    ASSERT_TRUE(bounded.GetCached(key_of(5), shader));
+    bounded.SetDiskBudget(3 * 10100);
+    ASSERT_TRUE(bounded.Compact(cache_path));
+    EXPECT_EQ(bounded.GetStats().diskEvictions, 17u);
+    EXPECT_LE(std::filesystem::file_size(cache_path), 3u * 10100u);
+    bounded.Clear();
+    ASSERT_TRUE(bounded.LoadFromDisk(cache_path));
+    EXPECT_EQ(bounded.GetEntryCount(), 3u);
+    EXPECT_TRUE(bounded.HasCached(key_of(2)));
+    EXPECT_TRUE(bounded.HasCached(key_of(5)));
+    EXPECT_TRUE(bounded.HasCached(key_of(19)));
+    bounded.Clear();
+}
+
+// 测试着色器异步编译队列
+TEST_F(CoreTest, ShaderCompileQueue) {
+    // 可见几何体优先，后处理按序号排在后面
+    std::vector<std::string> ordered = {
+        "gbuffers_terrain", "gbuffers_entities", "gbuffers_water", "gbuffers_armor_glint",
+        "shadow", "deferred", "deferred3", "composite", "composite7", "composite12", "final", "custom"};
+    for (size_t i = 1; i < ordered.size(); i++) {
+        EXPECT_LT(render::GetProgramPriority(ordered[i - 1]), render::GetProgramPriority(ordered[i]))
+            << ordered[i - 1] << " vs " << ordered[i];
+    }
+    
+    // 单工作线程，先用一个阻塞任务占住线程，让其余任务排队
+    common::ThreadPool pool(1);
+    std::vector<std::string> order;
+    std::mutex order_mutex;
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    {
+        render::ShaderCompileQueue queue(&pool);
+        queue.Submit("blocker", 0, [&]() {
+            started.set_value();
+            release_future.wait();
+            return true;
+        });
+        started.get_future().wait();
+        
+        auto record = [&](const std::string& name, bool result) {
+            return [&, name, result]() {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(name);
+                return result;
+            };
+        };
+        std::vector<std::string> names = {"composite7", "final", "composite", "gbuffers_water", "gbuffers_terrain"};
+        std::unordered_map<std::string, std::shared_future<bool>> futures;
+        for (const std::string& name : names) {
+            futures[name] = queue.Submit(name, render::GetProgramPriority(name), record(name, name != "final"));
+        }
+        
+        // 同名任务未完成时复用同一个future
+        auto duplicate = queue.Submit("composite", 0, record("duplicate", true));
+        EXPECT_TRUE(queue.GetFuture("composite").valid());
+        EXPECT_EQ(queue.GetPendingCount(), names.size() + 1);
+        
+        // 渲染线程需要composite7时提到最前
+        EXPECT_TRUE(queue.Prioritize("composite7"));
+        EXPECT_FALSE(queue.Prioritize("missing"));
+        release.set_value();
+        
+        EXPECT_TRUE(futures["composite7"].get());
+        EXPECT_FALSE(futures["final"].get());
+        EXPECT_TRUE(duplicate.get());
+        queue.WaitAll();
+        EXPECT_EQ(queue.GetPendingCount(), 0u);
+        EXPECT_FALSE(queue.GetFuture("composite").valid());
+    }
+    std::vector<std::string> expected = {"composite7", "gbuffers_terrain", "gbuffers_water", "composite", "final"};
+    EXPECT_EQ(order, expected);
+    
+    // 转换器：未连接游戏运行时时编译失败，但队列与后备材质路径可用
+    std::string pack_dir = temp_dir_ + "/async_pack";
+    std::filesystem::create_directories(pack_dir + "/shaders");
+    for (const std::string& name : {"gbuffers_terrain", "composite7"}) {
+        std::ofstream(pack_dir + "/shaders/" + name + ".fsh") << "void main() { gl_FragColor = vec4(1.0); }\n";
+    }
+    render::ShaderConverter converter;
+    converter.SetThreadPool(&pool);
+    ASSERT_TRUE(converter.ParseShaderpack(pack_dir));
+    auto material_futures = converter.CompileAllToRenderDragonAsync();
+    ASSERT_EQ(material_futures.size(), 2u);
+    EXPECT_EQ(converter.AcquireMaterial("gbuffers_terrain"), nullptr);
+    converter.WaitForCompilation();
+    for (auto& [name, future] : material_futures) {
+        EXPECT_FALSE(future.get()) << name;
+    }
+}
+
+// 测试Uniform布局与打包缓冲区
+TEST_F(CoreTest, UniformLayout) {
+    render::UniformLayout layout;
+    layout.AddFromSource(
+        "uniform float frameTime;\n"
+        "uniform sampler2D colortex0;\n"
+        "uniform  vec3 lightColors [2];\n"
+        "uniform mat4 viewMatrix;\n"
+        "in vec2 uniformCoord;\n"
+        "layout(std140) uniform Block { vec4 member; };\n",
+        {{"viewMatrix", 7}});
+    // 其他阶段重复声明的Uniform只登记一次
+    layout.AddFromSource("uniform mat4 viewMatrix;\nuniform int frameIndex;\n", {});
+
+    ASSERT_EQ(layout.GetSlotCount(), 4u);
+    EXPECT_EQ(layout.FindSlot("colortex0"), -1);
+    EXPECT_EQ(layout.FindSlot("uniformCoord"), -1);
+    EXPECT_EQ(layout.GetBufferSize(), 1u + 6u + 16u + 1u);
+
+    const render::UniformSlot& lights = layout.GetSlot(layout.FindSlot("lightColors"));
+    EXPECT_EQ(lights.offset, 1u);
+    EXPECT_EQ(lights.count, 6u);
+    const render::UniformSlot& view = layout.GetSlot(layout.FindSlot("viewMatrix"));
+    EXPECT_EQ(view.offset, 7u);
+    EXPECT_EQ(view.location, 7);
+
+    // 槽位在初始化时解析一次，之后每帧按槽位写入
+    int time_slot = layout.FindSlot("frameTime");
+    int lights_slot = layout.FindSlot("lightColors");
+    render::UniformBuffer buffer(layout);
+    ASSERT_EQ(buffer.Size(), layout.GetBufferSize());
+    buffer.Set(time_slot, 2.5f);
+    float colors[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    buffer.Set(lights_slot, colors, 8); // 超出槽位长度截断
+    buffer.Set(-1, 9.0f);
+    EXPECT_FLOAT_EQ(buffer.Data()[0], 2.5f);
+    EXPECT_FLOAT_EQ(buffer.Data()[6], 6.0f);
+    EXPECT_FLOAT_EQ(buffer.Data()[7], 0.0f);
+
+    // 解析光影包时为每个材质构建布局
+    std::string pack_dir = temp_dir_ + "/uniform_pack";
+    std::filesystem::create_directories(pack_dir + "/shaders");
+    std::ofstream(pack_dir + "/shaders/gbuffers_basic.vsh")
+        << "uniform float waveSpeed;\nvoid main() { gl_Position = vec4(waveSpeed); }\n";
+    std::ofstream(pack_dir + "/shaders/gbuffers_basic.fsh")
+        << "uniform vec4 tintColor;\nuniform sampler2D lightmap;\n"
+        << "void main() { gl_FragColor = tintColor * texture2D(lightmap, vec2(0.0)); }\n";
+    render::ShaderConverter converter;
+    ASSERT_TRUE(converter.ParseShaderpack(pack_dir));
+    const render::MaterialInfo* material = converter.GetMaterialInfo("gbuffers_basic");
+    ASSERT_NE(material, nullptr);
+    EXPECT_GE(material->uniformLayout->FindSlot("waveSpeed"), 0);
+    EXPECT_GE(material->uniformLayout->FindSlot("tintColor"), 0);
+    EXPECT_EQ(material->uniformLayout->FindSlot("lightmap"), -1);
+
+    // 未连接游戏运行时上传失败
+    render::UniformBuffer material_buffer(material->uniformLayout);
+    EXPECT_FALSE(converter.UploadUniforms(nullptr, material_buffer));
+    
+    // 缓冲区共享持有布局，重新解析光影包后旧缓冲区仍然有效
+    EXPECT_EQ(material_buffer.GetSharedLayout(), material->uniformLayout);
+    ASSERT_TRUE(converter.ParseShaderpack(pack_dir));
+    EXPECT_NE(converter.GetMaterialInfo("gbuffers_basic")->uniformLayout, material_buffer.GetSharedLayout());
+    material_buffer.Set(material_buffer.GetLayout().FindSlot("tintColor"), 1.0f);
+    EXPECT_EQ(material_buffer.Size(), material_buffer.GetLayout().GetBufferSize());
+}
+
+// 测试光影选项变体
+TEST_F(CoreTest, ShaderOptionVariants) {
+    std::string pack_dir = temp_dir_ + "/variant_pack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    std::ofstream(shaders_dir + "/shaders.properties") << "WAVE_SPEED=1.5\n";
+    std::ofstream(shaders_dir + "/lib/settings.glsl") << "#define SHADOWS\n";
+    std::ofstream(shaders_dir + "/gbuffers_terrain.fsh")
+        << "#include \"/lib/settings.glsl\"\n"
+        << "#ifdef SHADOWS\nuniform sampler2D shadowtex0;\n#endif\n"
+        << "void main() { gl_FragColor = vec4(1.0); }\n";
+    std::ofstream(shaders_dir + "/gbuffers_terrain.vsh") << "void main() { gl_Position = vec4(0.0); }\n";
+    std::ofstream(shaders_dir + "/composite.fsh")
+        << "#define WAVE_SPEED 1.0\nvoid main() { gl_FragColor = vec4(WAVE_SPEED); }\n";
+
+    render::ShaderConverter converter;
+    EXPECT_FALSE(converter.SetShaderOption("SHADOWS", "false"));
+    ASSERT_TRUE(converter.ParseShaderpack(pack_dir));
+    EXPECT_EQ(converter.GetVariantCount(), 3u);
+    EXPECT_EQ(converter.GetShaderOptions().at("WAVE_SPEED"), "1.5");
+
+    auto source_of = [&](const std::string& material, render::ShaderStage stage) {
+        for (const auto& shader : converter.GetMaterialInfo(material)->shaders) {
+            if (shader.stage == stage) {
+                return shader.source;
+            }
+        }
+        return std::string();
+    };
+    EXPECT_NE(source_of("gbuffers_terrain", render::ShaderStage::FRAGMENT).find("shadowtex0"), std::string::npos);
+    std::string composite_source = source_of("composite", render::ShaderStage::FRAGMENT);
+    EXPECT_NE(composite_source.find("1.5"), std::string::npos);
+
+    // 关闭SHADOWS只重新转换引用它的阶段
+    ASSERT_TRUE(converter.SetShaderOption("SHADOWS", "false"));
+    EXPECT_EQ(converter.GetVariantCount(), 4u);
+    EXPECT_EQ(source_of("gbuffers_terrain", render::ShaderStage::FRAGMENT).find("shadowtex0"), std::string::npos);
+    EXPECT_EQ(source_of("composite", render::ShaderStage::FRAGMENT), composite_source);
+    EXPECT_EQ(converter.GetMaterialInfo("composite")->properties.at("SHADOWS"), "false");
+
+    // 切换回之前的取值复用已有变体
+    ASSERT_TRUE(converter.SetShaderOption("SHADOWS", "true"));
+    EXPECT_EQ(converter.GetVariantCount(), 4u);
+    EXPECT_NE(source_of("gbuffers_terrain", render::ShaderStage::FRAGMENT).find("shadowtex0"), std::string::npos);
+
+    ASSERT_TRUE(converter.ApplyShaderOptions({{"WAVE_SPEED", "2.0"}, {"UNUSED_OPTION", "1"}}));
+    EXPECT_EQ(converter.GetVariantCount(), 5u);
+    EXPECT_NE(source_of("composite", render::ShaderStage::FRAGMENT).find("2.0"), std::string::npos);
+}
+
+// 测试运行时着色器源代码缓存
+TEST_F(CoreTest, ShaderSourceCache) {
+    render::ShaderStage stage;
+    ASSERT_TRUE(render::ShaderStageFromGLType(0x8B31, stage)); // GL_VERTEX_SHADER
+    EXPECT_EQ(stage, render::ShaderStage::VERTEX);
+    ASSERT_TRUE(render::ShaderStageFromGLType(0x8B30, stage)); // GL_FRAGMENT_SHADER
+    EXPECT_EQ(stage, render::ShaderStage::FRAGMENT);
+    EXPECT_FALSE(render::ShaderStageFromGLType(0, stage));
+
+    // glShaderSource形式的片段：以'\0'结尾与显式长度混用
+    std::string full = "#version 120\nvarying vec2 uv;\nvoid main() { gl_FragColor = texture2D(texture, uv); }\n";
+    const char* fragments[] = {"#version 120\nvarying vec2 uv;\n", "void main() { gl_FragColor = texture2D(texture, uv); }\nXXXX"};
+    int lengths[] = {-1, static_cast<int>(std::strlen(fragments[1])) - 4};
+
+    render::ShaderSourceCache cache;
+    auto translated = cache.Translate(2, fragments, lengths, render::ShaderStage::FRAGMENT);
+    ASSERT_NE(translated, nullptr);
+    EXPECT_EQ(*translated, render::RewriteGLSLForRenderDragon(full, render::ShaderStage::FRAGMENT));
+    EXPECT_EQ(cache.GetMissCount(), 1u);
+
+    // 重复上传同一源代码只命中缓存，不同阶段分别缓存
+    EXPECT_EQ(cache.Translate(full, render::ShaderStage::FRAGMENT), translated);
+    // 只上传第一个片段是另一份源代码
+    EXPECT_NE(cache.Translate(1, fragments, nullptr, render::ShaderStage::FRAGMENT), translated);
+    EXPECT_NE(cache.Translate(full, render::ShaderStage::VERTEX), translated);
+    EXPECT_EQ(cache.Translate(full, render::ShaderStage::VERTEX), cache.Translate(full, render::ShaderStage::VERTEX));
+    EXPECT_EQ(cache.GetHitCount(), 3u);
+    EXPECT_EQ(cache.GetMissCount(), 3u);
+    EXPECT_EQ(cache.GetEntryCount(), 3u);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetEntryCount(), 0u);
+    EXPECT_EQ(*cache.Translate(0, nullptr, nullptr, render::ShaderStage::VERTEX),
+              render::RewriteGLSLForRenderDragon("", render::ShaderStage::VERTEX));
+
+    // 未加载Java版光影包时不转换任何源代码
+    EXPECT_FALSE(cache.ShouldTranslate(1, fragments, nullptr));
+    cache.SetJavaShaderpackLoaded(true);
+    EXPECT_EQ(cache.GetEntryCount(), 0u);
+    EXPECT_TRUE(cache.ShouldTranslate(2, fragments, lengths));
+    const char* noVersion[] = {"varying vec2 uv;\nvoid main() {}\n"};
+    EXPECT_TRUE(cache.ShouldTranslate(1, noVersion, nullptr));
+    // GLSL ES源代码原样传递，#version可能跨片段
+    const char* es3[] = {"#version 3", "00 es\nprecision mediump float;\nvoid main() {}\n"};
+    EXPECT_FALSE(cache.ShouldTranslate(2, es3, nullptr));
+    const char* es2[] = {"// game shader\n#version 100\nvoid main() {}\n"};
+    EXPECT_FALSE(cache.ShouldTranslate(1, es2, nullptr));
+    const char* core[] = {"#version 330 core\nvoid main() {}\n"};
+    EXPECT_TRUE(cache.ShouldTranslate(1, core, nullptr));
+    cache.SetJavaShaderpackLoaded(false);
+    EXPECT_FALSE(cache.ShouldTranslate(1, core, nullptr));
+}
+
 // 测试Java模组运行时初始化
 TEST_F(CoreTest, JavaModRuntimeInitialization) {
     // 创建Java模组运行时
@@ -321,6 +1196,677 @@ TEST_F(CoreTest, JavaMethodInvocation) {
     runtime.Shutdown();
 }
 
+// 测试Java方法缓存与句柄调用
+TEST_F(CoreTest, JavaMethodCache) {
+    mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    // 同一方法只解析一次
+    mods::JavaMethodHandle abs_handle;
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "abs", "(I)I", true, abs_handle));
+    EXPECT_TRUE(abs_handle.IsValid());
+    EXPECT_EQ(abs_handle.returnType, 'I');
+    mods::JavaMethodHandle again;
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "abs", "(I)I", true, again));
+    EXPECT_EQ(again.method, abs_handle.method);
+    EXPECT_EQ(runtime.GetCachedMethodCount(), 1u);
+    
+    // 静态与实例方法分别缓存
+    EXPECT_TRUE(runtime.CallStaticJavaMethod("java/lang/Math", "max", "(II)I", 1, 2));
+    EXPECT_EQ(runtime.GetCachedMethodCount(), 2u);
+    EXPECT_TRUE(runtime.Invoke(abs_handle, nullptr, -5));
+    
+    // 不存在的类和方法不会进入缓存
+    mods::JavaMethodHandle missing;
+    EXPECT_FALSE(runtime.PrepareCall("com/test/Missing", "run", "()V", true, missing));
+    EXPECT_FALSE(runtime.PrepareCall("java/lang/Math", "missing", "()V", true, missing));
+    EXPECT_FALSE(runtime.PrepareCall("java/lang/Math", "abs", "(I", true, missing));
+    EXPECT_FALSE(missing.IsValid());
+    EXPECT_EQ(runtime.GetCachedMethodCount(), 2u);
+    
+    // 清空缓存后旧句柄失效，重新解析得到新句柄
+    runtime.ClearMethodCache();
+    EXPECT_EQ(runtime.GetCachedMethodCount(), 0u);
+    EXPECT_FALSE(runtime.Invoke(abs_handle, nullptr, -5));
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "abs", "(I)I", true, abs_handle));
+    EXPECT_TRUE(runtime.Invoke(abs_handle, nullptr, -5));
+    
+    runtime.Shutdown();
+}
+
+// 测试多线程附加JVM与模组处理函数
+TEST_F(CoreTest, JavaThreadAttach) {
+    mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    // 同一线程重复获取返回缓存的JNIEnv
+    JNIEnv* main_env = runtime.GetEnv();
+    ASSERT_NE(main_env, nullptr);
+    EXPECT_EQ(runtime.GetEnv(), main_env);
+    
+    // 其他线程自动附加后可直接调用
+    mods::JavaMethodHandle abs_handle;
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "abs", "(I)I", true, abs_handle));
+    bool thread_result = false;
+    std::thread caller([&]() {
+        thread_result = runtime.GetEnv() != nullptr && runtime.Invoke(abs_handle, nullptr, -1) &&
+                        runtime.CallStaticJavaMethod("java/lang/Math", "abs", "(I)I", -2);
+    });
+    caller.join();
+    EXPECT_TRUE(thread_result);
+    
+    // 工作线程池并行运行处理函数
+    std::vector<mods::JavaModRuntime::ModTask> tasks;
+    for (int i = 0; i < 32; i++) {
+        tasks.push_back([&runtime, &abs_handle, i](JNIEnv* env) {
+            return env != nullptr && runtime.Invoke(abs_handle, nullptr, -i);
+        });
+    }
+    tasks.push_back([](JNIEnv*) { return false; });
+    EXPECT_EQ(runtime.RunModTasks(tasks), 32u);
+    
+    auto future = runtime.SubmitModTask([&runtime, &abs_handle](JNIEnv*) {
+        return runtime.Invoke(abs_handle, nullptr, 5);
+    });
+    EXPECT_TRUE(future.get());
+    
+    runtime.Shutdown();
+    EXPECT_FALSE(runtime.SubmitModTask([](JNIEnv*) { return true; }).get());
+}
+
+// 测试JAR元数据扫描与缓存
+TEST_F(CoreTest, JarMetadataScanner) {
+    std::string forge_jar = CreateTestJar(mods_dir_ + "/forge.jar", {
+        {"mcmod.info", "[{\"modid\": \"forgemod\", \"name\": \"Forge Mod\", \"version\": \"1.2.0\"}]"},
+        {"com/test/ForgeMod.class", std::string(4096, 'x')}});
+    CreateTestJar(mods_dir_ + "/toml.jar", {
+        {"META-INF/mods.toml", "[[mods]]\nmodId=\"tomlmod\"\nversion=\"2.0.0\"\ndisplayName=\"Toml Mod\"\n"}}, false);
+    CreateTestJar(mods_dir_ + "/fabric.jar", {
+        {"fabric.mod.json", "{\"id\": \"fabricmod\", \"version\": \"3.0.0\"}"}});
+    CreateTestJar(mods_dir_ + "/plain.jar", {{"readme.txt", "no manifest"}});
+    std::ofstream(mods_dir_ + "/broken.jar") << "not a zip file";
+    std::ofstream(mods_dir_ + "/notes.txt") << "ignored";
+    
+    // 直接读取归档条目
+    mods::JarArchive archive;
+    ASSERT_TRUE(archive.Open(forge_jar));
+    EXPECT_EQ(archive.GetEntryCount(), 2u);
+    EXPECT_TRUE(archive.HasEntry("com/test/ForgeMod.class"));
+    EXPECT_FALSE(archive.HasEntry("fabric.mod.json"));
+    std::string content;
+    ASSERT_TRUE(archive.ReadEntry("com/test/ForgeMod.class", content));
+    EXPECT_EQ(content, std::string(4096, 'x'));
+    EXPECT_FALSE(archive.Open(mods_dir_ + "/broken.jar"));
+    
+    // 扫描目录，无法解析的JAR被跳过
+    mods::JavaModRuntime runtime;
+    std::vector<mods::JavaModInfo> found;
+    ASSERT_EQ(runtime.ScanModsDirectory(mods_dir_, found), 4u);
+    std::map<std::string, std::string> versions;
+    for (const auto& info : found) {
+        versions[info.modId] = info.version;
+    }
+    EXPECT_EQ(versions["forgemod"], "1.2.0");
+    EXPECT_EQ(versions["tomlmod"], "2.0.0");
+    EXPECT_EQ(versions["fabricmod"], "3.0.0");
+    EXPECT_EQ(versions.count("plain"), 1u);
+    EXPECT_EQ(runtime.GetJarScanner().GetMissCount(), 4u);
+    
+    // 缓存持久化后，新的扫描器全部命中
+    std::string cache_path = output_dir_ + "/jars.cache";
+    ASSERT_TRUE(runtime.GetJarScanner().SaveCache(cache_path));
+    mods::JavaModRuntime warm;
+    ASSERT_TRUE(warm.GetJarScanner().LoadCache(cache_path));
+    std::vector<mods::JavaModInfo> cached;
+    ASSERT_EQ(warm.ScanModsDirectory(mods_dir_, cached), 4u);
+    EXPECT_EQ(warm.GetJarScanner().GetHitCount(), 4u);
+    EXPECT_EQ(warm.GetJarScanner().GetMissCount(), 0u);
+    
+    // JAR内容变化后哈希不同，重新读取
+    CreateTestJar(forge_jar, {
+        {"mcmod.info", "[{\"modid\": \"forgemod\", \"name\": \"Forge Mod\", \"version\": \"1.3.0\"}]"},
+        {"com/test/ForgeMod.class", std::string(4096, 'x')}});
+    mods::JarMetadata metadata;
+    ASSERT_TRUE(warm.GetJarScanner().Scan(forge_jar, metadata));
+    EXPECT_NE(metadata.mcmodInfo.find("1.3.0"), std::string::npos);
+    EXPECT_EQ(warm.GetJarScanner().GetMissCount(), 1u);
+    
+    // 损坏的缓存文件被拒绝
+    std::ofstream(cache_path, std::ios::binary | std::ios::app) << "garbage";
+    mods::JarScanner rejected;
+    EXPECT_FALSE(rejected.LoadCache(cache_path));
+}
+
+// 测试模组依赖图与按依赖加载
+TEST_F(CoreTest, ModDependencyGraph) {
+    // core <- api <- {addon, compat}，compat还依赖外部的missing；a、b互相依赖，c依赖环
+    mods::ModDependencyGraph graph;
+    graph.AddMod("addon", {"api"});
+    graph.AddMod("core", {});
+    graph.AddMod("compat", {"api", "missing"});
+    graph.AddMod("api", {"core"});
+    graph.AddMod("a", {"b"});
+    graph.AddMod("b", {"a"});
+    graph.AddMod("c", {"a"});
+    EXPECT_EQ(graph.GetModCount(), 7u);
+    EXPECT_EQ(graph.GetMissingDependencies("compat"), std::vector<std::string>({"missing"}));
+    EXPECT_EQ(graph.GetDependencies("compat"), std::vector<std::string>({"api"}));
+    
+    std::vector<std::vector<std::string>> levels;
+    std::vector<std::string> cycle;
+    EXPECT_FALSE(graph.BuildLevels(levels, cycle));
+    ASSERT_EQ(levels.size(), 3u);
+    EXPECT_EQ(levels[0], std::vector<std::string>({"core"}));
+    EXPECT_EQ(levels[1], std::vector<std::string>({"api"}));
+    EXPECT_EQ(levels[2], std::vector<std::string>({"addon", "compat"}));
+    ASSERT_EQ(cycle.size(), 3u);
+    EXPECT_EQ(cycle.front(), cycle.back());
+    
+    // 关键路径取累计耗时最长的依赖链
+    double critical_ms = 0.0;
+    std::vector<std::string> path = graph.GetCriticalPath(
+        {{"core", 5.0}, {"api", 2.0}, {"addon", 1.0}, {"compat", 4.0}}, critical_ms);
+    EXPECT_EQ(path, std::vector<std::string>({"core", "api", "compat"}));
+    EXPECT_DOUBLE_EQ(critical_ms, 11.0);
+    
+    // 按层加载：api初始化失败时依赖它的addon、compat被跳过，环上的模组在最后按发现顺序跳过
+    mods::ModLoadReport graph_report;
+    std::vector<std::string> initialized;
+    std::vector<std::string> loaded;
+    size_t graph_loaded = graph.LoadLevels(graph_report, std::chrono::steady_clock::now(),
+        [&initialized](const std::string& modId) {
+            initialized.push_back(modId);
+            return modId != "api";
+        },
+        [&loaded](const std::string& modId) { loaded.push_back(modId); });
+    EXPECT_EQ(graph_loaded, 1u);
+    EXPECT_EQ(graph_report.loadedCount, 1u);
+    EXPECT_EQ(initialized, std::vector<std::string>({"core", "api"}));
+    EXPECT_EQ(loaded, std::vector<std::string>({"core"}));
+    EXPECT_EQ(graph_report.skipped, std::vector<std::string>({"addon", "compat", "a", "b", "c"}));
+    EXPECT_EQ(graph_report.missingDependencies["compat"], std::vector<std::string>({"missing"}));
+    ASSERT_EQ(graph_report.timings.size(), 2u);
+    EXPECT_TRUE(graph_report.timings[0].loaded);
+    EXPECT_FALSE(graph_report.timings[1].loaded);
+    EXPECT_EQ(graph_report.timings[1].level, 1u);
+    EXPECT_EQ(graph_report.criticalPath.front(), "core");
+    
+    // 从JAR描述文件解析依赖，加载器与游戏本身不计入
+    CreateTestJar(mods_dir_ + "/base.jar", {
+        {"META-INF/mods.toml", "[[mods]]\nmodId=\"base\"\n[[dependencies.base]]\nmodId=\"forge\"\nmandatory=true\n"}});
+    CreateTestJar(mods_dir_ + "/lib.jar", {
+        {"mcmod.info", "[{\"modid\": \"lib\", \"requiredMods\": [\"base@[1.0,)\"]}]"}});
+    CreateTestJar(mods_dir_ + "/app.jar", {
+        {"fabric.mod.json", "{\"id\": \"app\", \"depends\": {\"fabricloader\": \">=0.14\", \"lib\": [\"*\"]}}"}});
+    CreateTestJar(mods_dir_ + "/opt.jar", {
+        {"META-INF/mods.toml", "[[mods]]\nmodId=\"opt\"\n[[dependencies.opt]]\nmodId=\"app\"\nmandatory=true\n"
+                               "[[dependencies.opt]]\nmodId=\"extra\"\nmandatory=false\n"}});
+    mods::JavaModRuntime runtime;
+    std::vector<mods::JavaModInfo> found;
+    ASSERT_EQ(runtime.ScanModsDirectory(mods_dir_, found), 4u);
+    std::map<std::string, std::vector<std::string>> dependencies;
+    for (const auto& info : found) {
+        dependencies[info.modId] = info.dependencies;
+    }
+    EXPECT_TRUE(dependencies["base"].empty());
+    EXPECT_EQ(dependencies["lib"], std::vector<std::string>({"base"}));
+    EXPECT_EQ(dependencies["app"], std::vector<std::string>({"lib"}));
+    EXPECT_EQ(dependencies["opt"], std::vector<std::string>({"app"}));
+    
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    // 链式依赖逐层加载
+    mods::ModLoadReport report;
+    EXPECT_EQ(runtime.LoadAll(mods_dir_, &report), 4u);
+    ASSERT_EQ(report.levels.size(), 4u);
+    EXPECT_EQ(report.levels[3], std::vector<std::string>({"opt"}));
+    EXPECT_EQ(report.criticalPath, std::vector<std::string>({"base", "lib", "app", "opt"}));
+    EXPECT_EQ(report.timings.size(), 4u);
+    EXPECT_NE(report.ToString().find("Critical path"), std::string::npos);
+    EXPECT_NE(runtime.GetModInfo("opt"), nullptr);
+    
+    // 已加载的模组不再重复加载
+    EXPECT_EQ(runtime.LoadAll(mods_dir_, &report), 0u);
+    
+    // 环上及依赖环的模组按发现顺序记为跳过
+    CreateTestJar(mods_dir_ + "/cyc_a.jar", {
+        {"mcmod.info", "[{\"modid\": \"cyc_a\", \"requiredMods\": [\"cyc_b\"]}]"}});
+    CreateTestJar(mods_dir_ + "/cyc_b.jar", {
+        {"mcmod.info", "[{\"modid\": \"cyc_b\", \"requiredMods\": [\"cyc_a\"]}]"}});
+    CreateTestJar(mods_dir_ + "/cyc_c.jar", {
+        {"mcmod.info", "[{\"modid\": \"cyc_c\", \"requiredMods\": [\"cyc_a\", \"base\"]}]"}});
+    EXPECT_EQ(runtime.LoadAll(mods_dir_, &report), 0u);
+    EXPECT_TRUE(report.levels.empty());
+    EXPECT_FALSE(report.cycle.empty());
+    std::vector<std::string> skipped = report.skipped;
+    std::sort(skipped.begin(), skipped.end());
+    EXPECT_EQ(skipped, std::vector<std::string>({"cyc_a", "cyc_b", "cyc_c"}));
+    EXPECT_EQ(runtime.GetModInfo("cyc_c"), nullptr);
+    runtime.Shutdown();
+}
+
+// 测试模组启动性能分析
+TEST_F(CoreTest, ModStartupProfiler) {
+    mods::ModProfiler& profiler = mods::ModProfiler::GetInstance();
+    
+    // 关闭时不记录
+    profiler.Disable();
+    profiler.Clear();
+    {
+        mods::ModProfileScope scope("java", "ignored", "load");
+    }
+    EXPECT_TRUE(profiler.GetEvents().empty());
+    
+    // 嵌套区间：外层先以文件名开始，解析后补记模组ID
+    profiler.Enable();
+    {
+        mods::ModProfileScope load("java", "alpha-1.0", "load");
+        {
+            mods::ModProfileScope parse("java", "alpha-1.0", "parse_manifest");
+            parse.SetModId("alpha");
+        }
+        mods::ModProfileScope init("java", "alpha", "init");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    {
+        mods::ModProfileScope load("netease", "beta", "load");
+        mods::ModProfileScope import("netease", "beta", "import");
+    }
+    
+    // 解析描述文件也会记录
+    CreateTestJar(mods_dir_ + "/gamma.jar", {{"fabric.mod.json", "{\"id\": \"gamma\"}"}});
+    mods::JavaModRuntime runtime;
+    std::vector<mods::JavaModInfo> found;
+    ASSERT_EQ(runtime.ScanModsDirectory(mods_dir_, found), 1u);
+    profiler.Disable();
+    
+    std::vector<mods::ModProfileEvent> events = profiler.GetEvents();
+    std::map<std::string, const mods::ModProfileEvent*> by_stack;
+    for (const auto& event : events) {
+        by_stack[event.stack] = &event;
+    }
+    ASSERT_EQ(by_stack.count("alpha:load;alpha:parse_manifest"), 1u);
+    ASSERT_EQ(by_stack.count("alpha:load;alpha:init"), 1u);
+    ASSERT_EQ(by_stack.count("gamma:parse_manifest"), 1u);
+    const mods::ModProfileEvent* alpha = by_stack["alpha:load"];
+    EXPECT_TRUE(alpha->outermost);
+    EXPECT_FALSE(by_stack["alpha:load;alpha:init"]->outermost);
+    EXPECT_GE(alpha->wallUs, 5000.0);
+    EXPECT_LT(alpha->selfUs, alpha->wallUs);
+    EXPECT_LT(alpha->cpuUs, alpha->wallUs);
+    
+    // 汇总只计入最外层区间，按耗时降序
+    std::vector<mods::ModProfileSummary> summaries = profiler.GetModSummaries();
+    ASSERT_EQ(summaries.size(), 3u);
+    EXPECT_EQ(summaries[0].modId, "alpha");
+    EXPECT_NEAR(summaries[0].wallMs, alpha->wallUs / 1000.0, 1e-9);
+    
+    // Chrome trace为合法JSON，每个区间一个完整事件
+    std::string trace_path = output_dir_ + "/startup.trace.json";
+    ASSERT_TRUE(profiler.WriteChromeTrace(trace_path));
+    common::JsonSaxHandler handler;
+    common::JsonSaxReader reader;
+    EXPECT_TRUE(reader.ParseFile(trace_path, handler)) << reader.GetError();
+    std::ifstream trace_file(trace_path);
+    std::string trace((std::istreambuf_iterator<char>(trace_file)), std::istreambuf_iterator<char>());
+    size_t complete_events = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1)) {
+        complete_events++;
+    }
+    EXPECT_EQ(complete_events, events.size());
+    EXPECT_NE(trace.find("\"name\":\"alpha:init\""), std::string::npos);
+    
+    // 折叠栈每行为"栈 自身微秒数"
+    std::string stacks_path = output_dir_ + "/startup.folded";
+    ASSERT_TRUE(profiler.WriteCollapsedStacks(stacks_path));
+    std::ifstream stacks_file(stacks_path);
+    std::string line;
+    bool found_init = false;
+    while (std::getline(stacks_file, line)) {
+        size_t space = line.rfind(' ');
+        ASSERT_NE(space, std::string::npos);
+        EXPECT_GT(std::stoll(line.substr(space + 1)), 0);
+        if (line.compare(0, space, "alpha:load;alpha:init") == 0) {
+            found_init = true;
+            EXPECT_GE(std::stoll(line.substr(space + 1)), 5000);
+        }
+    }
+    EXPECT_TRUE(found_init);
+    profiler.Clear();
+}
+
+// 测试JAR入口类解析
+TEST_F(CoreTest, JarEntryPointResolution) {
+    // 最小类文件：常量池含若干UTF8常量与一个占两个槽位的Long
+    auto make_class = [](const std::vector<std::string>& utf8) {
+        std::string data("\xCA\xFE\xBA\xBE\x00\x00\x00\x34", 8);
+        size_t count = utf8.size() + 3;
+        data += static_cast<char>(count >> 8);
+        data += static_cast<char>(count & 0xFF);
+        data += std::string("\x05\x00\x00\x00\x00\x00\x00\x00\x2A", 9);
+        for (const auto& value : utf8) {
+            data += '\x01';
+            data += static_cast<char>(value.size() >> 8);
+            data += static_cast<char>(value.size() & 0xFF);
+            data += value;
+        }
+        return data + std::string(8, '\0');
+    };
+    
+    std::string forge_jar = CreateTestJar(mods_dir_ + "/forge.jar", {
+        {"META-INF/mods.toml", "[[mods]]\nmodId=\"forgemod\"\n"},
+        {"com/example/ExampleMod.class", make_class({"com/example/ExampleMod", "Lnet/minecraftforge/fml/common/Mod;"})},
+        {"com/example/Helper.class", make_class({"com/example/Helper", "Lnet/minecraftforge/fml/common/Mod$EventBusSubscriber;"})},
+        {"com/example/Broken.class", "not a class"}});
+    std::string fabric_jar = CreateTestJar(mods_dir_ + "/fabric.jar", {
+        {"fabric.mod.json", "{\"id\": \"fabricmod\", \"entrypoints\": {"
+                            "\"main\": [\"com.fab.Main\", {\"adapter\": \"kotlin\", \"value\": \"com.fab.KtInit\"}],"
+                            " \"client\": [\"com.fab.Client::init\"], \"server\": [\"com.fab.Server\"]}}"},
+        {"com/fab/Main.class", make_class({"Lnet/minecraftforge/fml/common/Mod;"})}});
+    
+    mods::JarScanner scanner;
+    mods::JarMetadata forge;
+    ASSERT_TRUE(scanner.Scan(forge_jar, forge));
+    EXPECT_EQ(forge.entryPoints, std::vector<std::string>({"com/example/ExampleMod"}));
+    
+    // Fabric只使用声明的入口点，不扫描类文件
+    mods::JarMetadata fabric;
+    ASSERT_TRUE(scanner.Scan(fabric_jar, fabric));
+    EXPECT_EQ(fabric.entryPoints, std::vector<std::string>({"com/fab/Main", "com/fab/KtInit", "com/fab/Client"}));
+    
+    // 入口类随缓存持久化
+    std::string cache_path = output_dir_ + "/jars.cache";
+    ASSERT_TRUE(scanner.SaveCache(cache_path));
+    mods::JarScanner warm;
+    ASSERT_TRUE(warm.LoadCache(cache_path));
+    mods::JarMetadata cached;
+    ASSERT_TRUE(warm.Scan(forge_jar, cached));
+    EXPECT_EQ(warm.GetHitCount(), 1u);
+    EXPECT_EQ(cached.entryPoints, forge.entryPoints);
+    
+    // 读取全部类文件条目
+    mods::JarArchive archive;
+    ASSERT_TRUE(archive.Open(forge_jar));
+    std::vector<std::string> classes;
+    EXPECT_EQ(archive.ReadEntries(".class", [&classes](const std::string& name, const std::string&) {
+        classes.push_back(name);
+        return true;
+    }), 3u);
+    EXPECT_EQ(classes.size(), 3u);
+    
+    // 模组信息带有入口类，加载与卸载都使用解析结果
+    mods::JavaModRuntime runtime;
+    std::vector<mods::JavaModInfo> found;
+    ASSERT_EQ(runtime.ScanModsDirectory(mods_dir_, found), 2u);
+    EXPECT_EQ(found[0].modId, "fabricmod");
+    EXPECT_EQ(found[0].entryPoints.size(), 3u);
+    
+    std::string java_jar = CreateTestJar(output_dir_ + "/javamod.jar", {
+        {"fabric.mod.json", "{\"id\": \"javamod\", \"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    ASSERT_TRUE(runtime.LoadMod(java_jar));
+    ASSERT_NE(runtime.GetModInfo("javamod"), nullptr);
+    EXPECT_EQ(runtime.GetModInfo("javamod")->entryPoints, std::vector<std::string>({"java/lang/Object"}));
+    EXPECT_TRUE(runtime.UnloadMod("javamod"));
+    runtime.Shutdown();
+}
+
+// 测试模组独立类加载器与卸载
+TEST_F(CoreTest, ModClassLoaderUnload) {
+    mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    // base/Api：public class Api {}（无方法的最小类文件）
+    const unsigned char api_class[] = {
+        0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34, 0x00, 0x05,
+        0x01, 0x00, 0x08, 'b', 'a', 's', 'e', '/', 'A', 'p', 'i', 0x07, 0x00, 0x01,
+        0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'O', 'b', 'j', 'e', 'c', 't', 0x07, 0x00, 0x03,
+        0x00, 0x21, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    std::string base_jar = CreateTestJar(mods_dir_ + "/base.jar", {
+        {"fabric.mod.json", "{\"id\": \"base\", \"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"},
+        {"base/Api.class", std::string(reinterpret_cast<const char*>(api_class), sizeof(api_class))}});
+    std::string addon_jar = CreateTestJar(mods_dir_ + "/addon.jar", {
+        {"fabric.mod.json", "{\"id\": \"addon\", \"depends\": {\"base\": \"*\"}, "
+                            "\"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+    
+    // 每个模组一个类加载器
+    ASSERT_TRUE(runtime.LoadMod(base_jar));
+    ASSERT_TRUE(runtime.LoadMod(addon_jar));
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 2u);
+    
+    // 菱形依赖：top同时依赖addon与side，两者都依赖base
+    std::string side_jar = CreateTestJar(mods_dir_ + "/side.jar", {
+        {"fabric.mod.json", "{\"id\": \"side\", \"depends\": {\"base\": \"*\"}, "
+                            "\"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+    std::string top_jar = CreateTestJar(mods_dir_ + "/top.jar", {
+        {"fabric.mod.json", "{\"id\": \"top\", \"depends\": {\"addon\": \"*\", \"side\": \"*\"}, "
+                            "\"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+    ASSERT_TRUE(runtime.LoadMod(side_jar));
+    ASSERT_TRUE(runtime.LoadMod(top_jar));
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 4u);
+    // 共同的传递依赖只由base的加载器定义一次，各模组看到同一个类
+    JNIEnv* env = runtime.GetEnv();
+    jclass base_api = runtime.LoadModClass("base", "base/Api");
+    ASSERT_NE(base_api, nullptr);
+    for (const char* mod : {"addon", "side", "top"}) {
+        jclass api = runtime.LoadModClass(mod, "base/Api");
+        ASSERT_NE(api, nullptr) << mod;
+        EXPECT_TRUE(env->IsSameObject(api, base_api)) << mod;
+        env->DeleteLocalRef(api);
+    }
+    env->DeleteLocalRef(base_api);
+    EXPECT_EQ(runtime.LoadModClass("top", "base/Missing"), nullptr);
+    EXPECT_FALSE(runtime.UnloadMod("side"));
+    EXPECT_TRUE(runtime.UnloadMod("top"));
+    EXPECT_TRUE(runtime.UnloadMod("side"));
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 2u);
+    
+    // 被依赖的模组不能先卸载
+    EXPECT_FALSE(runtime.UnloadMod("base"));
+    EXPECT_TRUE(runtime.UnloadMod("addon"));
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 1u);
+    
+    // 热重载：卸载后加载器被释放，重新加载创建新的加载器
+    for (int cycle = 0; cycle < 3; cycle++) {
+        ASSERT_TRUE(runtime.UnloadMod("base"));
+        EXPECT_EQ(runtime.GetModClassLoaderCount(), 0u);
+        EXPECT_EQ(runtime.GetModInfo("base"), nullptr);
+        ASSERT_TRUE(runtime.LoadMod(base_jar));
+        EXPECT_EQ(runtime.GetModClassLoaderCount(), 1u);
+    }
+    
+    runtime.Shutdown();
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 0u);
+}
+
+// 测试JVM启动配置与CDS归档
+TEST_F(CoreTest, JvmStartupProfile) {
+    std::string cds_dir = temp_dir_ + "/cds";
+    std::string config_path = temp_dir_ + "/jvm.json";
+    {
+        std::ofstream config(config_path);
+        config << "{\"jvm\": {\"initial_heap\": \"256M\", \"max_heap\": \"2G\", \"gc\": \"ZGC\", "
+                  "\"cds_directory\": \"" << cds_dir << "\", \"options\": [\"-XX:+AlwaysPreTouch\"]}}";
+    }
+    mods::JvmProfile profile;
+    ASSERT_TRUE(mods::LoadJvmProfile(config_path, profile));
+    EXPECT_EQ(profile.initialHeap, "256M");
+    EXPECT_EQ(profile.maxHeap, "2G");
+    EXPECT_EQ(profile.gc, mods::JvmGarbageCollector::ZGC);
+    EXPECT_TRUE(profile.classDataSharing);
+    EXPECT_EQ(profile.extraOptions, std::vector<std::string>({"-XX:+AlwaysPreTouch"}));
+    
+    // 无效的配置不修改原值
+    {
+        std::ofstream config(config_path);
+        config << "{\"jvm\": {\"max_heap\": \"lots\", \"gc\": \"g1\"}}";
+    }
+    EXPECT_FALSE(mods::LoadJvmProfile(config_path, profile));
+    EXPECT_EQ(profile.maxHeap, "2G");
+    EXPECT_EQ(profile.gc, mods::JvmGarbageCollector::ZGC);
+    mods::JvmGarbageCollector gc;
+    EXPECT_TRUE(mods::ParseJvmGarbageCollector("Shenandoah", gc));
+    EXPECT_EQ(gc, mods::JvmGarbageCollector::SHENANDOAH);
+    EXPECT_FALSE(mods::ParseJvmGarbageCollector("cms", gc));
+    
+    // 首次启动写入归档，归档存在后直接使用
+    mods::CdsArchiveMode mode;
+    std::vector<std::string> options = mods::BuildJvmOptions(profile, 0x1234, mode);
+    std::string archive = mods::GetCdsArchivePath(profile, 0x1234);
+    EXPECT_EQ(mode, mods::CdsArchiveMode::DUMP);
+    EXPECT_EQ(options, std::vector<std::string>({"-Xms256M", "-Xmx2G", "-XX:+UnlockExperimentalVMOptions",
+                                                 "-XX:+UseZGC", "-XX:ArchiveClassesAtExit=" + archive,
+                                                 "-XX:+AlwaysPreTouch"}));
+    {
+        std::ofstream jsa(archive, std::ios::binary);
+        jsa << "archive";
+    }
+    options = mods::BuildJvmOptions(profile, 0x1234, mode);
+    EXPECT_EQ(mode, mods::CdsArchiveMode::USE);
+    EXPECT_NE(std::find(options.begin(), options.end(), "-XX:SharedArchiveFile=" + archive), options.end());
+    
+    // 模组集合变化后生成新归档，旧归档被删除
+    options = mods::BuildJvmOptions(profile, 0x5678, mode);
+    EXPECT_EQ(mode, mods::CdsArchiveMode::DUMP);
+    EXPECT_FALSE(std::filesystem::exists(archive));
+    
+    profile.classDataSharing = false;
+    profile.gc = mods::JvmGarbageCollector::DEFAULT;
+    options = mods::BuildJvmOptions(profile, 0x5678, mode);
+    EXPECT_EQ(mode, mods::CdsArchiveMode::DISABLED);
+    EXPECT_EQ(options.size(), 3u);
+    
+    // 模组集合哈希随JAR的增加与内容变化而改变
+    mods::JavaModRuntime runtime;
+    std::string jar_path = CreateTestJar(mods_dir_ + "/cdsmod.jar", {{"fabric.mod.json", "{\"id\": \"cdsmod\"}"}});
+    uint64_t hash = runtime.ComputeModSetHash(mods_dir_);
+    EXPECT_EQ(runtime.ComputeModSetHash(mods_dir_), hash);
+    CreateTestJar(mods_dir_ + "/other.jar", {{"fabric.mod.json", "{\"id\": \"other\"}"}});
+    uint64_t added = runtime.ComputeModSetHash(mods_dir_);
+    EXPECT_NE(added, hash);
+    CreateTestJar(jar_path, {{"fabric.mod.json", "{\"id\": \"cdsmod\", \"version\": \"2\"}"}});
+    EXPECT_NE(runtime.ComputeModSetHash(mods_dir_), added);
+    
+    // 运行时按配置启动JVM
+    profile.classDataSharing = true;
+    runtime.SetJvmProfile(profile);
+    runtime.SetModsDirectory(mods_dir_);
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    EXPECT_EQ(runtime.GetCdsArchiveMode(), mods::CdsArchiveMode::DUMP);
+    const auto& jvm_options = runtime.GetJvmOptions();
+    EXPECT_NE(std::find(jvm_options.begin(), jvm_options.end(), "-Dminecraft.mods.dir=" + mods_dir_), jvm_options.end());
+    EXPECT_NE(std::find(jvm_options.begin(), jvm_options.end(), "-Xmx2G"), jvm_options.end());
+    runtime.Shutdown();
+}
+
+// 测试批量方块桥接
+TEST_F(CoreTest, BulkBlockBridge) {
+    mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    JNIEnv* env = runtime.GetEnv();
+    ASSERT_NE(env, nullptr);
+    
+    // 4x3x2的区域，int[]与直接缓冲区都按区域大小处理
+    const jint volume = 4 * 3 * 2;
+    jintArray blocks = env->NewIntArray(volume);
+    ASSERT_NE(blocks, nullptr);
+    EXPECT_EQ(mods::bridge::Java_SetBlocks(env, nullptr, 10, 64, -5, 4, 3, 2, blocks), volume);
+    EXPECT_EQ(mods::bridge::Java_GetBlocks(env, nullptr, 10, 64, -5, 4, 3, 2, blocks), volume);
+    
+    std::vector<int32_t> storage(volume + 1);
+    jobject buffer = env->NewDirectByteBuffer(storage.data(), volume * sizeof(int32_t));
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(mods::bridge::Java_SetBlocksBuffer(env, nullptr, 0, 0, 0, 2, 3, 4, buffer), volume);
+    EXPECT_EQ(mods::bridge::Java_GetBlocksBuffer(env, nullptr, 0, 0, 0, 2, 3, 4, buffer), volume);
+    
+    // 空区域、超出容量、非直接缓冲区与未对齐的地址被拒绝
+    EXPECT_EQ(mods::bridge::Java_GetBlocks(env, nullptr, 0, 0, 0, 0, 3, 2, blocks), -1);
+    EXPECT_EQ(mods::bridge::Java_GetBlocks(env, nullptr, 0, 0, 0, 5, 3, 2, blocks), -1);
+    EXPECT_EQ(mods::bridge::Java_SetBlocks(env, nullptr, 0, 0, 0, 65536, 65536, 2, blocks), -1);
+    EXPECT_EQ(mods::bridge::Java_SetBlocks(env, nullptr, 0, 0, 0, 4, 3, 2, nullptr), -1);
+    EXPECT_EQ(mods::bridge::Java_GetBlocksBuffer(env, nullptr, 0, 0, 0, 5, 3, 2, buffer), -1);
+    EXPECT_EQ(mods::bridge::Java_GetBlocksBuffer(env, nullptr, 0, 0, 0, 4, 3, 2, blocks), -1);
+    jobject unaligned = env->NewDirectByteBuffer(reinterpret_cast<char*>(storage.data()) + 1,
+                                                 volume * sizeof(int32_t));
+    EXPECT_EQ(mods::bridge::Java_SetBlocksBuffer(env, nullptr, 0, 0, 0, 4, 3, 2, unaligned), -1);
+    
+    env->DeleteLocalRef(unaligned);
+    env->DeleteLocalRef(buffer);
+    env->DeleteLocalRef(blocks);
+    runtime.Shutdown();
+}
+
+// 测试事件批处理队列
+TEST_F(CoreTest, EventBatchQueue) {
+    mods::EventBatchQueue queue(64, 3);
+    uint16_t block_update = queue.RegisterEventType("block_update");
+    uint16_t tick = queue.RegisterEventType("tick");
+    EXPECT_EQ(queue.RegisterEventType("block_update"), block_update);
+    EXPECT_EQ(queue.FindEventType("tick"), tick);
+    EXPECT_EQ(queue.FindEventType("missing"), -1);
+    
+    // 每条记录8字节头加12字节负载，一个缓冲区放3条
+    for (int32_t i = 0; i < 7; i++) {
+        int32_t position[3] = {i, i * 2, i * 3};
+        ASSERT_TRUE(queue.Push(block_update, position, sizeof(position)));
+    }
+    ASSERT_TRUE(queue.Push(tick, nullptr, 0));
+    EXPECT_EQ(queue.GetPendingCount(), 8u);
+    
+    // 缓冲区全部写满后拒绝新事件，大于缓冲区的事件也被拒绝
+    int32_t position[3] = {0, 0, 0};
+    EXPECT_TRUE(queue.Push(block_update, position, sizeof(position)));
+    EXPECT_FALSE(queue.Push(block_update, position, sizeof(position)));
+    std::vector<uint8_t> large(64);
+    EXPECT_FALSE(queue.Push(tick, large.data(), static_cast<uint32_t>(large.size())));
+    
+    // 批次按写入顺序交出，记录可按头逐条解析
+    std::vector<int32_t> xs;
+    int ticks = 0;
+    size_t batches = 0;
+    size_t flushed = queue.Flush([&](const mods::EventBatchQueue::Batch& batch) {
+        batches++;
+        uint32_t count = 0;
+        for (size_t offset = 0; offset < batch.bytes; count++) {
+            mods::EventRecordHeader header;
+            std::memcpy(&header, batch.data + offset, sizeof(header));
+            if (header.type == block_update) {
+                int32_t x;
+                std::memcpy(&x, batch.data + offset + sizeof(header), sizeof(x));
+                xs.push_back(x);
+            } else if (header.type == tick) {
+                ticks++;
+            }
+            offset += sizeof(header) + header.size;
+        }
+        EXPECT_EQ(count, batch.count);
+    });
+    EXPECT_EQ(flushed, 9u);
+    EXPECT_EQ(batches, 3u);
+    EXPECT_EQ(ticks, 1);
+    EXPECT_EQ(xs, (std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6, 0}));
+    EXPECT_EQ(queue.GetPendingCount(), 0u);
+    
+    // 分发后缓冲区可重新使用
+    EXPECT_TRUE(queue.Push(tick, nullptr, 0));
+    EXPECT_EQ(queue.Flush(nullptr), 1u);
+    EXPECT_EQ(queue.Flush(nullptr), 0u);
+}
+
 // 测试网易模组运行时初始化
 TEST_F(CoreTest, NeteaseModRuntimeInitialization) {
     // 创建网易模组运行时
@@ -554,6 +2100,347 @@ TEST_F(CoreTest, ResourcePackSorting) {
     manager.Shutdown();
 }
 
+// 测试纹理图集构建与增量更新
+TEST_F(CoreTest, TextureAtlasBuild) {
+    std::string blocks_dir = temp_dir_ + "/textures/blocks";
+    std::filesystem::create_directories(blocks_dir);
+    
+    // 创建100个16x16纹理和1个过大的纹理
+    auto make_texture = [](uint32_t size, uint8_t value) {
+        resources::Image image;
+        image.width = size;
+        image.height = size;
+        image.pixels.assign(size * size * 4, value);
+        return image;
+    };
+    for (int i = 0; i < 100; i++) {
+        resources::EncodePNGFile(blocks_dir + "/block" + std::to_string(i) + ".png",
+                                 make_texture(16, static_cast<uint8_t>(i)));
+    }
+    resources::EncodePNGFile(blocks_dir + "/large.png", make_texture(256, 0));
+    
+    std::string atlas_dir = output_dir_ + "/atlas";
+    resources::TextureAtlasBuilder builder;
+    builder.AddDirectory(blocks_dir, "blocks");
+    ASSERT_TRUE(builder.Build(atlas_dir, "blocks")) << "Failed to build atlas";
+    
+    EXPECT_EQ(builder.GetStats().packed, 100) << "Packed texture count mismatch";
+    EXPECT_EQ(builder.GetStats().skipped, 1) << "Large texture should not be packed";
+    EXPECT_EQ(builder.GetStats().pages, 1) << "Small textures should fit in one page";
+    ASSERT_TRUE(std::filesystem::exists(atlas_dir + "/blocks.atlas.json")) << "UV mapping not written";
+    
+    // 验证像素位置与UV映射一致
+    resources::Image page;
+    ASSERT_TRUE(resources::DecodePNGFile(atlas_dir + "/blocks_0.png", page));
+    for (const auto& region : builder.GetRegions()) {
+        int index = std::stoi(region.name.substr(std::string("blocks/block").size()));
+        EXPECT_EQ(page.pixels[(region.y * page.width + region.x) * 4], index) << region.name;
+    }
+    
+    // 修改单个纹理后增量重建
+    resources::EncodePNGFile(blocks_dir + "/block7.png", make_texture(16, 200));
+    resources::TextureAtlasBuilder rebuilder;
+    rebuilder.AddDirectory(blocks_dir, "blocks");
+    ASSERT_TRUE(rebuilder.Build(atlas_dir, "blocks")) << "Failed to rebuild atlas";
+    EXPECT_TRUE(rebuilder.GetStats().incremental) << "Rebuild should be incremental";
+    EXPECT_EQ(rebuilder.GetStats().updated, 1) << "Only the changed texture should be updated";
+    
+    // 留白变化后UV随之变化，必须完整重建
+    resources::AtlasOptions padded;
+    padded.padding = 2;
+    resources::TextureAtlasBuilder repadder(padded);
+    repadder.AddDirectory(blocks_dir, "blocks");
+    ASSERT_TRUE(repadder.Build(atlas_dir, "blocks")) << "Failed to rebuild atlas with new padding";
+    EXPECT_FALSE(repadder.GetStats().incremental) << "Padding change should force a full rebuild";
+    std::vector<resources::AtlasPage> pages;
+    std::vector<resources::AtlasRegion> regions;
+    uint32_t padding = 0;
+    ASSERT_TRUE(resources::TextureAtlasBuilder::LoadMapping(atlas_dir + "/blocks.atlas.json", pages, regions, &padding));
+    EXPECT_EQ(padding, 2u);
+    
+    // 纹理定义改为引用图集页与UV，未入图集的纹理保持原样
+    std::string terrain_path = output_dir_ + "/terrain_texture.json";
+    {
+        std::ofstream terrain(terrain_path);
+        terrain << R"({"resource_pack_name": "mod", "texture_name": "atlas.terrain", "texture_data": {
+            "alias": {"textures": "textures/blocks/block3"},
+            "variants": {"textures": ["textures/blocks/block4.png", {"path": "textures/blocks/block5", "overlay_color": "#ffffff"}]},
+            "big": {"textures": "textures/blocks/large"}}})";
+    }
+    ASSERT_TRUE(resources::WriteTextureDefinitions(terrain_path, "atlas.terrain", "textures/atlas",
+                                                   repadder.GetPages(), repadder.GetRegions()));
+    nlohmann::json terrain = nlohmann::json::parse(std::ifstream(terrain_path));
+    auto& data = terrain["texture_data"];
+    const resources::AtlasRegion* block3 = nullptr;
+    for (const auto& region : repadder.GetRegions()) {
+        if (region.name == "blocks/block3") {
+            block3 = &region;
+        }
+    }
+    ASSERT_NE(block3, nullptr);
+    EXPECT_EQ(data["alias"]["textures"]["path"], "textures/atlas/blocks_0");
+    EXPECT_EQ(data["alias"]["textures"]["uv"], nlohmann::json({block3->x, block3->y}));
+    EXPECT_EQ(data["alias"]["textures"]["uv_size"], nlohmann::json({16, 16}));
+    EXPECT_EQ(data["variants"]["textures"][0]["path"], "textures/atlas/blocks_0");
+    EXPECT_EQ(data["variants"]["textures"][1]["overlay_color"], "#ffffff");
+    EXPECT_EQ(data["variants"]["textures"][1]["path"], "textures/atlas/blocks_0");
+    EXPECT_EQ(data["big"]["textures"], "textures/blocks/large");
+    EXPECT_EQ(terrain["resource_pack_name"], "mod");
+    // 未被引用的纹理以短名新增，已引用的不重复添加
+    EXPECT_EQ(data["block0"]["textures"]["path"], "textures/atlas/blocks_0");
+    EXPECT_FALSE(data.contains("block3"));
+    EXPECT_EQ(data.size(), 3u + 97u);
+}
+
+// 测试GPU纹理压缩输出
+TEST_F(CoreTest, TextureCompression) {
+    // 非4对齐尺寸，验证边缘块补齐
+    resources::Image image;
+    image.width = 18;
+    image.height = 10;
+    image.pixels.resize(image.width * image.height * 4);
+    for (uint32_t i = 0; i < image.width * image.height; i++) {
+        image.pixels[i * 4 + 0] = static_cast<uint8_t>(i * 3);
+        image.pixels[i * 4 + 1] = static_cast<uint8_t>(i * 5);
+        image.pixels[i * 4 + 2] = 128;
+        image.pixels[i * 4 + 3] = 255;
+    }
+    
+    const size_t expected_size = 5 * 3 * 16;
+    for (auto format : {resources::CompressedFormat::ETC2_RGBA8,
+                        resources::CompressedFormat::ASTC_4x4,
+                        resources::CompressedFormat::BC7}) {
+        std::vector<uint8_t> data;
+        ASSERT_TRUE(resources::CompressImage(image, format, resources::CompressionPreset::FAST, data));
+        EXPECT_EQ(data.size(), expected_size) << resources::CompressedFormatSuffix(format);
+    }
+    
+    // 通过pack_config.json开启压缩后，转换PNG会额外输出KTX
+    std::string input_dir = temp_dir_ + "/compress_pack";
+    std::filesystem::create_directories(input_dir);
+    resources::EncodePNGFile(input_dir + "/stone.png", image);
+    std::ofstream(input_dir + "/pack_config.json")
+        << R"({"texture_compression": {"enabled": true, "preset": "fast", "formats": ["bc7", "etc2"]}})";
+    
+    std::string output_dir = output_dir_ + "/compress_pack";
+    resources::ResourceManager::instance().BatchConvert(input_dir, output_dir);
+    ASSERT_TRUE(std::filesystem::exists(output_dir + "/stone.png")) << "PNG fallback missing";
+    ASSERT_TRUE(std::filesystem::exists(output_dir + "/stone.bc7.ktx")) << "BC7 output missing";
+    ASSERT_TRUE(std::filesystem::exists(output_dir + "/stone.etc2.ktx")) << "ETC2 output missing";
+    
+    // KTX头(64字节) + imageSize(4字节) + 数据
+    EXPECT_EQ(std::filesystem::file_size(output_dir + "/stone.bc7.ktx"), 64 + 4 + expected_size);
+    std::ifstream ktx(output_dir + "/stone.bc7.ktx", std::ios::binary);
+    char identifier[12];
+    ktx.read(identifier, sizeof(identifier));
+    EXPECT_EQ(std::string(identifier + 1, 6), "KTX 11") << "KTX identifier mismatch";
+    
+    // 配置只作用于所在的资源包，之后转换的资源包不再压缩
+    std::string plain_dir = temp_dir_ + "/plain_pack";
+    std::filesystem::create_directories(plain_dir);
+    resources::EncodePNGFile(plain_dir + "/dirt.png", image);
+    std::string plain_output = output_dir_ + "/plain_pack";
+    resources::ResourceManager::instance().BatchConvert(plain_dir, plain_output);
+    EXPECT_TRUE(std::filesystem::exists(plain_output + "/dirt.png"));
+    EXPECT_FALSE(std::filesystem::exists(plain_output + "/dirt.bc7.ktx")) << "Pack config leaked into next pack";
+}
+
+// 测试OBJ模型转换
+TEST_F(CoreTest, ObjModelConversion) {
+    // 浮点解析
+    float value = 0.0f;
+    std::string number = "-1.25e2";
+    EXPECT_EQ(resources::ParseFloat(number.data(), number.data() + number.size(), value),
+              number.data() + number.size());
+    EXPECT_FLOAT_EQ(value, -125.0f);
+    
+    // 四边形、重复坐标的三角形、无法线的五边形、越界索引的面
+    std::string obj_path = temp_dir_ + "/model.obj";
+    std::ofstream obj(obj_path);
+    obj << "# test model\n";
+    obj << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 0\n";
+    obj << "vt 0 0\nvt 1 0\nvt 1 1\n";
+    obj << "vn 0 0 -1\n";
+    obj << "f 1/1/1 2/2/1 3/3/1 4/1/1\n";
+    obj << "f 5/1/1 -4/2/1 -3/3/1\n";
+    obj << "f 1 2 3 4 2\n";
+    obj << "f 9 1 2";
+    obj.close();
+    
+    std::string geometry_path = output_dir_ + "/model.geo.json";
+    resources::ObjModelConverter converter;
+    ASSERT_TRUE(converter.Convert(obj_path, geometry_path)) << "Failed to convert OBJ";
+    
+    const auto& stats = converter.GetStats();
+    EXPECT_EQ(stats.faces, 3) << "Invalid face should be skipped";
+    EXPECT_EQ(stats.polys, 5) << "Pentagon should be split into triangles";
+    EXPECT_EQ(stats.positions, 4) << "Duplicate position should be merged";
+    EXPECT_EQ(stats.normals, 2) << "Missing normals should use the face normal";
+    
+    std::ifstream geometry(geometry_path);
+    std::stringstream content;
+    content << geometry.rdbuf();
+    EXPECT_NE(content.str().find("\"identifier\":\"geometry.model\""), std::string::npos);
+    EXPECT_NE(content.str().find("\"poly_mesh\""), std::string::npos);
+    
+    // 超过64个顶点的面完整拆分，不截断
+    std::string disc_path = temp_dir_ + "/disc.obj";
+    std::ofstream disc(disc_path);
+    const int sides = 100;
+    for (int i = 0; i < sides; i++) {
+        float angle = 2.0f * 3.14159265f * i / sides;
+        disc << "v " << std::cos(angle) << " " << std::sin(angle) << " 0\n";
+    }
+    disc << "f";
+    for (int i = 1; i <= sides; i++) {
+        disc << " " << i;
+    }
+    disc << "\n";
+    disc.close();
+    ASSERT_TRUE(converter.Convert(disc_path, output_dir_ + "/disc.geo.json"));
+    EXPECT_EQ(converter.GetStats().faces, 1u);
+    EXPECT_EQ(converter.GetStats().polys, static_cast<size_t>(sides - 2));
+    EXPECT_EQ(converter.GetStats().positions, static_cast<size_t>(sides));
+}
+
+// 测试声音转换流水线
+TEST_F(CoreTest, AudioConversion) {
+    // 48kHz立体声1kHz正弦
+    resources::AudioBuffer source;
+    source.sampleRate = 48000;
+    source.channels = 2;
+    source.samples.resize(48000 * 2);
+    for (size_t i = 0; i < 48000; i++) {
+        float v = 0.5f * std::sin(2.0f * 3.14159265f * 1000.0f * i / 48000.0f);
+        source.samples[i * 2] = v;
+        source.samples[i * 2 + 1] = v;
+    }
+    
+    resources::AudioBuffer mono;
+    resources::DownmixAudio(source, 1, mono);
+    ASSERT_EQ(mono.FrameCount(), 48000);
+    EXPECT_NEAR(mono.samples[100], source.samples[200], 1e-6f);
+    
+    // 重采样后峰值幅度保持不变
+    resources::AudioBuffer resampled;
+    resources::ResampleAudio(mono, 22050, resampled);
+    ASSERT_EQ(resampled.FrameCount(), 22050);
+    float peak = 0.0f;
+    for (size_t i = 100; i < resampled.samples.size() - 100; i++) {
+        peak = std::max(peak, std::fabs(resampled.samples[i]));
+    }
+    EXPECT_NEAR(peak, 0.5f, 0.01f);
+    
+    // WAV写出/读回
+    std::string sounds_dir = temp_dir_ + "/sounds";
+    std::filesystem::create_directories(sounds_dir);
+    ASSERT_TRUE(resources::EncodePCM16WAVFile(sounds_dir + "/tone.wav", source));
+    resources::AudioBuffer decoded;
+    ASSERT_TRUE(resources::DecodeWAVFile(sounds_dir + "/tone.wav", decoded));
+    EXPECT_EQ(decoded.channels, 2);
+    EXPECT_EQ(decoded.sampleRate, 48000u);
+    EXPECT_NEAR(decoded.samples[202], source.samples[202], 1e-4f);
+    
+    // 批量转换：目标格式为PCM16 WAV时原文件直接复制，降采样时需要转码
+    std::ofstream(sounds_dir + "/music.ogg") << "OggS";
+    std::string output_dir = output_dir_ + "/sounds";
+    std::filesystem::create_directories(output_dir);
+    
+    resources::AudioConverter converter;
+    resources::AudioConvertOptions options;
+    options.codec = resources::AudioCodec::PCM16_WAV;
+    converter.SetOptions(options);
+    auto stats = converter.ConvertBatch({
+        {sounds_dir + "/tone.wav", output_dir + "/tone.wav"},
+        {sounds_dir + "/music.ogg", output_dir + "/music.ogg"}
+    });
+    EXPECT_EQ(stats.passedThrough, 2);
+    EXPECT_EQ(stats.failed, 0);
+    
+    options.sampleRate = 22050;
+    options.channels = 1;
+    converter.SetOptions(options);
+    std::string result = converter.Convert(sounds_dir + "/tone.wav", output_dir + "/tone_small.wav");
+    ASSERT_FALSE(result.empty()) << "Failed to convert WAV";
+    resources::AudioBuffer converted;
+    ASSERT_TRUE(resources::DecodeWAVFile(result, converted));
+    EXPECT_EQ(converted.channels, 1);
+    EXPECT_EQ(converted.sampleRate, 22050u);
+    
+    // 批量结果与任务一一对应，失败的任务没有输出
+    auto batch = converter.ConvertBatch({
+        {sounds_dir + "/tone.wav", output_dir + "/tone_batch.wav"},
+        {sounds_dir + "/missing.wav", output_dir + "/missing.wav"}
+    });
+    ASSERT_EQ(batch.outputs.size(), 2);
+    EXPECT_FALSE(batch.outputs[0].empty());
+    EXPECT_TRUE(batch.outputs[1].empty());
+    EXPECT_EQ(batch.failed, 1);
+    
+    // 只支持1或2声道输出：多声道下混到其他目标时按立体声处理，转换与配置均拒绝
+    resources::AudioBuffer surround;
+    surround.sampleRate = 48000;
+    surround.channels = 6;
+    surround.samples.assign(480 * 6, 0.25f);
+    resources::AudioBuffer mixed;
+    resources::DownmixAudio(surround, 4, mixed);
+    EXPECT_EQ(mixed.channels, 2);
+    EXPECT_EQ(mixed.samples.size(), 480 * 2);
+    
+    options.channels = 4;
+    converter.SetOptions(options);
+    EXPECT_TRUE(converter.Convert(sounds_dir + "/tone.wav", output_dir + "/tone_quad.wav").empty());
+    
+    std::string config_path = temp_dir_ + "/pack_config.json";
+    std::ofstream(config_path) << R"({"audio": {"channels": 6, "sample_rate": 22050}})";
+    resources::ResourceConverter resourceConverter;
+    EXPECT_FALSE(resourceConverter.LoadPackConfig(config_path));
+    EXPECT_EQ(resourceConverter.GetAudioOptions().channels, 0);
+    EXPECT_EQ(resourceConverter.GetAudioOptions().sampleRate, 0u);
+}
+
+// 测试语言文件流式转换
+TEST_F(CoreTest, LangConversion) {
+    EXPECT_EQ(resources::MapLangKey("block.minecraft.stone"), "tile.stone");
+    EXPECT_EQ(resources::MapLangKey("item.minecraft.diamond"), "item.diamond");
+    EXPECT_EQ(resources::MapLangKey("gui.testmod.title"), "gui.testmod.title");
+    EXPECT_EQ(resources::BedrockLangName("zh_cn"), "zh_CN");
+    
+    // 带BOM，包含各类转义、嵌套对象与非字符串值
+    std::string json_path = temp_dir_ + "/en_us.json";
+    std::ofstream json(json_path, std::ios::binary);
+    json << "\xEF\xBB\xBF{\n";
+    json << "  \"block.minecraft.stone\": \"Stone\",\n";
+    json << "  \"gui.quote\": \"Say \\\"hi\\\" \\\\ \\/\",\n";
+    json << "  \"gui.lines\": \"Line1\\nLine2\\tEnd\",\n";
+    json << "  \"gui.unicode\": \"caf\\u00e9 \\ud83d\\ude00\",\n";
+    json << "  \"gui.nested\": {\"ignored\": \"value\"},\n";
+    json << "  \"gui.number\": 42\n";
+    json << "}\n";
+    json.close();
+    
+    std::string lang_path = output_dir_ + "/en_US.lang";
+    resources::LangConvertStats stats;
+    ASSERT_TRUE(resources::ConvertJsonLangFile(json_path, lang_path, &stats)) << "Failed to convert lang file";
+    EXPECT_EQ(stats.entries, 4);
+    EXPECT_EQ(stats.skipped, 2);
+    
+    std::ifstream lang(lang_path, std::ios::binary);
+    std::stringstream content;
+    content << lang.rdbuf();
+    EXPECT_EQ(content.str(),
+              "tile.stone=Stone\n"
+              "gui.quote=Say \"hi\" \\ /\n"
+              "gui.lines=Line1\\nLine2 End\n"
+              "gui.unicode=caf\xC3\xA9 \xF0\x9F\x98\x80\n");
+    
+    // 格式错误时不留下不完整的输出
+    std::string broken_path = temp_dir_ + "/broken.json";
+    std::ofstream(broken_path) << "{\"a\": \"unterminated}";
+    EXPECT_FALSE(resources::ConvertJsonLangFile(broken_path, output_dir_ + "/broken.lang"));
+    EXPECT_FALSE(std::filesystem::exists(output_dir_ + "/broken.lang"));
+}
+
 // 测试CMC文件格式
 TEST_F(CoreTest, CMCFormat) {
     // 创建CMC打包器
@@ -9,20 +9,41 @@
 #include <packer/windows/shader_packer.h>
 #include <packer/windows/unified_packer.h>
 #include <core/mods/java_runtime.h>
+#include <core/mods/jar_scanner.h>
+#include <core/mods/mod_dependency_graph.h>
+#include <core/mods/mod_profiler.h>
+#include <core/mods/jvm_profile.h>
 #include <core/mods/netease_runtime.h>
 #include <core/resources/resource_manager.h>
+#include <core/resources/model_converter.h>
+#include <core/resources/audio_converter.h>
+#include <core/resources/lang_converter.h>
 #include <core/render/shader_converter.h>
+#include <core/render/glsl_rewriter.h>
+#include <core/render/glsl_preprocessor.h>
+#include <core/render/shader_cache.h>
+#include <core/render/uniform_layout.h>
+#include <core/render/shader_source_cache.h>
 #include <common/cmc_format.h>
+#include <common/thread_pool.h>
+#include <tests/common/test_jar.h>
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <sstream>
 #include <chrono>
+#include <regex>
+#include <nlohmann/json.hpp>
 #include <thread>
 
 namespace mcu {
 namespace performance {
 namespace test {
 
+using mcu::test::CreateTestJar;
+
 class PerformanceTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -587,6 +608,1204 @@ TEST_F(PerformanceTest, LongRunningStabilityTest) {
     EXPECT_LT(duration.count(), 30000) << "Long running test took too long";
 }
 
+// 性能测试16：大型OBJ模型转换性能
+TEST_F(PerformanceTest, ObjModelConversionPerformance) {
+    // 生成500x500网格（约25万顶点、25万四边形）
+    const int grid = 500;
+    std::string obj_path = temp_dir_ + "/grid.obj";
+    {
+        std::ofstream obj(obj_path);
+        for (int y = 0; y <= grid; y++) {
+            for (int x = 0; x <= grid; x++) {
+                obj << "v " << x * 0.01 << " " << (x % 7) * 0.05 << " " << y * 0.01 << "\n";
+                obj << "vt " << x / double(grid) << " " << y / double(grid) << "\n";
+            }
+        }
+        obj << "vn 0 1 0\n";
+        for (int y = 0; y < grid; y++) {
+            for (int x = 0; x < grid; x++) {
+                int a = y * (grid + 1) + x + 1;
+                int b = a + grid + 1;
+                obj << "f " << a << "/" << a << "/1 " << a + 1 << "/" << a + 1 << "/1 "
+                    << b + 1 << "/" << b + 1 << "/1 " << b << "/" << b << "/1\n";
+            }
+        }
+    }
+    
+    // 基准：getline + stringstream逐行解析，面数据全部保存在内存后再输出
+    auto naive_start = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream in(obj_path);
+        std::vector<float> positions, uvs, normals;
+        std::vector<std::vector<int>> faces;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ss(line);
+            std::string tag;
+            ss >> tag;
+            float a = 0, b = 0, c = 0;
+            if (tag == "v" || tag == "vn") {
+                ss >> a >> b >> c;
+                auto& target = tag == "v" ? positions : normals;
+                target.insert(target.end(), {a, b, c});
+            } else if (tag == "vt") {
+                ss >> a >> b;
+                uvs.insert(uvs.end(), {a, b});
+            } else if (tag == "f") {
+                std::vector<int> face;
+                std::string token;
+                while (ss >> token) {
+                    std::replace(token.begin(), token.end(), '/', ' ');
+                    std::istringstream ts(token);
+                    int v = 0, vt = 0, vn = 0;
+                    ts >> v >> vt >> vn;
+                    face.insert(face.end(), {v - 1, vn - 1, vt - 1});
+                }
+                faces.push_back(face);
+            }
+        }
+        std::ofstream out(output_dir_ + "/grid_naive.geo.json");
+        out << "{\"polys\":[";
+        for (size_t i = 0; i < faces.size(); i++) {
+            out << (i ? ",[" : "[");
+            for (size_t k = 0; k < faces[i].size(); k += 3) {
+                out << (k ? ",[" : "[") << faces[i][k] << "," << faces[i][k + 1] << "," << faces[i][k + 2] << "]";
+            }
+            out << "]";
+        }
+        out << "],\"positions\":[";
+        for (size_t i = 0; i < positions.size(); i += 3) {
+            out << (i ? ",[" : "[") << positions[i] << "," << positions[i + 1] << "," << positions[i + 2] << "]";
+        }
+        out << "]}";
+    }
+    auto naive_end = std::chrono::high_resolution_clock::now();
+    
+    // 流式转换
+    core::resources::ObjModelConverter converter;
+    auto start = std::chrono::high_resolution_clock::now();
+    bool result = converter.Convert(obj_path, output_dir_ + "/grid.geo.json");
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    ASSERT_TRUE(result) << "Failed to convert OBJ";
+    EXPECT_EQ(converter.GetStats().faces, static_cast<size_t>(grid * grid));
+    
+    auto naive_duration = std::chrono::duration_cast<std::chrono::milliseconds>(naive_end - naive_start);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Naive OBJ conversion time: " << naive_duration.count() << " ms" << std::endl;
+    std::cout << "Streaming OBJ conversion time: " << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：流式转换至少比逐行stringstream快2倍
+    EXPECT_LT(duration.count() * 2, naive_duration.count()) << "Streaming OBJ conversion not fast enough";
+}
+
+// 性能测试17：批量声音转码性能
+TEST_F(PerformanceTest, AudioBatchConversionPerformance) {
+    // 生成32个5秒48kHz立体声WAV
+    const int file_count = 32;
+    core::resources::AudioBuffer source;
+    source.sampleRate = 48000;
+    source.channels = 2;
+    source.samples.resize(48000 * 5 * 2);
+    for (size_t i = 0; i < source.samples.size(); i++) {
+        source.samples[i] = 0.3f * std::sin(i * 0.01f);
+    }
+    
+    std::string sounds_dir = temp_dir_ + "/sounds";
+    std::filesystem::create_directories(sounds_dir);
+    std::vector<core::resources::AudioJob> jobs;
+    for (int i = 0; i < file_count; i++) {
+        std::string path = sounds_dir + "/sound" + std::to_string(i) + ".wav";
+        core::resources::EncodePCM16WAVFile(path, source);
+        jobs.push_back({path, output_dir_ + "/sound" + std::to_string(i) + ".wav"});
+    }
+    
+    // 下混为单声道并降采样到22.05kHz
+    core::resources::AudioConverter converter;
+    core::resources::AudioConvertOptions options;
+    options.sampleRate = 22050;
+    options.channels = 1;
+    converter.SetOptions(options);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    auto stats = converter.ConvertBatch(jobs);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    EXPECT_EQ(stats.converted, static_cast<size_t>(file_count));
+    
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Audio batch conversion time (" << file_count << " files): " << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：32个5秒音频应在2秒内完成
+    EXPECT_LT(duration.count(), 2000) << "Audio batch conversion took too long";
+}
+
+// 性能测试18：语言文件转换性能（流式 vs DOM）
+TEST_F(PerformanceTest, LangConversionPerformance) {
+    // 生成50000条目的语言文件
+    const int entry_count = 50000;
+    std::string json_path = temp_dir_ + "/en_us.json";
+    {
+        std::ofstream json(json_path);
+        json << "{\n";
+        for (int i = 0; i < entry_count; i++) {
+            json << "  \"block.minecraft.test_block_" << i << "\": \"Test Block \\\"" << i
+                 << "\\\" \\u00e9\\nSecond line\"" << (i + 1 < entry_count ? ",\n" : "\n");
+        }
+        json << "}\n";
+    }
+    
+    // 基准：nlohmann DOM + 正则替换键名
+    auto dom_start = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream file(json_path);
+        nlohmann::json lang = nlohmann::json::parse(file);
+        std::ofstream out(output_dir_ + "/en_US_dom.lang");
+        for (auto& [key, value] : lang.items()) {
+            if (value.is_string()) {
+                std::string new_key = std::regex_replace(key, std::regex("block\\.minecraft\\."), "tile.");
+                new_key = std::regex_replace(new_key, std::regex("item\\.minecraft\\."), "item.");
+                new_key = std::regex_replace(new_key, std::regex("entity\\.minecraft\\."), "entity.");
+                out << new_key << "=" << core::resources::EscapeLangValue(value.get<std::string>()) << "\n";
+            }
+        }
+    }
+    auto dom_end = std::chrono::high_resolution_clock::now();
+    
+    // 流式转换
+    core::resources::LangConvertStats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+    bool result = core::resources::ConvertJsonLangFile(json_path, output_dir_ + "/en_US.lang", &stats);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    ASSERT_TRUE(result) << "Failed to convert lang file";
+    EXPECT_EQ(stats.entries, static_cast<size_t>(entry_count));
+    
+    auto dom_duration = std::chrono::duration_cast<std::chrono::milliseconds>(dom_end - dom_start);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "DOM lang conversion time: " << dom_duration.count() << " ms" << std::endl;
+    std::cout << "Streaming lang conversion time: " << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：流式转换至少比DOM方式快3倍
+    EXPECT_LT(duration.count() * 3, dom_duration.count()) << "Streaming lang conversion not fast enough";
+}
+
+// 逐条regex_replace实现，作为改写结果与耗时的基准
+static std::string LegacyRegexConvertGLSL(const std::string& source, core::render::ShaderStage stage) {
+    static const char* const kCommonRules[][2] = {
+        {"uniform\\s+mat4\\s+gbufferModelView;", "uniform mat4 u_modelViewMatrix;"},
+        {"uniform\\s+mat4\\s+gbufferProjection;", "uniform mat4 u_projectionMatrix;"},
+        {"uniform\\s+mat4\\s+gbufferProjectionInverse;", "uniform mat4 u_projectionMatrixInverse;"},
+        {"uniform\\s+mat4\\s+gbufferModelViewInverse;", "uniform mat4 u_modelViewMatrixInverse;"},
+        {"uniform\\s+mat4\\s+gbufferPreviousModelView;", "uniform mat4 u_previousModelViewMatrix;"},
+        {"uniform\\s+mat4\\s+gbufferPreviousProjection;", "uniform mat4 u_previousProjectionMatrix;"},
+        {"uniform\\s+mat4\\s+gbufferTextureMatrix;", "uniform mat4 u_textureMatrix;"},
+        {"uniform\\s+float\\s+frameTimeCounter;", "uniform float u_time;"},
+        {"uniform\\s+float\\s+sunAngle;", "uniform float u_sunAngle;"},
+        {"uniform\\s+float\\s+shadowAngle;", "uniform float u_shadowAngle;"},
+        {"uniform\\s+vec2\\s+viewWidth;", "uniform vec2 u_viewportSize;"},
+        {"uniform\\s+vec2\\s+viewHeight;", "uniform vec2 u_viewportSize;"},
+        {"uniform\\s+vec3\\s+cameraPosition;", "uniform vec3 u_cameraPosition;"},
+        {"uniform\\s+vec3\\s+previousCameraPosition;", "uniform vec3 u_previousCameraPosition;"},
+        {"uniform\\s+vec3\\s+sunPosition;", "uniform vec3 u_sunPosition;"},
+        {"uniform\\s+vec3\\s+moonPosition;", "uniform vec3 u_moonPosition;"},
+        {"uniform\\s+vec3\\s+shadowLightPosition;", "uniform vec3 u_shadowLightPosition;"},
+        {"uniform\\s+sampler2D\\s+texture;", "uniform sampler2D u_texture;"},
+        {"uniform\\s+sampler2D\\s+normals;", "uniform sampler2D u_normalMap;"},
+        {"uniform\\s+sampler2D\\s+specular;", "uniform sampler2D u_specularMap;"},
+        {"uniform\\s+sampler2D\\s+shadow;", "uniform sampler2D u_shadowMap;"},
+        {"uniform\\s+sampler2D\\s+shadowcolor0;", "uniform sampler2D u_shadowColorMap;"},
+        {"uniform\\s+sampler2D\\s+shadowcolor1;", "uniform sampler2D u_shadowColorMap1;"},
+    };
+    static const char* const kVertexRules[][2] = {
+        {"attribute\\s+vec3\\s+position;", "in vec3 a_position;"},
+        {"attribute\\s+vec4\\s+color;", "in vec4 a_color;"},
+        {"attribute\\s+vec2\\s+texcoord;", "in vec2 a_texCoord;"},
+        {"attribute\\s+vec2\\s+lmcoord;", "in vec2 a_lightMapCoord;"},
+        {"attribute\\s+vec3\\s+normal;", "in vec3 a_normal;"},
+        {"attribute\\s+vec4\\s+tangent;", "in vec4 a_tangent;"},
+        {"varying\\s+(\\w+)\\s+(\\w+);", "out $1 $2;"},
+    };
+    static const char* const kFunctionRules[][2] = {
+        {"ftransform\\(\\)", "(u_projectionMatrix * u_modelViewMatrix * vec4(a_position, 1.0))"},
+        {"texture2D\\s*\\(", "texture("},
+        {"texture2DLod\\s*\\(", "textureLod("},
+        {"shadow2D\\s*\\(", "texture("},
+        {"shadow2DLod\\s*\\(", "textureLod("},
+    };
+    
+    std::string converted = source;
+    std::string header;
+    
+    // 声明改名后，对该变量的引用（非函数调用）随之改名
+    auto applyDeclRule = [&converted](const char* const rule[2]) {
+        std::regex pattern(rule[0]);
+        if (!std::regex_search(converted, pattern)) {
+            return;
+        }
+        converted = std::regex_replace(converted, pattern, rule[1]);
+        std::string from(rule[0]);
+        if (from.find('(') != std::string::npos) {
+            return;
+        }
+        from = from.substr(from.rfind('+') + 1);
+        from.pop_back();
+        std::string to(rule[1]);
+        to = to.substr(to.rfind(' ') + 1);
+        to.pop_back();
+        // 成员访问（前面是'.'）不改名
+        converted = std::regex_replace(converted, std::regex("((?:^|[^.\\s])\\s*)\\b" + from + "\\b(?!\\s*\\()"),
+                                       "$1" + to);
+    };
+    
+    converted = std::regex_replace(converted, std::regex("#version\\s+\\d+([ \\t]+(core|compatibility|es)\\b)?"),
+                                   "#version 330 core");
+    for (const auto& rule : kCommonRules) {
+        applyDeclRule(rule);
+    }
+    if (stage == core::render::ShaderStage::VERTEX) {
+        for (const auto& rule : kVertexRules) {
+            applyDeclRule(rule);
+        }
+    } else if (stage == core::render::ShaderStage::FRAGMENT) {
+        converted = std::regex_replace(converted, std::regex("varying\\s+(\\w+)\\s+(\\w+);"), "in $1 $2;");
+        converted = std::regex_replace(converted, std::regex("gl_FragColor"), "fragColor");
+        if (converted.find("out vec4 fragColor;") == std::string::npos) {
+            header += "out vec4 fragColor;\n";
+        }
+    }
+    bool ftransform = converted.find("ftransform()") != std::string::npos;
+    for (const auto& rule : kFunctionRules) {
+        converted = std::regex_replace(converted, std::regex(rule[0]), rule[1]);
+    }
+    if (stage == core::render::ShaderStage::VERTEX && ftransform) {
+        for (const char* decl : {"uniform mat4 u_projectionMatrix;", "uniform mat4 u_modelViewMatrix;", "in vec3 a_position;"}) {
+            if (converted.find(decl) == std::string::npos) {
+                header += decl;
+                header += '\n';
+            }
+        }
+    }
+    // 补充的声明插在#version行之后
+    size_t version = converted.find("#version 330 core");
+    size_t line = version == std::string::npos ? 0 : converted.find('\n', version) + 1;
+    converted.insert(line, header);
+    return converted;
+}
+
+// 性能测试19：大型光影着色器单遍改写性能
+TEST_F(PerformanceTest, GLSLRewritePerformance) {
+    // 生成接近大型光影包（BSL、Complementary）规模的着色器源码
+    std::ostringstream source;
+    source << "#version 120\n\n";
+    source << "uniform mat4 gbufferModelView;\nuniform mat4 gbufferProjectionInverse;\n";
+    source << "uniform float frameTimeCounter;\nuniform vec3 cameraPosition;\nuniform sampler2D texture;\n";
+    source << "attribute vec4 color;\nattribute vec2 texcoord;\n";
+    for (int i = 0; i < 4000; i++) {
+        source << "varying vec4 v_data" << i << ";\n";
+        source << "vec4 sample" << i << "(vec2 uv) {\n";
+        source << "    vec4 albedo = texture2D(texture, uv) * texture2DLod (texture, uv, 2.0);\n";
+        source << "    float shade = shadow2D(shadowtex0, vec3(uv, 0.5)).r; // gl_FragColor\n";
+        source << "    return albedo * shade + ftransform() * 0.0;\n";
+        source << "}\n";
+    }
+    std::string glsl = source.str();
+    
+    const core::render::ShaderStage stages[] = {core::render::ShaderStage::VERTEX,
+                                                core::render::ShaderStage::FRAGMENT};
+    for (core::render::ShaderStage stage : stages) {
+        auto legacy_start = std::chrono::high_resolution_clock::now();
+        std::string expected = LegacyRegexConvertGLSL(glsl, stage);
+        auto legacy_end = std::chrono::high_resolution_clock::now();
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        std::string converted = core::render::RewriteGLSLForRenderDragon(glsl, stage);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        // 输出必须与逐条正则替换逐字节一致
+        ASSERT_EQ(converted, expected) << "Single-pass rewrite differs from regex chain";
+        
+        auto legacy_duration = std::chrono::duration_cast<std::chrono::microseconds>(legacy_end - legacy_start);
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        std::cout << "Shader source size: " << glsl.size() << " bytes" << std::endl;
+        std::cout << "Regex chain rewrite time: " << legacy_duration.count() << " us" << std::endl;
+        std::cout << "Single-pass rewrite time: " << duration.count() << " us" << std::endl;
+        
+        // 性能要求：单遍改写至少快一个数量级
+        EXPECT_LT(duration.count() * 10, legacy_duration.count()) << "Single-pass rewrite not fast enough";
+    }
+}
+
+// 性能测试20：共享包含库的光影包预处理性能
+TEST_F(PerformanceTest, ShaderIncludeCachePerformance) {
+    // 模拟OptiFine光影包：100个程序共享同一组大型包含库
+    const int program_count = 100;
+    const int library_count = 4;
+    std::string shaders_dir = temp_dir_ + "/includepack/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    
+    for (int l = 0; l < library_count; l++) {
+        std::ofstream library(shaders_dir + "/lib/library" + std::to_string(l) + ".glsl");
+        library << "#define LIBRARY" << l << "_QUALITY 2 // [1 2 3]\n";
+        for (int i = 0; i < 1500; i++) {
+            library << "#if LIBRARY" << l << "_QUALITY > 1\n";
+            library << "vec3 function" << l << "_" << i << "(vec3 x) { return x * " << i << ".0; } // detail\n";
+            library << "#else\n";
+            library << "vec3 function" << l << "_" << i << "(vec3 x) { return x; }\n";
+            library << "#endif\n";
+        }
+    }
+    std::vector<std::string> programs;
+    for (int p = 0; p < program_count; p++) {
+        std::string program = shaders_dir + "/program" + std::to_string(p) + ".fsh";
+        std::ofstream file(program);
+        file << "#version 120\n";
+        for (int l = 0; l < library_count; l++) {
+            file << "#include \"/lib/library" << l << ".glsl\"\n";
+        }
+        file << "void main() { gl_FragColor = vec4(function0_1(vec3(1.0)), 1.0); }\n";
+        programs.push_back(program);
+    }
+    
+    std::string output;
+    std::string error;
+    
+    // 基准：每个程序单独预处理，包含库每次重新解析
+    auto uncached_start = std::chrono::high_resolution_clock::now();
+    for (const auto& program : programs) {
+        core::render::GLSLPreprocessor preprocessor(shaders_dir);
+        ASSERT_TRUE(preprocessor.Process(program, output, &error)) << error;
+    }
+    auto uncached_end = std::chrono::high_resolution_clock::now();
+    
+    // 共享缓存
+    core::render::GLSLPreprocessor preprocessor(shaders_dir);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& program : programs) {
+        ASSERT_TRUE(preprocessor.Process(program, output, &error)) << error;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    // 每个包含库只解析一次
+    EXPECT_EQ(preprocessor.GetParseCount(), static_cast<size_t>(program_count + library_count));
+    
+    auto uncached_duration = std::chrono::duration_cast<std::chrono::milliseconds>(uncached_end - uncached_start);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Preprocess without include cache (" << program_count << " programs): "
+              << uncached_duration.count() << " ms" << std::endl;
+    std::cout << "Preprocess with include cache (" << program_count << " programs): "
+              << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：共享缓存至少快5倍
+    EXPECT_LT(duration.count() * 5, uncached_duration.count()) << "Include cache not effective enough";
+}
+
+// 性能测试21：光影包多程序并行转换性能
+TEST_F(PerformanceTest, ParallelShaderpackPerformance) {
+    // 150个程序的光影包，共享一个包含库
+    const int program_count = 150;
+    std::string pack_dir = temp_dir_ + "/parallelpack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    {
+        std::ofstream library(shaders_dir + "/lib/common.glsl");
+        library << "uniform mat4 gbufferModelView;\nuniform sampler2D texture;\n";
+        for (int i = 0; i < 300; i++) {
+            library << "uniform float option" << i << ";\n";
+            library << "vec4 sample" << i << "(vec2 uv) { return texture2D(texture, uv) * option" << i << "; }\n";
+        }
+    }
+    for (int p = 0; p < program_count; p++) {
+        std::ofstream program(shaders_dir + "/program" + std::to_string(p) + (p % 2 ? ".vsh" : ".fsh"));
+        program << "#version 120\n#include \"/lib/common.glsl\"\n";
+        program << "varying vec2 uv;\nvoid main() { gl_FragColor = sample" << p << "(uv); }\n";
+    }
+    
+    // 基准：单工作线程（调用线程参与，共2个线程）
+    common::ThreadPool small_pool(1);
+    core::render::ShaderConverter serial;
+    serial.SetThreadPool(&small_pool);
+    auto serial_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(serial.ParseShaderpack(pack_dir));
+    auto serial_end = std::chrono::high_resolution_clock::now();
+    
+    // 默认线程池
+    core::render::ShaderConverter parallel;
+    auto start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(parallel.ParseShaderpack(pack_dir));
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    EXPECT_EQ(parallel.GetMaterialList().size(), static_cast<size_t>(program_count));
+    
+    auto serial_duration = std::chrono::duration_cast<std::chrono::milliseconds>(serial_end - serial_start);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    size_t threads = common::ThreadPool::GetDefault().GetThreadCount() + 1;
+    std::cout << "Shaderpack conversion with 2 threads: " << serial_duration.count() << " ms" << std::endl;
+    std::cout << "Shaderpack conversion with " << threads << " threads: " << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：4核及以上时至少快1.5倍
+    if (threads >= 4) {
+        EXPECT_LT(duration.count() * 3, serial_duration.count() * 2) << "Shaderpack conversion does not scale";
+    }
+}
+
+// 性能测试22：着色器缓存热加载性能
+TEST_F(PerformanceTest, ShaderCacheWarmLoadPerformance) {
+    const int program_count = 100;
+    std::string pack_dir = temp_dir_ + "/cachedpack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    {
+        std::ofstream library(shaders_dir + "/lib/common.glsl");
+        library << "uniform mat4 gbufferModelView;\nuniform sampler2D texture;\n";
+        for (int i = 0; i < 300; i++) {
+            library << "uniform float option" << i << ";\n";
+            library << "vec4 sample" << i << "(vec2 uv) { return texture2D(texture, uv) * option" << i << "; }\n";
+        }
+    }
+    for (int p = 0; p < program_count; p++) {
+        std::ofstream program(shaders_dir + "/program" + std::to_string(p) + (p % 2 ? ".vsh" : ".fsh"));
+        program << "#version 120\n#include \"/lib/common.glsl\"\n";
+        program << "varying vec2 uv;\nvoid main() { gl_FragColor = sample" << p << "(uv); }\n";
+    }
+    std::string cache_path = temp_dir_ + "/shaders.cache";
+    
+    // 冷加载：转换、编译并写入缓存
+    core::render::ShaderCache cold_cache;
+    core::render::ShaderConverter cold;
+    cold.SetShaderCache(&cold_cache);
+    auto cold_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(cold.ParseShaderpack(pack_dir));
+    ASSERT_TRUE(cold_cache.SaveToDisk(cache_path));
+    auto cold_end = std::chrono::high_resolution_clock::now();
+    
+    // 热加载：映射缓存文件，只做预处理与哈希
+    core::render::ShaderCache warm_cache;
+    core::render::ShaderConverter warm;
+    warm.SetShaderCache(&warm_cache);
+    auto warm_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(warm_cache.LoadFromDisk(cache_path));
+    ASSERT_TRUE(warm.ParseShaderpack(pack_dir));
+    auto warm_end = std::chrono::high_resolution_clock::now();
+    
+    ASSERT_EQ(warm.GetMaterialList().size(), static_cast<size_t>(program_count));
+    for (int p = 0; p < program_count; p++) {
+        std::string name = "program" + std::to_string(p);
+        EXPECT_EQ(warm.GetMaterialInfo(name)->shaders[0].source, cold.GetMaterialInfo(name)->shaders[0].source);
+        EXPECT_EQ(warm.GetMaterialInfo(name)->shaders[0].uniforms, cold.GetMaterialInfo(name)->shaders[0].uniforms);
+    }
+    
+    auto cold_duration = std::chrono::duration_cast<std::chrono::milliseconds>(cold_end - cold_start);
+    auto warm_duration = std::chrono::duration_cast<std::chrono::milliseconds>(warm_end - warm_start);
+    std::cout << "Cold shaderpack load: " << cold_duration.count() << " ms" << std::endl;
+    std::cout << "Warm shaderpack load: " << warm_duration.count() << " ms" << std::endl;
+    
+    // 性能要求：热加载至少快2倍
+    EXPECT_LT(warm_duration.count() * 2, cold_duration.count()) << "Shader cache does not skip conversion";
+}
+
+// 性能测试23：按槽位批量更新Uniform性能
+TEST_F(PerformanceTest, UniformBatchUpdatePerformance) {
+    const int material_count = 50;
+    const int uniform_count = 200;
+    const int frame_count = 200;
+    
+    std::string source;
+    std::vector<std::string> names;
+    for (int i = 0; i < uniform_count; i++) {
+        names.push_back("u_option" + std::to_string(i));
+        source += "uniform " + std::string(i % 4 == 0 ? "vec4 " : "float ") + names.back() + ";\n";
+    }
+    core::render::UniformLayout layout;
+    layout.AddFromSource(source, {});
+    ASSERT_EQ(layout.GetSlotCount(), static_cast<size_t>(uniform_count));
+    
+    core::render::ShaderConverter converter;
+    float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    
+    // 按名称更新：每帧为每个材质填充名称到值的映射
+    std::vector<std::unordered_map<std::string, float>> maps(material_count);
+    auto named_start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < frame_count; frame++) {
+        value[0] = static_cast<float>(frame);
+        for (auto& values : maps) {
+            for (const std::string& name : names) {
+                values[name] = value[0];
+            }
+            converter.UpdateUniforms(nullptr, values);
+        }
+    }
+    auto named_end = std::chrono::high_resolution_clock::now();
+    
+    // 按槽位更新：槽位预先解析，每帧写入打包缓冲区后整体上传
+    std::vector<int> slots;
+    for (const std::string& name : names) {
+        slots.push_back(layout.FindSlot(name));
+    }
+    std::vector<core::render::UniformBuffer> buffers(material_count, core::render::UniformBuffer(layout));
+    auto batched_start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < frame_count; frame++) {
+        value[0] = static_cast<float>(frame);
+        for (auto& buffer : buffers) {
+            for (int slot : slots) {
+                buffer.Set(slot, value, 4);
+            }
+            converter.UploadUniforms(nullptr, buffer);
+        }
+    }
+    auto batched_end = std::chrono::high_resolution_clock::now();
+    EXPECT_FLOAT_EQ(buffers[0].Data()[0], static_cast<float>(frame_count - 1));
+    
+    auto named_duration = std::chrono::duration_cast<std::chrono::microseconds>(named_end - named_start);
+    auto batched_duration = std::chrono::duration_cast<std::chrono::microseconds>(batched_end - batched_start);
+    std::cout << "Named uniform updates: " << named_duration.count() << " us" << std::endl;
+    std::cout << "Batched uniform updates: " << batched_duration.count() << " us" << std::endl;
+    
+    // 性能要求：按槽位更新至少快2倍
+    EXPECT_LT(batched_duration.count() * 2, named_duration.count()) << "Uniform updates still hash names per frame";
+}
+
+// 性能测试24：切换光影选项性能
+TEST_F(PerformanceTest, ShaderOptionTogglePerformance) {
+    const int program_count = 100;
+    const int water_count = 10;
+    std::string pack_dir = temp_dir_ + "/optionpack";
+    std::string shaders_dir = pack_dir + "/shaders";
+    std::filesystem::create_directories(shaders_dir + "/lib");
+    {
+        std::ofstream library(shaders_dir + "/lib/common.glsl");
+        library << "uniform mat4 gbufferModelView;\nuniform sampler2D texture;\n";
+        for (int i = 0; i < 300; i++) {
+            library << "uniform float option" << i << ";\n";
+            library << "vec4 sample" << i << "(vec2 uv) { return texture2D(texture, uv) * option" << i << "; }\n";
+        }
+    }
+    std::ofstream(shaders_dir + "/lib/water.glsl")
+        << "//#define FANCY_WATER\n#ifdef FANCY_WATER\nuniform float waveHeight;\n#endif\n";
+    for (int p = 0; p < program_count; p++) {
+        std::ofstream program(shaders_dir + "/program" + std::to_string(p) + ".fsh");
+        program << "#version 120\n#include \"/lib/common.glsl\"\n";
+        if (p < water_count) {
+            program << "#include \"/lib/water.glsl\"\n";
+        }
+        program << "varying vec2 uv;\nvoid main() { gl_FragColor = sample" << p << "(uv); }\n";
+    }
+    
+    core::render::ShaderConverter converter;
+    ASSERT_TRUE(converter.ParseShaderpack(pack_dir));
+    
+    // 全量重新解析：修改配置后重新加载整个光影包
+    std::ofstream(shaders_dir + "/shaders.properties") << "FANCY_WATER=true\n";
+    core::render::ShaderConverter reloaded;
+    auto full_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(reloaded.ParseShaderpack(pack_dir));
+    auto full_end = std::chrono::high_resolution_clock::now();
+    
+    // 按变体切换：只重新转换引用该选项的程序
+    auto toggle_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(converter.SetShaderOption("FANCY_WATER", "true"));
+    auto toggle_end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(converter.GetVariantCount(), static_cast<size_t>(program_count + water_count));
+    for (int p = 0; p < water_count; p++) {
+        std::string name = "program" + std::to_string(p);
+        EXPECT_EQ(converter.GetMaterialInfo(name)->shaders[0].source, reloaded.GetMaterialInfo(name)->shaders[0].source);
+    }
+    
+    // 切换回原值复用已有变体
+    auto revert_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(converter.SetShaderOption("FANCY_WATER", "false"));
+    auto revert_end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(converter.GetVariantCount(), static_cast<size_t>(program_count + water_count));
+    
+    auto full_duration = std::chrono::duration_cast<std::chrono::milliseconds>(full_end - full_start);
+    auto toggle_duration = std::chrono::duration_cast<std::chrono::milliseconds>(toggle_end - toggle_start);
+    auto revert_duration = std::chrono::duration_cast<std::chrono::milliseconds>(revert_end - revert_start);
+    std::cout << "Full shaderpack reload: " << full_duration.count() << " ms" << std::endl;
+    std::cout << "Option toggle: " << toggle_duration.count() << " ms" << std::endl;
+    std::cout << "Option revert: " << revert_duration.count() << " ms" << std::endl;
+    
+    // 性能要求：切换选项至少比全量重新解析快3倍
+    EXPECT_LT(toggle_duration.count() * 3, full_duration.count()) << "Option toggle reconverts unaffected programs";
+    EXPECT_LE(revert_duration.count(), toggle_duration.count());
+}
+
+// 性能测试25：重复上传着色器源代码的转换性能
+TEST_F(PerformanceTest, ShaderSourceCachePerformance) {
+    const int shader_count = 50;
+    const int upload_rounds = 20;
+    
+    // 模拟游戏上传的着色器：版本行与主体分两个片段
+    std::vector<std::string> bodies;
+    for (int s = 0; s < shader_count; s++) {
+        std::stringstream body;
+        body << "varying vec2 uv;\nuniform sampler2D texture;\n";
+        for (int i = 0; i < 100; i++) {
+            body << "uniform float weight" << s << "_" << i << ";\n";
+        }
+        body << "void main() { gl_FragColor = texture2D(texture, uv) * weight" << s << "_0; }\n";
+        bodies.push_back(body.str());
+    }
+    const char* version = "#version 120\n";
+    
+    // 每次上传都转换
+    size_t direct_size = 0;
+    auto direct_start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < upload_rounds; round++) {
+        for (const auto& body : bodies) {
+            direct_size += core::render::RewriteGLSLForRenderDragon(version + body, core::render::ShaderStage::FRAGMENT).size();
+        }
+    }
+    auto direct_end = std::chrono::high_resolution_clock::now();
+    
+    // 按源代码哈希复用（上下文丢失、窗口大小变化后重新上传）
+    core::render::ShaderSourceCache cache;
+    size_t cached_size = 0;
+    auto cached_start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < upload_rounds; round++) {
+        for (const auto& body : bodies) {
+            const char* fragments[] = {version, body.c_str()};
+            cached_size += cache.Translate(2, fragments, nullptr, core::render::ShaderStage::FRAGMENT)->size();
+        }
+    }
+    auto cached_end = std::chrono::high_resolution_clock::now();
+    
+    EXPECT_EQ(cached_size, direct_size);
+    EXPECT_EQ(cache.GetMissCount(), static_cast<uint64_t>(shader_count));
+    
+    auto direct_duration = std::chrono::duration_cast<std::chrono::microseconds>(direct_end - direct_start);
+    auto cached_duration = std::chrono::duration_cast<std::chrono::microseconds>(cached_end - cached_start);
+    std::cout << "Translate every upload: " << direct_duration.count() << " us" << std::endl;
+    std::cout << "Translate with source cache: " << cached_duration.count() << " us" << std::endl;
+    
+    // 性能要求：缓存后至少快5倍
+    EXPECT_LT(cached_duration.count() * 5, direct_duration.count()) << "Repeated uploads are translated again";
+}
+
+// 性能测试26：JNI调用开销
+TEST_F(PerformanceTest, JNICallOverheadPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    const int call_count = 100000;
+    
+    // 每次调用都查找类与方法（清空缓存模拟未缓存的路径）
+    auto lookup_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < call_count; i++) {
+        runtime.ClearMethodCache();
+        ASSERT_TRUE(runtime.CallStaticJavaMethod("java/lang/Math", "abs", "(I)I", -i));
+    }
+    auto lookup_end = std::chrono::high_resolution_clock::now();
+    
+    // 按名称调用，命中方法缓存
+    auto cached_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < call_count; i++) {
+        ASSERT_TRUE(runtime.CallStaticJavaMethod("java/lang/Math", "abs", "(I)I", -i));
+    }
+    auto cached_end = std::chrono::high_resolution_clock::now();
+    
+    // 通过句柄调用，跳过字符串查找
+    core::mods::JavaMethodHandle handle;
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "abs", "(I)I", true, handle));
+    auto handle_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < call_count; i++) {
+        ASSERT_TRUE(runtime.Invoke(handle, nullptr, -i));
+    }
+    auto handle_end = std::chrono::high_resolution_clock::now();
+    
+    runtime.Shutdown();
+    
+    auto lookup_duration = std::chrono::duration_cast<std::chrono::microseconds>(lookup_end - lookup_start);
+    auto cached_duration = std::chrono::duration_cast<std::chrono::microseconds>(cached_end - cached_start);
+    auto handle_duration = std::chrono::duration_cast<std::chrono::microseconds>(handle_end - handle_start);
+    std::cout << "JNI calls with lookup: " << lookup_duration.count() << " us" << std::endl;
+    std::cout << "JNI calls with method cache: " << cached_duration.count() << " us" << std::endl;
+    std::cout << "JNI calls with handle: " << handle_duration.count() << " us" << std::endl;
+    
+    // 性能要求：句柄调用不慢于按名称的缓存调用，两者都快于每次查找
+    EXPECT_LT(cached_duration.count(), lookup_duration.count()) << "Method cache is not used";
+    EXPECT_LE(handle_duration.count(), cached_duration.count()) << "Handle call is slower than name lookup";
+}
+
+// 性能测试27：批量事件分发性能
+TEST_F(PerformanceTest, BatchedEventDispatchPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    core::mods::JavaMethodHandle dispatcher;
+    if (!runtime.PrepareCall("com/mcu/bridge/EventDispatcher", "dispatchBatch", "(Ljava/nio/ByteBuffer;II)V",
+                             true, dispatcher)) {
+        runtime.Shutdown();
+        GTEST_SKIP() << "Event dispatcher not available";
+    }
+    
+    const int tick_count = 20;
+    const int events_per_tick = 5000;
+    uint16_t block_update = runtime.RegisterBatchedEvent("block_update");
+    
+    // 每个事件单独跨越JNI
+    size_t single_events = 0;
+    auto single_start = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < tick_count; tick++) {
+        for (int i = 0; i < events_per_tick; i++) {
+            int32_t position[3] = {i, tick, -i};
+            runtime.QueueEvent(block_update, position, sizeof(position));
+            single_events += runtime.FlushEvents();
+        }
+    }
+    auto single_end = std::chrono::high_resolution_clock::now();
+    
+    // 每tick整批跨越一次
+    size_t batched_events = 0;
+    auto batched_start = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < tick_count; tick++) {
+        for (int i = 0; i < events_per_tick; i++) {
+            int32_t position[3] = {i, tick, -i};
+            runtime.QueueEvent(block_update, position, sizeof(position));
+        }
+        batched_events += runtime.FlushEvents();
+    }
+    auto batched_end = std::chrono::high_resolution_clock::now();
+    
+    runtime.Shutdown();
+    
+    EXPECT_EQ(single_events, static_cast<size_t>(tick_count * events_per_tick));
+    EXPECT_EQ(batched_events, single_events);
+    
+    auto single_duration = std::chrono::duration_cast<std::chrono::microseconds>(single_end - single_start);
+    auto batched_duration = std::chrono::duration_cast<std::chrono::microseconds>(batched_end - batched_start);
+    std::cout << "Per-event dispatch: " << single_duration.count() << " us" << std::endl;
+    std::cout << "Batched dispatch: " << batched_duration.count() << " us" << std::endl;
+    
+    // 性能要求：批量分发至少快10倍
+    EXPECT_LT(batched_duration.count() * 10, single_duration.count()) << "Events are not batched";
+}
+
+// 性能测试28：模组处理函数并行执行性能
+TEST_F(PerformanceTest, ParallelModHandlerPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    const int handler_count = 64;
+    const int calls_per_handler = 20000;
+    core::mods::JavaMethodHandle sqrt_handle;
+    ASSERT_TRUE(runtime.PrepareCall("java/lang/Math", "sqrt", "(D)D", true, sqrt_handle));
+    
+    // 相互独立的模组处理函数
+    std::vector<core::mods::JavaModRuntime::ModTask> handlers;
+    for (int h = 0; h < handler_count; h++) {
+        handlers.push_back([&runtime, &sqrt_handle, h](JNIEnv*) {
+            bool ok = true;
+            for (int i = 0; i < calls_per_handler; i++) {
+                ok = runtime.Invoke(sqrt_handle, nullptr, static_cast<double>(h * calls_per_handler + i)) && ok;
+            }
+            return ok;
+        });
+    }
+    
+    // 在调用线程上依次执行
+    auto serial_start = std::chrono::high_resolution_clock::now();
+    for (const auto& handler : handlers) {
+        ASSERT_TRUE(handler(runtime.GetEnv()));
+    }
+    auto serial_end = std::chrono::high_resolution_clock::now();
+    
+    // 工作线程池并行执行
+    auto parallel_start = std::chrono::high_resolution_clock::now();
+    size_t succeeded = runtime.RunModTasks(handlers);
+    auto parallel_end = std::chrono::high_resolution_clock::now();
+    
+    runtime.Shutdown();
+    
+    EXPECT_EQ(succeeded, static_cast<size_t>(handler_count));
+    
+    auto serial_duration = std::chrono::duration_cast<std::chrono::milliseconds>(serial_end - serial_start);
+    auto parallel_duration = std::chrono::duration_cast<std::chrono::milliseconds>(parallel_end - parallel_start);
+    size_t cores = std::thread::hardware_concurrency();
+    std::cout << "Mod handlers on one thread: " << serial_duration.count() << " ms" << std::endl;
+    std::cout << "Mod handlers on worker pool: " << parallel_duration.count() << " ms" << std::endl;
+    
+    // 性能要求：4核及以上时至少快1.5倍
+    if (cores >= 4) {
+        EXPECT_LT(parallel_duration.count() * 3, serial_duration.count() * 2) << "Mod handlers do not run in parallel";
+    }
+}
+
+// 性能测试29：JAR元数据扫描性能
+TEST_F(PerformanceTest, JarMetadataScanPerformance) {
+    const int jar_count = 300;
+    const int classes_per_jar = 200;
+    
+    // 每个JAR包含mods.toml与若干类文件
+    std::string class_body(2048, '\0');
+    for (size_t i = 0; i < class_body.size(); i++) {
+        class_body[i] = static_cast<char>((i * 31) % 251);
+    }
+    for (int j = 0; j < jar_count; j++) {
+        std::map<std::string, std::string> entries;
+        std::stringstream toml;
+        toml << "modLoader=\"javafml\"\n[[mods]]\nmodId=\"mod" << j << "\"\nversion=\"1.0." << j << "\"\n";
+        toml << "description=\"" << std::string(1024, 'd') << "\"\n";
+        entries["META-INF/mods.toml"] = toml.str();
+        for (int c = 0; c < classes_per_jar; c++) {
+            entries["com/mod" + std::to_string(j) + "/Class" + std::to_string(c) + ".class"] = class_body;
+        }
+        CreateTestJar(mods_dir_ + "/mod" + std::to_string(j) + ".jar", entries);
+    }
+    
+    // 基准：单线程冷启动
+    common::ThreadPool single_pool(1);
+    core::mods::JavaModRuntime serial;
+    serial.GetJarScanner().SetThreadPool(&single_pool);
+    std::vector<core::mods::JavaModInfo> serial_mods;
+    auto serial_start = std::chrono::high_resolution_clock::now();
+    ASSERT_EQ(serial.ScanModsDirectory(mods_dir_, serial_mods), static_cast<size_t>(jar_count));
+    auto serial_end = std::chrono::high_resolution_clock::now();
+    
+    // 默认线程池冷启动
+    core::mods::JavaModRuntime cold;
+    std::vector<core::mods::JavaModInfo> cold_mods;
+    auto cold_start = std::chrono::high_resolution_clock::now();
+    ASSERT_EQ(cold.ScanModsDirectory(mods_dir_, cold_mods), static_cast<size_t>(jar_count));
+    auto cold_end = std::chrono::high_resolution_clock::now();
+    std::string cache_path = output_dir_ + "/jars.cache";
+    ASSERT_TRUE(cold.GetJarScanner().SaveCache(cache_path));
+    
+    // 热启动：从缓存文件加载，不解压任何条目
+    core::mods::JavaModRuntime warm;
+    std::vector<core::mods::JavaModInfo> warm_mods;
+    auto warm_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(warm.GetJarScanner().LoadCache(cache_path));
+    ASSERT_EQ(warm.ScanModsDirectory(mods_dir_, warm_mods), static_cast<size_t>(jar_count));
+    auto warm_end = std::chrono::high_resolution_clock::now();
+    
+    EXPECT_EQ(warm.GetJarScanner().GetMissCount(), 0u);
+    for (int j = 0; j < jar_count; j++) {
+        EXPECT_EQ(warm_mods[j].modId, cold_mods[j].modId);
+        EXPECT_EQ(warm_mods[j].version, serial_mods[j].version);
+    }
+    
+    auto serial_duration = std::chrono::duration_cast<std::chrono::microseconds>(serial_end - serial_start);
+    auto cold_duration = std::chrono::duration_cast<std::chrono::microseconds>(cold_end - cold_start);
+    auto warm_duration = std::chrono::duration_cast<std::chrono::microseconds>(warm_end - warm_start);
+    size_t threads = common::ThreadPool::GetDefault().GetThreadCount() + 1;
+    std::cout << "Scan " << jar_count << " JARs with 2 threads: " << serial_duration.count() << " us" << std::endl;
+    std::cout << "Scan " << jar_count << " JARs with " << threads << " threads: " << cold_duration.count() << " us" << std::endl;
+    std::cout << "Scan " << jar_count << " JARs from cache: " << warm_duration.count() << " us" << std::endl;
+    
+    // 性能要求：300个JAR冷启动扫描在1秒内完成，热启动快于冷启动；4核及以上时并行至少快1.5倍
+    EXPECT_LT(cold_duration.count(), 1000000) << "JAR scanning is too slow";
+    EXPECT_LT(warm_duration.count(), cold_duration.count()) << "JAR cache does not skip decompression";
+    if (threads >= 4) {
+        EXPECT_LT(cold_duration.count() * 3, serial_duration.count() * 2) << "JAR scanning does not scale";
+    }
+}
+
+// 性能测试30：模组依赖图分层性能
+TEST_F(PerformanceTest, ModDependencyGraphPerformance) {
+    const int mod_count = 20000;
+    const int fan_in = 4;
+    
+    // 每个模组依赖前面的若干模组，另有部分依赖目录中不存在的模组
+    std::vector<std::vector<std::string>> dependencies(mod_count);
+    std::unordered_map<std::string, double> durations;
+    for (int i = 0; i < mod_count; i++) {
+        for (int d = 1; d <= fan_in && i >= d * 97; d++) {
+            dependencies[i].push_back("mod" + std::to_string((i * 7919 + d * 104729) % (i - d * 96)));
+        }
+        if (i % 10 == 0) {
+            dependencies[i].push_back("external" + std::to_string(i));
+        }
+        durations["mod" + std::to_string(i)] = static_cast<double>(i % 13);
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    core::mods::ModDependencyGraph graph;
+    for (int i = 0; i < mod_count; i++) {
+        graph.AddMod("mod" + std::to_string(i), dependencies[i]);
+    }
+    std::vector<std::vector<std::string>> levels;
+    std::vector<std::string> cycle;
+    ASSERT_TRUE(graph.BuildLevels(levels, cycle));
+    double critical_ms = 0.0;
+    std::vector<std::string> path = graph.GetCriticalPath(durations, critical_ms);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    size_t sorted = 0;
+    for (const auto& level : levels) {
+        sorted += level.size();
+    }
+    EXPECT_EQ(sorted, static_cast<size_t>(mod_count));
+    EXPECT_FALSE(path.empty());
+    
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Dependency graph of " << mod_count << " mods: " << levels.size() << " levels, critical path "
+              << path.size() << " mods, " << duration.count() << " ms" << std::endl;
+    
+    // 性能要求：20000个模组的分层与关键路径在200毫秒内完成
+    EXPECT_LT(duration.count(), 200) << "Dependency graph is too slow";
+}
+
+// 性能测试31：启动性能分析开销
+TEST_F(PerformanceTest, ModProfilerOverheadPerformance) {
+    const int scope_count = 100000;
+    core::mods::ModProfiler& profiler = core::mods::ModProfiler::GetInstance();
+    std::string mod_id = "example_mod";
+    
+    // 关闭时的开销
+    profiler.Disable();
+    auto disabled_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < scope_count; i++) {
+        core::mods::ModProfileScope scope("java", mod_id, "init");
+    }
+    auto disabled_end = std::chrono::high_resolution_clock::now();
+    
+    // 启用时两层嵌套
+    profiler.Enable();
+    auto enabled_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < scope_count / 2; i++) {
+        core::mods::ModProfileScope load("java", mod_id, "load");
+        core::mods::ModProfileScope init("java", mod_id, "init");
+    }
+    auto enabled_end = std::chrono::high_resolution_clock::now();
+    profiler.Disable();
+    EXPECT_EQ(profiler.GetEvents().size(), static_cast<size_t>(scope_count));
+    
+    auto export_start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(profiler.WriteChromeTrace(output_dir_ + "/startup.trace.json"));
+    ASSERT_TRUE(profiler.WriteCollapsedStacks(output_dir_ + "/startup.folded"));
+    auto export_end = std::chrono::high_resolution_clock::now();
+    profiler.Clear();
+    
+    auto disabled_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(disabled_end - disabled_start);
+    auto enabled_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(enabled_end - enabled_start);
+    auto export_duration = std::chrono::duration_cast<std::chrono::milliseconds>(export_end - export_start);
+    double disabled_ns = static_cast<double>(disabled_duration.count()) / scope_count;
+    double enabled_ns = static_cast<double>(enabled_duration.count()) / scope_count;
+    std::cout << "Disabled profile scope: " << disabled_ns << " ns" << std::endl;
+    std::cout << "Enabled profile scope: " << enabled_ns << " ns" << std::endl;
+    std::cout << "Export " << scope_count << " events: " << export_duration.count() << " ms" << std::endl;
+    
+    // 性能要求：关闭时每个区间不超过100纳秒，启用时不超过5微秒，导出10万事件在1秒内
+    EXPECT_LT(disabled_ns, 100.0) << "Disabled profiler is not free";
+    EXPECT_LT(enabled_ns, 5000.0) << "Profile scope is too expensive";
+    EXPECT_LT(export_duration.count(), 1000) << "Profile export is too slow";
+}
+
+// 性能测试32：模组入口类解析性能
+TEST_F(PerformanceTest, ModEntryPointLoadPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    const int mod_count = 200;
+    std::string resolved_dir = mods_dir_ + "/resolved";
+    std::string probed_dir = mods_dir_ + "/probed";
+    std::filesystem::create_directories(resolved_dir);
+    std::filesystem::create_directories(probed_dir);
+    
+    // 声明了入口点的模组与需要按类名探测的模组
+    for (int i = 0; i < mod_count; i++) {
+        std::string id = std::to_string(i);
+        CreateTestJar(resolved_dir + "/resolved" + id + ".jar", {
+            {"fabric.mod.json", "{\"id\": \"resolved" + id + "\", \"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+        CreateTestJar(probed_dir + "/probed" + id + ".jar", {{"readme.txt", "no manifest"}});
+    }
+    
+    auto probed_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < mod_count; i++) {
+        ASSERT_TRUE(runtime.LoadMod(probed_dir + "/probed" + std::to_string(i) + ".jar"));
+    }
+    auto probed_end = std::chrono::high_resolution_clock::now();
+    
+    auto resolved_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < mod_count; i++) {
+        ASSERT_TRUE(runtime.LoadMod(resolved_dir + "/resolved" + std::to_string(i) + ".jar"));
+    }
+    auto resolved_end = std::chrono::high_resolution_clock::now();
+    
+    // 卸载复用缓存的入口类
+    auto unload_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < mod_count; i++) {
+        ASSERT_TRUE(runtime.UnloadMod("resolved" + std::to_string(i)));
+    }
+    auto unload_end = std::chrono::high_resolution_clock::now();
+    runtime.Shutdown();
+    
+    auto probed_duration = std::chrono::duration_cast<std::chrono::microseconds>(probed_end - probed_start);
+    auto resolved_duration = std::chrono::duration_cast<std::chrono::microseconds>(resolved_end - resolved_start);
+    auto unload_duration = std::chrono::duration_cast<std::chrono::microseconds>(unload_end - unload_start);
+    std::cout << "Load " << mod_count << " mods by probing class names: " << probed_duration.count() << " us" << std::endl;
+    std::cout << "Load " << mod_count << " mods with resolved entry points: " << resolved_duration.count() << " us" << std::endl;
+    std::cout << "Unload " << mod_count << " mods: " << unload_duration.count() << " us" << std::endl;
+    
+    // 性能要求：使用解析出的入口类比逐个探测类名更快
+    EXPECT_LT(resolved_duration.count(), probed_duration.count()) << "Entry point resolution does not avoid probing";
+}
+
+// 性能测试33：模组热重载性能
+TEST_F(PerformanceTest, ModHotReloadPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    
+    const int cycle_count = 500;
+    std::string jar = mods_dir_ + "/reload.jar";
+    CreateTestJar(jar, {
+        {"fabric.mod.json", "{\"id\": \"reload\", \"entrypoints\": {\"main\": [\"java.lang.Object\"]}}"}});
+    
+    // 反复加载与卸载同一模组，每次都创建并丢弃独立的类加载器
+    size_t max_loaders = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < cycle_count; i++) {
+        ASSERT_TRUE(runtime.LoadMod(jar));
+        max_loaders = std::max(max_loaders, runtime.GetModClassLoaderCount());
+        ASSERT_TRUE(runtime.UnloadMod("reload"));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    // 卸载后不保留任何加载器
+    EXPECT_EQ(max_loaders, 1u);
+    EXPECT_EQ(runtime.GetModClassLoaderCount(), 0u);
+    runtime.Shutdown();
+    
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    double per_cycle = static_cast<double>(duration.count()) / cycle_count;
+    std::cout << "Hot reload " << cycle_count << " cycles: " << duration.count() << " us ("
+              << per_cycle << " us per cycle)" << std::endl;
+    
+    // 性能要求：每次重载（不含模组自身初始化）在5毫秒内完成
+    EXPECT_LT(per_cycle, 5000.0) << "Mod hot reload is too slow";
+}
+
+// 性能测试34：JVM启动前的CDS归档选择开销
+TEST_F(PerformanceTest, JvmProfileStartupPerformance) {
+    const int jar_count = 300;
+    const int classes_per_jar = 100;
+    
+    std::string class_body(1024, 'c');
+    for (int j = 0; j < jar_count; j++) {
+        std::map<std::string, std::string> entries;
+        entries["fabric.mod.json"] = "{\"id\": \"mod" + std::to_string(j) + "\"}";
+        for (int c = 0; c < classes_per_jar; c++) {
+            entries["com/mod" + std::to_string(j) + "/Class" + std::to_string(c) + ".class"] = class_body;
+        }
+        CreateTestJar(mods_dir_ + "/mod" + std::to_string(j) + ".jar", entries);
+    }
+    
+    core::mods::JvmProfile profile;
+    profile.cdsDirectory = output_dir_ + "/cds";
+    core::mods::JavaModRuntime runtime;
+    
+    // 首次启动：扫描所有JAR并计算模组集合哈希，选择写入归档
+    core::mods::CdsArchiveMode mode;
+    auto cold_start = std::chrono::high_resolution_clock::now();
+    uint64_t hash = runtime.ComputeModSetHash(mods_dir_);
+    std::vector<std::string> options = core::mods::BuildJvmOptions(profile, hash, mode);
+    auto cold_end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(mode, core::mods::CdsArchiveMode::DUMP);
+    
+    std::ofstream(core::mods::GetCdsArchivePath(profile, hash), std::ios::binary) << "archive";
+    
+    // 再次启动：元数据缓存命中，只读取中央目录
+    const int iterations = 20;
+    auto warm_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        EXPECT_EQ(runtime.ComputeModSetHash(mods_dir_), hash);
+        options = core::mods::BuildJvmOptions(profile, hash, mode);
+    }
+    auto warm_end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(mode, core::mods::CdsArchiveMode::USE);
+    
+    auto cold_duration = std::chrono::duration_cast<std::chrono::microseconds>(cold_end - cold_start);
+    double warm_ms = std::chrono::duration<double, std::milli>(warm_end - warm_start).count() / iterations;
+    std::cout << "JVM profile for " << jar_count << " mods: cold " << cold_duration.count() / 1000.0
+              << " ms, warm " << warm_ms << " ms" << std::endl;
+    
+    // 性能要求：归档命中时的额外启动开销在20毫秒内（远小于CDS节省的类加载时间）
+    EXPECT_LT(warm_ms, 20.0) << "Mod set hashing is too slow";
+}
+
+// 性能测试35：批量方块访问与逐个访问的吞吐量
+TEST_F(PerformanceTest, BulkBlockAccessPerformance) {
+    core::mods::JavaModRuntime runtime;
+    if (!runtime.Initialize()) {
+        GTEST_SKIP() << "JVM not available";
+    }
+    JNIEnv* env = runtime.GetEnv();
+    ASSERT_NE(env, nullptr);
+    
+    // 一个完整区块（16x256x16），通过注册的函数指针调用，与JVM调用本地方法的方式相同
+    const int size_x = 16, size_y = 256, size_z = 16;
+    const int volume = size_x * size_y * size_z;
+    const int iterations = 20;
+    auto* volatile get_block = &core::mods::bridge::Java_GetBlock;
+    auto* volatile set_block = &core::mods::bridge::Java_SetBlock;
+    auto* volatile get_blocks = &core::mods::bridge::Java_GetBlocks;
+    auto* volatile set_blocks = &core::mods::bridge::Java_SetBlocks;
+    auto* volatile get_blocks_buffer = &core::mods::bridge::Java_GetBlocksBuffer;
+    
+    // 逐个访问：每个方块一次本地调用
+    std::vector<int32_t> single_blocks(volume);
+    auto single_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        size_t index = 0;
+        for (int y = 0; y < size_y; y++) {
+            for (int z = 0; z < size_z; z++) {
+                for (int x = 0; x < size_x; x++) {
+                    single_blocks[index] = get_block(env, nullptr, x, y, z);
+                    set_block(env, nullptr, x, y, z, single_blocks[index] + 1);
+                    index++;
+                }
+            }
+        }
+    }
+    auto single_end = std::chrono::high_resolution_clock::now();
+    
+    // 批量访问：每个区块读写各一次调用，int[]在临界区内直接读写
+    jintArray blocks = env->NewIntArray(volume);
+    ASSERT_NE(blocks, nullptr);
+    auto bulk_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ASSERT_EQ(get_blocks(env, nullptr, 0, 0, 0, size_x, size_y, size_z, blocks), volume);
+        ASSERT_EQ(set_blocks(env, nullptr, 0, 0, 0, size_x, size_y, size_z, blocks), volume);
+    }
+    auto bulk_end = std::chrono::high_resolution_clock::now();
+    
+    // 直接缓冲区：Java与本地共享同一块内存
+    std::vector<int32_t> storage(volume);
+    jobject buffer = env->NewDirectByteBuffer(storage.data(), volume * sizeof(int32_t));
+    ASSERT_NE(buffer, nullptr);
+    auto buffer_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ASSERT_EQ(get_blocks_buffer(env, nullptr, 0, 0, 0, size_x, size_y, size_z, buffer), volume);
+    }
+    auto buffer_end = std::chrono::high_resolution_clock::now();
+    env->DeleteLocalRef(buffer);
+    env->DeleteLocalRef(blocks);
+    runtime.Shutdown();
+    
+    double total_blocks = static_cast<double>(volume) * iterations;
+    double single_us = std::chrono::duration<double, std::micro>(single_end - single_start).count();
+    double bulk_us = std::chrono::duration<double, std::micro>(bulk_end - bulk_start).count();
+    double buffer_us = std::chrono::duration<double, std::micro>(buffer_end - buffer_start).count();
+    std::cout << "Single block access: " << single_us << " us (" << total_blocks * 2 / single_us
+              << " blocks/us, " << volume * 2 << " native calls per chunk)" << std::endl;
+    std::cout << "Bulk int[] access: " << bulk_us << " us (" << total_blocks * 2 / bulk_us
+              << " blocks/us, 2 native calls per chunk)" << std::endl;
+    std::cout << "Bulk ByteBuffer read: " << buffer_us << " us (" << total_blocks / buffer_us
+              << " blocks/us)" << std::endl;
+    
+    // 性能要求：不计JNI切换，批量访问也快于逐个访问（每次切换还会额外节省数十纳秒）
+    EXPECT_LT(bulk_us, single_us) << "Bulk block access is slower than single calls";
+}
+
 } // namespace test
 } // namespace performance
 } // namespace mcu